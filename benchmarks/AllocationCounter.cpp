@@ -0,0 +1,13 @@
+#include "AllocationCounter.h"
+#include "../tests/MallocHook.h"
+
+void OpenSoT::benchmarks::AllocationCounter::start()
+{
+    MallocHook::start();
+}
+
+unsigned long OpenSoT::benchmarks::AllocationCounter::stop()
+{
+    MallocHook::stop();
+    return MallocHook::getAllocations();
+}
@@ -0,0 +1,28 @@
+#ifndef _OPENSOT_BENCHMARKS_ALLOCATION_COUNTER_H_
+#define _OPENSOT_BENCHMARKS_ALLOCATION_COUNTER_H_
+
+namespace OpenSoT { namespace benchmarks {
+
+    /**
+     * @brief The AllocationCounter class counts the heap allocations (malloc, calloc, realloc, aligned allocations and
+     * hence operator new and Eigen dynamic matrices) done by any thread while the counter is enabled.
+     * On glibc the allocation functions are replaced by the benchmark executable, on other platforms only
+     * operator new is counted. The allocation functions are replaced through tests/MallocHook.h.
+     */
+    class AllocationCounter {
+    public:
+        /**
+         * @brief start resets the counter and enables it
+         */
+        static void start();
+
+        /**
+         * @brief stop disables the counter
+         * @return the number of allocations since the last start()
+         */
+        static unsigned long stop();
+    };
+
+} }
+
+#endif
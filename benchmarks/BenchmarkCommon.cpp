@@ -0,0 +1,221 @@
+#include "BenchmarkCommon.h"
+#include "AllocationCounter.h"
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/solvers/nHQP.h>
+#include <OpenSoT/solvers/eHQP.h>
+#include <OpenSoT/solvers/l1HQP.h>
+#include <OpenSoT/solvers/wHQP.h>
+#ifdef OPENSOT_HAS_SOTH_FRONT_END
+#include <OpenSoT/solvers/HCOD.h>
+#endif
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+using namespace OpenSoT::benchmarks;
+using namespace OpenSoT::solvers;
+
+namespace {
+
+    std::string readFile(const std::string& path)
+    {
+        std::ifstream t(path);
+        std::stringstream buffer;
+        buffer << t.rdbuf();
+        return buffer.str();
+    }
+
+    std::string frontEndName(const front_ends front_end)
+    {
+        switch(front_end)
+        {
+            case(front_ends::iHQP):  return "iHQP";
+            case(front_ends::nHQP):  return "nHQP";
+            case(front_ends::eHQP):  return "eHQP";
+            case(front_ends::l1HQP): return "l1HQP";
+            case(front_ends::wHQP):  return "wHQP";
+            case(front_ends::HCOD):  return "HCOD";
+        }
+        return "";
+    }
+
+    bool usesBackEnd(const front_ends front_end)
+    {
+        return front_end == front_ends::iHQP || front_end == front_ends::nHQP || front_end == front_ends::l1HQP ||
+               front_end == front_ends::wHQP;
+    }
+
+    /**
+     * @brief percentile of a sorted vector
+     */
+    double percentile(const std::vector<double>& sorted, const double p)
+    {
+        if(sorted.empty())
+            return 0.;
+        return sorted[std::min<std::size_t>(sorted.size() - 1, p * sorted.size())];
+    }
+
+    /**
+     * @brief residual of the first priority level
+     */
+    double residual(OpenSoT::AutoStack::Ptr stack, const Eigen::VectorXd& x)
+    {
+        auto task = stack->getStack().front();
+        return (task->getA() * x - task->getb()).norm();
+    }
+
+    /**
+     * @brief violation maximum violation of the bounds (and global constraints) of the stack
+     */
+    double violation(OpenSoT::AutoStack::Ptr stack, const Eigen::VectorXd& x)
+    {
+        auto bounds = stack->getBounds();
+        if(!bounds)
+            return 0.;
+
+        double v = 0.;
+        if(bounds->getLowerBound().size() == x.size())
+            v = std::max({v, (bounds->getLowerBound() - x).maxCoeff(), (x - bounds->getUpperBound()).maxCoeff()});
+        if(bounds->getAineq().rows() > 0)
+        {
+            Eigen::VectorXd y = bounds->getAineq() * x;
+            v = std::max({v, (bounds->getbLowerBound() - y).maxCoeff(), (y - bounds->getbUpperBound()).maxCoeff()});
+        }
+        if(bounds->getAeq().rows() > 0)
+            v = std::max(v, (bounds->getAeq() * x - bounds->getbeq()).cwiseAbs().maxCoeff());
+        return v;
+    }
+}
+
+XBot::ModelInterface::Ptr OpenSoT::benchmarks::getModel(const std::string& name)
+{
+    std::string robot_folder = OPENSOT_BENCHMARK_ROBOTS_PATH;
+    robot_folder += name;
+
+    return XBot::ModelInterface::getModel(
+        readFile(robot_folder + "/" + name + ".urdf"),
+        readFile(robot_folder + "/" + name + ".srdf"),
+        OPENSOT_BENCHMARK_MODEL_TYPE);
+}
+
+SolverPtr OpenSoT::benchmarks::makeSolver(const front_ends front_end, OpenSoT::AutoStack::Ptr stack,
+                                          const solver_back_ends back_end)
+{
+    switch(front_end)
+    {
+        case(front_ends::iHQP):
+            return std::make_shared<iHQP>(*stack, DEFAULT_EPS_REGULARISATION, back_end);
+        case(front_ends::nHQP):
+            return std::make_shared<nHQP>(stack->getStack(), stack->getBounds(), DEFAULT_EPS_REGULARISATION, back_end);
+        case(front_ends::eHQP):
+            return std::make_shared<eHQP>(stack->getStack());
+        case(front_ends::l1HQP):
+            return std::make_shared<l1HQP>(*stack, DEFAULT_EPS_REGULARISATION, back_end);
+        case(front_ends::wHQP):
+            return std::make_shared<wHQP>(*stack, std::vector<double>(), DEFAULT_EPS_REGULARISATION, back_end);
+        case(front_ends::HCOD):
+#ifdef OPENSOT_HAS_SOTH_FRONT_END
+            return std::make_shared<HCOD>(*stack, 1e-9);
+#else
+            throw std::runtime_error("HCOD front-end is not available");
+#endif
+    }
+    return nullptr;
+}
+
+void OpenSoT::benchmarks::runProblem(benchmark::State& state, std::function<Problem::Ptr()> factory,
+                                     const front_ends front_end, const solver_back_ends back_end)
+{
+    Problem::Ptr problem = factory();
+    problem->reset();
+    problem->preTick(0);
+    problem->getStack()->update();
+
+    SolverPtr solver;
+    try
+    {
+        solver = makeSolver(front_end, problem->getStack(), back_end);
+    }
+    catch(const std::exception& e)
+    {
+        state.SkipWithError(e.what());
+        return;
+    }
+
+    Eigen::VectorXd x;
+    std::vector<double> latencies;
+    latencies.reserve(OPENSOT_BENCHMARK_TICKS);
+    unsigned long allocations = 0;
+    unsigned int failures = 0;
+    double residuals = 0., max_violation = 0.;
+
+    unsigned int tick = 0;
+    for(auto _ : state)
+    {
+        problem->preTick(tick);
+
+        AllocationCounter::start();
+        auto start = std::chrono::steady_clock::now();
+
+        problem->getStack()->update();
+        bool success = solver->solve(x);
+
+        double latency = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        allocations += AllocationCounter::stop();
+
+        state.SetIterationTime(latency);
+        latencies.push_back(latency);
+
+        if(success)
+        {
+            residuals += residual(problem->getStack(), x);
+            max_violation = std::max(max_violation, violation(problem->getStack(), x));
+        }
+        else
+        {
+            ++failures;
+            x.setZero(problem->getStack()->getStack().front()->getXSize());
+        }
+
+        problem->postTick(x);
+        ++tick;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    state.counters["p50_us"] = 1e6 * percentile(latencies, 0.5);
+    state.counters["p90_us"] = 1e6 * percentile(latencies, 0.9);
+    state.counters["p99_us"] = 1e6 * percentile(latencies, 0.99);
+    state.counters["max_us"] = 1e6 * percentile(latencies, 1.);
+    state.counters["allocs"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+    state.counters["residual"] = tick > failures ? residuals / (tick - failures) : 0.;
+    state.counters["violation"] = max_violation;
+    state.counters["failures"] = failures;
+}
+
+void OpenSoT::benchmarks::registerProblem(const std::string& name, std::function<Problem::Ptr()> factory)
+{
+    for(front_ends front_end : {front_ends::iHQP, front_ends::nHQP, front_ends::eHQP, front_ends::l1HQP,
+                                 front_ends::wHQP, front_ends::HCOD})
+    {
+        std::vector<solver_back_ends> back_ends = {solver_back_ends::qpOASES};
+        if(usesBackEnd(front_end))
+            back_ends = {solver_back_ends::qpOASES, solver_back_ends::OSQP, solver_back_ends::eiQuadProg,
+                         solver_back_ends::proxQP, solver_back_ends::proxQPSparse, solver_back_ends::qpSWIFT,
+                         solver_back_ends::GLPK, solver_back_ends::Auto};
+
+        for(solver_back_ends back_end : back_ends)
+        {
+            std::string benchmark_name = name + "/" + frontEndName(front_end);
+            if(usesBackEnd(front_end))
+                benchmark_name += "/" + whichBackEnd(back_end);
+
+            benchmark::RegisterBenchmark(benchmark_name.c_str(),
+                [factory, front_end, back_end](benchmark::State& state){
+                    runProblem(state, factory, front_end, back_end);})
+                ->Iterations(OPENSOT_BENCHMARK_TICKS)
+                ->UseManualTime()
+                ->Unit(benchmark::kMicrosecond);
+        }
+    }
+}
@@ -0,0 +1,109 @@
+#ifndef _OPENSOT_BENCHMARKS_COMMON_H_
+#define _OPENSOT_BENCHMARKS_COMMON_H_
+
+#include <OpenSoT/Solver.h>
+#include <OpenSoT/utils/AutoStack.h>
+#include <OpenSoT/solvers/BackEndFactory.h>
+#include <xbot2_interface/xbotinterface2.h>
+#include <benchmark/benchmark.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief OPENSOT_BENCHMARK_TICKS number of control ticks simulated by each benchmark
+ */
+#ifndef OPENSOT_BENCHMARK_TICKS
+#define OPENSOT_BENCHMARK_TICKS 1000
+#endif
+
+namespace OpenSoT { namespace benchmarks {
+
+    typedef OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::SolverPtr SolverPtr;
+
+    enum class front_ends{
+        iHQP,
+        nHQP,
+        eHQP,
+        l1HQP,
+        wHQP,
+        HCOD
+    };
+
+    /**
+     * @brief getModel loads one of the robots in tests/robots
+     * @param name of the robot
+     * @return the model
+     */
+    XBot::ModelInterface::Ptr getModel(const std::string& name);
+
+    /**
+     * @brief The Problem class is a closed-loop control problem: at each tick the stack is updated and solved,
+     * then the solution is used to integrate the state of the model
+     */
+    class Problem {
+    public:
+        typedef std::shared_ptr<Problem> Ptr;
+
+        virtual ~Problem(){}
+
+        /**
+         * @brief reset brings the model back to the initial state
+         */
+        virtual void reset() = 0;
+
+        /**
+         * @brief preTick updates the model and the references of the tasks (not measured)
+         * @param tick counter since the last reset
+         */
+        virtual void preTick(const unsigned int tick) = 0;
+
+        /**
+         * @brief postTick integrates the solution (not measured)
+         * @param x solution of the solver, zero if the solver failed
+         */
+        virtual void postTick(const Eigen::VectorXd& x) = 0;
+
+        /**
+         * @brief getStack
+         * @return the stack of the problem
+         */
+        OpenSoT::AutoStack::Ptr getStack(){return _stack;}
+
+    protected:
+        OpenSoT::AutoStack::Ptr _stack;
+    };
+
+    /**
+     * @brief makeSolver creates a front-end for the stack
+     * @param front_end
+     * @param stack
+     * @param back_end used by the front-ends which are based on a BackEnd (iHQP, nHQP, l1HQP and wHQP)
+     * @return the solver
+     * @throw if the back-end is not available or the problem can not be initialized
+     */
+    SolverPtr makeSolver(const front_ends front_end, OpenSoT::AutoStack::Ptr stack,
+                         const OpenSoT::solvers::solver_back_ends back_end);
+
+    /**
+     * @brief registerProblem registers a benchmark for each front-end and back-end, named
+     * <name>/<front-end>[/<back-end>]
+     * @param name of the problem, e.g. IK/panda
+     * @param factory creates the problem
+     */
+    void registerProblem(const std::string& name, std::function<Problem::Ptr()> factory);
+
+    /**
+     * @brief runProblem runs OPENSOT_BENCHMARK_TICKS ticks of the problem and reports:
+     *  - tick latency (stack update + solve) percentiles in microseconds,
+     *  - heap allocations per tick,
+     *  - mean residual of the first priority level and max violation of the bounds,
+     *  - number of failed ticks.
+     * Only the update of the stack and the solve are measured.
+     */
+    void runProblem(benchmark::State& state, std::function<Problem::Ptr()> factory,
+                    const front_ends front_end, const OpenSoT::solvers::solver_back_ends back_end);
+
+} }
+
+#endif
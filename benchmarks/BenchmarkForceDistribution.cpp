@@ -0,0 +1,101 @@
+#include "BenchmarkCommon.h"
+#include <OpenSoT/tasks/force/CoM.h>
+#include <OpenSoT/tasks/MinimizeVariable.h>
+#include <OpenSoT/constraints/force/FrictionCone.h>
+#include <OpenSoT/constraints/force/WrenchLimits.h>
+#include <cmath>
+
+using namespace OpenSoT::benchmarks;
+
+namespace {
+
+/**
+ * @brief The ForceDistributionProblem class distributes the contact wrenches of coman (floating base) in contact
+ * with both feet and the left hand, such that the CoM tracks a circle, with minimum wrenches:
+ *
+ *      CoM / MinimizeVariable << FrictionCones << WrenchLimits
+ */
+class ForceDistributionProblem : public Problem {
+public:
+    ForceDistributionProblem():
+        _model(getModel("coman_floating_base")),
+        _dt(0.001),
+        _contacts({"r_sole", "l_sole", "LSoftHand"})
+    {
+        Eigen::VectorXd q = _model->getNeutralQ();
+        q[_model->getQIndex("RHipSag")] = -25.0*M_PI/180.0;
+        q[_model->getQIndex("RKneeSag")] = 50.0*M_PI/180.0;
+        q[_model->getQIndex("RAnkSag")] = -25.0*M_PI/180.0;
+        q[_model->getQIndex("LHipSag")] = -25.0*M_PI/180.0;
+        q[_model->getQIndex("LKneeSag")] = 50.0*M_PI/180.0;
+        q[_model->getQIndex("LAnkSag")] = -25.0*M_PI/180.0;
+        q[_model->getQIndex("LShSag")] =  -90.0*M_PI/180.0;
+        q[_model->getQIndex("LForearmPlate")] = -90.0*M_PI/180.0;
+        _model->setJointPosition(q);
+        _model->update();
+
+        OpenSoT::OptvarHelper::VariableVector variables;
+        for(const std::string& contact : _contacts)
+            variables.emplace_back(contact, 6);
+        OpenSoT::OptvarHelper opt(variables);
+
+        std::vector<OpenSoT::AffineHelper> wrenches;
+        OpenSoT::constraints::force::FrictionCones::friction_cones friction_cones;
+        for(const std::string& contact : _contacts)
+        {
+            wrenches.push_back(opt.getVariable(contact));
+
+            Eigen::Affine3d T;
+            _model->getPose(contact, T);
+            friction_cones.push_back(std::make_pair(T.linear(), 0.8));
+        }
+
+        _com = std::make_shared<OpenSoT::tasks::force::CoM>(wrenches, _contacts, *_model);
+        _com0 = _com->getLinearReference();
+
+        // the wrenches are all the variables of the problem
+        OpenSoT::AffineHelper all_wrenches = OpenSoT::AffineHelper::Identity(opt.getSize());
+        auto min_wrenches = std::make_shared<OpenSoT::tasks::MinimizeVariable>("min_wrenches", all_wrenches);
+
+        auto friction = std::make_shared<OpenSoT::constraints::force::FrictionCones>(
+                    _contacts, wrenches, *_model, friction_cones);
+
+        Eigen::VectorXd wrench_limits = Eigen::VectorXd::Constant(6*_contacts.size(), 300.);
+        auto limits = std::make_shared<OpenSoT::constraints::force::WrenchLimits>(
+                    "wrench_limits", -wrench_limits, wrench_limits, all_wrenches);
+
+        _stack = (_com / min_wrenches) << friction << limits;
+    }
+
+    void reset() override
+    {
+
+    }
+
+    void preTick(const unsigned int tick) override
+    {
+        const double t = tick * _dt;
+        Eigen::Vector3d com_ref = _com0;
+        com_ref[1] += 0.02 * std::sin(M_PI * t);
+        _com->setLinearReference(com_ref);
+    }
+
+    void postTick(const Eigen::VectorXd& x) override
+    {
+
+    }
+
+private:
+    XBot::ModelInterface::Ptr _model;
+    double _dt;
+    std::vector<std::string> _contacts;
+    OpenSoT::tasks::force::CoM::Ptr _com;
+    Eigen::Vector3d _com0;
+};
+
+const bool registered = [](){
+    registerProblem("ForceDistribution/coman", [](){return std::make_shared<ForceDistributionProblem>();});
+    return true;
+}();
+
+}
@@ -0,0 +1,136 @@
+#include "BenchmarkCommon.h"
+#include <OpenSoT/utils/InverseDynamics.h>
+#include <OpenSoT/tasks/acceleration/Cartesian.h>
+#include <OpenSoT/tasks/acceleration/CoM.h>
+#include <OpenSoT/tasks/acceleration/Postural.h>
+#include <OpenSoT/tasks/acceleration/DynamicFeasibility.h>
+#include <OpenSoT/constraints/acceleration/JointLimits.h>
+#include <OpenSoT/constraints/acceleration/VelocityLimits.h>
+#include <OpenSoT/constraints/force/FrictionCone.h>
+#include <cmath>
+
+using namespace OpenSoT::benchmarks;
+
+namespace {
+
+/**
+ * @brief The IDProblem class is a whole-body inverse dynamics of coman (floating base) standing on both feet:
+ * the CoM tracks a circle while the hands are kept in place, the optimization variables are the joint
+ * accelerations and the contact wrenches:
+ *
+ *      (sum of contacts) / (CoM + hands) / Postural << DynamicFeasibility << FrictionCones << JointLimits << VelocityLimits
+ */
+class IDProblem : public Problem {
+public:
+    IDProblem():
+        _model(getModel("coman_floating_base")),
+        _dt(0.001),
+        _contacts({"l_sole", "r_sole"})
+    {
+        _q0 = _model->getNeutralQ();
+        _q0[_model->getQIndex("RHipSag")] = -25.0*M_PI/180.0;
+        _q0[_model->getQIndex("RKneeSag")] = 50.0*M_PI/180.0;
+        _q0[_model->getQIndex("RAnkSag")] = -25.0*M_PI/180.0;
+        _q0[_model->getQIndex("LHipSag")] = -25.0*M_PI/180.0;
+        _q0[_model->getQIndex("LKneeSag")] = 50.0*M_PI/180.0;
+        _q0[_model->getQIndex("LAnkSag")] = -25.0*M_PI/180.0;
+        _q0[_model->getQIndex("LShSag")] =  20.0*M_PI/180.0;
+        _q0[_model->getQIndex("LElbj")] = -80.0*M_PI/180.0;
+        _q0[_model->getQIndex("RShSag")] =  20.0*M_PI/180.0;
+        _q0[_model->getQIndex("RElbj")] = -80.0*M_PI/180.0;
+
+        // the world frame is placed under the left foot
+        _model->setJointPosition(_q0);
+        _model->update();
+        Eigen::Affine3d l_sole_T_Waist;
+        _model->getPose("Waist", "l_sole", l_sole_T_Waist);
+        l_sole_T_Waist.translation()[0] = 0.;
+        l_sole_T_Waist.translation()[1] = 0.;
+        _model->setFloatingBasePose(l_sole_T_Waist);
+        _model->update();
+        _model->getJointPosition(_q0);
+        _dq0.setZero(_model->getNv());
+        _ddq.setZero(_model->getNv());
+        reset();
+
+        _id = std::make_shared<OpenSoT::utils::InverseDynamics>(_contacts, *_model);
+        const OpenSoT::AffineHelper& qddot = _id->getJointsAccelerationAffine();
+        const std::vector<OpenSoT::AffineHelper>& wrenches = _id->getContactsWrenchAffine();
+
+        using namespace OpenSoT::tasks::acceleration;
+        OpenSoT::tasks::Aggregated::TaskPtr contacts;
+        OpenSoT::constraints::force::FrictionCones::friction_cones friction_cones;
+        for(const std::string& contact : _contacts)
+        {
+            auto contact_task = std::make_shared<Cartesian>(contact + "_kin", *_model, contact, "world", qddot);
+            contacts = contacts ? OpenSoT::tasks::Aggregated::TaskPtr(contacts + contact_task) : contact_task;
+
+            Eigen::Affine3d T;
+            _model->getPose(contact, T);
+            friction_cones.push_back(std::make_pair(T.linear(), 0.8));
+        }
+
+        _com = std::make_shared<CoM>(*_model, qddot);
+        _com->getReference(_com0);
+        auto l_arm = std::make_shared<Cartesian>("l_arm", *_model, "LSoftHand", "world", qddot);
+        auto r_arm = std::make_shared<Cartesian>("r_arm", *_model, "RSoftHand", "world", qddot);
+        auto postural = std::make_shared<Postural>(*_model, qddot);
+
+        Eigen::VectorXd qmin, qmax, dqmax;
+        _model->getJointLimits(qmin, qmax);
+        _model->getVelocityLimits(dqmax);
+
+        auto dynamics = std::make_shared<DynamicFeasibility>("dynamics", *_model, qddot, wrenches, _contacts);
+        auto friction = std::make_shared<OpenSoT::constraints::force::FrictionCones>(
+                    _contacts, wrenches, *_model, friction_cones);
+        auto joint_limits = std::make_shared<OpenSoT::constraints::acceleration::JointLimits>(
+                    *_model, qddot, qmax, qmin, 10.*dqmax, _dt);
+        auto velocity_limits = std::make_shared<OpenSoT::constraints::acceleration::VelocityLimits>(
+                    *_model, qddot, dqmax, _dt);
+
+        _stack = (contacts / (_com + l_arm + r_arm) / postural) << dynamics << friction
+                << joint_limits << velocity_limits;
+    }
+
+    void reset() override
+    {
+        _q = _q0;
+        _dq = _dq0;
+    }
+
+    void preTick(const unsigned int tick) override
+    {
+        _model->setJointPosition(_q);
+        _model->setJointVelocity(_dq);
+        _model->update();
+
+        const double t = tick * _dt;
+        Eigen::Vector3d com_ref = _com0;
+        com_ref[1] += 0.02 * std::sin(M_PI * t);
+        com_ref[2] += 0.02 * (std::cos(M_PI * t) - 1.);
+        _com->setReference(com_ref);
+    }
+
+    void postTick(const Eigen::VectorXd& x) override
+    {
+        _id->getJointsAccelerationAffine().getValue(x, _ddq);
+        _q = _model->sum(_q, _dq*_dt + 0.5*_ddq*_dt*_dt);
+        _dq += _ddq*_dt;
+    }
+
+private:
+    XBot::ModelInterface::Ptr _model;
+    double _dt;
+    std::vector<std::string> _contacts;
+    OpenSoT::utils::InverseDynamics::Ptr _id;
+    OpenSoT::tasks::acceleration::CoM::Ptr _com;
+    Eigen::Vector3d _com0;
+    Eigen::VectorXd _q0, _dq0, _q, _dq, _ddq;
+};
+
+const bool registered = [](){
+    registerProblem("ID/coman", [](){return std::make_shared<IDProblem>();});
+    return true;
+}();
+
+}
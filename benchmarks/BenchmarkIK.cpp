@@ -0,0 +1,106 @@
+#include "BenchmarkCommon.h"
+#include <OpenSoT/tasks/velocity/Cartesian.h>
+#include <OpenSoT/tasks/velocity/Postural.h>
+#include <OpenSoT/constraints/velocity/JointLimits.h>
+#include <OpenSoT/constraints/velocity/VelocityLimits.h>
+#include <cmath>
+
+using namespace OpenSoT::benchmarks;
+
+namespace {
+
+/**
+ * @brief The IKProblem class is a velocity IK: the end-effectors track a circle in the world frame while the
+ * postural is kept at the initial configuration, with joint position and velocity limits:
+ *
+ *      (sum of Cartesian)/Postural << JointLimits << VelocityLimits
+ */
+class IKProblem : public Problem {
+public:
+    IKProblem(const std::string& robot, const std::vector<std::string>& end_effectors):
+        _model(getModel(robot)),
+        _dT(0.01)
+    {
+        Eigen::VectorXd qmin, qmax, dqmax;
+        _model->getJointLimits(qmin, qmax);
+        _model->getVelocityLimits(dqmax);
+
+        _q0 = 0.5 * (qmin + qmax);
+        _q = _q0;
+        _model->setJointPosition(_q);
+        _model->update();
+
+        OpenSoT::tasks::Aggregated::TaskPtr cartesians;
+        for(const std::string& end_effector : end_effectors)
+        {
+            auto cartesian = std::make_shared<OpenSoT::tasks::velocity::Cartesian>(
+                        end_effector, *_model, end_effector, "world");
+            cartesian->setLambda(0.1);
+            _cartesians.push_back(cartesian);
+
+            Eigen::Affine3d T;
+            _model->getPose(end_effector, T);
+            _initial_poses.push_back(T);
+
+            if(cartesians)
+                cartesians = cartesians + cartesian;
+            else
+                cartesians = cartesian;
+        }
+
+        auto postural = std::make_shared<OpenSoT::tasks::velocity::Postural>(*_model);
+        postural->setReference(_q0);
+        postural->setLambda(0.01);
+
+        auto joint_limits = std::make_shared<OpenSoT::constraints::velocity::JointLimits>(*_model, qmax, qmin);
+        auto velocity_limits = std::make_shared<OpenSoT::constraints::velocity::VelocityLimits>(*_model, dqmax, _dT);
+
+        _stack = (cartesians / postural) << joint_limits << velocity_limits;
+    }
+
+    void reset() override
+    {
+        _q = _q0;
+    }
+
+    void preTick(const unsigned int tick) override
+    {
+        _model->setJointPosition(_q);
+        _model->update();
+
+        const double t = tick * _dT;
+        for(unsigned int i = 0; i < _cartesians.size(); ++i)
+        {
+            Eigen::Affine3d T = _initial_poses[i];
+            T.translation()[1] += 0.05 * std::sin(M_PI * t);
+            T.translation()[2] += 0.05 * (std::cos(M_PI * t) - 1.);
+            _cartesians[i]->setReference(T);
+        }
+    }
+
+    void postTick(const Eigen::VectorXd& x) override
+    {
+        _q += x;
+    }
+
+private:
+    XBot::ModelInterface::Ptr _model;
+    double _dT;
+    Eigen::VectorXd _q0, _q;
+    std::vector<OpenSoT::tasks::velocity::Cartesian::Ptr> _cartesians;
+    std::vector<Eigen::Affine3d> _initial_poses;
+};
+
+const bool registered = [](){
+    registerProblem("IK/panda", [](){
+        return std::make_shared<IKProblem>("panda", std::vector<std::string>{"panda_link8"});});
+    registerProblem("IK/coman", [](){
+        return std::make_shared<IKProblem>("coman", std::vector<std::string>{"l_wrist", "r_wrist"});});
+    registerProblem("IK/bigman", [](){
+        return std::make_shared<IKProblem>("bigman", std::vector<std::string>{"l_wrist", "r_wrist"});});
+    registerProblem("IK/huboplus", [](){
+        return std::make_shared<IKProblem>("huboplus", std::vector<std::string>{"Body_LWP", "Body_RWP"});});
+    return true;
+}();
+
+}
@@ -41,6 +41,8 @@ void pySolver(py::module& m, const std::string& className) {
             .value("ODYS", OpenSoT::solvers::solver_back_ends::ODYS)
             .value("qpSWIFT", OpenSoT::solvers::solver_back_ends::qpSWIFT)
             .value("proxQP", OpenSoT::solvers::solver_back_ends::proxQP)
+            .value("proxQPSparse", OpenSoT::solvers::solver_back_ends::proxQPSparse)
+            .value("Auto", OpenSoT::solvers::solver_back_ends::Auto)
             .export_values();
 
 
@@ -113,12 +113,12 @@ inline Scalar distance(Scalar a, Scalar b)
 
 inline void compute_d(VectorXd &d, const MatrixXd& J, const VectorXd& np)
 {
-  d = J.adjoint() * np;
+  d.noalias() = J.adjoint() * np;
 }
 
 inline void update_z(VectorXd& z, const MatrixXd& J, const VectorXd& d,  int iq)
 {
-  z = J.rightCols(z.size()-iq) * d.tail(d.size()-iq);
+  z.noalias() = J.rightCols(z.size()-iq) * d.tail(d.size()-iq);
 }
 
 inline void update_r(const MatrixXd& R, VectorXd& r, const VectorXd& d, int iq) 
@@ -129,12 +129,38 @@ inline void update_r(const MatrixXd& R, VectorXd& r, const VectorXd& d, int iq)
 bool add_constraint(MatrixXd& R, MatrixXd& J, VectorXd& d, int& iq, double& R_norm);
 void delete_constraint(MatrixXd& R, MatrixXd& J, VectorXi& A, VectorXd& u,  int p, int& iq, int l);
 
+/* QuadProgWorkspace holds the Cholesky decomposition of G and the working memory of the solver:
+   when the same workspace is used to solve problems of the same size no memory is allocated */
+struct QuadProgWorkspace
+{
+  LLT<MatrixXd,Lower> chol;
+  MatrixXd R, J;
+  VectorXd s, z, r, d, np, u, x_old, u_old;
+  VectorXi A, A_old, iai, iaexcl;
+
+  /* resize the working memory for n variables, p equality and m inequality constraints,
+     nothing is allocated if the sizes did not change */
+  inline void resize(int n, int p, int m)
+  {
+    R.resize(n, n); J.resize(n, n);
+    s.resize(m + p); z.resize(n); r.resize(m + p); d.resize(n); np.resize(n); u.resize(m + p);
+    x_old.resize(n); u_old.resize(m + p);
+    A.resize(m + p); A_old.resize(m + p); iai.resize(m + p); iaexcl.resize(m + p);
+  }
+};
+
 /* solve_quadprog2 is used when the Cholesky decomposition of the G matrix is precomputed */
 double solve_quadprog2(LLT<MatrixXd,Lower> &chol,  double c1, VectorXd & g0,  
                       const MatrixXd & CE, const VectorXd & ce0,  
                       const MatrixXd & CI, const VectorXd & ci0, 
                       VectorXd& x);
 
+/* solve_quadprog2 using the working memory of ws (ws.chol is not used) */
+double solve_quadprog2(const LLT<MatrixXd,Lower> &chol,  double c1, const VectorXd & g0,
+                      const MatrixXd & CE, const VectorXd & ce0,
+                      const MatrixXd & CI, const VectorXd & ci0,
+                      VectorXd& x, QuadProgWorkspace& ws);
+
 /* solve_quadprog is used for on-demand QP solving */
 inline double solve_quadprog(MatrixXd & G,  VectorXd & g0,  
                       const MatrixXd & CE, const VectorXd & ce0,  
@@ -154,27 +180,53 @@ inline double solve_quadprog(MatrixXd & G,  VectorXd & g0,
 
 }
 
+/* solve_quadprog using the Cholesky decomposition and the working memory of ws, to be used for
+   sequences of problems of the same size */
+inline double solve_quadprog(const MatrixXd & G,  const VectorXd & g0,
+                      const MatrixXd & CE, const VectorXd & ce0,
+                      const MatrixXd & CI, const VectorXd & ci0,
+                      VectorXd& x, QuadProgWorkspace& ws){
+
+  /* compute the trace of the original matrix G */
+  double c1 = G.trace();
+
+  /* decompose the matrix G in the form LL^T */
+  ws.chol.compute(G);
+
+  return solve_quadprog2(ws.chol, c1, g0, CE, ce0, CI, ci0, x, ws);
+}
+
 /* solve_quadprog2 is used for when the Cholesky decomposition of G is pre-computed */
 inline double solve_quadprog2(LLT<MatrixXd,Lower> &chol,  double c1, VectorXd & g0,  
                       const MatrixXd & CE, const VectorXd & ce0,  
                       const MatrixXd & CI, const VectorXd & ci0, 
                       VectorXd& x)
+{
+  QuadProgWorkspace ws;
+  return solve_quadprog2(chol, c1, g0, CE, ce0, CI, ci0, x, ws);
+}
+
+inline double solve_quadprog2(const LLT<MatrixXd,Lower> &chol,  double c1, const VectorXd & g0,
+                      const MatrixXd & CE, const VectorXd & ce0,
+                      const MatrixXd & CI, const VectorXd & ci0,
+                      VectorXd& x, QuadProgWorkspace& ws)
 {
   int i, j, k, l; /* indices */
   int ip, me, mi;
   int n=g0.size();   
   int p=CE.cols(); 
   int m=CI.cols();
-  MatrixXd R(g0.size(),g0.size()), J(g0.size(),g0.size());
+  ws.resize(n, p, m);
+  MatrixXd &R = ws.R, &J = ws.J;
   
  
-  VectorXd s(m+p), z(n), r(m + p), d(n),  np(n), u(m + p);
-  VectorXd x_old(n), u_old(m + p);
+  VectorXd &s = ws.s, &z = ws.z, &r = ws.r, &d = ws.d, &np = ws.np, &u = ws.u;
+  VectorXd &x_old = ws.x_old, &u_old = ws.u_old;
   double f_value, psi, c2, sum, ss, R_norm;
   const double inf = std::numeric_limits<double>::infinity();
   double t, t1, t2; /* t is the step length, which is the minimum of the partial step length t1 
     * and the full step length t2 */
-  VectorXi A(m + p), A_old(m + p), iai(m + p), iaexcl(m+p);
+  VectorXi &A = ws.A, &A_old = ws.A_old, &iai = ws.iai, &iaexcl = ws.iaexcl;
   int q;
   int iq, iter = 0;
  	
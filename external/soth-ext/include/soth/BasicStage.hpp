@@ -34,6 +34,10 @@ class SOTH_API BasicStage : boost::noncopyable {
   const MatrixXdRef& J;
   const VectorBoundRef& bounds;
   const Index nr, nc;  // nr=nbCols(J), nc=nbRows(J).
+  /* The first nbBoundRows constraints are simple bounds on the first
+   * variables (constraint i is e_i'.u): they are handled by index and are not
+   * stored in J, which only holds the nr-nbBoundRows other rows. */
+  Index nbBoundRows;
   const BaseY& Y;
 
  public:
@@ -54,7 +58,16 @@ class SOTH_API BasicStage : boost::noncopyable {
 
   Index nbConstraints(void) const { return nr; }
 
-  /* Return the J row of the <cst> constraint (in the global ppol,
+  /* Declare the first <nb> constraints as simple bounds on the first <nb>
+   * variables. Their activation and check only need the index of the
+   * variable; from now on the data of J only holds the nr-nb other rows. */
+  void setBoundRows(const Index nb);
+  Index nbBounds(void) const { return nbBoundRows; }
+  inline bool isBoundRow(const Index& cst) const { return cst < nbBoundRows; }
+  /* Row of J storing the (not bound) constraint <cst>. */
+  inline Index Jrow(const Index& cst) const { return cst - nbBoundRows; }
+
+  /* Return the J row of the <cst> constraint (in the global pool,
    * not only in the active pool. */
   VectorXd getJrow(const Index& cst) const;
   /* Return the bound-values of constraint <cst>.*/
@@ -47,6 +47,8 @@ class SOTH_API HCOD {
   Index sizeA() const;
   int rank() const;
   Index nbStages() const { return (Index)stages.size(); }
+  /* Number of iterations of the last active search. */
+  int getNbIterations() const { return nbIterations; }
 
   /* --- Decomposition --- */
  public:
@@ -108,6 +110,7 @@ class SOTH_API HCOD {
 
   VectorXd uNext, Ytu, YtuNext, rho;
   int freezedStages;
+  int nbIterations;
   bool isReset, isInit, isSolutionCpt, withDamp;
 };
 
@@ -2,6 +2,7 @@
 #define _HCOD_WRAPPER_
 
 #include <memory>
+#include <vector>
 #include "visibility.h"
 
 
@@ -9,6 +10,7 @@ namespace soth{
 
 class HCOD;
 class Bound;
+struct ConstraintRef;
 
 class SOTH_API HCOD_wrapper{
 public:
@@ -23,6 +25,30 @@ public:
 
     bool updateStage(const unsigned int i, const double* Jdata, const Bound* bdata);
 
+    /**
+     * The first nb constraints of the i-th stage are simple bounds on the first nb variables,
+     * which are activated and checked by index: from now on the J data of the stage (see
+     * updateStage()) only holds the other rows.
+     */
+    bool setStageBoundRows(const unsigned int i, const unsigned int nb);
+
+    /**
+     * Number of iterations of the last active search.
+     */
+    unsigned int getIterations() const;
+
+    /**
+     * Active set of the last active search (equality rows are not reported), it is used as
+     * initial guess by the next active search unless setInitialActiveSet() is called.
+     */
+    void getActiveSet(std::vector<std::vector<ConstraintRef> >& active_set) const;
+
+    /**
+     * Set the initial guess of the active set for the next active search (equality rows are
+     * always added), returns false if the number of stages is wrong.
+     */
+    bool setActiveSet(const std::vector<std::vector<ConstraintRef> >& active_set);
+
 
 
 private:
@@ -1,5 +1,7 @@
+#ifndef NDEBUG
 #define SOTH_DEBUG
 #define SOTH_DEBUG_MODE 15
+#endif
 #include "../include/soth/BasicStage.hpp"
 #include "../include/soth/debug.hpp"
 
@@ -29,7 +31,8 @@ BasicStage::BasicStage(const Index innr, const Index innc, const double* Jdata,
       J(Jmap),
       bounds(boundsMap),
       nr(innr),
-      nc(innc)
+      nc(innc),
+      nbBoundRows(0)
 
       ,
       Y(Y) {}
@@ -44,7 +47,8 @@ BasicStage::BasicStage(const Index innr, const Index innc, const double* Jdata,
       J(Jmap),
       bounds(boundsMap),
       nr(innr),
-      nc(innc)
+      nc(innc),
+      nbBoundRows(0)
 
       ,
       Y(Y) {}
@@ -59,7 +63,8 @@ BasicStage::BasicStage(const MatrixXd& inJ, const VectorBound& inbounds,
       J(Jmap),
       bounds(boundsMap),
       nr((Index)inJ.rows()),
-      nc((Index)inJ.cols())
+      nc((Index)inJ.cols()),
+      nbBoundRows(0)
 
       ,
       Y(inY) {
@@ -67,14 +72,14 @@ BasicStage::BasicStage(const MatrixXd& inJ, const VectorBound& inbounds,
 }
 
 void BasicStage::set(const MatrixXd& inJ, const VectorBound& inbounds) {
-  assert(inJ.rows() == (int)nr && inJ.cols() == (int)nc);
+  assert(inJ.rows() == (int)(nr - nbBoundRows) && inJ.cols() == (int)nc);
   assert(inbounds.size() == (int)nr);
   sotDEBUG(15) << "inJ = " << (MATLAB)inJ << std::endl;
   set(inJ.data(), inbounds.data());
 }
 
 void BasicStage::set(const double* Jdata, const Bound* bdata) {
-  new (&Jmap) MapXd(Jdata, nr, nc);
+  new (&Jmap) MapXd(Jdata, nr - nbBoundRows, nc);
   new (&boundsMap) MapBound(bdata, nr);
 
   sotDEBUG(15) << "map = " << (MATLAB)Jmap << std::endl;
@@ -82,7 +87,12 @@ void BasicStage::set(const double* Jdata, const Bound* bdata) {
   sotDEBUG(15) << (&Jmap) << "=?=" << (&J) << std::endl;
 }
 
-MatrixXd BasicStage::getJ(void) const { return J; }
+MatrixXd BasicStage::getJ(void) const {
+  MatrixXd res(nr, nc);
+  res.topRows(nbBoundRows) = MatrixXd::Identity(nbBoundRows, nc);
+  res.bottomRows(nr - nbBoundRows) = J;
+  return res;
+}
 
 VectorBound BasicStage::getBounds(void) const { return bounds; }
 
@@ -91,7 +101,16 @@ VectorBound& BasicStage::getBoundsInternal() {
   return boundsInternal;
 }
 
-VectorXd BasicStage::getJrow(const Index& cst) const { return J.row(cst); }
+void BasicStage::setBoundRows(const Index nb) {
+  assert(nb >= 0 && nb <= nr && nb <= nc);
+  nbBoundRows = nb;
+  new (&Jmap) MapXd(Jmap.data(), nr - nbBoundRows, nc);
+}
+
+VectorXd BasicStage::getJrow(const Index& cst) const {
+  if (isBoundRow(cst)) return VectorXd::Unit(nc, cst);
+  return J.row(Jrow(cst));
+}
 
 Bound BasicStage::getBoundRow(const Index& cst) const { return bounds[cst]; }
 
@@ -1,5 +1,7 @@
+#ifndef NDEBUG
 #define SOTH_DEBUG
 #define SOTH_DEBUG_MODE 15
+#endif
 #include "../include/soth/debug.hpp"
 //#include "soth/COD.hpp"  // DEBUG
 #include <sys/time.h>
@@ -18,6 +20,7 @@ HCOD::HCOD(Index inSizeProblem, Index nbStage)
       YtuNext(sizeProblem),
       rho(sizeProblem),
       freezedStages(0),
+      nbIterations(0),
       isReset(false),
       isInit(false),
       isSolutionCpt(false),
@@ -449,9 +452,11 @@ void HCOD::activeSearch(VectorXd& u) {
   time1 = ((t1.tv_sec-t0.tv_sec)+(t1.tv_usec-t0.tv_usec)/1.0e6);*/
 
   int iter = 0;
+  nbIterations = 0;
   Index stageMinimal = 0;
   do {
     iter++;
+    nbIterations = iter;
     sotDEBUG(5) << " --- *** \t" << iter << "\t***.---" << std::endl;
     // if( iter>1 ) { break; }
 
@@ -49,6 +49,39 @@ bool HCOD_wrapper::updateStage(const unsigned int i, const double* Jdata, const
     return true;
 }
 
+bool HCOD_wrapper::setStageBoundRows(const unsigned int i, const unsigned int nb)
+{
+    if(i >= _hcod->stages.size())
+        return false;
+
+    if(nb > _hcod->stages[i]->nbConstraints() || nb > _problem_size)
+        return false;
+
+    _hcod->stages[i]->setBoundRows(nb);
+
+    return true;
+}
+
+unsigned int HCOD_wrapper::getIterations() const
+{
+    return _hcod->getNbIterations();
+}
+
+void HCOD_wrapper::getActiveSet(std::vector<std::vector<ConstraintRef> >& active_set) const
+{
+    active_set = _hcod->getOptimalActiveSet();
+}
+
+bool HCOD_wrapper::setActiveSet(const std::vector<std::vector<ConstraintRef> >& active_set)
+{
+    if(active_set.size() != _hcod->stages.size())
+        return false;
+
+    _hcod->setInitialActiveSet(active_set);
+
+    return true;
+}
+
 HCOD_wrapper::~HCOD_wrapper()
 {
 
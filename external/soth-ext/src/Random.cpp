@@ -1,5 +1,7 @@
+#ifndef NDEBUG
 #define SOTH_DEBUG
 #define SOTH_DEBUG_MODE 45
+#endif
 #include "../include/soth/debug.hpp"
 
 #include <cstdlib>
@@ -1,5 +1,7 @@
+#ifndef NDEBUG
 #define SOTH_DEBUG
 #define SOTH_DEBUG_MODE 45
+#endif
 #include "../include/soth/debug.hpp"
 
 #include "../external/Eigen/LU"
@@ -145,9 +147,19 @@ void Stage::computeInitialJY(void) {
   Matrix<Index, Dynamic, 1> activeCst = activeSet;
 
   Block<MatrixXd> ML = ML_.topRows(sizeA());
-  // DEBUG: const cast!! because SubMatrix does not support const&.
-  ML = SubMatrix<MatrixXdRef, RowPermutation>(const_cast<MatrixXdRef&>(J),
-                                              &activeCst);
+  if (nbBoundRows == 0) {
+    // DEBUG: const cast!! because SubMatrix does not support const&.
+    ML = SubMatrix<MatrixXdRef, RowPermutation>(const_cast<MatrixXdRef&>(J),
+                                                &activeCst);
+  } else {
+    for (Index r = 0; r < sizeA(); ++r) {
+      if (isBoundRow(activeCst[r])) {
+        ML.row(r).setZero();
+        ML(r, activeCst[r]) = 1;
+      } else
+        ML.row(r) = J.row(Jrow(activeCst[r]));
+    }
+  }
   sotDEBUG(15) << "Ja = " << (MATLAB)ML << std::endl;
 
   freeML.resetTop(sizeA());
@@ -690,8 +702,19 @@ MatrixXd::Index Stage::update(const ConstraintRef& cst, GivensSequence& Yup) {
 
   /* Add a line to ML. */
   RowML JupY = ML_.row(wcolup);
-  JupY = sign * J.row(cst.row);
-  Y.applyThisOnTheLeft(JupY);
+  if (isBoundRow(cst.row)) {
+    /* e_i'.Y is the i-th row of Y. */
+    if (Y.isExplicit)
+      JupY = sign * Y.matrixExplicit.row(cst.row);
+    else {
+      JupY.setZero();
+      JupY[cst.row] = sign;
+      Y.applyThisOnTheLeft(JupY);
+    }
+  } else {
+    JupY = sign * J.row(Jrow(cst.row));
+    Y.applyThisOnTheLeft(JupY);
+  }
   sotDEBUG(5) << "JupY = " << (MATLAB)JupY << endl;
   sotDEBUG(5) << "JupY = " << JupY << endl;
 
@@ -1244,8 +1267,14 @@ bool Stage::checkBound(const VectorXd& u0, const VectorXd& u1,
     assert(bounds[i].getType() != Bound::BOUND_TWIN);
 
     /* This has already been computed and could be avoided... TODO. */
-    double val0 = J.row(i) * u0;
-    double val1 = J.row(i) * u1;
+    double val0, val1;
+    if (isBoundRow(i)) {
+      val0 = u0[i];
+      val1 = u1[i];
+    } else {
+      val0 = J.row(Jrow(i)) * u0;
+      val1 = J.row(Jrow(i)) * u1;
+    }
     const Bound& b = bounds[i];
     sotDEBUG(5) << "bound = " << b << endl;
     sotDEBUG(5) << "Ju0=" << val0 << "  --  Ju1=" << val1
@@ -1498,7 +1527,10 @@ SubMatrix<MatrixXd, RowPermutation> Stage::Jactive(MatrixXd& J_) const {
   for (Index cst = 0; cst < nr; ++cst) {
     if (activeSet.isActive(cst)) {
       const Index row = activeSet.map(cst);
-      J_.row(Iw(row)) = activeSet.sign(cst) * J.row(cst);
+      if (isBoundRow(cst))
+        J_.row(Iw(row)) = activeSet.sign(cst) * VectorXd::Unit(nc, cst).transpose();
+      else
+        J_.row(Iw(row)) = activeSet.sign(cst) * J.row(Jrow(cst));
     }
   }
 
@@ -20,8 +20,10 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 #include <matlogger2/matlogger2.h>
 #include <xbot2_interface/logger.h>
+#include <xbot2_interface/xbotinterface2.h>
 
 #include <OpenSoT/version.h>
 
@@ -108,10 +110,24 @@
 
         }
 
+        /**
+         * @brief increaseVersion has to be called by derived classes each time the bounds, Aeq, beq, Aineq,
+         * bLowerBound or bUpperBound are written, in update() and in the setters
+         */
+        void increaseVersion() { ++_version; _versioned = true; }
+
+    private:
+        /**
+         * @brief _version counter incremented each time the constraint changes, _versioned is false until
+         * increaseVersion() is called for the first time
+         */
+        mutable unsigned int _version;
+        bool _versioned;
+
     public:
         Constraint(const std::string constraint_id,
                    const unsigned int x_size) :
-            _constraint_id(constraint_id), _x_size(x_size) {}
+            _constraint_id(constraint_id), _x_size(x_size), _version(0), _versioned(false) {}
         virtual ~Constraint() {}
 
         const unsigned int getXSize() { return _x_size; }
@@ -180,6 +196,28 @@
         /** Updates the A, b, Aeq, beq, Aineq, b*Bound matrices */
         virtual void update() {}
 
+        /**
+         * @brief getVersion returns a counter which is incremented each time the bounds, Aeq, beq, Aineq,
+         * bLowerBound or bUpperBound of the constraint are written. Consumers (aggregates, solvers) can store the
+         * version and skip copying or factorising the constraint if it did not change.
+         * NOTE: derived classes which never call increaseVersion() (e.g. written before the versions were
+         * introduced) are reported as changed at each call, so that their consumers never use stale data
+         * @return the version of the constraint
+         */
+        unsigned int getVersion() const
+        {
+            if(!_versioned)
+                ++_version;
+            return _version;
+        }
+
+        /**
+         * @brief getModels appends the models read by update() (none by default): constraints reading from the
+         * same model can not be updated concurrently, see constraints::Aggregated::setThreadPool()
+         * @param models
+         */
+        virtual void getModels(std::vector<const XBot::ModelInterface*>& models) const {}
+
         /**
          * @brief log logs common Constraint internal variables
          * @param logger a shared pointer to a MathLogger
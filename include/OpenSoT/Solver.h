@@ -20,6 +20,7 @@
 
 #include <OpenSoT/Task.h>
 #include <OpenSoT/Constraint.h>
+#include <OpenSoT/utils/SolverStatistics.h>
 #include <list>
 
 using namespace std;
@@ -42,6 +43,11 @@ using namespace std;
         ConstraintPtr _globalConstraints;
         std::string _solver_id;
 
+        /**
+         * @brief _statistics if set, the solver records its timings
+         */
+        utils::SolverStatistics::Ptr _statistics;
+
         /**
          * @brief _log implement this on the solver to log data
          * @param logger a pointer to a MatLogger
@@ -101,6 +107,26 @@ using namespace std;
            _solver_id = solver_id;
        }
 
+        /**
+         * @brief setStatistics enables the recording of the timings of the solver: at each call of solve() the solver fills
+         * the current record of the statistics and commits it. The same statistics can be shared with the AutoStack
+         * to record the update time in the same record.
+         * NOTE: the front-ends which solve the whole hierarchy as a single problem (l1HQP, wHQP, HCOD) record it in the
+         * first level, eHQP has no back-end and records the decomposition of each level as back-end time.
+         * @param statistics a pointer to a SolverStatistics, nullptr to disable the recording
+         */
+        void setStatistics(utils::SolverStatistics::Ptr statistics){
+            _statistics = statistics;
+        }
+
+        /**
+         * @brief getStatistics
+         * @return the pointer to the statistics used by the solver (nullptr if not set)
+         */
+        utils::SolverStatistics::Ptr getStatistics(){
+            return _statistics;
+        }
+
         /**
          * @brief log logs data related to the solver
          * @param logger a pointer to a MatLogger
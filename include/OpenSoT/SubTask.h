@@ -47,6 +47,8 @@
 
         typedef std::shared_ptr<OpenSoT::SubTask> Ptr;
 
+        void getModels(std::vector<const XBot::ModelInterface*>& models) const override { _taskPtr->getModels(models); }
+
     protected:
         TaskPtr _taskPtr;
         Indices _subTaskMap;
@@ -158,6 +158,12 @@
             return false;
         }
 
+        /**
+         * @brief increaseVersion has to be called by derived classes each time A, b, W or c are written outside
+         * of _update(), e.g. in setters (update() already increases the version)
+         */
+        void increaseVersion() { ++_version; }
+
     private:
 
         /**
@@ -187,6 +193,11 @@
          */
         Matrix_type _A_last_active;
 
+        /**
+         * @brief _version counter incremented each time the task changes
+         */
+        unsigned int _version;
+
     public:
         /**
          * @brief Task define a task in terms of Ax = b
@@ -195,7 +206,7 @@
          */
         Task(const std::string task_id,
              const unsigned int x_size) :
-            _task_id(task_id), _x_size(x_size), _active_joints_mask(x_size), _is_active(true), _weight_is_diagonal(false)
+            _task_id(task_id), _x_size(x_size), _active_joints_mask(x_size), _is_active(true), _weight_is_diagonal(false), _version(0)
         {
             //Eigen:
             _A.setZero(0,x_size);
@@ -233,6 +244,7 @@
             
             if(!_is_active && active_flag && _A_last_active.rows() > 0){
                 _A = _A_last_active;
+                increaseVersion();
             }
             
             _is_active = active_flag;
@@ -307,6 +319,21 @@
             return _c;
         }
 
+        /**
+         * @brief getVersion returns a counter which is incremented each time A, b, W or c of the task are written,
+         * i.e. at each update() and in the setters. Consumers (aggregates, solvers) can store the version and
+         * skip copying or factorising the task if it did not change.
+         * @return the version of the task
+         */
+        unsigned int getVersion() const { return _version; }
+
+        /**
+         * @brief getModels appends the models read by update() (none by default): tasks reading from the
+         * same model can not be updated concurrently, see tasks::Aggregated::setThreadPool()
+         * @param models
+         */
+        virtual void getModels(std::vector<const XBot::ModelInterface*>& models) const {}
+
         /**
          * @brief getWeight
          * @return the weight of the norm of the task error
@@ -325,6 +352,7 @@
             assert(W.rows() == this->getTaskSize());
             assert(W.cols() == W.rows());
             _W = W;
+            increaseVersion();
         }
 
         /**
@@ -339,6 +367,7 @@
             assert(w>=0.0);
             _W.setIdentity();
             _W = _W * w;
+            increaseVersion();
         }
 
         /**
@@ -378,6 +407,7 @@
             for(typename std::list< ConstraintPtr >::iterator i = this->getConstraints().begin();
                 i != this->getConstraints().end(); ++i) (*i)->update();
             this->_update();
+            increaseVersion();
             
             if(!_is_active){
                 _A_last_active = _A;
@@ -424,6 +454,7 @@
                 _active_joints_mask = active_joints_mask;
 
                 applyActiveJointsMask(_A);
+                increaseVersion();
 
                 return true;
             }
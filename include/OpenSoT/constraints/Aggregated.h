@@ -22,6 +22,7 @@
 #include <Eigen/Dense>
 #include <memory>
 #include <OpenSoT/utils/Piler.h>
+#include <OpenSoT/utils/ThreadPool.h>
 #include <list>
 
 using namespace OpenSoT::utils;
@@ -90,8 +91,29 @@ using namespace OpenSoT::utils;
             unsigned int _number_of_bounds;
             unsigned int _aggregationPolicy;
 
+            /**
+             * @brief _generated_bounds and _generated_versions store the constraints, and their versions,
+             * used the last time the aggregated constraint has been generated
+             */
+            std::vector< ConstraintPtr > _generated_bounds;
+            std::vector< unsigned int > _generated_versions;
+            bool _is_generated;
+
+            /**
+             * @brief _thread_pool if set, the constraints are updated in parallel
+             */
+            ThreadPool::Ptr _thread_pool;
+            std::vector< ConstraintPtr > _parallel_bounds;
+
             void checkSizes();
 
+            /**
+             * @brief isChanged checks if the list of constraints, or any of the constraints, changed since
+             * the last generation, storing the actual constraints and versions
+             * @return true if the aggregated constraint needs to be generated again
+             */
+            bool isChanged();
+
             static const std::string concatenateConstraintsIds(const std::list<ConstraintPtr> constraints);
 
             static const std::string _CONSTRAINT_PLUS_;
@@ -148,6 +170,23 @@ using namespace OpenSoT::utils;
 
             std::list< ConstraintPtr >& getConstraintsList() { return _bounds; }
 
+            /**
+             * @brief setThreadPool enables the parallel update of the aggregated constraints: the update() of all
+             * the constraints is distributed among the workers of the pool and joined before the constraints are piled.
+             * NOTE: the pool is refused if two constraints read from the same model (see Constraint::getModels())
+             * since the model is not safe to be read concurrently, the check is done here so constraints reading
+             * from a model must not be added to the list after this call
+             * @param thread_pool a pool of workers, nullptr to get back to the serial update
+             * @return false if two constraints share a model, the update stays serial
+             */
+            bool setThreadPool(ThreadPool::Ptr thread_pool);
+
+            void getModels(std::vector<const XBot::ModelInterface*>& models) const override;
+
+            /**
+             * @brief generateAll piles all the constraints, nothing is done if neither the constraints list
+             * nor any of the constraints changed since the last call
+             */
             void generateAll();
         };
     }
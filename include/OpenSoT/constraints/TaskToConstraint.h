@@ -39,6 +39,8 @@
             typedef std::shared_ptr< OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd> > TaskPtr;
             typedef std::shared_ptr< OpenSoT::constraints::TaskToConstraint> Ptr;
 
+            void getModels(std::vector<const XBot::ModelInterface*>& models) const override { _task->getModels(models); }
+
         private:
             
             TaskPtr _task;
@@ -35,6 +35,9 @@
             class JointLimits: public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
             public:
                 typedef std::shared_ptr<JointLimits> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
             private:
                 
                 Eigen::VectorXd _jointLimitsMin;
@@ -34,6 +34,9 @@ namespace OpenSoT {
             class JointLimitsECBF: public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
             public:
                 typedef std::shared_ptr<JointLimitsECBF> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
             private:
 
                 Eigen::VectorXd _jointLimitsMin;
@@ -33,6 +33,9 @@
             class JointLimitsViability: public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
             public:
                 typedef std::shared_ptr<JointLimitsViability> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
             private:
 
                 Eigen::VectorXd _jointLimitsMin;
@@ -18,6 +18,8 @@ class TorqueLimits : public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
 public:
     typedef std::shared_ptr<TorqueLimits> Ptr;
 
+    void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
     /**
      * @brief TorqueLimits
      * @param robot
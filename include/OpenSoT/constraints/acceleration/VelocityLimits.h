@@ -17,6 +17,8 @@ public:
 
     typedef std::shared_ptr<VelocityLimits> Ptr;
 
+    void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
     /**
      * @brief VelocityLimits constructor
      * @param robot model
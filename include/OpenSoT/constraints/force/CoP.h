@@ -35,6 +35,8 @@ namespace OpenSoT {
        public:
            typedef std::shared_ptr<CoP> Ptr;
 
+           void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_model); }
+
         /**
          * @brief CoP constructor of the CoP constraint
          * @param model of the robot
@@ -79,6 +81,8 @@ namespace OpenSoT {
        public:
            typedef std::shared_ptr<CoPs> Ptr;
 
+           void getModels(std::vector<const XBot::ModelInterface*>& models) const override { _internal_constraint->getModels(models); }
+
            CoPs(const std::vector<AffineHelper>& wrench,
                 const std::vector<std::string>& contact_name,
                 XBot::ModelInterface &robot,
@@ -90,6 +94,10 @@ namespace OpenSoT {
 
        private:
            OpenSoT::constraints::Aggregated::Ptr _internal_constraint;
+           /**
+            * @brief _internal_version version of the internal constraint copied in the bounds
+            */
+           unsigned int _internal_version;
            void generateBounds();
 
        };
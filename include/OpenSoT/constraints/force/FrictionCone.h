@@ -38,6 +38,8 @@
             public:
                 typedef std::shared_ptr<FrictionCone> Ptr;
 
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
                 /**
                  * @brief friction_cone is defined by a Rotation matrix (the rotation from world frame to contatc
                  * surface) and friction coefficient
@@ -94,6 +96,8 @@
                 typedef std::vector<FrictionCone::friction_cone> friction_cones;
                 typedef std::shared_ptr<FrictionCones> Ptr;
 
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { _internal_constraint->getModels(models); }
+
                 FrictionCones(const std::vector<std::string>& contact_name,
                              const std::vector<AffineHelper>& wrench,
                              XBot::ModelInterface &robot,
@@ -106,6 +110,10 @@
             private:
                 std::map<std::string, FrictionCone::Ptr> _friction_cone_map;
                 OpenSoT::constraints::Aggregated::Ptr _internal_constraint;
+                /**
+                 * @brief _internal_version version of the internal constraint copied in the bounds
+                 */
+                unsigned int _internal_version;
                 void generateBounds();
             };
     }
@@ -40,6 +40,8 @@ class NormalTorque: public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
 public:
     typedef std::shared_ptr<NormalTorque> Ptr;
 
+    void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_model); }
+
     /**
      * @brief NormalTorque
      * @param contact_link
@@ -101,6 +103,8 @@ class NormalTorques: public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
 public:
     typedef std::shared_ptr<NormalTorques> Ptr;
 
+    void getModels(std::vector<const XBot::ModelInterface*>& models) const override { _internal_constraint->getModels(models); }
+
     NormalTorques(const std::vector<std::string>& contact_name,
                   const std::vector<AffineHelper>& wrench,
                   XBot::ModelInterface &robot,
@@ -115,6 +119,10 @@ public:
 private:
     std::map<std::string, NormalTorque::Ptr> _normal_torque_map;
     OpenSoT::constraints::Aggregated::Ptr _internal_constraint;
+    /**
+     * @brief _internal_version version of the internal constraint copied in the bounds
+     */
+    unsigned int _internal_version;
     void generateBounds();
 };
 
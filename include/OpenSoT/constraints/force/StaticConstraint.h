@@ -16,6 +16,8 @@ namespace OpenSoT { namespace constraints { namespace force {
     {
         
     public:
+        void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
         /**
          * @brief StaticConstraint constructor
          * @param robot model
@@ -140,6 +140,10 @@
             private:
                 std::map<std::string, WrenchLimits::Ptr> _wrench_lims_constraints;
                 OpenSoT::constraints::Aggregated::Ptr _aggregated_constraint;
+                /**
+                 * @brief _internal_version version of the internal constraint copied in the bounds
+                 */
+                unsigned int _internal_version;
                 virtual void generateBounds();
 
             };
@@ -44,6 +44,12 @@
             class CartesianPositionConstraint: public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
             public:
                 typedef std::shared_ptr<CartesianPositionConstraint> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override {
+                    if(_cartesianTask) _cartesianTask->getModels(models);
+                    if(_comTask) _comTask->getModels(models);
+                }
+
             private:
                 OpenSoT::tasks::velocity::Cartesian::Ptr _cartesianTask;
                 OpenSoT::tasks::velocity::CoM::Ptr _comTask;
@@ -32,6 +32,12 @@
             class CartesianVelocity: public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
             public:
                 typedef std::shared_ptr<CartesianVelocity> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override {
+                    if(_cartesian_task) _cartesian_task->getModels(models);
+                    if(_com_task) _com_task->getModels(models);
+                }
+
             private:
                 OpenSoT::tasks::velocity::Cartesian::Ptr _cartesian_task;
                 OpenSoT::tasks::velocity::CoM::Ptr _com_task;
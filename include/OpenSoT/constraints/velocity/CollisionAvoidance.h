@@ -47,6 +47,8 @@ public:
     typedef XBot::Collision::CollisionModel::WitnessPointVector WitnessPointVector;
     typedef XBot::Collision::CollisionModel::LinkPairVector LinkPairVector;
 
+    void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
     /**
      * @brief SelfCollisionAvoidance
      * @param x status
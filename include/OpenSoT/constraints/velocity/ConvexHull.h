@@ -43,6 +43,9 @@
             class ConvexHull: public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
             public:
                 typedef std::shared_ptr<ConvexHull> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
             private:
                 XBot::ModelInterface &_robot;
                 double _boundScaling;
@@ -34,6 +34,9 @@
             class JointLimitsInvariance: public Constraint<Eigen::MatrixXd, Eigen::VectorXd> {
             public:
                 typedef std::shared_ptr<JointLimitsInvariance> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
             private:
 
                 Eigen::VectorXd _jointLimitsMin;
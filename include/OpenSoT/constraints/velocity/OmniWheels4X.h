@@ -34,6 +34,8 @@ namespace OpenSoT {
        public:
            typedef std::shared_ptr<OmniWheels4X> Ptr;
 
+           void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
            /**
             * @brief OmniWheel4X maps base velocities (XY-YAW) into wheels velocities
             *
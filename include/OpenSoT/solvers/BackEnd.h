@@ -5,10 +5,60 @@
 #include <xbot2_interface/logger.h>
 #include <boost/any.hpp>
 #include <OpenSoT/Task.h>
+#include <type_traits>
 
 namespace OpenSoT{
     namespace solvers{
 
+    /**
+     * @brief The BackEndCapabilities struct describes what a back-end can do, it is exported by each back-end plugin
+     * through the get_capabilities() function and used by selectBackEnd() (see BackEndFactory.h)
+     */
+    struct BackEndCapabilities
+    {
+        /**
+         * @brief qp the back-end solves QPs
+         */
+        bool qp = true;
+
+        /**
+         * @brief lp the back-end solves LPs (H = 0)
+         */
+        bool lp = false;
+
+        /**
+         * @brief milp the back-end supports integer and binary variables
+         */
+        bool milp = false;
+
+        /**
+         * @brief hotstart the back-end reuses the solution (active set, basis or iterates) of the previous solve
+         */
+        bool hotstart = false;
+
+        /**
+         * @brief sparse the back-end exploits the sparsity of H and A
+         */
+        bool sparse = false;
+
+        /**
+         * @brief real_time_safe solve() does not allocate memory once the size of the problem is fixed, at the moment
+         * only eiQuadProg (see iHQP::setRealTimeMode())
+         */
+        bool real_time_safe = false;
+
+        /**
+         * @brief positive_definite_hessian the back-end needs a (regularised) positive definite Hessian
+         */
+        bool positive_definite_hessian = false;
+
+        /**
+         * @brief max_recommended_size number of variables plus constraints above which the back-end is not
+         * recommended, 0 if there is no limit
+         */
+        int max_recommended_size = 0;
+    };
+
     class BackEnd{
     public:
         BackEnd(const int number_of_variables, const int number_of_constraints);
@@ -16,6 +66,19 @@ namespace OpenSoT{
 
         typedef std::shared_ptr<BackEnd> Ptr;
 
+        /**
+         * @brief RowMajorMatrixXd is the type of the constraint matrix: the constraints are stored (and can be
+         * piled, see utils::RowMajorMatrixPiler) in row-major order so that rows can be passed to solvers which
+         * want row-major data without copies.
+         * NOTE: getA() returns a row-major matrix, binding it to a const Eigen::MatrixXd& makes a copy.
+         * Column-major constraint matrices are still accepted by initProblem(), updateConstraints() and
+         * updateProblem(): through the BackEnd interface they are converted in a row-major buffer reused among the
+         * calls (called on a derived back-end they are converted in a temporary), hence they cost one transposed
+         * copy more than row-major ones. Back-ends which want column-major data (OSQP, proxQP, qpSWIFT) make
+         * their own transposed copy of _A.
+         */
+        typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> RowMajorMatrixXd;
+
         /**
          * @brief getSolution return the actual solution of the QP problem
          * @return solution
@@ -27,7 +90,7 @@ namespace OpenSoT{
          */
         const Eigen::MatrixXd& getH(){return _H;}
         const Eigen::VectorXd& getg(){return _g;}
-        const Eigen::MatrixXd& getA(){return _A;}
+        const RowMajorMatrixXd& getA(){return _A;}
         const Eigen::VectorXd& getlA(){return _lA;}
         const Eigen::VectorXd& getuA(){return _uA;}
         const Eigen::VectorXd& getl(){return _l;}
@@ -56,9 +119,48 @@ namespace OpenSoT{
          * @return if the problem is correctly updated
          */
         bool updateProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                                           const Eigen::MatrixXd &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
+                                           const Eigen::Ref<const RowMajorMatrixXd> &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                                            const Eigen::VectorXd &l, const Eigen::VectorXd &u);
 
+        /**
+         * @brief updateProblem overload for column-major constraint matrices, see RowMajorMatrixXd
+         */
+        template <typename Derived>
+        typename std::enable_if<!Derived::IsRowMajor, bool>::type
+        updateProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
+                      const Eigen::MatrixBase<Derived> &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
+                      const Eigen::VectorXd &l, const Eigen::VectorXd &u)
+        {
+            _A_row_major = A;
+            return updateProblem(H, g, _A_row_major, lA, uA, l, u);
+        }
+
+        /**
+         * @brief updateConstraints overload for column-major constraint matrices, see RowMajorMatrixXd
+         */
+        template <typename Derived>
+        typename std::enable_if<!Derived::IsRowMajor, bool>::type
+        updateConstraints(const Eigen::MatrixBase<Derived>& A,
+                          const Eigen::Ref<const Eigen::VectorXd> &lA,
+                          const Eigen::Ref<const Eigen::VectorXd> &uA)
+        {
+            _A_row_major = A;
+            return updateConstraints(_A_row_major, lA, uA);
+        }
+
+        /**
+         * @brief initProblem overload for column-major constraint matrices, see RowMajorMatrixXd
+         */
+        template <typename Derived>
+        typename std::enable_if<!Derived::IsRowMajor, bool>::type
+        initProblem(const Eigen::MatrixXd& H, const Eigen::VectorXd& g,
+                    const Eigen::MatrixBase<Derived>& A, const Eigen::VectorXd& lA, const Eigen::VectorXd& uA,
+                    const Eigen::VectorXd& l, const Eigen::VectorXd& u)
+        {
+            _A_row_major = A;
+            return initProblem(H, g, _A_row_major, lA, uA, l, u);
+        }
+
         void printProblemInformation(const int problem_number, const std::string& problem_id,
                                      const std::string& constraints_id, const std::string& bounds_id);
 
@@ -87,7 +189,7 @@ namespace OpenSoT{
          * @param uA update upper constraint Eigen::VectorXd
          * @return true if constraints are correctly updated
          */
-        virtual bool updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
+        virtual bool updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A,
                                        const Eigen::Ref<const Eigen::VectorXd> &lA,
                                        const Eigen::Ref<const Eigen::VectorXd> &uA);
 
@@ -123,7 +225,7 @@ namespace OpenSoT{
          * @return true if the problem can be solved
          */
         virtual bool initProblem(const Eigen::MatrixXd& H, const Eigen::VectorXd& g,
-                                 const Eigen::MatrixXd& A, const Eigen::VectorXd& lA, const Eigen::VectorXd& uA,
+                                 const Eigen::Ref<const RowMajorMatrixXd>& A, const Eigen::VectorXd& lA, const Eigen::VectorXd& uA,
                                  const Eigen::VectorXd& l, const Eigen::VectorXd& u) = 0;
         /**
          * @brief solve the QP problem
@@ -160,6 +262,16 @@ namespace OpenSoT{
             return false;
         }
 
+        /**
+         * @brief getNumberOfIterations return the number of iterations performed by the last call to solve()
+         * (e.g. the working set recalculations for active set solvers)
+         * @return number of iterations, -1 if not available
+         */
+        virtual int getNumberOfIterations()
+        {
+            return -1;
+        }
+
         /**
          * @brief getEpsRegularisation return internal solver eps
          * @return eps value
@@ -194,7 +306,7 @@ namespace OpenSoT{
         /**
          * Define a set of constraints weighted with A: lA <= Ax <= uA
          */
-        Eigen::MatrixXd _A;
+        RowMajorMatrixXd _A;
         Eigen::VectorXd _lA;
         Eigen::VectorXd _uA;
 
@@ -213,6 +325,13 @@ namespace OpenSoT{
          * @brief _number_of_variables which remain constant during BE existence
          */
         int _number_of_variables;
+
+    private:
+        /**
+         * @brief _A_row_major row-major copy of the column-major constraint matrices, kept to not allocate at
+         * each call
+         */
+        RowMajorMatrixXd _A_row_major;
     };
 
     }
@@ -5,6 +5,11 @@
 #include <boost/make_shared.hpp>
 #include <type_traits>
 
+/**
+ * Default eps regularisation of the front-ends (iHQP, wHQP and l1HQP)
+ */
+#define DEFAULT_EPS_REGULARISATION 2E2 //THIS VALUE IS HISTORICALLY USED IN QPOASES
+
 namespace OpenSoT{
     namespace solvers{
         enum class solver_back_ends{
@@ -14,7 +19,9 @@ namespace OpenSoT{
             eiQuadProg,
             ODYS,
             qpSWIFT,
-            proxQP
+            proxQP,
+            proxQPSparse,
+            Auto //the back-end is chosen by selectBackEnd(), NOT included in solver_back_ends_iterator
         };
 
         template < typename C, C beginVal, C endVal>
@@ -37,21 +44,53 @@ namespace OpenSoT{
           bool operator!=(const Iterator& i) { return val != i.val; }
         };
 
-        typedef Iterator<solver_back_ends, solver_back_ends::qpOASES, solver_back_ends::proxQP> solver_back_ends_iterator;
+        typedef Iterator<solver_back_ends, solver_back_ends::qpOASES, solver_back_ends::proxQPSparse> solver_back_ends_iterator;
+
+        /**
+         * @brief The AutoBackEndThresholds struct contains the thresholds used by selectBackEnd():
+         *  - problems with less than small_size variables plus constraints are solved by dense back-ends
+         *  - problems with a density of H and A less than sparse_density are solved by sparse back-ends
+         * the defaults are starting points: the benchmarks register the Auto back-end next to the others, so the
+         * thresholds can be tuned on the target machine and set through setAutoBackEndThresholds()
+         */
+        struct AutoBackEndThresholds
+        {
+            static constexpr int DEFAULT_SMALL_SIZE = 100;
+            static constexpr double DEFAULT_SPARSE_DENSITY = 0.2;
+
+            int small_size = DEFAULT_SMALL_SIZE;
+            double sparse_density = DEFAULT_SPARSE_DENSITY;
+        };
+
+        /**
+         * @brief setAutoBackEndThresholds sets the thresholds used by all the following calls to selectBackEnd()
+         * @param thresholds
+         * @return false if small_size is negative or sparse_density is not in [0, 1]
+         */
+        bool setAutoBackEndThresholds(const AutoBackEndThresholds& thresholds);
+
+        /**
+         * @brief getAutoBackEndThresholds
+         * @return the thresholds used by selectBackEnd()
+         */
+        AutoBackEndThresholds getAutoBackEndThresholds();
 
         /**
          * @brief BackEndFactory creates an instance of an OpenSoT BackEnd
-         * @param be_solver the type of solver
+         * @param be_solver the type of solver, if solver_back_ends::Auto the back-end is chosen by selectBackEnd()
+         * from the size, the Hessian type and the density of the problem
          * @param number_of_variables of the problem
          * @param number_of_constraints of the problem
          * @param hessian_type of the problem
          * @param eps_regularisation of the problem
+         * @param density ratio of nonzeros in H and A, see estimateDensity(), used only by solver_back_ends::Auto
          * @return a BackEnd pointer
          */
         BackEnd::Ptr BackEndFactory(const solver_back_ends be_solver, const int number_of_variables,
                                const int number_of_constraints,
                                OpenSoT::HessianType hessian_type,
-                               const double eps_regularisation);
+                               const double eps_regularisation,
+                               const double density = 1.);
 
         /**
          * @brief whichBackEnd return a string whith the used BackEnd
@@ -59,6 +98,50 @@ namespace OpenSoT{
          * @return string
          */
         std::string whichBackEnd(const solver_back_ends be_solver);
+
+        /**
+         * @brief isBackEndAvailable
+         * @param be_solver the type of solver
+         * @return true if the plugin of the back-end can be loaded
+         */
+        bool isBackEndAvailable(const solver_back_ends be_solver);
+
+        /**
+         * @brief getBackEndCapabilities returns the capabilities exported by the plugin of the back-end, the result
+         * is cached so that each plugin is queried only once
+         * @param be_solver the type of solver
+         * @return the capabilities of the back-end
+         * @throw std::runtime_error if the back-end is not available
+         */
+        BackEndCapabilities getBackEndCapabilities(const solver_back_ends be_solver);
+
+        /**
+         * @brief selectBackEnd chooses, among the available back-ends, the one recommended for a problem:
+         *  - LPs (HST_ZERO) are solved by back-ends supporting LPs (GLPK first)
+         *  - sparse problems larger than the small size (see AutoBackEndThresholds) by sparse back-ends (OSQP first)
+         *  - dense problems by dense back-ends (eiQuadProg first if the Hessian type is HST_IDENTITY or HST_POSDEF)
+         * back-ends are skipped if the size of the problem is larger than their max_recommended_size, unless
+         * no other back-end can solve the problem
+         * @param number_of_variables of the problem
+         * @param number_of_constraints of the problem
+         * @param hessian_type of the problem
+         * @param eps_regularisation of the problem, not used to decide if H is positive definite since the
+         * back-ends scale it to a very small value
+         * @param density ratio of nonzeros in H and A, see estimateDensity()
+         * @return the recommended back-end
+         * @throw std::runtime_error if no back-end is available
+         */
+        solver_back_ends selectBackEnd(const int number_of_variables,
+                                       const int number_of_constraints,
+                                       OpenSoT::HessianType hessian_type,
+                                       const double eps_regularisation,
+                                       const double density = 1.);
+
+        /**
+         * @brief estimateDensity
+         * @return ratio of nonzeros in H and A
+         */
+        double estimateDensity(const Eigen::MatrixXd& H, const Eigen::Ref<const BackEnd::RowMajorMatrixXd>& A);
     }
 }
 
@@ -42,7 +42,7 @@ public:
      * l/u bounds
      **/
     bool initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                             const Eigen::MatrixXd &A,
+                             const Eigen::Ref<const RowMajorMatrixXd> &A,
                              const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                              const Eigen::VectorXd &l, const Eigen::VectorXd &u);
 
@@ -68,11 +68,26 @@ private:
     glp_iocp _param;
     glp_smcp _param_simplex;
 
-    Eigen::VectorXi _rows;
-    Eigen::VectorXi _cols;
-    Eigen::VectorXd _a;
+    /**
+     * @brief _A_loaded constraint matrix loaded in GLPK, _ind and _val are used to pass the nonzeros of a row
+     * (1-based as required by glp_set_mat_row)
+     */
+    RowMajorMatrixXd _A_loaded;
+    Eigen::VectorXi _ind;
+    Eigen::VectorXd _val;
 
-    void createsVectorsFromConstraintsMatrix();
+    /**
+     * @brief updateConstraintsMatrix loads in GLPK only the nonzeros of the rows of A changed w.r.t. _A_loaded
+     * @param all_rows if true all the rows are loaded
+     */
+    void updateConstraintsMatrix(const bool all_rows);
+
+    /**
+     * @brief solveLPRelaxation solves the LP relaxation with the simplex, warm started from the basis of the
+     * previous solve. If the basis is not valid an advanced initial basis is computed and the simplex is run again
+     * @return output of glp_simplex
+     */
+    int solveLPRelaxation();
 
     int checkConstrType(const double u, const double l);
 
@@ -23,6 +23,26 @@ namespace OpenSoT{
         {
             public:
                 typedef std::shared_ptr<HCOD> Ptr;
+
+                /**
+                 * @brief The ActiveConstraint struct identifies an active row of a stage
+                 * (stage 0 contains the constraints, if present, then the tasks follow the priorities).
+                 * Equality rows are always active and are not reported
+                 */
+                struct ActiveConstraint {
+                    enum class Type {
+                        LOWER,
+                        UPPER
+                    };
+
+                    int row;
+                    Type type;
+                };
+
+                /**
+                 * @brief ActiveSet contains the active rows of each stage
+                 */
+                typedef std::vector<std::vector<ActiveConstraint>> ActiveSet;
                 typedef MatrixPiler VectorPiler;
 
                 /**
@@ -76,6 +96,44 @@ namespace OpenSoT{
                  */
                 void setDamping(double damping);
 
+                /**
+                 * @brief setWarmStart enables the warm start (default true): the active set of the last solve is
+                 * used as initial guess of the next one and, if no task or constraint changed, the last solution
+                 * is returned without solving. If disabled, each solve starts from the equality rows only
+                 * @param warm_start
+                 */
+                void setWarmStart(const bool warm_start);
+
+                /**
+                 * @brief getWarmStart
+                 * @return true if the warm start is enabled
+                 */
+                bool getWarmStart() const;
+
+                /**
+                 * @brief getActiveSet
+                 * @param active_set active set of the last solve
+                 */
+                void getActiveSet(ActiveSet& active_set) const;
+
+                /**
+                 * @brief setActiveSet sets the initial guess of the active set for the next solve
+                 * @param active_set one vector of active rows per stage
+                 * @return false if the number of stages or a row is not valid
+                 */
+                bool setActiveSet(const ActiveSet& active_set);
+
+                /**
+                 * @brief resetActiveSet the next solve will start from the equality rows only
+                 */
+                void resetActiveSet();
+
+                /**
+                 * @brief getNumberOfIterations
+                 * @return number of active set iterations of the last solve (0 if the last solution has been reused)
+                 */
+                unsigned int getNumberOfIterations() const;
+
                 /**
                  * @brief printSOT print some SOT infos
                  */
@@ -116,38 +174,68 @@ namespace OpenSoT{
                 void init(const double damping);
 
                 /**
-                 * @brief copy_bounds copies _bounds into _vector_bounds and _vector_J
+                 * @brief _warm_start if true the active set and the solution are reused
                  */
-                void copy_bounds();
+                bool _warm_start;
 
                 /**
-                 * @brief copy_tasks copies _tasks into _vector_bounds and _vector_J
+                 * @brief _solution last solution
+                 */
+                Eigen::VectorXd _solution;
+
+                /**
+                 * @brief _solution_valid true if the last solve succeeded and nothing changed since then
+                 */
+                bool _solution_valid;
+
+                /**
+                 * @brief _iterations number of iterations of the last solve
                  */
-                void copy_tasks();
+                unsigned int _iterations;
 
                 /**
-                 * @brief _A matrix to pile constraints matrices
+                 * @brief _bounds_version version of the constraints copied in _vector_J and _vector_bounds
                  */
-                MatrixPiler _A;
+                unsigned int _bounds_version;
 
                 /**
-                 * @brief _lA to pile bounds
+                 * @brief _bounds_copied true if the constraints have been copied in _vector_J and _vector_bounds
                  */
-                VectorPiler _lA;
+                bool _bounds_copied;
 
                 /**
-                 * @brief _uA to pile bounds
+                 * @brief copy_bounds copies _bounds into _vector_bounds and _vector_J, the variable bounds are
+                 * passed to soth by index and are not stored in _vector_J
+                 * @param changed true if the constraints have been copied
+                 * @return false if the number of rows of the constraints stage changed
                  */
-                VectorPiler _uA;
+                bool copy_bounds(bool& changed);
 
                 /**
-                 * @brief _I Identity to be used for bounds
+                 * @brief copy_tasks copies _tasks into _vector_bounds and _vector_J
+                 * @return true if at least one task has been copied
+                 */
+                bool copy_tasks();
+
+                /**
+                 * @brief solveHierarchy copies the problem and runs the active search, called by solve() which
+                 * eventually records the statistics
+                 * @param solution vector
+                 * @return true if the hierarchy is solved
+                 */
+                bool solveHierarchy(Eigen::VectorXd& solution);
+
+                /**
+                 * @brief _nb number of variable bounds: they are the first constraints of the constraints stage,
+                 * handled by index inside soth (no rows in _vector_J[0], no dense row operations)
                  */
-                Eigen::MatrixXd _I;
+                int _nb;
 
                 // TASKS WEIGHTS ARE HANDLED WITH THE FOLLOWING OBJECTS.
                 // NOTE THAT: FOR DIAGONAL MATRICES (WHEN THE WEIGHT IS DIAGONAL FLAG IS TRUE) THE
-                // WEIGHT FOR THE TASK IS THE SIMPLE SQRT OF THE ELEMENTS ON THE DIAGONAL.
+                // WEIGHT FOR THE TASK IS THE SIMPLE SQRT OF THE ELEMENTS ON THE DIAGONAL, OTHERWISE THE
+                // TRANSPOSED CHOLESKY FACTOR U OF W = U'U IS USED (||U(Ax - b)|| = ||W^1/2(Ax - b)||).
+                // FACTORS ARE COMPUTED ONLY WHEN THE WEIGHT CHANGES, TASKS ARE COPIED ONLY WHEN THEIR VERSION CHANGES.
                 //
                 // TO DISABLE COMPUTATIONS OF WEIGHTS PLEASE SET THE FLAG: disable_weights_computation (default false, weights are computed).
                 /**
@@ -156,15 +244,57 @@ namespace OpenSoT{
                 bool _disable_weights_computation;
 
                 /**
-                 * @brief _W vector to handle task weights
+                 * @brief _W vector to handle task weights (factors of non-diagonal weights)
                  */
                 std::vector<Eigen::MatrixXd> _W;
 
                 /**
-                 * @brief _sqrt is used to compute sqrt of positive-definite symmetric weight matrices
+                 * @brief _w vector to handle diagonal task weights (sqrt of the diagonal)
+                 */
+                std::vector<Eigen::VectorXd> _w;
+
+                /**
+                 * @brief _W_last weights used to compute _W and _w
+                 */
+                std::vector<Eigen::MatrixXd> _W_last;
+
+                /**
+                 * @brief _W_diagonal diagonal flags used to compute _W and _w
+                 */
+                std::vector<bool> _W_diagonal;
+
+                /**
+                 * @brief _W_computed true if _W or _w have been computed for the task
+                 */
+                std::vector<bool> _W_computed;
+
+                /**
+                 * @brief _llt is used to compute the Cholesky factor of positive-definite symmetric weight matrices
+                 */
+                std::vector<Eigen::LLT<Eigen::MatrixXd> > _llt;
+
+                /**
+                 * @brief _sqrt is used to compute sqrt of positive-semidefinite symmetric weight matrices
+                 * (when the Cholesky factorization fails)
                  */
                 std::vector<Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> >_sqrt;
 
+                /**
+                 * @brief _task_versions versions of the tasks copied in _vector_J and _vector_bounds
+                 */
+                std::vector<unsigned int> _task_versions;
+
+                /**
+                 * @brief _task_copied true if the task has been copied in _vector_J and _vector_bounds
+                 */
+                std::vector<bool> _task_copied;
+
+                /**
+                 * @brief compute_weight computes the factor of the i-th task weight if the weight changed
+                 * @param i task index
+                 */
+                void compute_weight(const unsigned int i);
+
                 /**
                  * @brief _Wb vector to store the product Wb
                  */
@@ -3,6 +3,7 @@
 
 #include <OpenSoT/solvers/BackEnd.h>
 #include <memory>
+#include <vector>
 #include <OpenSoT/Task.h>
 #include <osqp.h>
 #include <OpenSoT/utils/Piler.h>
@@ -26,6 +27,44 @@ public:
     
     typedef MatrixPiler VectorPiler;
 
+    /**
+     * @brief SparsityPattern marks the structural nonzeros of a matrix
+     */
+    typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> SparsityPattern;
+
+    /**
+     * @brief The OSQPBackEndOptions struct can be passed to setOptions() in place of OSQPSettings
+     */
+    struct OSQPBackEndOptions
+    {
+        /**
+         * @brief settings of OSQP, if not set the actual settings are kept
+         */
+        std::shared_ptr<OSQPSettings> settings;
+
+        /**
+         * @brief H_pattern (n x n) and A_pattern (number of constraints x n) are the structural nonzeros of H and A,
+         * i.e. a superset of the entries which can be nonzero during the whole run, derived from the structure of
+         * the problem (e.g. the block layout of the variables touched by each task and constraint).
+         * If at least one of them is set only the entries in the patterns (plus the diagonal of H, needed by the
+         * regularisation) are passed to OSQP: the patterns are fixed when the problem is initialized and at each
+         * update only their values are copied. Each update is checked for nonzeros of H and A outside of the
+         * patterns: if any, the patterns are grown and OSQP is set-up again by the next solve(). An empty pattern
+         * means that the matrix is dense (default).
+         * Only the upper triangular part of H_pattern is used.
+         */
+        SparsityPattern H_pattern;
+        SparsityPattern A_pattern;
+
+        /**
+         * @brief detect_patterns if true H_pattern and A_pattern are ignored and the patterns are the nonzeros of
+         * H and A when the problem is initialized, e.g. the structural zeros of tasks and constraints built on a
+         * subset of the variables, grown as the declared ones. The patterns do not depend on the size of the
+         * problem, hence the option can be set before the front-end creates the problem.
+         */
+        bool detect_patterns = false;
+    };
+
     /**
      * @brief OSQPBackEnd constructor with creation of a QP problem.
      * @param number_of_variables of the QP problem
@@ -59,7 +98,7 @@ public:
      * @return true if the problem can be solved
      */
     virtual bool initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                             const Eigen::MatrixXd &A,
+                             const Eigen::Ref<const RowMajorMatrixXd> &A,
                              const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                              const Eigen::VectorXd &l, const Eigen::VectorXd &u);
 
@@ -77,7 +116,8 @@ public:
 
     /**
      * @brief setOptions of the QP problem.
-     * @param options
+     * @param options can be OSQPSettings or OSQPBackEndOptions, changing the sparsity patterns of an initialized
+     * problem sets-up the OSQP workspace again
      */
     virtual void setOptions(const boost::any& options);
 
@@ -103,7 +143,7 @@ public:
      * @param uA update upper constraint Eigen::VectorXd
      * @return true if constraints are correctly updated
      */
-    virtual bool updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A, 
+    virtual bool updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A, 
                                 const Eigen::Ref<const Eigen::VectorXd>& lA, 
                                 const Eigen::Ref<const Eigen::VectorXd>& uA);
 
@@ -139,6 +179,15 @@ public:
         return _eps_regularisation;
     }
 
+    /**
+     * @brief getNumberOfIterations return the number of ADMM iterations of the last solve
+     * @return number of iterations
+     */
+    virtual int getNumberOfIterations()
+    {
+        return _workspace ? _workspace->info->iter : -1;
+    }
+
 private:
     
     typedef Eigen::SparseMatrix<double> SparseMatrix;
@@ -153,6 +202,39 @@ private:
      */
     void __generate_data_struct(const int number_of_variables, const int number_of_constraints, const int number_of_bounds);
     void update_data_struct();
+
+    /**
+     * @brief __generate_sparse_data_struct creates SPARSE Hessian and Constraints matrices from the declared
+     * sparsity patterns (see OSQPBackEndOptions) and the indices used to update their values.
+     * Note that bounds are treated as constraints.
+     */
+    void __generate_sparse_data_struct();
+
+    /**
+     * @brief grow_P_pattern and grow_A_pattern add the nonzeros of _H (upper triangular part) and of _A outside
+     * of the sparsity patterns to the patterns, dense patterns are never grown
+     * @return true if the pattern has been grown
+     */
+    bool grow_P_pattern();
+    bool grow_A_pattern();
+
+    /**
+     * @brief update_sparse_P_values and update_sparse_A_values copy the values of _H and _A at the entries of the
+     * sparsity patterns in the sparse matrices
+     */
+    void update_sparse_P_values();
+    void update_sparse_A_values();
+
+    /**
+     * @brief setup (re)creates the OSQP workspace from _data
+     * @return false if the workspace can not be created
+     */
+    bool setup();
+
+    /**
+     * @brief cleanup frees the OSQP workspace
+     */
+    void cleanup();
     
     void upper_triangular_sparse_update();
     
@@ -186,7 +268,29 @@ private:
 
     double _eps_regularisation;
 
+    /**
+     * @brief _sparse true if only the entries of the sparsity patterns are passed to OSQP
+     */
+    bool _sparse;
+
+    /**
+     * @brief _P_pattern and _A_pattern are the declared (or detected) structural nonzeros of H and A, empty if dense
+     */
+    SparsityPattern _P_pattern;
+    SparsityPattern _A_pattern;
 
+    /**
+     * @brief _detect_patterns see OSQPBackEndOptions, _patterns_grown true if a pattern has been grown since the
+     * last set-up
+     */
+    bool _detect_patterns;
+    bool _patterns_grown;
+
+    /**
+     * @brief _P_index and _A_index are, for each nonzero of _Psparse and _Asparse, the offset of the entry in the
+     * data of _H and _A (-1 for the constant rows of the bounds), _P_diagonal are the nonzeros on the diagonal of P
+     */
+    std::vector<int> _P_index, _A_index, _P_diagonal;
 
 //        void print_csc_matrix_raw(csc* a, const std::string& name);
 
@@ -23,6 +23,27 @@ namespace OpenSoT{
      */
     class QPOasesBackEnd:  public BackEnd{
     public:
+        /**
+         * @brief The QPOasesBackEndOptions struct can be passed to setOptions() in place of qpOASES::Options
+         */
+        struct QPOasesBackEndOptions
+        {
+            /**
+             * @brief options of qpOASES, if not set the actual options are kept
+             */
+            std::shared_ptr<qpOASES::Options> options;
+
+            /**
+             * @brief constraints_capacity maximum number of constraints the internal problem is sized for.
+             * If greater than zero, the internal SQProblem has (at least) constraints_capacity constraints and the
+             * rows not used are padded as free constraints (-INFTY <= 0 <= INFTY): changing the number of
+             * constraints within the capacity does not initialize the problem again and hotstart continues.
+             * If the number of constraints exceeds the capacity, the capacity is enlarged and the problem is
+             * initialized again. If zero (default), the problem is initialized again at each size change.
+             */
+            int constraints_capacity = 0;
+        };
+
         /**
          * @brief QPOasesBackEnd constructor with creation of a QP problem.
          * @param number_of_variables of the QP problem
@@ -70,7 +91,8 @@ namespace OpenSoT{
 
         /**
          * @brief setOptions of the QP problem.
-         * @param options
+         * @param options can be qpOASES::Options or QPOasesBackEndOptions, changing the constraints capacity of an
+         * initialized problem initializes it again
          */
         virtual void setOptions(const boost::any& options);
 
@@ -92,7 +114,7 @@ namespace OpenSoT{
          * @return true if the problem can be solved
          */
         virtual bool initProblem(const Eigen::MatrixXd& H, const Eigen::VectorXd& g,
-                        const Eigen::MatrixXd& A,
+                        const Eigen::Ref<const RowMajorMatrixXd>& A,
                         const Eigen::VectorXd& lA, const Eigen::VectorXd& uA,
                         const Eigen::VectorXd& l, const Eigen::VectorXd& u);
 
@@ -117,13 +139,13 @@ namespace OpenSoT{
          * _A = A
          * _lA = lA
          * _uA = uA
-         * A, lA and uA can change rows size to allow variable constraints
+         * A, lA and uA can change rows size to allow variable constraints (see QPOasesBackEndOptions)
          * @param A update constraint matrix
          * @param lA update lower constraint Eigen::VectorXd
          * @param uA update upper constraint Eigen::VectorXd
          * @return true if constraints are correctly updated
          */
-        virtual bool updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
+        virtual bool updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A,
                                const Eigen::Ref<const Eigen::VectorXd> &lA, 
                                const Eigen::Ref<const Eigen::VectorXd> &uA);
 
@@ -167,10 +189,23 @@ namespace OpenSoT{
 
         /**
          * @brief getActiveConstraints return the active constraints of the solved QP problem
+         * NOTE: when the constraints capacity is used, the free rows after the actual constraints are included
+         * (and are never active)
          * @return active constraints
          */
         const qpOASES::Constraints& getActiveConstraints(){return *_constraints;}
 
+        /**
+         * @brief getDualSolution return the dual solution of the solved QP problem: the multipliers of the bounds
+         * followed by the multipliers of the actual constraints (the free rows of the constraints capacity are
+         * not included)
+         * @return dual solution
+         */
+        Eigen::VectorBlock<const Eigen::VectorXd> getDualSolution() const
+        {
+            return _dual_solution.head(_H.cols() + _A.rows());
+        }
+
 
         /**
          * @brief printProblemInformation print some extra information about the problem
@@ -204,6 +239,15 @@ namespace OpenSoT{
             return _epsRegularisation;
         }
 
+        /**
+         * @brief getNumberOfIterations return the number of working set recalculations of the last solve
+         * @return nWSR
+         */
+        int getNumberOfIterations()
+        {
+            return _number_of_iterations;
+        }
+
     protected:
         /**
          * @brief printConstraintsInfo function that print informations when the problem is not feasible
@@ -217,6 +261,33 @@ namespace OpenSoT{
          */
         void checkINFTY();
 
+        /**
+         * @brief resetProblem creates a new SQProblem with the actual options, sized for the actual number of
+         * constraints or for the constraints capacity
+         */
+        void resetProblem();
+
+        /**
+         * @brief pileConstraints returns the constraints passed to qpOASES: without constraints capacity these are
+         * _A (already row-major), _lA and _uA, otherwise they are copied in _A_padded, _lA_padded and _uA_padded
+         * and the rows exceeding the number of constraints are set as free constraints
+         * @param A pointer to the row-major constraint matrix
+         * @param lA pointer to the lower constraints
+         * @param uA pointer to the upper constraints
+         */
+        void pileConstraints(const double*& A, const double*& lA, const double*& uA);
+
+        /**
+         * @brief regulariseHessian copies _H in _H_regularised and adds _epsRegularisation to its diagonal, called
+         * each time _H or _epsRegularisation change
+         */
+        void regulariseHessian();
+
+        /**
+         * @brief _H_regularised is the Hessian passed to qpOASES, _H is kept without regularisation
+         */
+        Eigen::MatrixXd _H_regularised;
+
         /**
          * @brief _problem is the internal SQProblem
          */
@@ -237,6 +308,11 @@ namespace OpenSoT{
          */
         int _nWSR;
 
+        /**
+         * @brief _number_of_iterations number of working set recalculations performed in the last solve
+         */
+        int _number_of_iterations;
+
         /**
          * @brief _epsRegularisation is a factor that multiplies standard epsRegularisation of qpOases
          */
@@ -249,11 +325,21 @@ namespace OpenSoT{
         std::shared_ptr<qpOASES::Options> _opt;
 
         /**
-         * Solution of the QP problem
+         * Dual solution of the QP problem, including the free rows of the constraints capacity
          */
         Eigen::VectorXd _dual_solution;
         
-        Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> _A_rm;
+        /**
+         * @brief _A_padded, _lA_padded and _uA_padded are the constraints passed to qpOASES when the constraints
+         * capacity is used
+         */
+        RowMajorMatrixXd _A_padded;
+        Eigen::VectorXd _lA_padded, _uA_padded;
+
+        /**
+         * @brief _constraints_capacity number of constraints the SQProblem is sized for, zero if not used
+         */
+        int _constraints_capacity;
 
     };
     }
@@ -26,6 +26,38 @@ namespace OpenSoT{
          * We compute W = LL' and then we multiply L'A and L'b
          */
         Eigen::LLT<Eigen::MatrixXd> _WChol;
+        /**
+         * @brief _Wsqrt is used in place of _WChol when the weight is diagonal, L = sqrt(W)
+         */
+        Eigen::VectorXd _Wsqrt;
+        /**
+         * @brief _AP is A*P, used when the weight is not diagonal
+         */
+        Eigen::MatrixXd _AP;
+        /**
+         * @brief _r is the (weighted) error of the task at the solution of the previous levels
+         */
+        Eigen::VectorXd _r, _Lr;
+        /**
+         * @brief _singularValuesInv and _VsingularValuesInv are used to compute the damped pseudoinverse
+         * (DecompositionMethod::SVD)
+         */
+        Eigen::VectorXd _singularValuesInv;
+        Eigen::MatrixXd _VsingularValuesInv;
+        /**
+         * @brief _JPqr is the rank revealing QR decomposition of _JP' (DecompositionMethod::COD):
+         * _JP'*Pi = Q*R, the first rank columns of Q are stored in _Q, while _RPt = R*Pi' so that _JP = _RPt'*_Q'
+         */
+        Eigen::ColPivHouseholderQR<Eigen::MatrixXd> _JPqr;
+        Eigen::MatrixXd _Q;
+        Eigen::MatrixXd _RPt;
+        /**
+         * @brief _GChol is the Cholesky decomposition of _G = _RPt*_RPt' + lambda^2*I (DecompositionMethod::COD)
+         */
+        Eigen::MatrixXd _G;
+        Eigen::LLT<Eigen::MatrixXd> _GChol;
+        Eigen::VectorXd _z;
+        Eigen::RowVectorXd _workspace;
     };
     /**
      * @brief The eHQP class implements an equality Hierarchical QP solver as the one used in:
@@ -36,7 +68,24 @@ namespace OpenSoT{
      */
     class eHQP : public OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>
     {
+    public:
+        /**
+         * @brief The DecompositionMethod enum selects how the damped pseudoinverse of each level is computed:
+         *  - SVD: JacobiSVD of J*P (default)
+         *  - COD: complete orthogonal decomposition J*P = Pi*R'*Q' obtained from the rank revealing QR of (J*P)',
+         *  the pseudoinverse is never formed and the solution is computed as Q*(R*R' + lambda^2*I)^-1*R*Pi'*b.
+         *  The damping factor lambda is estimated as the smallest diagonal element of R. This is much faster
+         *  than the SVD for large tasks.
+         */
+        enum class DecompositionMethod
+        {
+            SVD,
+            COD
+        };
+
+    private:
         int _x_size;
+        DecompositionMethod _decomposition_method;
         std::vector<stack_level> _stack_levels;
 
         /**
@@ -61,16 +110,22 @@ namespace OpenSoT{
          *        by Householder transformations with column pivoting.
          *        The SVD decomposition is also used the compute the projectors, since
          *        we have that \f$AA^\dagger=U_1U_1^T\f$
-         *
-         */
-        #if EIGEN_MINOR_VERSION <= 0
-        Eigen::MatrixXd getDampedPinv(  const Eigen::MatrixXd& J,
-                                const Eigen::JacobiSVD<Eigen::MatrixXd>& svd,
-                                const Eigen::FullPivLU<Eigen::MatrixXd>& fpl) const;
-        #else
-        Eigen::MatrixXd getDampedPinv(  const Eigen::MatrixXd& J,
-                                        const Eigen::JacobiSVD<Eigen::MatrixXd>& svd) const;
-        #endif
+         *        The pseudoinverse is written in level._JPpinv, using the workspace of the level.
+         * @return the rank of J
+         */
+        int getDampedPinv(stack_level& level) const;
+
+        /**
+         * @brief solveSVD computes the damped pseudoinverse of _JP of the level through its SVD, updates the solution
+         * and the projector P = P_prev - V1*V1', where V1 are the first rank columns of V
+         */
+        void solveSVD(stack_level& level, const stack_level& previous_level, Eigen::VectorXd& solution);
+
+        /**
+         * @brief solveCOD solves the damped least squares problem of the level through the complete orthogonal
+         * decomposition of _JP, updates the solution and the projector P = P_prev - Q*Q'
+         */
+        void solveCOD(stack_level& level, const stack_level& previous_level, Eigen::VectorXd& solution);
                                         
         /** @brief sigma_min is the minimum value which is accepted for 
          *                   a singular value before regularization is enabled */
@@ -105,7 +160,19 @@ namespace OpenSoT{
          * if min(singular_values) < sigma_min then:
          *      singular_values_inv[i] = singular_values[i]/(singular_values[i]^2 + min(singular_values)^2)
          */
-        void setSigmaMin(const double& sigma_min);        
+        void setSigmaMin(const double& sigma_min);
+
+        /**
+         * @brief setDecompositionMethod
+         * @param method used to compute the damped pseudoinverse of the levels (default DecompositionMethod::SVD)
+         */
+        void setDecompositionMethod(const DecompositionMethod method);
+
+        /**
+         * @brief getDecompositionMethod
+         * @return the method used to compute the damped pseudoinverse of the levels
+         */
+        DecompositionMethod getDecompositionMethod() const;
     };
 }
 }
@@ -7,6 +7,7 @@
 #include <eiquadprog.hpp>
 
 #define EIQUADPROG_DEFAULT_EPS_REGULARISATION 0
+#define EIQUADPROG_INFINITY 1E20 //bounds with larger magnitude are not passed to the solver
 
 using namespace OpenSoT::utils;
 
@@ -27,7 +28,7 @@ public:
     ~eiQuadProgBackEnd();
 
     virtual bool initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                             const Eigen::MatrixXd &A,
+                             const Eigen::Ref<const RowMajorMatrixXd> &A,
                              const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                              const Eigen::VectorXd &l, const Eigen::VectorXd &u);
 
@@ -57,16 +58,35 @@ public:
 
 private:
     double _eps_regularisation;
-    Eigen::MatrixXd _I;
 
+    /**
+     * @brief _CI and _ci0 are the inequality constraints in the layout required by eiQuadProg (one constraint
+     * per column, CI^T x + ci0 >= 0): bounds and constraints are written directly, skipping infinite bounds.
+     * _CE and _ce0 are the (empty) equality constraints
+     */
+    Eigen::MatrixXd _CI, _CE;
+    Eigen::VectorXd _ci0, _ce0;
 
-    MatrixPiler _CIPiler;
-    VectorPiler _ci0Piler;
+    /**
+     * @brief _workspace Cholesky decomposition and working memory of the solver, kept between calls so that
+     * solve() does not allocate once the size of the problem is fixed
+     */
+    Eigen::QuadProgWorkspace _workspace;
 
+    /**
+     * @brief _H_factorized and _eps_factorized Hessian and regularisation decomposed in _workspace, _H_regularised
+     * the regularised Hessian and _H_trace its trace: when H and the regularisation do not change the
+     * decomposition is reused
+     */
+    Eigen::MatrixXd _H_factorized, _H_regularised;
+    double _H_trace;
+    double _eps_factorized;
 
 
     void __generate_data_struct();
 
+    bool __solve();
+
 
     double _f_value;
 
@@ -26,11 +26,11 @@
 #include <OpenSoT/constraints/Aggregated.h>
 #include <OpenSoT/solvers/BackEndFactory.h>
 #include <OpenSoT/utils/Piler.h>
+#include <OpenSoT/utils/CostFunctionCache.h>
+#include <OpenSoT/utils/ThreadPool.h>
 
 using namespace OpenSoT::utils;
 
-#define DEFAULT_EPS_REGULARISATION 2E2 //THIS VALUE IS HISTORICALLY USED IN QPOASES
-
 namespace OpenSoT{
 class AutoStack;
 }
@@ -112,11 +112,31 @@ namespace OpenSoT{
 
         /**
          * @brief solve a stack of tasks
+         * NOTE: see setRealTimeMode() for the conditions under which solve() does not allocate memory
          * @param solution vector
          * @return true if all the stack is solved
          */
         bool solve(Eigen::VectorXd& solution);
 
+        /**
+         * @brief setRealTimeMode enables the real-time mode: after the first call, as long as the size of the problem
+         * does not change, solve() does not allocate nor free memory.
+         * NOTE: the guarantee holds ONLY if all the levels use the eiQuadProg back-end, which is the only back-end
+         * that does not allocate inside solve() (see BackEndCapabilities::real_time_safe), and if the stack is
+         * solved serially: the real-time mode can not be enabled with other back-ends or with a thread pool, and
+         * setThreadPool() is refused while it is enabled. The tasks and constraints in the stack are expected to
+         * be allocation-free in their update() as well, see tests/solvers/TestRealTime.cpp.
+         * @param enable true to enable the real-time mode
+         * @return false if the real-time mode can not be enabled
+         */
+        bool setRealTimeMode(const bool enable);
+
+        /**
+         * @brief isRealTimeMode
+         * @return true if the real-time mode is enabled
+         */
+        bool isRealTimeMode() const { return _real_time_mode; }
+
         /**
          * @brief getNumberOfTasks
          * @return lenght of the stack
@@ -192,6 +212,46 @@ namespace OpenSoT{
          */
         bool getBackEnd(const unsigned int i, BackEnd::Ptr& back_end);
 
+        /**
+         * @brief setThreadPool enables the detection of independent sub-hierarchies: if the variables can be split
+         * in blocks which are not coupled by any task (or task weight) nor constraint, e.g. two robots or a
+         * mobile base and an arm glued through an OptvarHelper, each block is solved as an independent iHQP and
+         * the sub-problems are solved in parallel. The blocks are declared through setColumnBlocks() or, if not
+         * declared, detected from the sparsity pattern of the problem when the pool is set. Each time a task
+         * or a constraint changes (see their versions) its sparsity pattern is checked against the blocks before
+         * solving: if a zero became a non-zero coupling two blocks (or a dropped zero row became non-zero) the
+         * blocks are detected again and the sub-problems rebuilt, while coupled declared blocks are discarded and
+         * the stack is solved as a single problem. If a single block is found the stack is solved as usual.
+         * The options and the eps regularisation of each level (setOptions(), setEpsRegularisation()) and the
+         * statistics are forwarded to the sub-problems: the timings of a level are summed over the sub-problems
+         * and a single record is committed by solve().
+         * NOTE: the solution is the same of the serial solve up to the regularisation, but the back-ends of
+         * the levels (getBackEnd(), getObjective()...) are not used while the sub-problems are solved. Options
+         * which depend on the size of the problem (e.g. the declared OSQP sparsity patterns, the detected
+         * ones are valid) are not valid for the sub-problems.
+         * The parallel solve is not available with a user defined regularisation nor in real-time mode.
+         * @param thread_pool a pool of workers, nullptr to get back to the serial solve
+         */
+        void setThreadPool(ThreadPool::Ptr thread_pool);
+
+        ThreadPool::Ptr getThreadPool(){ return _thread_pool; }
+
+        /**
+         * @brief setColumnBlocks declares the independent blocks of variables solved in parallel, see setThreadPool()
+         * @param blocks block of each variable, from 0 to the number of blocks - 1, an empty vector to detect the
+         * blocks from the sparsity pattern
+         * @return false if the size of blocks is not the number of variables or if a task, a task weight or a
+         * constraint couples two blocks
+         */
+        bool setColumnBlocks(const std::vector<int>& blocks);
+
+        /**
+         * @brief getNumberOfSubProblems
+         * @return number of independent sub-problems solved by the last call to solve(), 1 if the stack has been
+         * solved as a single problem
+         */
+        unsigned int getNumberOfSubProblems(){ return _sub_problems.empty() ? 1 : _sub_problems.size(); }
+
     protected:
         virtual void _log(XBot::MatLogger2::Ptr logger, const std::string& prefix);
 
@@ -209,12 +269,100 @@ namespace OpenSoT{
          */
         double _epsRegularisation;
 
+        /**
+         * @brief _real_time_mode see setRealTimeMode()
+         */
+        bool _real_time_mode;
+
         /**
          * @brief prepareSoT initialize the complete stack
          * @return true if stack is correctly initialized
          */
         bool prepareSoT(const std::vector<solver_back_ends> be_solver);
 
+        /**
+         * @brief solveStack solves the stack of tasks, called by solve() which eventually records the statistics
+         * @param solution vector
+         * @return true if all the stack is solved
+         */
+        bool solveStack(Eigen::VectorXd& solution);
+
+        /**
+         * @brief The SubProblem struct is an independent sub-hierarchy, see setThreadPool()
+         */
+        struct SubProblem;
+
+        /**
+         * @brief _sub_problems independent sub-problems, empty if the stack is solved as a single problem
+         */
+        std::vector<std::shared_ptr<SubProblem>> _sub_problems;
+
+        ThreadPool::Ptr _thread_pool;
+
+        /**
+         * @brief _column_blocks block of each variable used to build the sub-problems, _declared_column_blocks
+         * the blocks declared through setColumnBlocks() (empty if detected), _column_parents is used to detect
+         * the blocks
+         */
+        std::vector<int> _column_blocks, _declared_column_blocks, _column_parents;
+
+        /**
+         * @brief _task_row_blocks and _constraint_row_blocks block of each row of the tasks and of the constraints
+         * of the levels, -1 for the zero rows which are dropped from the sub-problems
+         */
+        std::vector<std::vector<int>> _task_row_blocks, _constraint_row_blocks;
+
+        /**
+         * @brief _column_blocks_versions versions of the tasks and of the constraints of the levels the last time
+         * their sparsity pattern has been checked against _column_blocks
+         */
+        std::vector<unsigned int> _column_blocks_versions;
+
+        /**
+         * @brief computeColumnBlocks detects the blocks of variables coupled by the tasks and the constraints
+         * @param blocks block of each variable, the variables which do not appear anywhere are in the block 0
+         * @return number of blocks
+         */
+        int computeColumnBlocks(std::vector<int>& blocks);
+
+        /**
+         * @brief partitionColumns computes _column_blocks (declared or detected) and builds the sub-problems
+         * @return false if the declared blocks are coupled, in which case they are discarded
+         */
+        bool partitionColumns();
+
+        /**
+         * @brief columnBlocksValid checks the sparsity pattern of the tasks and constraints which changed since
+         * the last check, see setThreadPool()
+         * @return false if a row or a task weight couples two blocks or if a dropped row is not zero anymore
+         */
+        bool columnBlocksValid();
+
+        /**
+         * @brief prepareSubProblems builds the sub-problems of the blocks in _column_blocks
+         * @return false if a sub-problem can not be initialized
+         */
+        bool prepareSubProblems(const int number_of_blocks);
+
+        /**
+         * @brief solveSubProblems solves the sub-problems in parallel, falls back to solveStack() if a single
+         * block has been found
+         * @param solution vector
+         * @return true if all the sub-problems are solved
+         */
+        bool solveSubProblems(Eigen::VectorXd& solution);
+
+        /**
+         * @brief updateAndSolveLevel updates cost, constraints and bounds of the i-th back-end and solves it
+         * @param i level
+         * @param constraints_task_i aggregated constraints of the level
+         * @param cost_changed if false the cost already loaded in the back-end is kept
+         * @param stats if not nullptr, the time spent inside BackEnd::solve() is recorded
+         * @return true if the level is solved
+         */
+        bool updateAndSolveLevel(const unsigned int i, OpenSoT::constraints::Aggregated& constraints_task_i,
+                                 const bool cost_changed, LevelStatistics* stats = nullptr);
+
         /**
          * @brief computeCostFunction compute a cost function for velocity control:
          *          F = ||Jdq - v||
@@ -224,9 +372,19 @@ namespace OpenSoT{
          */
         void computeCostFunction(const TaskPtr& task, Eigen::MatrixXd& H, Eigen::VectorXd& g);
 
+        /**
+         * @brief computeCostFunction compute a cost function for velocity control using a cache:
+         * H and g are recomputed only if the task changed since the last call
+         * @param task to get Jacobian and reference
+         * @param cost cache containing H and g
+         * @return true if H and g have been recomputed
+         */
+        bool computeCostFunction(const TaskPtr& task, CostFunctionCache& cost);
+
         /**
          * @brief computeOptimalityConstraint compute optimality constraint for velocity control:
          *      Jj*dqj = Jj*dqi
+         * and pile it at the bottom of the constraints
          * @param task to get Jacobian of the previous task
          * @param problem to get solution of the previous task
          * @param A constraint matrix
@@ -234,31 +392,58 @@ namespace OpenSoT{
          * @param uA upper bounds
          */
         void computeOptimalityConstraint(const TaskPtr& task, BackEnd::Ptr& problem,
-                                         Eigen::MatrixXd& A,
-                                         Eigen::VectorXd& lA, Eigen::VectorXd& uA);
+                                         RowMajorMatrixPiler& A, VectorPiler& lA, VectorPiler& uA);
+
+        /**
+         * @brief computeFakeOptimalityConstraint compute a fake optimality constraint for a not active task:
+         *      -1 <= 0x <= 1
+         * and pile it at the bottom of the constraints
+         * @param task the not active task
+         * @param A constraint matrix
+         * @param lA lower bounds
+         * @param uA upper bounds
+         */
+        void computeFakeOptimalityConstraint(const TaskPtr& task,
+                                             RowMajorMatrixPiler& A, VectorPiler& lA, VectorPiler& uA);
 
 
 
         Eigen::MatrixXd H;
         Eigen::VectorXd g;
 
+        /**
+         * @brief _cost_functions cached cost function of each level
+         */
+        std::vector<CostFunctionCache> _cost_functions;
+
+        /**
+         * @brief _cost_function cache used by computeCostFunction(task, H, g)
+         */
+        CostFunctionCache _cost_function;
+
         //USER REGULARISATION
-        Eigen::MatrixXd Hr;
-        Eigen::VectorXd gr;
+        CostFunctionCache _regularisation_cost_function;
 
         OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>::TaskPtr _regularisation_task;
         //
 
-        MatrixPiler A;
+        /**
+         * @brief A, lA and uA contain the constraints of the level under solution:
+         * the optimality constraints of the previous levels are piled at the top and are kept in place
+         * while going down the stack, only the constraints of the actual level are (re)written below them.
+         * A is piled in row-major order, as stored by the back-ends
+         */
+        RowMajorMatrixPiler A;
         VectorPiler lA;
         VectorPiler uA;
         
         Eigen::VectorXd l;
         Eigen::VectorXd u;
         
-        std::vector<Eigen::MatrixXd> tmp_A;
-        std::vector<Eigen::VectorXd> tmp_lA;
-        std::vector<Eigen::VectorXd> tmp_uA;
+        /**
+         * @brief opt_b used to compute the optimality constraint J*dq
+         */
+        Eigen::VectorXd opt_b;
 
 
         std::vector<solver_back_ends> _be_solver;
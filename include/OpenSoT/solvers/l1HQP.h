@@ -12,8 +12,6 @@
 #include <OpenSoT/solvers/BackEnd.h>
 #include <memory>
 
-#define DEFAULT_EPS_REGULARISATION 2E2 //THIS VALUE IS HISTORICALLY USED IN QPOASES
-
 namespace OpenSoT{
 class AutoStack;
 }
@@ -44,21 +42,37 @@ namespace solvers {
     {
     public:
         typedef std::shared_ptr<constraint_helper> Ptr;
-
         constraint_helper(std::string id, OpenSoT::constraints::Aggregated::ConstraintPtr constraints,
                           const AffineHelper& x);
 
+        /**
+         * @brief update rewrites in place the rows of the constraints, nothing is done if the constraints
+         * did not change since the last update (the rows of the bounds are constant).
+         * Equality constraints are written as inequality constraints with coincident lower and upper bounds
+         */
         void update();
+
+        /**
+         * @brief isChanged
+         * @return true if the last call to update() changed the constraint
+         */
+        bool isChanged() const { return _changed; }
+
+        /**
+         * @brief copyTo copies the time-varying blocks of the constraint in a matrix and vectors
+         * containing the constraint starting at row
+         */
+        void copyTo(const unsigned int row, BackEnd::RowMajorMatrixXd& A, Eigen::VectorXd& lA, Eigen::VectorXd& uA) const;
+
     private:
         OpenSoT::constraints::Aggregated::ConstraintPtr _constraints;
-        AffineHelper _constraint;
         AffineHelper _x;
-        Eigen::MatrixXd I;
-
-        OpenSoT::utils::MatrixPiler _A;
-        OpenSoT::utils::MatrixPiler _b_lower;
-        OpenSoT::utils::MatrixPiler _b_upper;
-
+        /**
+         * @brief _x_col first column of the x variable
+         */
+        int _x_col;
+        unsigned int _version;
+        bool _changed;
     };
 
     class task_to_constraint_helper: public Constraint<Eigen::MatrixXd, Eigen::VectorXd>
@@ -79,19 +93,34 @@ namespace solvers {
         task_to_constraint_helper(std::string id, OpenSoT::tasks::Aggregated::TaskPtr& task,
                                   const AffineHelper& x, const AffineHelper& t);
 
+        /**
+         * @brief update rewrites in place the WA and Wb blocks, the contribution of the extra variable and
+         * the lower bounds are constant. Nothing is done if the task did not change since the last update
+         */
         void update();
+
+        /**
+         * @brief isChanged
+         * @return true if the last call to update() changed the constraint
+         */
+        bool isChanged() const { return _changed; }
+
+        /**
+         * @brief copyTo copies the time-varying blocks of the constraint in a matrix and upper bound vector
+         * containing the constraint starting at row (the lower bounds are constant)
+         */
+        void copyTo(const unsigned int row, BackEnd::RowMajorMatrixXd& A, Eigen::VectorXd& uA) const;
+
     private:
         OpenSoT::tasks::Aggregated::TaskPtr& _task;
-        AffineHelper _constraint;
         AffineHelper _x;
         AffineHelper _t;
-
-        OpenSoT::utils::MatrixPiler _II;
-        OpenSoT::utils::MatrixPiler _AA;
-        OpenSoT::utils::MatrixPiler _bb;
-
-        Eigen::VectorXd o, inf, ones;
-        Eigen::MatrixXd O;
+        /**
+         * @brief _x_col first column of the x variable
+         */
+        int _x_col;
+        unsigned int _version;
+        bool _changed;
         double M = 10.; //This is for the Big-M constraint
     };
 
@@ -121,7 +150,9 @@ namespace solvers {
 
             /**
              * @brief getInternalProblem(), getConstraints(), getHardConstraints(), getTasks() and
-             * getPriorityConstraints() are ONLY for debugging
+             * getPriorityConstraints() are ONLY for debugging.
+             * NOTE: the internal problem is assembled at construction, solve() updates only the
+             * helpers and the time-varying blocks of the LP passed to the back-end
              * @return
              */
             const std::shared_ptr<AutoStack>& getInternalProblem(){ return _internal_stack;}
@@ -148,6 +179,10 @@ namespace solvers {
 
             OpenSoT::AutoStack& _stack_of_tasks;
             std::shared_ptr<OptvarHelper> _opt;
+            /**
+             * @brief _x original optimization variable, kept to extract the solution without allocations
+             */
+            AffineHelper _x;
             /**
              * @brief _linear_gains vector of gains
              */
@@ -187,8 +222,23 @@ namespace solvers {
 
             Eigen::VectorXd _internal_solution;
             Eigen::MatrixXd _H;
+
+            /**
+             * @brief _A, _lA and _uA are the constraints of the LP passed to the back-end: they are
+             * assembled once and only the blocks of the changed helpers are copied in place
+             */
+            BackEnd::RowMajorMatrixXd _A;
+            Eigen::VectorXd _lA, _uA;
+            bool update_constraints();
             OpenSoT::HessianType _hessian_type;
 
+            /**
+             * @brief solveProblem solves the LP, called by solve() which eventually records the statistics
+             * @param solution vector
+             * @return true if the LP is solved
+             */
+            bool solveProblem(Eigen::VectorXd& solution);
+
             /**
              * @brief _priority_constraints implements constraints in the form:
              *
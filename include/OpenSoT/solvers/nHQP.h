@@ -24,6 +24,7 @@
 #include <memory>
 
 #include <eigen3/Eigen/SVD>
+#include <eigen3/Eigen/QR>
 
 #include <OpenSoT/Task.h>
 #include <OpenSoT/Solver.h>
@@ -49,13 +50,15 @@ namespace OpenSoT { namespace solvers {
      * Notice how each layer optimizes only over the remaining dofs after higher priority tasks
      * have been optimized. Hence, the size of QP probles decreases along the hierarchy.
      *
+     * Constraints: the global constraints, and the local constraints of the K-th task, are projected onto the nullspace
+     * coordinates of the K-th layer as well, i.e. lA <= C*x <= uA -> lA - C*solK-1 <= C*NK-1*xK <= uA - C*solK-1.
+     * Equality constraints are considered as inequality constraints with equal lower and upper bounds, bounds are
+     * turned into constraints for all the layers but the first. As in iHQP, local constraints of a task are considered
+     * only at its layer.
+     *
      * Limitations:
-     *  - no support for equality constraints
-     *  - no support for local constraints
      *  - [!!!] ranks of tasks should not change during runtime (e.g. disabling a task)
      *
-     * @todo: implement equality constraints by considering the nullspace Neq = Null(Aeq).
-     * All optimizations will then take place in the null space of equality constraints.
      * @todo: add reference
      */
     class nHQP: public Solver<Eigen::MatrixXd, Eigen::VectorXd>
@@ -65,6 +68,21 @@ namespace OpenSoT { namespace solvers {
 
         static constexpr double DEFAULT_MIN_SV_RATIO = 0.05;
 
+        static constexpr double DEFAULT_NULLSPACE_WARM_START_TOLERANCE = 1e-9;
+
+        /**
+         * @brief The NullspaceMethod enum selects the decomposition used to compute the nullspace basis of each layer:
+         *  - SVD: singular value decomposition of A*N (thin U, full V)
+         *  - ColPivQR: column pivoting (rank revealing) QR decomposition of (A*N)^T, only the columns of Q spanning
+         *  the nullspace are formed. The singular values needed by the A and b regularization and by the selective
+         *  nullspace regularization are computed from the small triangular factor.
+         */
+        enum class NullspaceMethod
+        {
+            SVD,
+            ColPivQR
+        };
+
         // Shared pointer typedef
         typedef std::shared_ptr<nHQP> Ptr;
 
@@ -132,6 +150,23 @@ namespace OpenSoT { namespace solvers {
          */
         void setPerformSelectiveNullSpaceRegularization(bool perform_selective_null_space_regularization);
 
+        /**
+         * @brief setNullspaceMethod for all the levels
+         * @param method used to compute the nullspace basis (default is NullspaceMethod::SVD)
+         */
+        void setNullspaceMethod(NullspaceMethod method);
+
+        /**
+         * @brief setNullspaceWarmStart enables the reuse of the nullspace basis of the previous solve() at all levels:
+         * if the previous basis N is still a basis of the nullspace of the current A*N_cumulated, i.e.
+         * max|A*N_cumulated*N| <= tolerance, the decomposition used to compute the nullspace is skipped
+         * (and so is the update of the cumulated nullspace when possible). This is useful with layers whose Jacobian
+         * does not change (or changes rarely) and keeps the nullspace coordinates of the lower layers continuous.
+         * @param enable true or false (default is false)
+         * @param tolerance on the residual max|A*N_cumulated*N|
+         */
+        void setNullspaceWarmStart(bool enable, double tolerance = DEFAULT_NULLSPACE_WARM_START_TOLERANCE);
+
     private:
 
         /**
@@ -143,10 +178,20 @@ namespace OpenSoT { namespace solvers {
 
         public:
 
+            /**
+             * @brief TaskData
+             * @param num_free_vars number of variables of this layer
+             * @param task of this layer
+             * @param constraint global constraints and bounds
+             * @param back_end to solve the QP
+             * @param local_constraints local constraints of the task aggregated with the global constraints and bounds,
+             * used in place of constraint if not nullptr
+             */
             TaskData(int num_free_vars,
                      TaskPtr task,
                      ConstraintPtr constraint,
-                     BackEnd::Ptr back_end);
+                     BackEnd::Ptr back_end,
+                     OpenSoT::constraints::Aggregated::Ptr local_constraints = nullptr);
 
             void set_min_sv_ratio(double sv);
 
@@ -160,7 +205,12 @@ namespace OpenSoT { namespace solvers {
             void compute_contraints(const Eigen::MatrixXd * AN_nullspace,
                                     const Eigen::VectorXd& q0);
 
-            bool update_and_solve();
+            /**
+             * @brief update_and_solve loads the problem in the back-end and solves it
+             * @param stats if not nullptr, the time spent inside the back-end, its iterations and status are recorded
+             * @return true if the problem is solved
+             */
+            bool update_and_solve(utils::LevelStatistics* stats = nullptr);
 
             bool compute_nullspace();
 
@@ -186,15 +236,28 @@ namespace OpenSoT { namespace solvers {
              */
             void set_perform_selective_null_space_regularization(bool perform_selective_null_space_regularization_);
 
+            void set_nullspace_method(NullspaceMethod method);
+
+            void set_nullspace_warm_start(bool enable, double tolerance);
+
+            /**
+             * @brief is_nullspace_reused
+             * @return true if the nullspace basis of the previous solve was reused by the last compute_cost()
+             */
+            bool is_nullspace_reused() const;
+
         private:
 
 
             // this task
             TaskPtr task;
 
-            // global constraints
+            // constraints of this layer (global constraints, or local_constraints if any)
             ConstraintPtr constraints;
 
+            // local constraints aggregated with the global ones (can be nullptr)
+            OpenSoT::constraints::Aggregated::Ptr local_constraints;
+
             // nullspace of AN (used by next task)
             Eigen::MatrixXd AN_nullspace;
 
@@ -211,8 +274,8 @@ namespace OpenSoT { namespace solvers {
             Eigen::MatrixXd H;
             Eigen::VectorXd g;
 
-            // inequality constraints (including bounds for i = 1, 2, ...)
-            utils::MatrixPiler Aineq;
+            // inequality constraints (including bounds for i = 1, 2, ...), row-major as stored by the back-ends
+            utils::RowMajorMatrixPiler Aineq;
 
             // inequality bounds
             utils::MatrixPiler lb, ub;
@@ -223,6 +286,25 @@ namespace OpenSoT { namespace solvers {
             // svd computation class
             Eigen::BDCSVD<Eigen::MatrixXd> svd;
 
+            // rank revealing qr of AN^T (used by NullspaceMethod::ColPivQR)
+            Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr;
+
+            // R, P*R^T and right singular vectors of AN computed from qr (used by NullspaceMethod::ColPivQR)
+            Eigen::MatrixXd qr_R, qr_PRt, qr_V;
+
+            // decomposition used to compute the nullspace
+            NullspaceMethod nullspace_method;
+
+            // if true the nullspace of the previous solve is reused when still valid
+            bool nullspace_warm_start;
+            double nullspace_warm_start_tolerance;
+
+            // true if AN_nullspace has been extracted from the last decomposition (or reused)
+            bool nullspace_computed;
+
+            // true if AN_nullspace of the previous solve was reused
+            bool nullspace_reused;
+
             // nullspace dimension (for next task)
             int ns_dim;
 
@@ -253,14 +335,31 @@ namespace OpenSoT { namespace solvers {
              */
             void regularize_A_b(double threshold);
 
+            /**
+             * @brief check_nullspace_warm_start checks whether the current AN_nullspace is still
+             * a basis of the nullspace of AN
+             * @return true if AN_nullspace can be reused
+             */
+            bool check_nullspace_warm_start() const;
+
         };
 
 
         virtual void _log(XBot::MatLogger2::Ptr logger, const std::string& prefix) override;
 
+        /**
+         * @brief solveStack solves the hierarchy, called by solve() which eventually records the statistics
+         * @param solution
+         * @return false if something went wrong
+         */
+        bool solveStack(Eigen::VectorXd& solution);
+
         // vector of previous task nullspaces (first elem is nx-by-nx identity)
         std::vector<Eigen::MatrixXd> _cumulated_nullspace;
 
+        // false if the last solve stopped before updating all the cumulated nullspaces
+        bool _cumulated_nullspace_valid;
+
         // task data for all layers
         std::vector<TaskData> _data_struct;
 
@@ -26,7 +26,7 @@ public:
     ~proxQPBackEnd();
 
     virtual bool initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                             const Eigen::MatrixXd &A,
+                             const Eigen::Ref<const RowMajorMatrixXd> &A,
                              const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                              const Eigen::VectorXd &l, const Eigen::VectorXd &u);
     virtual bool solve();
@@ -37,7 +37,7 @@ public:
 
     virtual bool updateTask(const Eigen::MatrixXd& H, const Eigen::VectorXd& g);
 
-    virtual bool updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
+    virtual bool updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A,
                                 const Eigen::Ref<const Eigen::VectorXd>& lA,
                                 const Eigen::Ref<const Eigen::VectorXd>& uA);
 
@@ -58,10 +58,21 @@ public:
         return _eps_regularisation;
     }
 
+    virtual int getNumberOfIterations()
+    {
+        return _QP ? _QP->results.info.iter : -1;
+    }
+
 private:
-    void create_data_structure(const Eigen::MatrixXd &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
+    void create_data_structure(const RowMajorMatrixXd &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                                const Eigen::VectorXd &l, const Eigen::VectorXd &u);
 
+    /**
+     * @brief checkStatus maps the status of the last solve of proxqp
+     * @return true if the problem has been solved
+     */
+    bool checkStatus();
+
     typedef MatrixPiler VectorPiler;
 
     std::shared_ptr<dense::QP<double>> _QP;
@@ -80,7 +91,12 @@ private:
 
     double _eps_regularisation;
 
-
+    /**
+     * @brief _number_of_equalities and _number_of_inequalities rows of the actual proxqp problem, when they change
+     * the problem is initialized again
+     */
+    int _number_of_equalities;
+    int _number_of_inequalities;
 };
 
 }
@@ -0,0 +1,173 @@
+#ifndef _WB_SOT_SOLVERS_PROXQP_SPARSE_BE_H_
+#define _WB_SOT_SOLVERS_PROXQP_SPARSE_BE_H_
+
+#include <OpenSoT/solvers/BackEnd.h>
+#include <memory>
+#include <vector>
+#include <OpenSoT/Task.h>
+#include <proxsuite/proxqp/sparse/sparse.hpp>
+
+#define PROXQP_SPARSE_DEFAULT_EPS_REGULARISATION 0
+
+namespace OpenSoT{
+namespace solvers{
+
+/**
+ * @brief The proxQPSparseBackEnd class implements a back-end based on the sparse API of proxsuite::proxqp.
+ * Constraints and bounds are passed as a single block of inequalities (equalities are rows with equal lower
+ * and upper bounds):
+ *
+ *          min     0.5 x^T H x + g^T x
+ *          s.t.    [l; lA] <= [I; A] x <= [u; uA]
+ *
+ * hence the number of rows does not change between two solves. Only the structural nonzeros of H and A, detected
+ * from the problem or declared through proxQPSparseBackEndOptions, are passed to the solver: the sparse matrices
+ * are built once and at each solve only their values are copied. The problem is initialized again, warm starting
+ * from the previous solution, only if a nonzero appears outside of the patterns.
+ */
+class proxQPSparseBackEnd:  public BackEnd{
+public:
+    typedef Eigen::SparseMatrix<double, Eigen::ColMajor, int> SparseMatrix;
+
+    /**
+     * @brief SparsityPattern marks the structural nonzeros of a matrix
+     */
+    typedef Eigen::Matrix<bool, Eigen::Dynamic, Eigen::Dynamic> SparsityPattern;
+
+    /**
+     * @brief The proxQPSparseBackEndOptions struct can be passed to setOptions() in place of
+     * proxsuite::proxqp::Settings<double>
+     */
+    struct proxQPSparseBackEndOptions
+    {
+        /**
+         * @brief settings of proxqp, if not set the actual settings are kept
+         */
+        std::shared_ptr<proxsuite::proxqp::Settings<double>> settings;
+
+        /**
+         * @brief H_pattern (n x n) and A_pattern (number of constraints x n) are the structural nonzeros of H and A,
+         * i.e. a superset of the entries which can be nonzero during the whole run (e.g. the blocks of the variables
+         * touched by each task and constraint of the aggregated stack). An empty pattern (default) is detected from
+         * the nonzeros of the matrix when the problem is initialized, or keeps the actual one if already initialized. The diagonal of H is always passed for the
+         * regularisation. Each update is checked for nonzeros outside of the patterns: if any, the patterns are
+         * grown and the problem is initialized again by the next solve().
+         */
+        SparsityPattern H_pattern;
+        SparsityPattern A_pattern;
+    };
+
+    proxQPSparseBackEnd(const int number_of_variables,
+                        const int number_of_constraints,
+                        const double eps_regularisation = PROXQP_SPARSE_DEFAULT_EPS_REGULARISATION);
+
+    ~proxQPSparseBackEnd();
+
+    virtual bool initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
+                             const Eigen::Ref<const RowMajorMatrixXd> &A,
+                             const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
+                             const Eigen::VectorXd &l, const Eigen::VectorXd &u);
+    virtual bool solve();
+
+    /**
+     * @brief getOptions
+     * @return proxsuite::proxqp::Settings<double>
+     */
+    virtual boost::any getOptions();
+
+    /**
+     * @brief setOptions
+     * @param options proxsuite::proxqp::Settings<double> or proxQPSparseBackEndOptions, changing the sparsity
+     * patterns of an initialized problem initializes it again
+     */
+    virtual void setOptions(const boost::any& options);
+
+    virtual bool updateTask(const Eigen::MatrixXd& H, const Eigen::VectorXd& g);
+
+    virtual bool updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A,
+                                const Eigen::Ref<const Eigen::VectorXd>& lA,
+                                const Eigen::Ref<const Eigen::VectorXd>& uA);
+
+    virtual bool updateBounds(const Eigen::VectorXd& l, const Eigen::VectorXd& u);
+
+    virtual double getObjective();
+
+    bool setEpsRegularisation(const double eps)
+    {
+        if(eps < 0.)
+            return false;
+        _eps_regularisation = eps;
+        return true;
+    }
+
+    virtual double getEpsRegularisation()
+    {
+        return _eps_regularisation;
+    }
+
+    virtual int getNumberOfIterations()
+    {
+        return _QP ? _QP->results.info.iter : -1;
+    }
+
+private:
+    /**
+     * @brief createSparseMatrices creates _Hsparse and _Csparse from the sparsity patterns and the indices used to
+     * update their values
+     */
+    void createSparseMatrices();
+
+    /**
+     * @brief updateSparseValues writes the values of H (plus regularisation), A, lA, uA, l and u in the sparse
+     * data structures, without allocations
+     */
+    void updateSparseValues();
+
+    /**
+     * @brief initQP creates and initializes the proxqp problem, warm starting from the previous primal and dual
+     * solution if available and of the same size
+     */
+    void initQP();
+
+    /**
+     * @brief growPatterns adds the nonzeros of _H and _A outside of _H_pattern and _A_pattern to the patterns
+     * @return true if at least one of the patterns has been grown
+     */
+    bool growPatterns();
+
+    /**
+     * @brief checkStatus maps the status of the last solve of proxqp
+     * @return true if the problem has been solved
+     */
+    bool checkStatus();
+
+    std::shared_ptr<proxsuite::proxqp::sparse::QP<double, int>> _QP;
+    std::shared_ptr<proxsuite::proxqp::Settings<double>> _user_settings;
+
+    /**
+     * @brief _H_pattern and _A_pattern are the structural nonzeros of H and A, empty until detected,
+     * _patterns_grown is true if a pattern has been grown since the problem was last initialized
+     */
+    SparsityPattern _H_pattern, _A_pattern;
+    bool _patterns_grown;
+
+    /**
+     * @brief _H_index and _C_index are the offsets in _H and _A of the values of _Hsparse and _Csparse (-1 for the
+     * constant rows of the bounds), _H_diagonal are the positions of the diagonal in the values of _Hsparse
+     */
+    std::vector<int> _H_index, _H_diagonal, _C_index;
+
+    /**
+     * @brief _Hsparse regularised Hessian, _Csparse bounds (first rows) and constraints (last rows), _Asparse and
+     * _b are the (empty) equality constraints
+     */
+    SparseMatrix _Hsparse, _Csparse, _Asparse;
+    Eigen::VectorXd _lC, _uC, _b;
+
+    double _eps_regularisation;
+};
+
+}
+}
+
+#endif
@@ -8,6 +8,7 @@
 #include <OpenSoT/utils/Piler.h>
 
 #define QPSWIFT_DEFAULT_EPS_REGULARISATION 0
+#define QPSWIFT_INFINITY 1E20 //bounds with larger magnitude are considered infinite
 
 using namespace OpenSoT::utils;
 
@@ -31,7 +32,7 @@ public:
     ~qpSWIFTBackEnd();
 
     virtual bool initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                             const Eigen::MatrixXd &A,
+                             const Eigen::Ref<const RowMajorMatrixXd> &A,
                              const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                              const Eigen::VectorXd &l, const Eigen::VectorXd &u);
 
@@ -43,7 +44,7 @@ public:
 
     virtual bool updateTask(const Eigen::MatrixXd& H, const Eigen::VectorXd& g);
 
-    virtual bool updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
+    virtual bool updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A,
                                 const Eigen::Ref<const Eigen::VectorXd>& lA,
                                 const Eigen::Ref<const Eigen::VectorXd>& uA);
 
@@ -63,11 +64,30 @@ public:
     {
         return _eps_regularisation;
     }
-private:
-    void createDataStructure(const Eigen::MatrixXd &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
-                             const Eigen::VectorXd &l, const Eigen::VectorXd &u);
 
-    typedef MatrixPiler VectorPiler;
+    virtual int getNumberOfIterations()
+    {
+        return _qp ? _qp->stats->IterationCount : -1;
+    }
+private:
+    /**
+     * @brief updateRowLayout classifies each constraint and bound as equality, one-sided or two-sided inequality.
+     * Rows with both sides at infinity are dropped, and one-sided rows are passed only once
+     * @return true if the classification changed w.r.t. the previous call
+     */
+    bool updateRowLayout();
+
+    /**
+     * @brief fillDataStructure writes A, lA, uA, l and u in the equality (_AA, _b) and inequality (_G, _h)
+     * matrices, according to the actual row layout
+     */
+    void fillDataStructure();
+
+    /**
+     * @brief setup calls QP_SETUP_dense. It is needed only when the row layout, H, _G or _AA change,
+     * otherwise g, _h and _b are updated in place inside the qpSWIFT data structure
+     */
+    bool setup();
 
     std::shared_ptr<QP> _qp; //qpSWIFT data structure
     std::shared_ptr<settings> _user_options;
@@ -75,24 +95,36 @@ private:
 
     double _eps_regularisation;
 
-    MatrixPiler _AA;
-    VectorPiler _b;
-    std::vector<unsigned int> _equality_constraint_indices;
-    std::vector<unsigned int> _equality_bounds_indices;
-
-    MatrixPiler _G;
-    VectorPiler _h;
-    std::vector<unsigned int> _inequality_constraint_indices;
-    std::vector<unsigned int> _inequality_bounds_indices;
-
-
-    Eigen::MatrixXd _I;
-
-
-
-
-
-
+    /**
+     * @brief _row_types type of each constraint (first) and bound (last)
+     */
+    std::vector<char> _row_types;
+
+    /**
+     * @brief _equality_rows index of the constraint (or bound, if >= number of constraints) of each row of _AA
+     */
+    std::vector<int> _equality_rows;
+
+    /**
+     * @brief _inequality_rows index of the constraint (or bound) and sign (+1 upper, -1 lower) of each row of _G
+     */
+    std::vector<std::pair<int, double>> _inequality_rows;
+
+    Eigen::MatrixXd _AA;
+    Eigen::VectorXd _b;
+    Eigen::MatrixXd _G;
+    Eigen::VectorXd _h;
+
+    /**
+     * @brief data used in the last QP_SETUP_dense
+     */
+    Eigen::MatrixXd _H_setup, _AA_setup, _G_setup;
+    Eigen::VectorXd _g_setup, _h_setup, _b_setup;
+
+    /**
+     * @brief _matrices_changed true if H or A were passed since the last QP_SETUP_dense
+     */
+    bool _matrices_changed;
 };
 
 }
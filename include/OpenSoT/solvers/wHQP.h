@@ -0,0 +1,189 @@
+#ifndef _OPENSOT_SOLVERS_WHQP_H_
+#define _OPENSOT_SOLVERS_WHQP_H_
+
+#include <OpenSoT/Solver.h>
+#include <OpenSoT/constraints/Aggregated.h>
+#include <OpenSoT/solvers/BackEndFactory.h>
+#include <OpenSoT/utils/CostFunctionCache.h>
+#include <memory>
+#include <vector>
+
+#define DEFAULT_LEVEL_WEIGHT_RATIO 1E3
+
+namespace OpenSoT{
+class AutoStack;
+}
+
+namespace OpenSoT{
+    namespace solvers{
+
+    /**
+     * @brief The wHQP class implements a "soft hierarchy" solver: all the levels of an AutoStack are fused in
+     * a single QP whose cost is the weighted sum of the costs of the levels:
+     *
+     *          min     sum_i w_i ||A_i x - b_i||_{W_i} + regularisation
+     *          s.t.    constraints of all the levels, global constraints and bounds
+     *
+     * hence a single back-end is solved at each tick. Priorities are not strict: a lower level can degrade a higher
+     * one proportionally to the ratio of their weights, but the solve time is bounded and does not depend on
+     * the number of levels.
+     * NOTE: the constraints attached to the tasks of any level are enforced as hard constraints of the single QP
+     */
+    class wHQP: public Solver<Eigen::MatrixXd, Eigen::VectorXd>
+    {
+    public:
+        typedef std::shared_ptr<wHQP> Ptr;
+
+        /**
+         * @brief wHQP constructor
+         * @param stack_of_tasks data structure which contains tasks, constraints and user defined regularisation
+         * @param level_weights weight of each level, if empty computeLevelWeights() with DEFAULT_LEVEL_WEIGHT_RATIO
+         * is used
+         * @param eps_regularisation regularisation factor used inside the QP solver (BackEnd)
+         * @param be_solver back-end
+         * @throw exception if the weights are not valid or the problem can not be initialized
+         */
+        wHQP(OpenSoT::AutoStack& stack_of_tasks,
+             const std::vector<double>& level_weights = std::vector<double>(),
+             const double eps_regularisation = DEFAULT_EPS_REGULARISATION,
+             const solver_back_ends be_solver = solver_back_ends::qpOASES);
+
+        ~wHQP(){}
+
+        /**
+         * @brief computeLevelWeights computes geometric weights: w_i = ratio^(levels - 1 - i),
+         * i.e. the last level has weight 1
+         * @param levels number of levels
+         * @param ratio ratio between the weights of two consecutive levels
+         * @return the weights
+         */
+        static std::vector<double> computeLevelWeights(const unsigned int levels,
+                                                       const double ratio = DEFAULT_LEVEL_WEIGHT_RATIO);
+
+        /**
+         * @brief solve the weighted stack of tasks
+         * @param solution vector
+         * @return true if the QP is solved
+         */
+        bool solve(Eigen::VectorXd& solution);
+
+        /**
+         * @brief getNumberOfTasks
+         * @return number of levels of the stack
+         */
+        unsigned int getNumberOfTasks(){return _tasks.size();}
+
+        /**
+         * @brief setLevelWeights sets the weights of the levels
+         * @param level_weights one non-negative weight per level, a zero weight disables the level
+         * @return false if the size is wrong or a weight is negative (or different from 1 for a single
+         * level with identity Hessian, see computeHessianType())
+         */
+        bool setLevelWeights(const std::vector<double>& level_weights);
+
+        /**
+         * @brief setLevelWeight sets the weight of the i-th level
+         * @return false if the level does not exist or the weight is negative (or different from 1 for a single
+         * level with identity Hessian, see computeHessianType())
+         */
+        bool setLevelWeight(const unsigned int i, const double weight);
+
+        const std::vector<double>& getLevelWeights() const {return _level_weights;}
+
+        /**
+         * @brief setOptions set options to the back-end
+         */
+        void setOptions(const boost::any& opt);
+
+        /**
+         * @brief getOptions
+         * @return the options of the back-end
+         */
+        boost::any getOptions();
+
+        /**
+         * @brief getObjective
+         * @return the value of the objective function at the optimum
+         */
+        double getObjective();
+
+        /**
+         * @brief getBackEndName
+         * @return the name of the back-end
+         */
+        std::string getBackEndName();
+
+        /**
+         * @brief setEpsRegularisation OVERWRITES the actual eps regularisation factor
+         * @return false if eps < 0
+         */
+        bool setEpsRegularisation(const double eps);
+
+        void getBackEnd(BackEnd::Ptr& back_end){back_end = _back_end;}
+
+        /**
+         * @brief getHessianType
+         * @return the Hessian type passed to the back-end, see computeHessianType()
+         */
+        OpenSoT::HessianType getHessianType() const {return _hessian_type;}
+
+    protected:
+        virtual void _log(XBot::MatLogger2::Ptr logger, const std::string& prefix);
+
+    private:
+        bool prepareQP(const solver_back_ends be_solver);
+
+        /**
+         * @brief computeCost sums the weighted cost functions of the levels, H and g are recomputed
+         * only if a level or a weight changed
+         */
+        void computeCost();
+
+        /**
+         * @brief computeHessianType computes the Hessian type of H = sum_i w_i H_i (+ regularisation):
+         *  - a single level with weight 1 and no regularisation keeps its Hessian type
+         *  - if all the levels (and the regularisation) share the same type it is kept, but HST_IDENTITY which
+         *    becomes HST_POSDEF
+         *  - HST_SEMIDEF otherwise
+         * @return the Hessian type passed to the back-end
+         */
+        OpenSoT::HessianType computeHessianType() const;
+
+        /**
+         * @brief checkWeights
+         * @return false if the weights are negative or change the weight of a single level with identity Hessian
+         */
+        bool checkWeights(const std::vector<double>& level_weights) const;
+
+        std::vector<double> _level_weights;
+        bool _weights_changed;
+        double _epsRegularisation;
+        solver_back_ends _be_solver;
+
+        /**
+         * @brief _cost_functions cached cost function of each level
+         */
+        std::vector<CostFunctionCache> _cost_functions;
+        CostFunctionCache _regularisation_cost_function;
+        TaskPtr _regularisation_task;
+
+        /**
+         * @brief _constraints constraints of all the levels, global constraints and bounds
+         */
+        std::shared_ptr<OpenSoT::constraints::Aggregated> _constraints;
+
+        BackEnd::Ptr _back_end;
+
+        /**
+         * @brief _hessian_type Hessian type passed to the back-end
+         */
+        OpenSoT::HessianType _hessian_type;
+
+        Eigen::MatrixXd _H;
+        Eigen::VectorXd _g;
+    };
+
+    }
+}
+
+#endif
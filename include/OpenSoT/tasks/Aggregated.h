@@ -23,6 +23,7 @@
 #include <memory>
 #include <list>
 #include <OpenSoT/utils/Piler.h>
+#include <OpenSoT/utils/ThreadPool.h>
 
 using namespace OpenSoT::utils;
 
@@ -58,6 +59,32 @@ using namespace OpenSoT::utils;
 
             unsigned int _aggregationPolicy;
 
+            /**
+             * @brief _generated_tasks and _generated_versions store the tasks, and their versions,
+             * used the last time A, b, c and W have been piled
+             */
+            std::vector< TaskPtr > _generated_tasks;
+            std::vector< unsigned int > _generated_versions;
+
+            /**
+             * @brief _force_generation is set when A has been modified by the Task (deactivation or active joints mask)
+             * and needs to be piled again even if none of the tasks changed
+             */
+            bool _force_generation;
+
+            /**
+             * @brief _thread_pool if set, the tasks are updated in parallel
+             */
+            ThreadPool::Ptr _thread_pool;
+            std::vector< TaskPtr > _parallel_tasks;
+
+            /**
+             * @brief isChanged checks if any of the tasks changed since the last time A, b, c and W have been piled,
+             * storing the actual versions
+             * @return true if A, b, c and W need to be piled again
+             */
+            bool isChanged();
+
             void generateAll();
 
             void generateConstraints();
@@ -190,6 +217,26 @@ using namespace OpenSoT::utils;
 
             const std::list< TaskPtr >& getTaskList() { return _tasks; }
 
+            /**
+             * @brief setThreadPool enables the parallel update of the aggregated tasks: the update() of all the tasks
+             * is distributed among the workers of the pool and joined before the tasks are piled.
+             * NOTE: a task is updated by a single worker together with its constraints, the pool is refused if two
+             * tasks read from the same model (see Task::getModels()) since the model is not safe to be read
+             * concurrently, the check is done here so the list of tasks must not change after this call
+             * @param thread_pool a pool of workers, nullptr to get back to the serial update
+             * @return false if two tasks share a model, the update stays serial
+             */
+            bool setThreadPool(ThreadPool::Ptr thread_pool);
+
+            void getModels(std::vector<const XBot::ModelInterface*>& models) const override;
+
+            /**
+             * @brief setActiveJointsMask set a mask on the Jacobian. The changes take effect immediately.
+             * @param active_joints_mask
+             * @return true if success
+             */
+            bool setActiveJointsMask(const std::vector<bool>& active_joints_mask);
+
             /**
              * @brief setLambda set the lambda to ALL the aggregated tasks to the same value lambda.
              * The lambda associated to the Aggregate and the lambda associated to the tasks are different if a
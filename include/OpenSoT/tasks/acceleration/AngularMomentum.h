@@ -45,6 +45,8 @@ namespace OpenSoT {
        public:
            typedef std::shared_ptr<AngularMomentum> Ptr;
 
+           void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
        private:
            XBot::ModelInterface& _robot;
 
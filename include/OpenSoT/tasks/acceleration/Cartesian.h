@@ -33,6 +33,8 @@ namespace OpenSoT { namespace tasks { namespace acceleration {
         
         typedef std::shared_ptr<Cartesian> Ptr;
 
+        void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
         Cartesian(const std::string task_id,
                   const XBot::ModelInterface& robot,
                   const std::string& distal_link,
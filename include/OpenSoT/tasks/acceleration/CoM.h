@@ -35,6 +35,8 @@ namespace OpenSoT { namespace tasks { namespace acceleration {
 
         typedef std::shared_ptr<CoM> Ptr;
 
+        void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
         /**
          * @brief CoM
          * @param robot the robot model
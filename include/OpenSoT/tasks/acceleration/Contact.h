@@ -32,6 +32,8 @@ namespace OpenSoT { namespace tasks { namespace acceleration {
         
         typedef std::shared_ptr<Contact> Ptr;
 
+        void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
         Contact(const std::string& task_id,
                 const XBot::ModelInterface& robot,
                 const std::string& contact_link,
@@ -24,6 +24,8 @@ namespace OpenSoT {
 
             typedef std::shared_ptr<DynamicFeasibility> Ptr;
 
+            void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
             /**
              * @brief DynamicFeasibility constructor
              * @param task_id id
@@ -14,6 +14,8 @@ namespace OpenSoT { namespace tasks { namespace acceleration {
     public:
         typedef std::shared_ptr<MinJointVel> Ptr;
 
+        void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
         /**
          * @brief MinJointVel
          * @param robot
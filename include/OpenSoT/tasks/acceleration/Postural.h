@@ -37,6 +37,8 @@ namespace OpenSoT { namespace tasks { namespace acceleration {
     public:
         
         typedef std::shared_ptr<Postural> Ptr;
+
+        void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
         
         Postural(const XBot::ModelInterface& robot,
                  AffineHelper qddot, const std::string task_id = "Postural");
@@ -33,6 +33,8 @@ namespace OpenSoT{
             public:
                 typedef std::shared_ptr<Contact> Ptr;
 
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
                 /**
                  * @brief Contact constructor which accept a robot model, a link name which represent
                  * the link in contact and a contact matrix (default is Identity)
@@ -32,6 +32,9 @@ namespace OpenSoT{
         class IMU: public OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>{
             public:
                 typedef std::shared_ptr<IMU> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
             /**
                  * @brief IMU accept a robot model and an imu, throws an error if the imu is
                  * not attached to the floating_base
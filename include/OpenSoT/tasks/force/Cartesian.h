@@ -19,6 +19,8 @@ namespace OpenSoT { namespace tasks { namespace force {
   public:
   
     typedef std::shared_ptr<Cartesian> Ptr;
+
+    void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
     
       /**
      * @brief Cartesian
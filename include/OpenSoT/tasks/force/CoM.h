@@ -44,6 +44,8 @@
             public:
                 
                 typedef std::shared_ptr<CoM> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
                 
             private:
                 
@@ -32,6 +32,8 @@ namespace OpenSoT {
             public:
             typedef std::shared_ptr<FloatingBase> Ptr;
 
+            void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_model); }
+
             /**
              * @brief FloatingBase constructor
              * @param model of the robot
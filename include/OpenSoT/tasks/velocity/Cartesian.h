@@ -47,6 +47,8 @@
             public:
                 
                 typedef std::shared_ptr<Cartesian> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
                 
             protected:
                 
@@ -40,6 +40,9 @@
             class CoM : public Task < Eigen::MatrixXd, Eigen::VectorXd > {
             public:
                 typedef std::shared_ptr<CoM> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
             private:
                 XBot::ModelInterface& _robot;
 
@@ -33,6 +33,8 @@ public:
 
     typedef std::shared_ptr<Contact> Ptr;
 
+    void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_model); }
+
     Contact(std::string task_id,
             const XBot::ModelInterface& model,
             std::string link_name,
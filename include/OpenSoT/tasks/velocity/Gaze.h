@@ -41,6 +41,8 @@ class Gaze: public OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>
 public:
     typedef std::shared_ptr<Gaze> Ptr;
 
+    void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
     Gaze(std::string task_id,
          XBot::ModelInterface &robot,
          std::string base_link,
@@ -155,6 +155,8 @@ namespace OpenSoT {
         public:
            typedef std::shared_ptr<JointAdmittance> Ptr;
 
+           void getModels(std::vector<const XBot::ModelInterface*>& models) const override { Postural::getModels(models); models.push_back(&_model); }
+
            /**
             * @brief JointAdmittance constructor
             * @param robot is updated with the actual measurements from the robot (used to cpmuted the non-linear terms \f$ \mathbf{h} \f$)
@@ -43,6 +43,8 @@ namespace OpenSoT {
        public:
            typedef std::shared_ptr<LinearMomentum> Ptr;
 
+           void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
        private:
            XBot::ModelInterface& _robot;
 
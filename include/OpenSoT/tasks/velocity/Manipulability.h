@@ -41,6 +41,8 @@ namespace OpenSoT {
             public:
                 typedef std::shared_ptr<Manipulability> Ptr;
 
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_model); }
+
                 Manipulability(const XBot::ModelInterface& robot_model, const Cartesian::Ptr CartesianTask, const double step = 1E-3);
                 Manipulability(const XBot::ModelInterface& robot_model, const CoM::Ptr CartesianTask, const double step = 1E-3);
 
@@ -138,21 +140,29 @@ namespace OpenSoT {
                         return computeManipulabilityIndex();
                     }
 
-                    void setW(const Eigen::MatrixXd& W) { _W = W; }
+                    void setW(const Eigen::MatrixXd& W) { _W = W; increaseVersion(); }
 
                     const Eigen::MatrixXd& getW() const {return _W;}
 
                     double computeManipulabilityIndex()
                     {
-                        Eigen::MatrixXd J = _CartesianTask->getA();
+                        const Eigen::MatrixXd& J = _CartesianTask->getA();
+                        _JW.noalias() = J*_W;
+                        _JWJt.noalias() = _JW*J.transpose();
+                        _lu.compute(_JWJt);
                         //fabs is to avoid nan when we have -1e-18!
-                        return sqrt(fabs((J*_W*J.transpose()).determinant()));
+                        return sqrt(fabs(_lu.determinant()));
                     }
+
+                private:
+                    Eigen::MatrixXd _JW, _JWJt;
+                    Eigen::PartialPivLU<Eigen::MatrixXd> _lu;
                 };
 
                 double _step;
                 Eigen::VectorXd _gradient;
                 Eigen::VectorXd _deltas;
+                Eigen::VectorXd _q_step;
 
                 ComputeManipulabilityIndexGradient _manipulabilityIndexGradientWorker;
             };
@@ -41,6 +41,9 @@
             class MinimumEffort : public Task < Eigen::MatrixXd, Eigen::VectorXd > {
             public:
                 typedef std::shared_ptr<MinimumEffort> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_model); }
+
             protected:
                 const XBot::ModelInterface& _model;
                 Eigen::VectorXd _q;
@@ -92,18 +95,23 @@
                         _robot->update();
 
                         _robot->computeGravityCompensation(_tau);
-                        return _tau.transpose()* _W * _tau;
+                        _tauW.noalias() = _tau.transpose()* _W;
+                        return _tauW.dot(_tau);
                     }
 
-                    void setW(const Eigen::MatrixXd& W) { _W = W; }
+                    void setW(const Eigen::MatrixXd& W) { _W = W; increaseVersion(); }
 
                     const Eigen::MatrixXd& getW() const {return _W;}
+
+                    private:
+                    Eigen::RowVectorXd _tauW;
                 };
 
                 ComputeGTauGradient _gTauGradientWorker;
                 double _step;
                 Eigen::VectorXd _gradient;
                 Eigen::VectorXd _deltas;
+                Eigen::VectorXd _q_step;
 
             public:
 
@@ -32,6 +32,9 @@
             class Postural : public Task < Eigen::MatrixXd, Eigen::VectorXd > {
             public:
                 typedef std::shared_ptr<Postural> Ptr;
+
+                void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_robot); }
+
             protected:
                 Eigen::VectorXd _q_desired;
                 Eigen::VectorXd _dq;
@@ -33,6 +33,8 @@ namespace OpenSoT { namespace tasks { namespace velocity {
     public:
         
         typedef std::shared_ptr<PureRolling> Ptr;
+
+        void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(&_model); }
         
         PureRolling(std::string wheel_link_name, 
                     double radius,
@@ -69,6 +71,8 @@ namespace OpenSoT { namespace tasks { namespace velocity {
     public:
         typedef std::shared_ptr<PureRollingPosition> Ptr;
 
+        void getModels(std::vector<const XBot::ModelInterface*>& models) const override { _pure_rolling->getModels(models); }
+
         PureRollingPosition(std::string wheel_link_name,
                     double radius,
                     const XBot::ModelInterface& model,
@@ -94,6 +98,8 @@ namespace OpenSoT { namespace tasks { namespace velocity {
     public:
         typedef std::shared_ptr<PureRollingOrientation> Ptr;
 
+        void getModels(std::vector<const XBot::ModelInterface*>& models) const override { _pure_rolling->getModels(models); }
+
         PureRollingOrientation(std::string wheel_link_name,
                     double radius,
                     const XBot::ModelInterface& model);
@@ -47,6 +47,10 @@ namespace OpenSoT {
 
             OpenSoT::constraints::Aggregated::Ptr _boundsAggregated;
 
+            ThreadPool::Ptr _thread_pool;
+
+            SolverStatistics::Ptr _statistics;
+
             std::vector<OpenSoT::solvers::iHQP::TaskPtr> flattenTask(
                     OpenSoT::solvers::iHQP::TaskPtr task);
         public:
@@ -104,6 +108,32 @@ namespace OpenSoT {
 
             OpenSoT::constraints::Aggregated::ConstraintPtr getBounds();
 
+            /**
+             * @brief setThreadPool enables the parallel update of the stack: the pool is passed to the bounds and to
+             * all the Aggregated levels of the stack (and regularisation), so that the tasks and the constraints
+             * of each of them are updated in parallel before being aggregated.
+             * NOTE: a model is not safe to be read concurrently, so an Aggregated whose tasks (or constraints) share
+             * a model keeps the serial update, see tasks::Aggregated::setThreadPool(). Tasks and constraints must
+             * not share any other data either, e.g. the same constraint object added to two different tasks of the
+             * same level
+             * @param thread_pool a pool of workers, nullptr to get back to the serial update
+             * @return false if any of the Aggregated refused the pool
+             */
+            bool setThreadPool(ThreadPool::Ptr thread_pool);
+
+            ThreadPool::Ptr getThreadPool(){ return _thread_pool; }
+
+            /**
+             * @brief setStatistics records the time spent inside update() into the current record of the statistics:
+             * the total time, the time spent to update the bounds and, for each level, the time spent to update its task.
+             * The same object should be passed to the solver (Solver::setStatistics()) which commits the record at the
+             * end of solve()
+             * @param statistics, nullptr to disable
+             */
+            void setStatistics(SolverStatistics::Ptr statistics){ _statistics = statistics; }
+
+            SolverStatistics::Ptr getStatistics(){ return _statistics; }
+
             OpenSoT::solvers::iHQP::TaskPtr getTask(const std::string& task_id);
     };
 
@@ -0,0 +1,127 @@
+#ifndef _OPENSOT_UTILS_BATCH_SOLVER_H_
+#define _OPENSOT_UTILS_BATCH_SOLVER_H_
+
+#include <OpenSoT/Solver.h>
+#include <OpenSoT/utils/AutoStack.h>
+#include <OpenSoT/utils/ThreadPool.h>
+#include <xbot2_interface/xbotinterface2.h>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace OpenSoT { namespace utils {
+    /**
+     * @brief The BatchSolver class solves in parallel a batch of independent problems (e.g. N joint configurations
+     * with their references), as needed by offline tools such as reachability maps, IK seeding or dataset generation.
+     *
+     * Tasks and constraints depend on the model they are created with, therefore the BatchSolver does not copy them:
+     * a user provided factory is called (serially, in the constructor) once per instance and returns a Problem,
+     * i.e. a model (usually obtained through model->clone()), the AutoStack created on it and the solver
+     * (e.g. an iHQP with the desired back-end from the BackEndFactory).
+     * Each instance is used by a single thread at a time, the problems of the batch are distributed
+     * among the instances through a utils::ThreadPool.
+     *
+     * NOTE: instances are reused for several problems of the batch, hence the back-ends are warm-started
+     * with the solution of the previous problem solved by the same instance.
+     */
+    class BatchSolver {
+    public:
+        typedef std::shared_ptr<BatchSolver> Ptr;
+        typedef OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd> SolverType;
+
+        /**
+         * @brief The Problem struct contains the objects owned by a single instance
+         */
+        struct Problem {
+            typedef std::shared_ptr<Problem> Ptr;
+
+            /**
+             * @brief model used by the tasks and constraints of the stack, can be nullptr if
+             * the problems are not set through joint configurations
+             */
+            XBot::ModelInterface::Ptr model;
+            OpenSoT::AutoStack::Ptr stack;
+            SolverType::SolverPtr solver;
+        };
+
+        /**
+         * @brief ProblemFactory creates the i-th instance
+         */
+        typedef std::function<Problem::Ptr(const unsigned int instance)> ProblemFactory;
+
+        /**
+         * @brief SetupFunction sets the i-th problem of the batch in the given instance
+         */
+        typedef std::function<void(Problem& problem, const unsigned int i)> SetupFunction;
+
+        /**
+         * @brief The Status enum is the outcome of a single problem of the batch
+         */
+        enum class Status {
+            SUCCESS = 0,
+            SOLVE_FAILED,
+            INVALID_INPUT,
+            EXCEPTION
+        };
+
+        /**
+         * @brief BatchSolver constructor
+         * @param number_of_instances number of problems solved concurrently
+         * (number_of_instances - 1 threads are created, the calling thread of solve() takes part to the computation)
+         * @param factory called once per instance
+         * @param cpus if not empty, threads are pinned to these cpus, see utils::ThreadPool
+         * @throw std::invalid_argument if number_of_instances is 0 or the factory returns an incomplete Problem
+         */
+        BatchSolver(const unsigned int number_of_instances, const ProblemFactory& factory,
+                    const std::vector<int>& cpus = std::vector<int>());
+
+        BatchSolver(const BatchSolver&) = delete;
+        BatchSolver& operator=(const BatchSolver&) = delete;
+
+        /**
+         * @brief solve solves a batch of problems, for each problem:
+         *  setup(problem, i) -> problem.stack->update() -> problem.solver->solve(solutions[i])
+         * @param number_of_problems size of the batch
+         * @param setup sets the i-th problem (model state, references...)
+         * @param solutions resized to number_of_problems
+         * @param status resized to number_of_problems, exceptions thrown while setting or solving the i-th
+         * problem are reported as Status::EXCEPTION
+         */
+        void solve(const unsigned int number_of_problems, const SetupFunction& setup,
+                   std::vector<Eigen::VectorXd>& solutions, std::vector<Status>& status);
+
+        /**
+         * @brief solve solves a batch of joint configurations, for each configuration:
+         *  problem.model->setJointPosition(q[i]) -> problem.model->update() -> set_references(problem, i) ->
+         *  problem.stack->update() -> problem.solver->solve(solutions[i])
+         * @param q joint configurations, configurations of wrong size are reported as Status::INVALID_INPUT
+         * @param solutions resized to q.size()
+         * @param status resized to q.size()
+         * @param set_references optional, sets the references of the i-th problem
+         * @throw std::runtime_error if the instances do not have a model
+         */
+        void solve(const std::vector<Eigen::VectorXd>& q,
+                   std::vector<Eigen::VectorXd>& solutions, std::vector<Status>& status,
+                   const SetupFunction& set_references = SetupFunction());
+
+        /**
+         * @brief getNumberOfInstances
+         * @return number of instances
+         */
+        unsigned int getNumberOfInstances() const {return _problems.size();}
+
+        /**
+         * @brief getProblem
+         * @param instance index of the instance
+         * @return the Problem of the instance
+         */
+        Problem& getProblem(const unsigned int instance);
+
+    private:
+        std::vector<Problem::Ptr> _problems;
+        ThreadPool _thread_pool;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef _OPENSOT_UTILS_COST_FUNCTION_CACHE_H_
+#define _OPENSOT_UTILS_COST_FUNCTION_CACHE_H_
+
+#include <Eigen/Dense>
+
+namespace OpenSoT { namespace utils {
+    /**
+     * @brief The CostFunctionCache class assembles the quadratic cost associated to a weighted task:
+     *
+     *          H = A'WA
+     *          g = -A'Wb + c
+     *
+     * H, g and the classification of the weight (identity, diagonal or dense) are recomputed only when the version
+     * of the task, which covers also the changes of the weight, changed since the last call.
+     * The Gram matrix is assembled through a symmetric rank update on A, without storing A transposed.
+     * All the memory is allocated the first time (or when the sizes change), then the computation is real-time safe.
+     */
+    class CostFunctionCache {
+
+    public:
+        enum class WeightType{
+            IDENTITY,
+            DIAGONAL,
+            DENSE
+        };
+
+        /**
+         * @brief CostFunctionCache constructor, the cache starts invalid
+         */
+        CostFunctionCache();
+
+        /**
+         * @brief compute H and g if the version changed since the last call
+         * @param A task matrix
+         * @param b task vector
+         * @param W task weight
+         * @param c linear term
+         * @param version of the task, incremented each time A, b, W or c change
+         * @return true if H and g have been recomputed, false if the cached values are still valid
+         */
+        bool compute(const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+                     const Eigen::MatrixXd& W, const Eigen::VectorXd& c,
+                     const unsigned int version);
+
+        /**
+         * @brief invalidate forces the recomputation of H and g at the next call of compute()
+         */
+        void invalidate(){_valid = false;}
+
+        /**
+         * @brief getH
+         * @return the Hessian of the cost function
+         */
+        const Eigen::MatrixXd& getH() const {return _H;}
+
+        /**
+         * @brief getg
+         * @return the gradient of the cost function
+         */
+        const Eigen::VectorXd& getg() const {return _g;}
+
+        /**
+         * @brief getWeightType
+         * @return the classification of the last used weight
+         */
+        WeightType getWeightType() const {return _weight_type;}
+
+    private:
+        bool _valid;
+        unsigned int _version;
+        WeightType _weight_type;
+
+        Eigen::MatrixXd _H;
+        Eigen::VectorXd _g;
+
+        Eigen::VectorXd _sqrt_w;
+        Eigen::MatrixXd _WA;
+        Eigen::VectorXd _Wb;
+
+        void classifyWeight(const Eigen::MatrixXd& W);
+    };
+
+} }
+
+inline OpenSoT::utils::CostFunctionCache::CostFunctionCache():
+    _valid(false),
+    _version(0),
+    _weight_type(WeightType::IDENTITY)
+{
+
+}
+
+inline void OpenSoT::utils::CostFunctionCache::classifyWeight(const Eigen::MatrixXd& W)
+{
+    if(W.isIdentity())
+        _weight_type = WeightType::IDENTITY;
+    else if(W.isDiagonal() && (W.diagonal().array() >= 0.).all())
+    {
+        _weight_type = WeightType::DIAGONAL;
+        _sqrt_w = W.diagonal().cwiseSqrt();
+    }
+    else
+        _weight_type = WeightType::DENSE;
+}
+
+inline bool OpenSoT::utils::CostFunctionCache::compute(const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+                                                       const Eigen::MatrixXd& W, const Eigen::VectorXd& c,
+                                                       const unsigned int version)
+{
+    if(_valid && version == _version)
+        return false;
+    _version = version;
+
+    classifyWeight(W);
+
+    const int x_size = c.size();
+    _H.setZero(x_size, x_size);
+
+    if(A.size() == 0)
+    {
+        _g = c;
+        _valid = true;
+        return true;
+    }
+
+    switch(_weight_type)
+    {
+    case WeightType::IDENTITY:
+        _H.selfadjointView<Eigen::Lower>().rankUpdate(A.transpose());
+        _g.noalias() = -1.0 * A.transpose() * b;
+        break;
+    case WeightType::DIAGONAL:
+        _WA.noalias() = _sqrt_w.asDiagonal() * A;
+        _H.selfadjointView<Eigen::Lower>().rankUpdate(_WA.transpose());
+        _Wb.noalias() = W.diagonal().asDiagonal() * b;
+        _g.noalias() = -1.0 * A.transpose() * _Wb;
+        break;
+    case WeightType::DENSE:
+        _WA.noalias() = W * A;
+        _H.triangularView<Eigen::Lower>() = A.transpose() * _WA;
+        _Wb.noalias() = W * b;
+        _g.noalias() = -1.0 * A.transpose() * _Wb;
+        break;
+    }
+    _H = _H.selfadjointView<Eigen::Lower>();
+    _g += c;
+
+    _valid = true;
+    return true;
+}
+
+#endif
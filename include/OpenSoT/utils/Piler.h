@@ -8,16 +8,22 @@ using XBot::Logger;
 
 namespace OpenSoT { namespace utils {
     /**
-     * @brief The MatrixPiler class implements real-time safe matrix/vector piling
+     * @brief The BasicMatrixPiler class implements real-time safe matrix/vector piling
+     * @tparam StorageOrder storage order of the piled matrix (Eigen::ColMajor or Eigen::RowMajor), in row-major
+     * order the piled rows are contiguous in memory and can be passed to solvers which want row-major data
+     * without copies
      */
-    class MatrixPiler {
+    template <int StorageOrder = Eigen::ColMajor>
+    class BasicMatrixPiler {
         
     public:
+        typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, StorageOrder> MatrixType;
+
         /**
-         * @brief MatrixPiler constructor, the matrix starts with 0 rows
+         * @brief BasicMatrixPiler constructor, the matrix starts with 0 rows
          * @param cols number of columns
          */
-        MatrixPiler(const int cols = 0);
+        BasicMatrixPiler(const int cols = 0);
         
         /**
          * @brief reset the number of rows of the matrix to 0
@@ -29,6 +35,13 @@ namespace OpenSoT { namespace utils {
          * @param cols new nnumber of columns
          */
         void reset(const int cols);
+
+        /**
+         * @brief rewind moves back the number of rows of the matrix, the first rows are left untouched
+         * so that new rows can be piled in place after them
+         * @param rows number of rows to keep
+         */
+        void rewind(const int rows);
         
         template <typename Derived>
         /**
@@ -48,7 +61,7 @@ namespace OpenSoT { namespace utils {
          * @brief generate_and_get
          * @return the actual matrix
          */
-        Eigen::Block<Eigen::MatrixXd> generate_and_get();
+        Eigen::Block<MatrixType> generate_and_get();
 
         /**
          * @brief cols
@@ -82,24 +95,36 @@ namespace OpenSoT { namespace utils {
         int _cols;
         int _current_row;
         
-        Eigen::MatrixXd _mat;
+        MatrixType _mat;
         
     };
+
+    /**
+     * @brief MatrixPiler piles in column-major order
+     */
+    typedef BasicMatrixPiler<Eigen::ColMajor> MatrixPiler;
+
+    /**
+     * @brief RowMajorMatrixPiler piles in row-major order
+     */
+    typedef BasicMatrixPiler<Eigen::RowMajor> RowMajorMatrixPiler;
     
 } }
 
 
 
 
-inline OpenSoT::utils::MatrixPiler::MatrixPiler(const int cols):
+template <int StorageOrder>
+inline OpenSoT::utils::BasicMatrixPiler<StorageOrder>::BasicMatrixPiler(const int cols):
     _cols(cols),
     _current_row(0)
 {
     _mat.resize(0, _cols);
 }
 
+template <int StorageOrder>
 template <typename Derived>
-inline void OpenSoT::utils::MatrixPiler::pile(const Eigen::MatrixBase<Derived>& matrix)
+inline void OpenSoT::utils::BasicMatrixPiler<StorageOrder>::pile(const Eigen::MatrixBase<Derived>& matrix)
 {
     if(matrix.cols() != _cols){
         throw std::runtime_error("matrix.cols() != _cols");
@@ -119,8 +144,9 @@ inline void OpenSoT::utils::MatrixPiler::pile(const Eigen::MatrixBase<Derived>&
 }
 
 
+template <int StorageOrder>
 template <typename Derived>
-inline void OpenSoT::utils::MatrixPiler::set(const Eigen::MatrixBase<Derived>& matrix)
+inline void OpenSoT::utils::BasicMatrixPiler<StorageOrder>::set(const Eigen::MatrixBase<Derived>& matrix)
 {
     if(_cols == matrix.cols())
     {
@@ -136,12 +162,14 @@ inline void OpenSoT::utils::MatrixPiler::set(const Eigen::MatrixBase<Derived>& m
 
 }
 
-inline void OpenSoT::utils::MatrixPiler::reset()
+template <int StorageOrder>
+inline void OpenSoT::utils::BasicMatrixPiler<StorageOrder>::reset()
 {
     _current_row = 0;
 }
 
-inline void OpenSoT::utils::MatrixPiler::reset(const int cols)
+template <int StorageOrder>
+inline void OpenSoT::utils::BasicMatrixPiler<StorageOrder>::reset(const int cols)
 {
     if(_cols == cols)
         reset();
@@ -153,7 +181,19 @@ inline void OpenSoT::utils::MatrixPiler::reset(const int cols)
     }
 }
 
-inline Eigen::Block<Eigen::MatrixXd> OpenSoT::utils::MatrixPiler::generate_and_get()
+template <int StorageOrder>
+inline void OpenSoT::utils::BasicMatrixPiler<StorageOrder>::rewind(const int rows)
+{
+    if(rows < 0 || rows > _current_row){
+        throw std::runtime_error("rows < 0 || rows > _current_row");
+    }
+
+    _current_row = rows;
+}
+
+template <int StorageOrder>
+inline Eigen::Block<typename OpenSoT::utils::BasicMatrixPiler<StorageOrder>::MatrixType>
+OpenSoT::utils::BasicMatrixPiler<StorageOrder>::generate_and_get()
 {
 //    if(_current_row != _mat.rows()){
 //        _mat.conservativeResize(_current_row, _cols);
@@ -0,0 +1,170 @@
+#ifndef _OPENSOT_UTILS_SOLVER_STATISTICS_H_
+#define _OPENSOT_UTILS_SOLVER_STATISTICS_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include <matlogger2/matlogger2.h>
+
+/**
+ * @brief OPENSOT_STATISTICS_MAX_LEVELS maximum number of priority levels recorded for each tick
+ */
+#ifndef OPENSOT_STATISTICS_MAX_LEVELS
+#define OPENSOT_STATISTICS_MAX_LEVELS 16
+#endif
+
+namespace OpenSoT { namespace utils {
+
+    /**
+     * @brief The LevelStatistics struct contains the timings of a single priority level (times are in seconds)
+     */
+    struct LevelStatistics {
+        /**
+         * @brief update_time time spent to update the task of the level (AutoStack::update())
+         */
+        double update_time = 0.;
+        /**
+         * @brief cost_time time spent to assemble the cost function
+         */
+        double cost_time = 0.;
+        /**
+         * @brief constraints_time time spent to aggregate and pile the constraints
+         */
+        double constraints_time = 0.;
+        /**
+         * @brief back_end_time time spent inside the back-end (update and solve)
+         */
+        double back_end_time = 0.;
+        /**
+         * @brief back_end_solve_time time spent inside BackEnd::solve() (or BackEnd::initProblem() at the first
+         * call), part of back_end_time
+         */
+        double back_end_solve_time = 0.;
+        /**
+         * @brief iterations number of iterations of the back-end, -1 if not available
+         */
+        int iterations = -1;
+        /**
+         * @brief success return status of the back-end
+         */
+        bool success = false;
+    };
+
+    /**
+     * @brief The TickStatistics struct contains the timings of a single control tick (times are in seconds)
+     */
+    struct TickStatistics {
+        /**
+         * @brief tick counter of the recorded ticks
+         */
+        unsigned long tick = 0;
+        /**
+         * @brief update_time time spent to update the tasks and constraints (AutoStack::update())
+         */
+        double update_time = 0.;
+        /**
+         * @brief bounds_update_time time spent to update the bounds (AutoStack::update()), part of update_time
+         */
+        double bounds_update_time = 0.;
+        /**
+         * @brief solve_time total time spent inside Solver::solve()
+         */
+        double solve_time = 0.;
+        /**
+         * @brief success return value of Solver::solve()
+         */
+        bool success = false;
+        /**
+         * @brief number_of_levels number of valid entries in levels
+         */
+        unsigned int number_of_levels = 0;
+        LevelStatistics levels[OPENSOT_STATISTICS_MAX_LEVELS];
+    };
+
+    /**
+     * @brief The SolverStatistics class records per-tick and per-level timings of Solvers, BackEnds and AutoStack.
+     *
+     * The real-time thread fills the current() record (through the solvers and the AutoStack) and pushes it into a
+     * lock-free single-producer/single-consumer ring buffer with commit(). A non real-time thread can drain the
+     * buffer using pop() or dump it through a MatLogger2 using log(). If the buffer is full the new records are
+     * dropped and counted.
+     * No memory is allocated after construction by the producer side.
+     */
+    class SolverStatistics {
+
+    public:
+        typedef std::shared_ptr<SolverStatistics> Ptr;
+        typedef std::chrono::steady_clock clock;
+
+        /**
+         * @brief SolverStatistics constructor
+         * @param capacity maximum number of ticks stored in the ring buffer
+         */
+        SolverStatistics(const unsigned int capacity = 1000);
+
+        /**
+         * @brief current record, filled by the producer during the tick
+         * @return reference to the current record
+         */
+        TickStatistics& current(){return _current;}
+
+        /**
+         * @brief level of the current record, levels exceeding OPENSOT_STATISTICS_MAX_LEVELS are recorded in the last one
+         * @param i level
+         * @return reference to the i-th level of the current record
+         */
+        LevelStatistics& level(const unsigned int i);
+
+        /**
+         * @brief commit pushes the current record into the ring buffer and resets it (called by the producer)
+         * @return false if the buffer was full and the record has been dropped
+         */
+        bool commit();
+
+        /**
+         * @brief pop the oldest record from the ring buffer (called by the consumer)
+         * @param stats the popped record
+         * @return false if the buffer is empty
+         */
+        bool pop(TickStatistics& stats);
+
+        /**
+         * @brief getDroppedTicks
+         * @return the number of records dropped since the buffer was full
+         */
+        unsigned long getDroppedTicks() const {return _dropped;}
+
+        /**
+         * @brief log drains the ring buffer into a logger (called by the consumer)
+         * @param logger a pointer to a MatLogger
+         * @param prefix used to log variables
+         */
+        void log(XBot::MatLogger2::Ptr logger, const std::string& prefix = "");
+
+        /**
+         * @brief elapsed
+         * @param start time point
+         * @return the seconds elapsed from start
+         */
+        static double elapsed(const clock::time_point& start)
+        {
+            return std::chrono::duration<double>(clock::now() - start).count();
+        }
+
+    private:
+        TickStatistics _current;
+        unsigned long _tick;
+
+        std::vector<TickStatistics> _buffer;
+        std::atomic<unsigned int> _head;
+        std::atomic<unsigned int> _tail;
+        std::atomic<unsigned long> _dropped;
+
+        std::vector<std::string> _level_names;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef _OPENSOT_UTILS_THREAD_POOL_H_
+#define _OPENSOT_UTILS_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace OpenSoT { namespace utils {
+    /**
+     * @brief The ThreadPool class implements a persistent pool of workers used to run in parallel
+     * a set of independent jobs (e.g. the update() of the tasks inside an Aggregated).
+     *
+     * Threads are created (and eventually pinned to cpus) in the constructor, run() does not allocate memory:
+     * the jobs are distributed through an atomic counter among the workers and the calling thread,
+     * which also takes part to the computation, and run() returns when all the jobs are done.
+     *
+     * run() called while the pool is already running (e.g. from inside a job) executes the jobs serially
+     * in the calling thread.
+     *
+     * NOTE: jobs are executed concurrently, hence they must not write shared data. Tasks and constraints sharing
+     * the same model can be updated in parallel as long as they only read from it (the model has to be updated
+     * before).
+     */
+    class ThreadPool {
+
+    public:
+        typedef std::shared_ptr<ThreadPool> Ptr;
+
+        /**
+         * @brief ThreadPool constructor
+         * @param number_of_threads number of workers, the calling thread of run() is not counted
+         * @param cpus if not empty, the i-th worker is pinned to the cpus[i % cpus.size()] cpu
+         */
+        ThreadPool(const unsigned int number_of_threads, const std::vector<int>& cpus = std::vector<int>());
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        template <typename Function>
+        /**
+         * @brief run executes job(i) for i = 0, ..., number_of_jobs - 1 and returns when all of them are done
+         * @param number_of_jobs number of jobs
+         * @param job callable with signature void(const unsigned int i), it is not copied
+         * @throw the first exception thrown by one of the jobs
+         */
+        void run(const unsigned int number_of_jobs, Function&& job)
+        {
+            typedef typename std::remove_reference<Function>::type Job;
+            runJobs(number_of_jobs,
+                    [](void* context, const unsigned int i){(*static_cast<Job*>(context))(i);},
+                    const_cast<void*>(static_cast<const void*>(&job)));
+        }
+
+        /**
+         * @brief getNumberOfThreads
+         * @return number of workers
+         */
+        unsigned int getNumberOfThreads() const {return _workers.size();}
+
+    private:
+        typedef void (*JobFunction)(void*, const unsigned int);
+
+        void runJobs(const unsigned int number_of_jobs, JobFunction function, void* context);
+
+        void workerLoop();
+
+        void executeJobs(JobFunction function, void* context, const unsigned int number_of_jobs);
+
+        std::vector<std::thread> _workers;
+
+        std::mutex _mutex;
+        std::condition_variable _start_condition;
+        std::condition_variable _done_condition;
+
+        std::atomic<bool> _running;
+        bool _stop;
+        unsigned long _generation;
+        unsigned int _busy_workers;
+
+        JobFunction _function;
+        void* _context;
+        unsigned int _number_of_jobs;
+        std::atomic<unsigned int> _next_job;
+        std::atomic<unsigned int> _pending_jobs;
+
+        std::exception_ptr _exception;
+    };
+
+} }
+
+#endif
@@ -18,6 +18,7 @@
 #include <OpenSoT/constraints/Aggregated.h>
 
 #include <assert.h>
+#include <map>
 #include <limits>
 #include <sstream>
 
@@ -32,7 +33,7 @@ Aggregated::Aggregated(const std::list<ConstraintPtr> bounds,
                        const unsigned int x_size,
                        const unsigned int aggregationPolicy) :
     Constraint(concatenateConstraintsIds(bounds), x_size),
-               _bounds(bounds), _aggregationPolicy(aggregationPolicy)
+               _bounds(bounds), _aggregationPolicy(aggregationPolicy), _is_generated(false)
 {
     _number_of_bounds = _bounds.size();
     this->checkSizes();
@@ -45,7 +46,7 @@ Aggregated::Aggregated(ConstraintPtr bound1,
                        const unsigned int &x_size,
                        const unsigned int aggregationPolicy) :
     Constraint(bound1->getConstraintID() + _CONSTRAINT_PLUS_ + bound2->getConstraintID(),
-               x_size), _aggregationPolicy(aggregationPolicy)
+               x_size), _aggregationPolicy(aggregationPolicy), _is_generated(false)
 {
     _bounds.push_back(bound1);
     _bounds.push_back(bound2);
@@ -57,20 +58,94 @@ Aggregated::Aggregated(ConstraintPtr bound1,
     this->generateAll();
 }
 
+bool Aggregated::setThreadPool(ThreadPool::Ptr thread_pool)
+{
+    _thread_pool.reset();
+
+    if(thread_pool)
+    {
+        /* a model can be read by a single constraint */
+        std::map<const XBot::ModelInterface*, ConstraintPtr> readers;
+        std::vector<const XBot::ModelInterface*> models;
+        for(const auto& bound : _bounds)
+        {
+            models.clear();
+            bound->getModels(models);
+
+            for(const auto model : models)
+            {
+                const auto reader = readers.emplace(model, bound).first;
+                if(reader->second != bound)
+                {
+                    XBot::Logger::error("Aggregated: constraints %s and %s read from the same model and can not be updated in parallel\n",
+                                        reader->second->getConstraintID().c_str(), bound->getConstraintID().c_str());
+                    return false;
+                }
+            }
+        }
+    }
+
+    _thread_pool = thread_pool;
+    return true;
+}
+
+void Aggregated::getModels(std::vector<const XBot::ModelInterface*>& models) const
+{
+    for(const auto& bound : _bounds)
+        bound->getModels(models);
+}
+
 void Aggregated::update() {
-    /* iterating on all bounds.. */
-    for(typename std::list< ConstraintPtr >::iterator i = _bounds.begin();
-        i != _bounds.end(); i++) {
+    if(_thread_pool)
+    {
+        /* the list of constraints can be modified from outside */
+        _parallel_bounds.assign(_bounds.begin(), _bounds.end());
+        _thread_pool->run(_parallel_bounds.size(), [this](const unsigned int i){_parallel_bounds[i]->update();});
+    }
+    else
+    {
+        /* iterating on all bounds.. */
+        for(typename std::list< ConstraintPtr >::iterator i = _bounds.begin();
+            i != _bounds.end(); i++) {
 
-        ConstraintPtr &b = *i;
-        /* update bounds */
-        b->update();
+            ConstraintPtr &b = *i;
+            /* update bounds */
+            b->update();
+        }
     }
 
     this->generateAll();
 }
 
+bool Aggregated::isChanged()
+{
+    bool changed = !_is_generated || _generated_bounds.size() != _bounds.size();
+    _is_generated = true;
+    if(changed)
+    {
+        _generated_bounds.resize(_bounds.size());
+        _generated_versions.resize(_bounds.size());
+    }
+
+    unsigned int j = 0;
+    for(typename std::list< ConstraintPtr >::iterator i = _bounds.begin(); i != _bounds.end(); i++) {
+        const unsigned int version = (*i)->getVersion();
+        if(changed || _generated_bounds[j] != *i || _generated_versions[j] != version)
+        {
+            _generated_bounds[j] = *i;
+            _generated_versions[j] = version;
+            changed = true;
+        }
+        j += 1;
+    }
+    return changed;
+}
+
 void Aggregated::generateAll() {
+    /* nothing to do if no constraint changed since the last call */
+    if(!this->isChanged())
+        return;
+
     /* resetting all internal data */
     _tmpupperBound.reset(1);
     _tmplowerBound.reset(1);
@@ -254,6 +329,7 @@ void Aggregated::generateAll() {
     _bUpperBound = _tmpbUpperBound.generate_and_get();
     _bLowerBound = _tmpbLowerBound.generate_and_get();
 
+    increaseVersion();
 }
 
 void Aggregated::checkSizes()
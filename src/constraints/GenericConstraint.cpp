@@ -65,6 +65,7 @@ bool OpenSoT::constraints::GenericConstraint::setBounds(const Eigen::VectorXd& u
         XBot::Logger::error("Type not defined in setBounds!");
         return false;}
     
+    increaseVersion();
     return true;
 }
 
@@ -65,6 +65,7 @@ void SubConstraint::update()
         generateBound(this->_constraintPtr->getbeq(), this->_beq);
         generateConstraint(this->_constraintPtr->getAeq(), this->_Aeq);
     }
+    increaseVersion();
 }
 
 void SubConstraint::generateConstraint(const Eigen::MatrixXd& A, Eigen::MatrixXd& sub_A)
@@ -67,4 +67,5 @@ void TaskToConstraint::generateAll() {
 
     assert( (_Aineq.rows() == _bLowerBound.rows()) &&
             (_Aineq.rows() == _bUpperBound.rows()));
+    increaseVersion();
 }
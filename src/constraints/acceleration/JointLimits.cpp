@@ -172,7 +172,7 @@ void JointLimits::update()
     _Aineq = _generic_constraint_internal->getAineq();
     _bLowerBound = _generic_constraint_internal->getbLowerBound();
     _bUpperBound = _generic_constraint_internal->getbUpperBound();
-
+    increaseVersion();
 }
 
 void JointLimits::setJointAccMax(const Eigen::VectorXd &jointAccMax)
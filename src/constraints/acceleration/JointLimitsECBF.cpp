@@ -68,6 +68,7 @@ void JointLimitsECBF::update()
     _Aineq = _generic_constraint_internal->getAineq();
     _bLowerBound = _generic_constraint_internal->getbLowerBound();
     _bUpperBound = _generic_constraint_internal->getbUpperBound();
+    increaseVersion();
 }
 
 void JointLimitsECBF::setAlpha1(const Eigen::VectorXd &a1)
@@ -92,6 +92,7 @@ void JointLimitsViability::update()
     _Aineq = _generic_constraint_internal->getAineq();
     _bLowerBound = _generic_constraint_internal->getbLowerBound();
     _bUpperBound = _generic_constraint_internal->getbUpperBound();
+    increaseVersion();
 }
 
 void JointLimitsViability::computeJointAccBounds()
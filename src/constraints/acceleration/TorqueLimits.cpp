@@ -43,6 +43,7 @@ void TorqueLimits::update()
     _Aineq = _dyn_constraint.getM();
     _bLowerBound = -_torque_limits - _h;
     _bUpperBound = _torque_limits - _h;
+    increaseVersion();
 }
 
 bool TorqueLimits::enableContact(const std::string& contact_link)
@@ -61,6 +61,7 @@ void OpenSoT::constraints::acceleration::VelocityLimits::update()
     _Aineq = _generic_constraint_internal->getAineq();
     _bLowerBound = _generic_constraint_internal->getbLowerBound();
     _bUpperBound = _generic_constraint_internal->getbUpperBound();
+    increaseVersion();
 }
 
 void OpenSoT::constraints::acceleration::VelocityLimits::setVelocityLimits(const double qDotLimit)
@@ -66,6 +66,7 @@ void CoP::update()
     _Aineq = _CoP.getM();
     _bUpperBound = -_CoP.getq();
     _bLowerBound = -1.0e20*Eigen::VectorXd::Ones(__A.rows());
+    increaseVersion();
 }
 
 /* CoPs */
@@ -74,7 +75,8 @@ CoPs::CoPs(const std::vector<AffineHelper>& wrench,
            XBot::ModelInterface &robot,
            const std::vector<Eigen::Vector2d>& X_Lims,
            const std::vector<Eigen::Vector2d>& Y_Lims):
-    Constraint("CoPs", wrench[0].getInputSize())
+    Constraint("CoPs", wrench[0].getInputSize()),
+    _internal_version(0)
 {
     std::list<ConstraintPtr> constraint_list;
     for(unsigned int i = 0; i < contact_name.size(); ++i){
@@ -91,7 +93,9 @@ CoPs::CoPs(const std::vector<AffineHelper>& wrench,
 void CoPs::update()
 {
     _internal_constraint->update();
-    generateBounds();
+    /* the bounds are copied only if one of the internal constraints changed */
+    if(_internal_constraint->getVersion() != _internal_version)
+        generateBounds();
 }
 
 void CoPs::generateBounds()
@@ -99,6 +103,8 @@ void CoPs::generateBounds()
     _Aineq = _internal_constraint->getAineq();
     _bUpperBound = _internal_constraint->getbUpperBound();
     _bLowerBound = _internal_constraint->getbLowerBound();
+    _internal_version = _internal_constraint->getVersion();
+    increaseVersion();
 }
 
 
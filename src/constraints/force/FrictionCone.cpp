@@ -69,7 +69,7 @@ namespace OpenSoT {
            _friction_cone = _A * _wrench - _b;
            _Aineq = _friction_cone.getM();
            _bUpperBound = - _friction_cone.getq();
-
+           increaseVersion();
        }
 
        void FrictionCone::setMu(const double mu)
@@ -81,6 +81,7 @@ namespace OpenSoT {
            _friction_cone = _A * _wrench - _b;
            _Aineq = _friction_cone.getM();
            _bUpperBound = - _friction_cone.getq();
+           increaseVersion();
        }
 
        void FrictionCone::setFrictionCone(const friction_cone& frc)
@@ -92,13 +93,15 @@ namespace OpenSoT {
            _friction_cone = _A * _wrench - _b;
            _Aineq = _friction_cone.getM();
            _bUpperBound = - _friction_cone.getq();
+           increaseVersion();
        }
 
        FrictionCones::FrictionCones(const std::vector<std::string>& contact_name,
                     const std::vector<AffineHelper>& wrench,
                     XBot::ModelInterface &robot,
                     const friction_cones & mu):
-           Constraint("friction_cones", wrench[0].getInputSize())
+           Constraint("friction_cones", wrench[0].getInputSize()),
+           _internal_version(0)
        {
            std::list<ConstraintPtr> constraint_list;
            for(unsigned int i = 0; i < contact_name.size(); ++i){
@@ -124,7 +127,9 @@ namespace OpenSoT {
        void FrictionCones::update()
        {
            _internal_constraint->update();
-           generateBounds();
+           /* the bounds are copied only if one of the internal constraints changed */
+           if(_internal_constraint->getVersion() != _internal_version)
+               generateBounds();
        }
 
        void FrictionCones::generateBounds()
@@ -132,6 +137,8 @@ namespace OpenSoT {
            _Aineq = _internal_constraint->getAineq();
            _bUpperBound = _internal_constraint->getbUpperBound();
            _bLowerBound = _internal_constraint->getbLowerBound();
+           _internal_version = _internal_constraint->getVersion();
+           increaseVersion();
        }
 
        }
@@ -48,6 +48,7 @@ void NormalTorque::update()
 
     _constraint = _AAd * _wrench;
     _Aineq = _constraint.getM();
+    increaseVersion();
 }
 
 void NormalTorque::_updateA()
@@ -82,7 +83,8 @@ NormalTorques::NormalTorques(const std::vector<std::string>& contact_name,
                              const std::vector<Eigen::Vector2d> & Xs,
                              const std::vector<Eigen::Vector2d> & Ys,
                              const std::vector<double> & mu):
-    Constraint("NormalTorques", wrench[0].getInputSize())
+    Constraint("NormalTorques", wrench[0].getInputSize()),
+    _internal_version(0)
 {
     std::list<ConstraintPtr> constraint_list;
     for(unsigned int i = 0; i < contact_name.size(); ++i){
@@ -112,7 +114,9 @@ NormalTorque::Ptr NormalTorques::getNormalTorque(const std::string& contact_name
 void NormalTorques::update()
 {
     _internal_constraint->update();
-    generateBounds();
+    /* the bounds are copied only if one of the internal constraints changed */
+    if(_internal_constraint->getVersion() != _internal_version)
+        generateBounds();
 }
 
 void NormalTorques::generateBounds()
@@ -120,6 +124,8 @@ void NormalTorques::generateBounds()
     _Aineq = _internal_constraint->getAineq();
     _bUpperBound = _internal_constraint->getbUpperBound();
     _bLowerBound = _internal_constraint->getbLowerBound();
+    _internal_version = _internal_constraint->getVersion();
+    increaseVersion();
 }
 
 
@@ -30,5 +30,5 @@ void OpenSoT::constraints::force::StaticConstraint::update()
     
     _Aeq = _constr.getM();
     _beq = _gcomp.tail(_robot.getActuatedNv()) - _constr.getq();
-    
+    increaseVersion();
 }
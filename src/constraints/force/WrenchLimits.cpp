@@ -55,7 +55,7 @@ void WrenchLimits::generateBounds()
         _bUpperBound = _constr_internal->getbUpperBound();
         _bLowerBound = _constr_internal->getbLowerBound();
     }
-
+    increaseVersion();
 }
 
 void WrenchLimits::releaseContact(bool released)
@@ -77,7 +77,8 @@ WrenchesLimits::WrenchesLimits(const std::vector<std::string>& contact_name,
                const Eigen::VectorXd& lowerLims,
                const Eigen::VectorXd& upperLims,
                const std::vector<AffineHelper>& wrench):
-    Constraint("wrenches_limits", wrench[0].getInputSize())
+    Constraint("wrenches_limits", wrench[0].getInputSize()),
+    _internal_version(0)
 {
     std::list<ConstraintPtr> constraint_list;
     for(unsigned int i = 0; i < contact_name.size(); ++i){
@@ -96,7 +97,8 @@ WrenchesLimits::WrenchesLimits(const std::vector<std::string>& contact_name,
                const std::vector<Eigen::VectorXd>& lowerLims,
                const std::vector<Eigen::VectorXd>& upperLims,
                const std::vector<AffineHelper>& wrench):
-    Constraint("wrenches_limits", wrench[0].getInputSize())
+    Constraint("wrenches_limits", wrench[0].getInputSize()),
+    _internal_version(0)
 {
     std::list<ConstraintPtr> constraint_list;
     for(unsigned int i = 0; i < contact_name.size(); ++i){
@@ -114,7 +116,8 @@ WrenchesLimits::WrenchesLimits(const std::vector<std::string>& contact_name,
 WrenchesLimits::WrenchesLimits(const std::map<std::string, WrenchLimits::Ptr>& wrench_lims_constraints,
                                const std::vector<AffineHelper>& wrench):
     Constraint("wrenches_limits", wrench[0].getInputSize()),
-    _wrench_lims_constraints(wrench_lims_constraints)
+    _wrench_lims_constraints(wrench_lims_constraints),
+    _internal_version(0)
 {
     std::list<ConstraintPtr> constraint_list;
 
@@ -139,7 +142,9 @@ WrenchLimits::Ptr WrenchesLimits::getWrenchLimits(const std::string& contact_nam
 void WrenchesLimits::update()
 {
     _aggregated_constraint->update();
-    generateBounds();
+    /* the bounds are copied only if one of the internal constraints changed */
+    if(_aggregated_constraint->getVersion() != _internal_version)
+        generateBounds();
 }
 
 void WrenchesLimits::generateBounds()
@@ -155,5 +160,7 @@ void WrenchesLimits::generateBounds()
         _upperBound = _aggregated_constraint->getUpperBound();
         _lowerBound = _aggregated_constraint->getLowerBound();
     }
+    _internal_version = _aggregated_constraint->getVersion();
+    increaseVersion();
 }
 
@@ -104,5 +104,5 @@ void CartesianPositionConstraint::update() {
     }
     _bUpperBound = ( _b_Cartesian - _A_Cartesian*currentPosition)*_boundScaling;
     _bLowerBound = -1.0e20*_bLowerBound.setOnes(_bUpperBound.size());
-
+    increaseVersion();
 }
@@ -82,6 +82,7 @@ void CartesianVelocity::generatebBounds() {
     _bUpperBound = +1.0*_velocityLimits*_dT;
 
     /**********************************************************************/
+    increaseVersion();
 }
 
 void CartesianVelocity::generateAineq()
@@ -93,5 +94,6 @@ void CartesianVelocity::generateAineq()
         _Aineq = _com_task->getA();
 
     /**********************************************************************/
+    increaseVersion();
 }
 
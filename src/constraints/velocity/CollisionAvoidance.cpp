@@ -141,7 +141,7 @@ void CollisionAvoidance::update()
 
     // save number of active constraints
     _num_active_pairs = row_idx;
-
+    increaseVersion();
 }
 
 bool CollisionAvoidance::addCollisionShape(const std::string &name,
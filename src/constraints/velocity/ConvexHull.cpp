@@ -52,6 +52,7 @@ void ConvexHull::update() {
     _Aineq = _C * _JCoM.block(0,0,2,_x_size);
     //_bLowerBound = -1.0e20*_bLowerBound.setOnes(_bUpperBound.size());
     /**********************************************************************/
+    increaseVersion();
 }
 
 bool ConvexHull::getConvexHull(std::vector<Eigen::Vector3d> &ch)
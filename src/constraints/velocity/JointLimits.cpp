@@ -50,6 +50,7 @@ void JointLimits::update()
         // avoid infeasibility
         _upperBound = _upperBound.cwiseMax(0.0);
         _lowerBound = _lowerBound.cwiseMin(0.0);
+        increaseVersion();
     }
     else
         XBot::Logger::warning("Wrong input x size, joint limits will not be upated!\n");
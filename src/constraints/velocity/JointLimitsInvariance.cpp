@@ -202,7 +202,7 @@ void JointLimitsInvariance::update()
         }
 
     }
-
+    increaseVersion();
 }
 
 bool JointLimitsInvariance::setPStepAheadPredictor(const double p)
@@ -71,6 +71,7 @@ void OmniWheels4X::update()
 {
     _robot.getPose(_base_link, _w_T_b);
     _Aineq.rightCols(_x_size-6).noalias() = _w_T_b.linear() * _J.rightCols(_x_size-6);
+    increaseVersion();
 }
 
 
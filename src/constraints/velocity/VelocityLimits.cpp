@@ -76,6 +76,7 @@ void VelocityLimits::generateBounds(const double qDotLimit)
         _upperBound<<_upperBound.setOnes(_x_size)*1.0*_qDotLimit*_dT;
 
     /**********************************************************************/
+    increaseVersion();
 }
 
 void VelocityLimits::generateBounds(const Eigen::VectorXd& qDotLimit)
@@ -86,4 +87,5 @@ void VelocityLimits::generateBounds(const Eigen::VectorXd& qDotLimit)
         _lowerBound[i] = -1.0*std::fabs(qDotLimit[i])*_dT;
         _upperBound[i] = 1.0*std::fabs(qDotLimit[i])*_dT;
     }
+    increaseVersion();
 }
@@ -16,7 +16,7 @@ BackEnd::BackEnd(const int number_of_variables, const int number_of_constraints)
     _u.setZero(number_of_variables);
 }
 
-bool BackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
+bool BackEnd::updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A,
                                 const Eigen::Ref<const Eigen::VectorXd> &lA,
                                 const Eigen::Ref<const Eigen::VectorXd> &uA)
 {
@@ -93,7 +93,7 @@ bool BackEnd::updateBounds(const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 }
 
 bool BackEnd::updateProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                            const Eigen::MatrixXd &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
+                            const Eigen::Ref<const RowMajorMatrixXd> &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                             const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
     bool success = true;
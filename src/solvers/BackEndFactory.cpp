@@ -1,5 +1,42 @@
 #include <OpenSoT/solvers/BackEndFactory.h>
 #include <xbot2_interface/common/dynamic_loading.h>
+#include <dlfcn.h>
+#include <map>
+#include <mutex>
+
+namespace {
+
+typedef OpenSoT::solvers::BackEnd* (*create_instance_t)(const int, const int, OpenSoT::HessianType, const double);
+
+/**
+ * @brief create_instance_cache create_instance function of each loaded plugin, so that the library is opened
+ * and the symbol is looked up only the first time a back-end is created
+ */
+std::map<std::string, create_instance_t> create_instance_cache;
+std::mutex create_instance_mutex;
+
+create_instance_t loadCreateInstance(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(create_instance_mutex);
+
+    auto it = create_instance_cache.find(name);
+    if(it != create_instance_cache.end())
+        return it->second;
+
+    const std::string library = "libOpenSotBackEnd" + name + ".so";
+    void* handle = dlopen(library.c_str(), RTLD_NOW | RTLD_GLOBAL);
+    if(!handle)
+        throw std::runtime_error("Can not load " + library + ": " + dlerror());
+
+    create_instance_t create_instance = reinterpret_cast<create_instance_t>(dlsym(handle, "create_instance"));
+    if(!create_instance)
+        throw std::runtime_error("Can not find create_instance in " + library + ": " + dlerror());
+
+    create_instance_cache[name] = create_instance;
+    return create_instance;
+}
+
+}
 
 OpenSoT::solvers::BackEnd::Ptr CreateBackend(std::string name,
                                              const int number_of_variables,
@@ -7,25 +44,29 @@ OpenSoT::solvers::BackEnd::Ptr CreateBackend(std::string name,
                                              OpenSoT::HessianType hessian_type,
                                              const double eps_regularisation)
 {
-    return OpenSoT::solvers::BackEnd::Ptr(
-        XBot::Utils::CallFunction<OpenSoT::solvers::BackEnd *>("libOpenSotBackEnd" + name + ".so",
-                                                               "create_instance",
-                                                               number_of_variables,
-                                                               number_of_constraints,
-                                                               hessian_type,
-                                                               eps_regularisation));
+    return OpenSoT::solvers::BackEnd::Ptr(loadCreateInstance(name)(number_of_variables,
+                                                                   number_of_constraints,
+                                                                   hessian_type,
+                                                                   eps_regularisation));
 }
 
 OpenSoT::solvers::BackEnd::Ptr OpenSoT::solvers::BackEndFactory(const solver_back_ends be_solver,
                                                                 const int number_of_variables,
                                                                 const int number_of_constraints,
                                                                 OpenSoT::HessianType hessian_type,
-                                                                const double eps_regularisation)
+                                                                const double eps_regularisation,
+                                                                const double density)
 {
-    std::cout << "BackEndFactory will load solver " <<
-        number_of_variables << " variables, " <<
-        number_of_constraints << " constraints,  " <<
-        eps_regularisation << " regularization \n";
+    if (be_solver == solver_back_ends::Auto) {
+        const solver_back_ends selected_be_solver = selectBackEnd(number_of_variables, number_of_constraints,
+                                                                  hessian_type, eps_regularisation, density);
+        XBot::Logger::info("BackEndFactory selected back-end %s\n", whichBackEnd(selected_be_solver).c_str());
+        return BackEndFactory(selected_be_solver, number_of_variables, number_of_constraints,
+                              hessian_type, eps_regularisation);
+    }
+
+    XBot::Logger::debug("BackEndFactory will load solver %i variables, %i constraints, %f regularization\n",
+                        number_of_variables, number_of_constraints, eps_regularisation);
 
     if (be_solver == solver_back_ends::qpOASES) {
         return CreateBackend("QPOases",
@@ -83,6 +124,14 @@ OpenSoT::solvers::BackEnd::Ptr OpenSoT::solvers::BackEndFactory(const solver_bac
                              eps_regularisation);
     }
 
+    if (be_solver == solver_back_ends::proxQPSparse) {
+        return CreateBackend("proxQPSparse",
+                             number_of_variables,
+                             number_of_constraints,
+                             hessian_type,
+                             eps_regularisation);
+    }
+
     else {
         throw std::runtime_error("Back-end is not available!");
     }
@@ -102,8 +151,146 @@ std::string OpenSoT::solvers::whichBackEnd(const solver_back_ends be_solver)
         return "ODYS";
     if (be_solver == solver_back_ends::proxQP)
         return "proxQP";
+    if (be_solver == solver_back_ends::proxQPSparse)
+        return "proxQPSparse";
+    if (be_solver == solver_back_ends::Auto)
+        return "Auto";
     if (be_solver == solver_back_ends::qpSWIFT)
         return "qpSWIFT";
     else
         return "????";
 }
+
+namespace {
+
+/**
+ * @brief capabilities_cache capabilities of the available back-ends, unavailable back-ends are not in the map
+ */
+std::map<OpenSoT::solvers::solver_back_ends, std::shared_ptr<OpenSoT::solvers::BackEndCapabilities>> capabilities_cache;
+std::mutex capabilities_mutex;
+
+std::shared_ptr<OpenSoT::solvers::BackEndCapabilities> loadCapabilities(const OpenSoT::solvers::solver_back_ends be_solver)
+{
+    std::lock_guard<std::mutex> lock(capabilities_mutex);
+
+    auto it = capabilities_cache.find(be_solver);
+    if(it != capabilities_cache.end())
+        return it->second;
+
+    std::shared_ptr<OpenSoT::solvers::BackEndCapabilities> capabilities;
+    if(be_solver != OpenSoT::solvers::solver_back_ends::Auto)
+    {
+        std::string name = OpenSoT::solvers::whichBackEnd(be_solver);
+        if(be_solver == OpenSoT::solvers::solver_back_ends::qpOASES)
+            name = "QPOases";
+
+        try
+        {
+            auto loaded = std::make_shared<OpenSoT::solvers::BackEndCapabilities>();
+            XBot::Utils::CallFunction<void>("libOpenSotBackEnd" + name + ".so", "get_capabilities", loaded.get());
+            capabilities = loaded;
+        }
+        catch(std::exception& e)
+        {
+            XBot::Logger::debug("Back-end %s is not available: %s\n", name.c_str(), e.what());
+        }
+    }
+
+    capabilities_cache[be_solver] = capabilities;
+    return capabilities;
+}
+
+}
+
+namespace {
+
+OpenSoT::solvers::AutoBackEndThresholds auto_back_end_thresholds;
+std::mutex auto_back_end_thresholds_mutex;
+
+}
+
+bool OpenSoT::solvers::setAutoBackEndThresholds(const AutoBackEndThresholds& thresholds)
+{
+    if(thresholds.small_size < 0 || thresholds.sparse_density < 0. || thresholds.sparse_density > 1.)
+    {
+        XBot::Logger::error("Invalid Auto back-end thresholds: small_size %i, sparse_density %f\n",
+                            thresholds.small_size, thresholds.sparse_density);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(auto_back_end_thresholds_mutex);
+    auto_back_end_thresholds = thresholds;
+    return true;
+}
+
+OpenSoT::solvers::AutoBackEndThresholds OpenSoT::solvers::getAutoBackEndThresholds()
+{
+    std::lock_guard<std::mutex> lock(auto_back_end_thresholds_mutex);
+    return auto_back_end_thresholds;
+}
+
+bool OpenSoT::solvers::isBackEndAvailable(const solver_back_ends be_solver)
+{
+    return bool(loadCapabilities(be_solver));
+}
+
+OpenSoT::solvers::BackEndCapabilities OpenSoT::solvers::getBackEndCapabilities(const solver_back_ends be_solver)
+{
+    auto capabilities = loadCapabilities(be_solver);
+    if(!capabilities)
+        throw std::runtime_error("Back-end " + whichBackEnd(be_solver) + " is not available!");
+    return *capabilities;
+}
+
+OpenSoT::solvers::solver_back_ends OpenSoT::solvers::selectBackEnd(const int number_of_variables,
+                                                                   const int number_of_constraints,
+                                                                   OpenSoT::HessianType hessian_type,
+                                                                   const double eps_regularisation,
+                                                                   const double density)
+{
+    const int size = number_of_variables + number_of_constraints;
+    const bool lp = hessian_type == OpenSoT::HessianType::HST_ZERO;
+    //eps_regularisation is scaled by the back-ends and is too small to make a semi-definite H positive definite
+    const bool positive_definite = hessian_type == OpenSoT::HessianType::HST_IDENTITY ||
+                                   hessian_type == OpenSoT::HessianType::HST_POSDEF;
+    const AutoBackEndThresholds thresholds = getAutoBackEndThresholds();
+    const bool sparse = density < thresholds.sparse_density && size > thresholds.small_size;
+
+    std::vector<solver_back_ends> candidates;
+    if(lp)
+        candidates = {solver_back_ends::GLPK, solver_back_ends::OSQP, solver_back_ends::qpOASES};
+    else if(sparse)
+        candidates = {solver_back_ends::OSQP, solver_back_ends::proxQPSparse, solver_back_ends::qpOASES,
+                      solver_back_ends::proxQP, solver_back_ends::eiQuadProg, solver_back_ends::qpSWIFT};
+    else
+        candidates = {solver_back_ends::eiQuadProg, solver_back_ends::qpOASES, solver_back_ends::proxQP,
+                      solver_back_ends::OSQP, solver_back_ends::proxQPSparse, solver_back_ends::qpSWIFT};
+
+    //the recommended size is considered only in the first pass
+    for(unsigned int pass = 0; pass < 2; ++pass)
+    {
+        for(const auto& be_solver : candidates)
+        {
+            auto capabilities = loadCapabilities(be_solver);
+            if(!capabilities)
+                continue;
+            if(lp ? !capabilities->lp : !capabilities->qp)
+                continue;
+            if(capabilities->positive_definite_hessian && !positive_definite)
+                continue;
+            if(pass == 0 && capabilities->max_recommended_size > 0 && size > capabilities->max_recommended_size)
+                continue;
+            return be_solver;
+        }
+    }
+
+    throw std::runtime_error("No back-end available for the problem!");
+}
+
+double OpenSoT::solvers::estimateDensity(const Eigen::MatrixXd& H, const Eigen::Ref<const BackEnd::RowMajorMatrixXd>& A)
+{
+    const double size = H.size() + A.size();
+    if(size == 0.)
+        return 1.;
+    return ((H.array() != 0.).count() + (A.array() != 0.).count())/size;
+}
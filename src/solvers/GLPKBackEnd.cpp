@@ -18,11 +18,18 @@ extern "C" void destroy_instance( BackEnd * instance )
     delete instance;
 }
 
+extern "C" void get_capabilities(BackEndCapabilities * capabilities)
+{
+    capabilities->qp = false;
+    capabilities->lp = true;
+    capabilities->milp = true;
+    capabilities->hotstart = true;
+}
+
 GLPKBackEnd::GLPKBackEnd(const int number_of_variables, const int number_of_constraints, const double eps_regularisation):
     BackEnd(number_of_variables, number_of_constraints),
-    _rows((number_of_constraints*number_of_variables)+1),
-    _cols(_rows.size()),
-    _a(_rows.size())
+    _ind(number_of_variables+1),
+    _val(number_of_variables+1)
 {
     _mip = glp_create_prob();
     glp_set_prob_name(_mip, "mip_problem");
@@ -91,7 +98,6 @@ void GLPKBackEnd::printErrorOutput(const int out)
 
 bool GLPKBackEnd::solve()
 {
-    createsVectorsFromConstraintsMatrix();
     roundBounds();
 
     //SETTING BOUNDS & COST FUNCTION
@@ -116,9 +122,10 @@ bool GLPKBackEnd::solve()
     //SETTING CONSTRAINTS
     for(unsigned int i = 0; i < _A.rows(); ++i)
         glp_set_row_bnds(_mip, i+1, checkConstrType(_uA[i], _lA[i]), _lA[i], _uA[i]);
-    //SETTING CONSTRAINT MATRIX
-    glp_load_matrix(_mip, _A.rows()*_A.cols(), _rows.data(), _cols.data(), _a.data());
+    //SETTING CONSTRAINT MATRIX (only changed rows)
+    updateConstraintsMatrix(false);
 
+    solveLPRelaxation();
     int out = glp_intopt(_mip, &_param);
     if(out != 0)
     {
@@ -138,13 +145,11 @@ double GLPKBackEnd::getObjective()
 }
 
 bool GLPKBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                         const Eigen::MatrixXd &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
+                         const Eigen::Ref<const RowMajorMatrixXd> &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                          const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
     _H = H; _g = g; _A = A; _lA = lA; _uA = uA; _l = l; _u = u;
 
-    createsVectorsFromConstraintsMatrix();
-
     _opt.ROUND_BOUNDS = 0; //bounds are not rounded (default)
 
 
@@ -176,7 +181,7 @@ bool GLPKBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
     for(unsigned int i = 0; i < _A.rows(); ++i)
         glp_set_row_bnds(_mip, i+1, checkConstrType(_uA[i], _lA[i]), _lA[i], _uA[i]);
     //SETTING CONSTRAINT MATRIX
-    glp_load_matrix(_mip, _A.rows()*_A.cols(), _rows.data(), _cols.data(), _a.data());
+    updateConstraintsMatrix(true);
 
 
     glp_init_iocp(&_param);
@@ -184,7 +189,7 @@ bool GLPKBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
 
     glp_init_smcp(&_param_simplex);
 
-    glp_simplex(_mip, &_param_simplex);
+    solveLPRelaxation();
 
 
     _param.fp_heur = GLP_OFF;
@@ -217,22 +222,44 @@ int GLPKBackEnd::writeLP()
     return glp_write_lp(_mip, NULL, "lp_problem");
 }
 
-//IN EIGEN COLUMN MAJOIR!
-void GLPKBackEnd::createsVectorsFromConstraintsMatrix()
+void GLPKBackEnd::updateConstraintsMatrix(const bool all_rows)
 {
-    int idx = 0;
-    for(unsigned int i = 0; i < _A.cols(); ++i)
+    if(all_rows)
+        _A_loaded = _A;
+
+    for(unsigned int i = 0; i < _A.rows(); ++i)
     {
-        for(unsigned int j = 0; j < _A.rows(); ++j)
+        if(!all_rows)
         {
-            _cols[idx+1] = i+1;
-            _rows[idx+1] = j+1;
-            idx++;
+            if(_A.row(i) == _A_loaded.row(i))
+                continue;
+            _A_loaded.row(i) = _A.row(i);
         }
+
+        int len = 0;
+        for(unsigned int j = 0; j < _A.cols(); ++j)
+        {
+            if(_A(i,j) != 0.)
+            {
+                ++len;
+                _ind[len] = j+1;
+                _val[len] = _A(i,j);
+            }
+        }
+        glp_set_mat_row(_mip, i+1, len, _ind.data(), _val.data());
     }
+}
 
-    _a.setZero(_a.size());
-    _a.tail(_A.rows()*_A.cols()) = Eigen::Map<Eigen::VectorXd>(_A.data(), _A.rows()*_A.cols());
+int GLPKBackEnd::solveLPRelaxation()
+{
+    //the simplex starts from the basis of the previous solve
+    int out = glp_simplex(_mip, &_param_simplex);
+    if(out == GLP_EBADB || out == GLP_ESING || out == GLP_ECOND)
+    {
+        glp_adv_basis(_mip, 0);
+        out = glp_simplex(_mip, &_param_simplex);
+    }
+    return out;
 }
 
 int GLPKBackEnd::checkConstrType(const double u, const double l)
@@ -289,16 +316,15 @@ Eigen::MatrixXd GLPKBackEnd::getGLPKConstraintMatrix()
 {
     Eigen::MatrixXd A(_A.rows(),_A.cols());
 
+    std::vector<double> val(_A.cols()+1);
+    std::vector<int> id(_A.cols()+1);
     for(unsigned int i = 0; i < _A.rows(); ++i)
     {
-        double val[_A.cols()];
-        int id[_A.cols()];
+        int len = glp_get_mat_row(_mip, i+1, id.data(), val.data());
 
-        glp_get_mat_row(_mip, i+1, id, val);
-
-        Eigen::VectorXd row(_A.cols());
-        for(unsigned int j = 0; j < _A.cols(); ++j)
-            row[id[j+1]-1] = val[j+1];
+        Eigen::VectorXd row = Eigen::VectorXd::Zero(_A.cols());
+        for(int k = 1; k <= len; ++k)
+            row[id[k]-1] = val[k];
 
         A.row(i) = row;
 
@@ -6,6 +6,16 @@ using namespace OpenSoT::solvers;
 
 #define DEFAULT_DISABLE_WEIGHTS_COMPUTATION false
 
+namespace {
+    inline void set_bound(soth::Bound& bound, const double lower, const double upper)
+    {
+        if(std::fabs(lower-upper) <= std::numeric_limits<double>::epsilon())
+            bound = soth::Bound(lower);
+        else
+            bound = soth::Bound(lower, upper);
+    }
+}
+
 HCOD::HCOD(OpenSoT::AutoStack &stack_of_tasks, const double damping):
     Solver(stack_of_tasks.getStack(), stack_of_tasks.getBounds()),
     _W(stack_of_tasks.getStack().size()),
@@ -57,10 +67,12 @@ void HCOD::init(const double damping)
 {
     _VARS = _tasks[0]->getA().cols();
 
-    _A.set(Eigen::MatrixXd(0, _VARS));
-    _lA.set(Eigen::MatrixXd(0,1));
-    _uA.set(Eigen::MatrixXd(0,1));
-
+    _nb = 0;
+    _warm_start = true;
+    _solution_valid = false;
+    _iterations = 0;
+    _bounds_version = 0;
+    _bounds_copied = false;
 
     // Level of priorities is given by Constraints + Tasks Levels
     _CL = 0;
@@ -68,22 +80,32 @@ void HCOD::init(const double damping)
         _CL = 1;
 
     int TL = _tasks.size();
-    _I.setIdentity(_VARS, _VARS);
 
     // here we create the hcod solver
     _hcod = std::make_shared<soth::HCOD_wrapper>(_VARS, _CL+TL);
     _vector_bounds.resize(_CL+TL);
     _vector_J.resize(_CL+TL);
 
+    _w.resize(TL);
+    _W_last.resize(TL);
+    _W_diagonal.assign(TL, false);
+    _W_computed.assign(TL, false);
+    _llt.resize(TL);
+    _task_versions.assign(TL, 0);
+    _task_copied.assign(TL, false);
+
     //creates bounds and tasks (here order is important!)
+    bool changed;
     if(_CL > 0)
-        copy_bounds();
+        copy_bounds(changed);
     copy_tasks();
 
-    // Pushback stages
+    // Pushback stages, the variable bounds of the constraints stage are not stored in _vector_J[0]
     for (unsigned int i = 0; i < _vector_J.size(); ++i)
     {
-        _hcod->pushBackStage(_vector_J[i].rows(), _vector_J[i].data(), _vector_bounds[i].data());
+        _hcod->pushBackStage(_vector_bounds[i].size(), _vector_J[i].data(), _vector_bounds[i].data());
+        if(i < _CL && _nb > 0)
+            _hcod->setStageBoundRows(i, _nb);
         _hcod->setNameByOrder("level_" + i);
     }
 
@@ -99,17 +121,64 @@ void HCOD::printSOT()
     XBot::Logger::info("HCOD:\n");
     XBot::Logger::info("    TOTAL STAGES: %i\n", _CL+_tasks.size());
     XBot::Logger::info("    STACK STAGES: %i\n", _tasks.size());
-    XBot::Logger::info("    CONSTRAINTS: %i\n", _A.rows());
+    XBot::Logger::info("    BOUNDS: %i\n", _nb);
+    XBot::Logger::info("    CONSTRAINTS: %i\n", _CL > 0 ? _vector_J[0].rows() : 0);
     for(unsigned int i = _CL; i < _vector_J.size(); ++i)
         XBot::Logger::info("    TOTAL TASKS STAGE %i: %i\n", i, _vector_J[i].rows());
 }
 
 bool HCOD::solve(Eigen::VectorXd &solution)
 {
-    if(_CL > 0)
-        copy_bounds();
+    if(!_statistics)
+        return solveHierarchy(solution);
+
+    const auto start = utils::SolverStatistics::clock::now();
+    bool success = solveHierarchy(solution);
+    _statistics->current().solve_time = utils::SolverStatistics::elapsed(start);
+    _statistics->current().success = success;
+    _statistics->commit();
+    return success;
+}
 
-    copy_tasks();
+bool HCOD::solveHierarchy(Eigen::VectorXd &solution)
+{
+    //the whole hierarchy is solved by a single active search, its timings are recorded in the first level
+    utils::LevelStatistics* stats = _statistics ? &_statistics->level(0) : nullptr;
+    utils::SolverStatistics::clock::time_point start;
+
+    bool changed = false;
+    if(stats) start = utils::SolverStatistics::clock::now();
+    const bool bounds_copied = _CL == 0 || copy_bounds(changed);
+    if(stats) stats->constraints_time = utils::SolverStatistics::elapsed(start);
+
+    if(!bounds_copied)
+    {
+        _solution_valid = false;
+        if(stats)
+            stats->success = false;
+        return false;
+    }
+
+    if(stats) start = utils::SolverStatistics::clock::now();
+    changed = copy_tasks() || changed;
+    if(stats) stats->cost_time = utils::SolverStatistics::elapsed(start);
+
+    if(_warm_start && _solution_valid && !changed)
+    {
+        solution = _solution;
+        _iterations = 0;
+        if(stats)
+        {
+            stats->iterations = 0;
+            stats->success = true;
+        }
+        return true;
+    }
+
+    if(stats) start = utils::SolverStatistics::clock::now();
+
+    if(!_warm_start)
+        _hcod->setInitialActiveSet();
 
     solution.setZero(_VARS);
     try
@@ -118,108 +187,187 @@ bool HCOD::solve(Eigen::VectorXd &solution)
     }
     catch(int)
     {
+        // the active set of a failed search is not a good initial guess
+        _hcod->setInitialActiveSet();
+        _solution_valid = false;
+        _iterations = _hcod->getIterations();
+        if(stats)
+        {
+            stats->back_end_time = stats->back_end_solve_time = utils::SolverStatistics::elapsed(start);
+            stats->iterations = _iterations;
+            stats->success = false;
+        }
         return false;
     }
+
+    _iterations = _hcod->getIterations();
+    if(stats)
+    {
+        stats->back_end_time = stats->back_end_solve_time = utils::SolverStatistics::elapsed(start);
+        stats->iterations = _iterations;
+        stats->success = true;
+    }
+    _solution = solution;
+    _solution_valid = true;
     return true;
 }
 
-void HCOD::copy_tasks()
+bool HCOD::copy_tasks()
 {
+    bool copied = false;
+
     int s = _tasks.size();
     int c = 0;
     if(_CL > 0)
         c+=1;
 
-    for(unsigned int i = 0; i < s; ++i)
+    for(unsigned int i = 0; i < s; ++i, ++c)
     {
+        // A, b and W did not change since the last copy
+        const unsigned int version = _tasks[i]->getVersion();
+        if(_task_copied[i] && _task_versions[i] == version &&
+           (_disable_weights_computation || _W_diagonal[i] == _tasks[i]->getWeightIsDiagonalFlag()))
+            continue;
+        _task_versions[i] = version;
+        _task_copied[i] = true;
+        copied = true;
+
+        const Eigen::MatrixXd& A = _tasks[i]->getA();
+        const Eigen::VectorXd& b = _tasks[i]->getb();
+
+        int ss = b.size();
+        if(_vector_bounds[c].size() != ss)
+            _vector_bounds[c].resize(ss);
+
         if(_disable_weights_computation)
         {
-            _vector_J[c] = _tasks[i]->getA();
-
-            int ss = _tasks[i]->getb().size();
-            if(_vector_bounds[c].size() != ss)
-                _vector_bounds[c].resize(ss);
+            _vector_J[c] = A;
 
             for(unsigned int j = 0; j < ss; ++j)
-                _vector_bounds[c][j] = _tasks[i]->getb()[j];
+                _vector_bounds[c][j] = b[j];
         }
         else
         {
-            _W[i] = _tasks[i]->getWeight();
-            if(_tasks[i]->getWeightIsDiagonalFlag()) //weight matrix is diagonal
+            compute_weight(i);
+
+            if(_vector_J[c].rows() != A.rows() || _vector_J[c].cols() != A.cols())
+                _vector_J[c].resize(A.rows(), A.cols());
+
+            if(_W_diagonal[i])
             {
-                for(unsigned int j = 0; i < _W[j].rows(); ++j)
-                    _W[i](j,j) = std::sqrt(_tasks[i]->getWeight()(j,j));
+                _vector_J[c].noalias() = _w[i].asDiagonal()*A;
+                for(unsigned int j = 0; j < ss; ++j)
+                    _vector_bounds[c][j] = _w[i][j]*b[j];
             }
-            else //if not diagonal we assume weight matrix positive-definite symmetric
+            else
             {
-                _sqrt[i].compute(_tasks[i]->getWeight());
-                _W[i] = _sqrt[i].operatorSqrt();
+                _vector_J[c].noalias() = _W[i]*A;
+                _Wb[i].noalias() = _W[i]*b;
+                for(unsigned int j = 0; j < ss; ++j)
+                    _vector_bounds[c][j] = _Wb[i][j];
             }
-
-            _vector_J[c] = _W[i]*_tasks[i]->getA();
-
-            int ss = _tasks[i]->getb().size();
-            if(_vector_bounds[c].size() != ss)
-                _vector_bounds[c].resize(ss);
-
-            _Wb[i] = _W[i]*_tasks[i]->getb();
-            for(unsigned int j = 0; j < ss; ++j)
-                _vector_bounds[c][j] = _Wb[i][j];
         }
-
-        c+=1;
     }
+
+    return copied;
 }
 
-void HCOD::copy_bounds()
+void HCOD::compute_weight(const unsigned int i)
 {
-    _A.reset();
-    _lA.reset();
-    _uA.reset();
+    const Eigen::MatrixXd& W = _tasks[i]->getWeight();
+    const bool diagonal = _tasks[i]->getWeightIsDiagonalFlag();
 
-    if(_bounds->getLowerBound().size() > 0)
-    {
-        _A.pile(_I);
-        _lA.pile(_bounds->getLowerBound());
-        _uA.pile(_bounds->getUpperBound());
-    }
+    if(_W_computed[i] && _W_diagonal[i] == diagonal &&
+       _W_last[i].rows() == W.rows() && _W_last[i].cols() == W.cols() && _W_last[i] == W)
+        return;
+
+    _W_last[i] = W;
+    _W_diagonal[i] = diagonal;
+    _W_computed[i] = true;
 
-    if(_bounds->getAineq().rows() > 0)
+    if(diagonal) //weight matrix is diagonal
     {
-        _A.pile(_bounds->getAineq());
-        _lA.pile(_bounds->getbLowerBound());
-        _uA.pile(_bounds->getbUpperBound());
+        _w[i] = W.diagonal().cwiseSqrt();
     }
-
-    if(_bounds->getAeq().rows() > 0)
+    else //if not diagonal we assume weight matrix positive-definite symmetric
     {
-        _A.pile(_bounds->getAeq());
-        _lA.pile(_bounds->getbeq());
-        _uA.pile(_bounds->getbeq());
+        _llt[i].compute(W);
+        if(_llt[i].info() == Eigen::Success)
+            _W[i] = _llt[i].matrixU();
+        else //positive-semidefinite weight
+        {
+            _sqrt[i].compute(W);
+            _W[i] = _sqrt[i].operatorSqrt();
+        }
     }
+}
+
+bool HCOD::copy_bounds(bool& changed)
+{
+    changed = false;
 
+    const unsigned int version = _bounds->getVersion();
+    if(_bounds_copied && _bounds_version == version)
+        return true;
 
-    _vector_J[0] = _A.generate_and_get();
+    const Eigen::VectorXd& lb = _bounds->getLowerBound();
+    const Eigen::VectorXd& ub = _bounds->getUpperBound();
+    const Eigen::MatrixXd& Aineq = _bounds->getAineq();
+    const Eigen::MatrixXd& Aeq = _bounds->getAeq();
 
-    int s = _lA.generate_and_get().size();
+    const int nb = lb.size() > 0 ? _VARS : 0;
+    const int s = nb + Aineq.rows() + Aeq.rows();
+
+    // the number of rows of the constraints stage is fixed once passed to soth
+    if(_bounds_copied && s != int(_vector_bounds[0].size()))
+    {
+        XBot::Logger::error("HCOD: constraints stage has %i rows, %i expected \n", s, int(_vector_bounds[0].size()));
+        return false;
+    }
+    _bounds_version = version;
+
+    // the variable bounds are handled by index inside soth, only the other constraints are stored in _vector_J[0]
+    if(_vector_J[0].rows() != s - nb || _vector_J[0].cols() != _VARS)
+        _vector_J[0].resize(s - nb, _VARS);
+    _vector_J[0].topRows(Aineq.rows()) = Aineq;
+    _vector_J[0].bottomRows(Aeq.rows()) = Aeq;
 
     if(_vector_bounds[0].size() != s)
         _vector_bounds[0].resize(s);
 
-    for(unsigned int i = 0; i < s; ++i)
+    int r = 0;
+    for(unsigned int i = 0; i < nb; ++i)
+        set_bound(_vector_bounds[0][r++], lb[i], ub[i]);
+
+    for(unsigned int i = 0; i < Aineq.rows(); ++i)
+        set_bound(_vector_bounds[0][r++], _bounds->getbLowerBound()[i], _bounds->getbUpperBound()[i]);
+
+    for(unsigned int i = 0; i < Aeq.rows(); ++i)
+        _vector_bounds[0][r++] = soth::Bound(_bounds->getbeq()[i]);
+
+    // the bounds appeared or disappeared: soth has to know them and _vector_J[0] has been reallocated
+    if(_bounds_copied && nb != _nb)
     {
-        double lAi = _lA.generate_and_get()(i,0);
-        double uAi = _uA.generate_and_get()(i,0);
-        if(std::fabs(lAi-uAi) <= std::numeric_limits<double>::epsilon())
-            _vector_bounds[0][i] = soth::Bound(lAi);
-        else
-            _vector_bounds[0][i] = soth::Bound(lAi, uAi);
+        if(!_hcod->setStageBoundRows(0, nb))
+        {
+            XBot::Logger::error("HCOD: unable to set %i variable bounds in the constraints stage \n", nb);
+            _bounds_copied = false;
+            return false;
+        }
+        _hcod->updateStage(0, _vector_J[0].data(), _vector_bounds[0].data());
+        _hcod->setInitialActiveSet();
     }
+
+    _nb = nb;
+    _bounds_copied = true;
+    changed = true;
+    return true;
 }
 
 void HCOD::setDisableWeightsComputation(const bool disable)
 {
+    if(_disable_weights_computation != disable)
+        _task_copied.assign(_task_copied.size(), false);
     _disable_weights_computation = disable;
 }
 
@@ -231,6 +379,76 @@ bool HCOD::getDisableWeightsComputation()
 void HCOD::setDamping(double damping)
 {
     _hcod->setDamping(damping);
+    _solution_valid = false;
+}
+
+void HCOD::setWarmStart(const bool warm_start)
+{
+    _warm_start = warm_start;
+}
+
+bool HCOD::getWarmStart() const
+{
+    return _warm_start;
+}
+
+void HCOD::getActiveSet(ActiveSet& active_set) const
+{
+    std::vector<soth::cstref_vector_t> cstrefs;
+    _hcod->getActiveSet(cstrefs);
+
+    active_set.resize(cstrefs.size());
+    for(unsigned int i = 0; i < cstrefs.size(); ++i)
+    {
+        active_set[i].clear();
+        for(const auto& cst : cstrefs[i])
+            active_set[i].push_back({int(cst.row), cst.type == soth::Bound::BOUND_INF ?
+                                     ActiveConstraint::Type::LOWER : ActiveConstraint::Type::UPPER});
+    }
+}
+
+bool HCOD::setActiveSet(const ActiveSet& active_set)
+{
+    if(active_set.size() != _vector_J.size())
+    {
+        XBot::Logger::error("HCOD: active set has %i stages, %i expected \n", int(active_set.size()), int(_vector_J.size()));
+        return false;
+    }
+
+    std::vector<soth::cstref_vector_t> cstrefs(active_set.size());
+    for(unsigned int i = 0; i < active_set.size(); ++i)
+    {
+        for(const auto& cst : active_set[i])
+        {
+            if(cst.row < 0 || cst.row >= _vector_bounds[i].size())
+            {
+                XBot::Logger::error("HCOD: row %i of stage %i does not exist \n", cst.row, i);
+                return false;
+            }
+
+            // equality rows are always active
+            if(_vector_bounds[i][cst.row].getType() == soth::Bound::BOUND_TWIN)
+                continue;
+
+            cstrefs[i].push_back(soth::ConstraintRef(cst.row, cst.type == ActiveConstraint::Type::LOWER ?
+                                                     soth::Bound::BOUND_INF : soth::Bound::BOUND_SUP));
+        }
+    }
+
+    _hcod->setActiveSet(cstrefs);
+    _solution_valid = false;
+    return true;
+}
+
+void HCOD::resetActiveSet()
+{
+    _hcod->setInitialActiveSet();
+    _solution_valid = false;
+}
+
+unsigned int HCOD::getNumberOfIterations() const
+{
+    return _iterations;
 }
 
 
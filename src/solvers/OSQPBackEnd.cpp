@@ -3,6 +3,7 @@
 #include <error.h>  // this is from osqp!
 #include <exception>
 #include <memory>
+#include <vector>
 using namespace OpenSoT::solvers;
 
 #define BASE_REGULARISATION 2.22E-13 //previous 1E-12
@@ -21,12 +22,23 @@ extern "C" void destroy_instance( BackEnd * instance )
     delete instance;
 }
 
+extern "C" void get_capabilities(BackEndCapabilities * capabilities)
+{
+    capabilities->lp = true;
+    capabilities->hotstart = true;
+    capabilities->sparse = true;
+}
+
 
 OSQPBackEnd::OSQPBackEnd(const int number_of_variables,
                          const int number_of_constraints,
                          const double eps_regularisation):
     BackEnd(number_of_variables, number_of_constraints),
-    _eps_regularisation(eps_regularisation*BASE_REGULARISATION) //TO HAVE COMPATIBILITY WITH THE QPOASES ONE!
+    _workspace(OSQP_NULL),
+    _eps_regularisation(eps_regularisation*BASE_REGULARISATION), //TO HAVE COMPATIBILITY WITH THE QPOASES ONE!
+    _sparse(false),
+    _detect_patterns(false),
+    _patterns_grown(false)
 {
     
     #ifdef DLONG
@@ -106,6 +118,158 @@ void OpenSoT::solvers::OSQPBackEnd::update_data_struct()
 {
 }
 
+void OSQPBackEnd::__generate_sparse_data_struct()
+{
+    const int number_of_variables = getNumVariables();
+    const int number_of_constraints = _A.rows();
+    const int number_of_bounds = _l.size();
+
+    _lb_piled.setConstant(number_of_bounds + number_of_constraints, -1.0);
+    _ub_piled.setConstant(number_of_bounds + number_of_constraints,  1.0);
+
+    /* Sparsity pattern of P: diagonal (needed for the regularisation) and upper triangular part of the pattern of H */
+    std::vector<Eigen::Triplet<double>> triplets;
+    for(int j = 0; j < number_of_variables; ++j)
+        for(int i = 0; i <= j; ++i)
+            if(i == j || _P_pattern.size() == 0 || _P_pattern(i,j))
+                triplets.emplace_back(i, j, 0.);
+
+    _Psparse.resize(number_of_variables, number_of_variables);
+    _Psparse.setFromTriplets(triplets.begin(), triplets.end());
+    _Psparse.makeCompressed();
+
+    _P_index.clear();
+    _P_diagonal.clear();
+    for(int j = 0; j < _Psparse.outerSize(); ++j)
+    {
+        for(SparseMatrix::InnerIterator it(_Psparse, j); it; ++it)
+        {
+            if(it.row() == j)
+                _P_diagonal.push_back(_P_index.size());
+            _P_index.push_back(&_H(it.row(), j) - _H.data());
+        }
+    }
+
+    /* Sparsity pattern of A: pattern of the constraints + identity for the bounds */
+    triplets.clear();
+    for(int j = 0; j < number_of_variables; ++j)
+    {
+        for(int i = 0; i < number_of_constraints; ++i)
+            if(_A_pattern.size() == 0 || _A_pattern(i,j))
+                triplets.emplace_back(i, j, 0.);
+        if(j < number_of_bounds)
+            triplets.emplace_back(number_of_constraints + j, j, 1.);
+    }
+
+    _Asparse.resize(number_of_constraints + number_of_bounds, number_of_variables);
+    _Asparse.setFromTriplets(triplets.begin(), triplets.end());
+    _Asparse.makeCompressed();
+
+    _A_index.clear();
+    for(int j = 0; j < _Asparse.outerSize(); ++j)
+        for(SparseMatrix::InnerIterator it(_Asparse, j); it; ++it)
+            _A_index.push_back(it.row() < number_of_constraints ? &_A(it.row(), j) - _A.data() : -1);
+
+    setCSCMatrix(_Pcsc.get(), _Psparse);
+    setCSCMatrix(_Acsc.get(), _Asparse);
+
+
+    /* Fill data */
+
+    _data->n = number_of_variables;
+    _data->m = number_of_constraints + number_of_bounds;
+    _data->l = _lb_piled.data();
+    _data->u = _ub_piled.data();
+    _data->q = _g.data();
+    _data->A = _Acsc.get();
+    _data->P = _Pcsc.get();
+}
+
+void OSQPBackEnd::update_sparse_P_values()
+{
+    double* values = _Psparse.valuePtr();
+    for(unsigned int k = 0; k < _P_index.size(); ++k)
+        values[k] = _H.data()[_P_index[k]];
+    for(unsigned int k = 0; k < _P_diagonal.size(); ++k)
+        values[_P_diagonal[k]] += _eps_regularisation;
+}
+
+void OSQPBackEnd::update_sparse_A_values()
+{
+    /* the rows of the bounds are constant */
+    double* values = _Asparse.valuePtr();
+    for(unsigned int k = 0; k < _A_index.size(); ++k)
+        if(_A_index[k] >= 0)
+            values[k] = _A.data()[_A_index[k]];
+}
+
+bool OSQPBackEnd::grow_P_pattern()
+{
+    //the diagonal of P is always in the sparse matrix
+    bool grown = false;
+    if(_P_pattern.size() == 0)
+        return grown;
+    for(int j = 0; j < _H.cols(); ++j)
+    {
+        for(int i = 0; i < j; ++i)
+        {
+            if(!_P_pattern(i,j) && _H(i,j) != 0.)
+                grown = _P_pattern(i,j) = true;
+        }
+    }
+    return grown;
+}
+
+bool OSQPBackEnd::grow_A_pattern()
+{
+    bool grown = false;
+    if(_A_pattern.size() == 0)
+        return grown;
+    for(int i = 0; i < _A.rows(); ++i)
+    {
+        for(int j = 0; j < _A.cols(); ++j)
+        {
+            if(!_A_pattern(i,j) && _A(i,j) != 0.)
+                grown = _A_pattern(i,j) = true;
+        }
+    }
+    return grown;
+}
+
+bool OSQPBackEnd::setup()
+{
+    cleanup();
+
+    if(_data && _settings)
+        osqp_setup(&_workspace, _data.get(), _settings.get());
+    else
+    {
+        XBot::Logger::error("OSQP: data or settings not created before setup\n");
+        return false;
+    }
+
+    if(!_workspace)
+    {
+        XBot::Logger::error("OSQP: unable to setup workspace\n");
+        return false;
+    }
+
+    return true;
+}
+
+void OSQPBackEnd::cleanup()
+{
+    if(!_workspace)
+        return;
+
+    //settings set through setOptions() are owned by _settings and must not be freed by OSQP
+    if(_workspace->settings == _settings.get())
+        _workspace->settings = OSQP_NULL;
+
+    osqp_cleanup(_workspace);
+    _workspace = OSQP_NULL;
+}
+
 
 void OSQPBackEnd::setCSCMatrix(csc* a, Eigen::SparseMatrix<double>& A)
 {
@@ -127,16 +291,27 @@ bool OSQPBackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd &g)
     }
     
     
-    int idx = 0;
-    for(int c = 0; c < getNumVariables(); c++)
+    if(_sparse)
     {
-        _P_values.segment(idx, c+1) = _H.col(c).head(c+1);
-        _P_values.segment(idx, c+1)(c) += _eps_regularisation;
-        idx += c+1;
+        //the values are copied by the set-up done in solve()
+        if(grow_P_pattern())
+            _patterns_grown = true;
+        else
+            update_sparse_P_values();
+    }
+    else
+    {
+        int idx = 0;
+        for(int c = 0; c < getNumVariables(); c++)
+        {
+            _P_values.segment(idx, c+1) = _H.col(c).head(c+1);
+            _P_values.segment(idx, c+1)(c) += _eps_regularisation;
+            idx += c+1;
+        }
+
+        setCSCMatrix(_Pcsc.get(), _Psparse);
+        _data->P->x = _P_values.data();
     }
-    
-    setCSCMatrix(_Pcsc.get(), _Psparse);
-    _data->P->x = _P_values.data();
     _data->q = _g.data();
     
     return true;
@@ -145,7 +320,7 @@ bool OSQPBackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd &g)
 
 
 
-bool OSQPBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A, 
+bool OSQPBackEnd::updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A, 
                                 const Eigen::Ref<const Eigen::VectorXd>& lA, 
                                 const Eigen::Ref<const Eigen::VectorXd>& uA)
 {
@@ -160,9 +335,19 @@ bool OSQPBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
         
 
         /* Update values in A upper part (constraints) */
-        _Adense.topRows(getNumConstraints()) = _A;
-        setCSCMatrix(_Acsc.get(), _Asparse); // Asparse may be reallocated???
-        _data->A->x = _Adense.data();
+        if(_sparse)
+        {
+            if(grow_A_pattern())
+                _patterns_grown = true;
+            else
+                update_sparse_A_values();
+        }
+        else
+        {
+            _Adense.topRows(getNumConstraints()) = _A;
+            setCSCMatrix(_Acsc.get(), _Asparse); // Asparse may be reallocated???
+            _data->A->x = _Adense.data();
+        }
         
         /* Update constraints bounds */
         _lb_piled.head(getNumConstraints()) = _lA;
@@ -197,16 +382,34 @@ bool OSQPBackEnd::updateBounds(const Eigen::VectorXd& l, const Eigen::VectorXd&
 
 bool OSQPBackEnd::solve()
 {
+    if(_patterns_grown)
+    {
+        XBot::Logger::warning("OSQP: nonzeros outside of the sparsity patterns, the patterns are grown and OSQP is set-up again\n");
+        return initProblem(_H, _g, _A, _lA, _uA, _l, _u);
+    }
+
     osqp_update_lin_cost(_workspace, _g.data());
     c_int update_bound_flag = osqp_update_bounds(_workspace, _lb_piled.data(), _ub_piled.data());
     if(update_bound_flag != 0)
         return false;
-    c_int update_A_flag = osqp_update_A(_workspace, _Adense.data(), OSQP_NULL, _Adense.size());
-    if(update_A_flag != 0)
-        return false;
-    c_int update_P_flag = osqp_update_P(_workspace, _P_values.data(), OSQP_NULL, _P_values.size());
-    if(update_P_flag != 0)
-        return false;
+    if(_sparse)
+    {
+        c_int update_A_flag = osqp_update_A(_workspace, _Asparse.valuePtr(), OSQP_NULL, _Asparse.nonZeros());
+        if(update_A_flag != 0)
+            return false;
+        c_int update_P_flag = osqp_update_P(_workspace, _Psparse.valuePtr(), OSQP_NULL, _Psparse.nonZeros());
+        if(update_P_flag != 0)
+            return false;
+    }
+    else
+    {
+        c_int update_A_flag = osqp_update_A(_workspace, _Adense.data(), OSQP_NULL, _Adense.size());
+        if(update_A_flag != 0)
+            return false;
+        c_int update_P_flag = osqp_update_P(_workspace, _P_values.data(), OSQP_NULL, _P_values.size());
+        if(update_P_flag != 0)
+            return false;
+    }
     
     
     
@@ -232,14 +435,67 @@ boost::any OSQPBackEnd::getOptions()
 
 void OSQPBackEnd::setOptions(const boost::any &options)
 {
+    if(options.type() == typeid(OSQPBackEndOptions))
+    {
+        const OSQPBackEndOptions& opt = boost::any_cast<const OSQPBackEndOptions&>(options);
+        if(opt.settings)
+            setOptions(*opt.settings);
+
+        const bool sparse = opt.detect_patterns || opt.H_pattern.size() > 0 || opt.A_pattern.size() > 0;
+        if(opt.detect_patterns)
+        {
+            if(opt.detect_patterns != _detect_patterns)
+            {
+                _sparse = true;
+                _detect_patterns = true;
+                _P_pattern.resize(0, 0);
+                _A_pattern.resize(0, 0);
+                if(_workspace)
+                    initProblem(_H, _g, _A, _lA, _uA, _l, _u);
+            }
+            return;
+        }
+        if(opt.H_pattern.size() > 0 && (opt.H_pattern.rows() != getNumVariables() || opt.H_pattern.cols() != getNumVariables()))
+        {
+            XBot::Logger::error("OSQP: H_pattern should be %i x %i\n", getNumVariables(), getNumVariables());
+            return;
+        }
+        if(opt.A_pattern.size() > 0 && (opt.A_pattern.rows() != getNumConstraints() || opt.A_pattern.cols() != getNumVariables()))
+        {
+            XBot::Logger::error("OSQP: A_pattern should be %i x %i\n", getNumConstraints(), getNumVariables());
+            return;
+        }
+
+        auto same = [](const SparsityPattern& a, const SparsityPattern& b){
+            return a.rows() == b.rows() && a.cols() == b.cols() && (a.size() == 0 || a == b);
+        };
+        if(sparse != _sparse || _detect_patterns || !same(opt.H_pattern, _P_pattern) || !same(opt.A_pattern, _A_pattern))
+        {
+            _sparse = sparse;
+            _detect_patterns = false;
+            _P_pattern = opt.H_pattern;
+            _A_pattern = opt.A_pattern;
+            //the data structures of an initialized problem have to be created again
+            if(_workspace)
+                initProblem(_H, _g, _A, _lA, _uA, _l, _u);
+        }
+        return;
+    }
+
+    const OSQPSettings* old_settings = _settings.get();
     _settings.reset();
     _settings = std::make_shared<OSQPSettings>(boost::any_cast<OSQPSettings>(options));
     if(_workspace)
+    {
+        //the copy of the settings done by osqp_setup() is not used anymore
+        if(_workspace->settings != old_settings)
+            c_free(_workspace->settings);
         _workspace->settings = _settings.get();
+    }
 }
 
 bool OSQPBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                                 const Eigen::MatrixXd &A,
+                                 const Eigen::Ref<const RowMajorMatrixXd> &A,
                                  const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                                  const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
@@ -249,7 +505,22 @@ bool OSQPBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
         return false;}
 
     _H = H; _g = g; _A = A; _lA = lA; _uA = uA; _l = l; _u = u; //this is needed since updateX should be used just to update and not init (maybe can be done in the base class)
-    __generate_data_struct(H.rows(), A.rows(), l.size());
+
+    //the detected patterns start from the nonzeros of the first problem and are only grown afterwards
+    if(_detect_patterns && _P_pattern.size() == 0)
+    {
+        _P_pattern.setConstant(H.rows(), H.cols(), false);
+        _A_pattern.setConstant(A.rows(), A.cols(), false);
+    }
+    if(_sparse)
+    {
+        grow_P_pattern();
+        grow_A_pattern();
+        _patterns_grown = false;
+        __generate_sparse_data_struct();
+    }
+    else
+        __generate_data_struct(H.rows(), A.rows(), l.size());
 
     bool success = true;
     success = updateTask(H, g) && success;
@@ -265,24 +536,8 @@ bool OSQPBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g
     }
     
 
-    //_workspace.reset( osqp_setup(_data.get(), _settings.get()) );
-    
-    c_int setup_return = 0;
-    if(_data && _settings)
-        setup_return = osqp_setup(&_workspace, _data.get(), _settings.get());
-    else
-    {
-        XBot::Logger::error("OSQP: data or settings not created before setup\n");
-        return false;
-    }
-
-
-    if(!_workspace)
-    {
-        XBot::Logger::error("OSQP: unable to setup workspace\n");
+    if(!setup())
         return false;
-    }
-
 
     success = solve() && success;
     
@@ -317,7 +572,7 @@ double OSQPBackEnd::getObjective()
 
 OSQPBackEnd::~OSQPBackEnd()
 {
-    osqp_cleanup(_workspace);
+    cleanup();
 }
 
 bool OSQPBackEnd::setEpsRegularisation(const double eps)
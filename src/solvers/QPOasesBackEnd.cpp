@@ -4,6 +4,7 @@
 #include <qpOASES/Utils.hpp>
 #include <fstream>
 #include <memory>
+#include <algorithm>
 #include <iostream>
 #include <qpOASES/Matrices.hpp>
 #include <xbot2_interface/logger.h>
@@ -23,13 +24,22 @@ extern "C" void destroy_instance( BackEnd * instance )
     delete instance;
 }
 
+extern "C" void get_capabilities(BackEndCapabilities * capabilities)
+{
+    capabilities->lp = true;
+    capabilities->hotstart = true;
+    capabilities->max_recommended_size = 300;
+}
+
 QPOasesBackEnd::QPOasesBackEnd(const int number_of_variables,
                                const int number_of_constraints,
                                OpenSoT::HessianType hessian_type, const double eps_regularisation):
     BackEnd(number_of_variables, number_of_constraints),
     _nWSR(13200),
+    _number_of_iterations(0),
     _epsRegularisation(eps_regularisation),
-    _dual_solution(number_of_variables)
+    _dual_solution(number_of_variables),
+    _constraints_capacity(0)
 {
     _problem = std::make_shared<qpOASES::SQProblem>(number_of_variables,
                                                       number_of_constraints,
@@ -76,6 +86,23 @@ void QPOasesBackEnd::setDefaultOptions()
 }
 
 void QPOasesBackEnd::setOptions(const boost::any &options){
+    if(options.type() == typeid(QPOasesBackEndOptions))
+    {
+        const QPOasesBackEndOptions& opt = boost::any_cast<const QPOasesBackEndOptions&>(options);
+        if(opt.options)
+            setOptions(*opt.options);
+
+        if(opt.constraints_capacity != _constraints_capacity)
+        {
+            bool initialised = _problem->isInitialised();
+            _constraints_capacity = opt.constraints_capacity;
+            resetProblem();
+            if(initialised)
+                initProblem(_H, _g, _A, _lA, _uA, _l, _u);
+        }
+        return;
+    }
+
     _opt.reset();
     _opt = std::make_shared<qpOASES::Options>(boost::any_cast<qpOASES::Options>(options));
     _problem->setOptions(boost::any_cast<qpOASES::Options>(options));}
@@ -84,7 +111,7 @@ boost::any QPOasesBackEnd::getOptions(){
     return _problem->getOptions();}
 
 bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                                 const Eigen::MatrixXd &A,
+                                 const Eigen::Ref<const RowMajorMatrixXd> &A,
                                  const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                                  const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
@@ -94,11 +121,7 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
         return false;}
 
     _H = H; _g = g; _A = A; _lA = lA; _uA = uA; _l = l; _u = u;
-
-
-    unsigned int _H_rows = _H.rows();
-    for(unsigned int i = 0; i < _H_rows; ++i)
-        _H(i,i) += _epsRegularisation;
+    regulariseHessian();
 
     checkINFTY();
 
@@ -122,15 +145,17 @@ bool QPOasesBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd
     int nWSR = _nWSR;
 
     /**
-     * this typedef is needed since qpOASES wants RoWMajor organization
-     * of matrices. Thanks to Arturo Laurenzi for the help finding this issue!
+     * qpOASES wants RoWMajor organization of matrices, _A is stored row-major.
+     * Thanks to Arturo Laurenzi for the help finding this issue!
      */
-    _A_rm = _A;
-    qpOASES::returnValue val =_problem->init(_H.data(),_g.data(),
-                       _A_rm.data(),
+    const double *A_ptr, *lA_ptr, *uA_ptr;
+    pileConstraints(A_ptr, lA_ptr, uA_ptr);
+    qpOASES::returnValue val =_problem->init(_H_regularised.data(),_g.data(),
+                       A_ptr,
                        _l.data(), _u.data(),
-                       _lA.data(),_uA.data(),
+                       lA_ptr, uA_ptr,
                        nWSR,0);
+    _number_of_iterations = nWSR;
 
     if(qpOASES::getSimpleStatus(val) < 0)
     {
@@ -182,6 +207,7 @@ bool QPOasesBackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd
     {
         _H = H;
         _g = g;
+        regulariseHessian();
 
         return true;
     }
@@ -190,19 +216,12 @@ bool QPOasesBackEnd::updateTask(const Eigen::MatrixXd &H, const Eigen::VectorXd
         _H = H;
         _g = g;
 
-        qpOASES::HessianType hessian_type = _problem->getHessianType();
-        int number_of_variables = _H.cols();
-        int number_of_constraints = _A.rows();
-        _problem.reset();
-        _problem = std::make_shared<qpOASES::SQProblem>(number_of_variables,
-                                                          number_of_constraints,
-                                                          hessian_type);
-        _problem->setOptions(*_opt.get());
+        resetProblem();
         return initProblem(_H, _g, _A, _lA, _uA, _l, _u);
     }
 }
 
-bool QPOasesBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
+bool QPOasesBackEnd::updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A,
                                const Eigen::Ref<const Eigen::VectorXd> &lA, 
                                const Eigen::Ref<const Eigen::VectorXd> &uA)
 {
@@ -219,8 +238,9 @@ bool QPOasesBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>&
         XBot::Logger::error("uA size: %i \n", uA.rows());
         return false;}
 
-    if(A.rows() == _A.rows())
+    if(A.rows() == _A.rows() || A.rows() <= _constraints_capacity)
     {
+        //within the capacity the new rows are piled in the same SQProblem at the next solve
         _A = A;
         _lA = lA;
         _uA = uA;
@@ -232,14 +252,16 @@ bool QPOasesBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>&
         _lA = lA;
         _uA = uA;
 
-        qpOASES::HessianType hessian_type = _problem->getHessianType();
-        int number_of_variables = _H.cols();
-        int number_of_constraints = _A.rows();
-        _problem.reset();
-        _problem = std::make_shared<qpOASES::SQProblem>(number_of_variables,
-                                                          number_of_constraints,
-                                                          hessian_type);
-        _problem->setOptions(*_opt.get());
+        if(_constraints_capacity > 0)
+        {
+#ifdef OPENSOT_VERBOSE
+            XBot::Logger::warning("Number of constraints %i exceeds the capacity %i, capacity is enlarged \n",
+                                  _A.rows(), _constraints_capacity);
+#endif
+            _constraints_capacity = _A.rows();
+        }
+
+        resetProblem();
         return initProblem(_H, _g, _A, _lA, _uA, _l, _u);
     }
 }
@@ -250,16 +272,14 @@ bool QPOasesBackEnd::solve()
     int nWSR = _nWSR;
     checkINFTY();
 
-    unsigned int _H_rows = _H.rows();
-    for(unsigned int i = 0; i < _H_rows; ++i)
-        _H(i,i) += _epsRegularisation;
-
-    _A_rm = _A;
-    qpOASES::returnValue val =_problem->hotstart(_H.data(),_g.data(),
-                       _A_rm.data(),
+    const double *A_ptr, *lA_ptr, *uA_ptr;
+    pileConstraints(A_ptr, lA_ptr, uA_ptr);
+    qpOASES::returnValue val =_problem->hotstart(_H_regularised.data(),_g.data(),
+                       A_ptr,
                         _l.data(), _u.data(),
-                       _lA.data(),_uA.data(),
+                       lA_ptr, uA_ptr,
                        nWSR,0);
+    _number_of_iterations = nWSR;
 
     if(val != qpOASES::SUCCESSFUL_RETURN){
 #ifdef OPENSOT_VERBOSE
@@ -267,13 +287,14 @@ bool QPOasesBackEnd::solve()
         XBot::Logger::success("RETRYING INITING WITH WARMSTART \n");
 #endif
 
-        val =_problem->init(_H.data(),_g.data(),
-                           _A_rm.data(),
+        val =_problem->init(_H_regularised.data(),_g.data(),
+                           A_ptr,
                            _l.data(), _u.data(),
-                           _lA.data(),_uA.data(),
+                           lA_ptr, uA_ptr,
                            nWSR,0,
                            _solution.data(), _dual_solution.data(),
                            _bounds.get(), _constraints.get());
+        _number_of_iterations += nWSR;
 
         if(val != qpOASES::SUCCESSFUL_RETURN){
 #ifdef OPENSOT_VERBOSE
@@ -355,6 +376,55 @@ void QPOasesBackEnd::checkINFTY()
     }
 }
 
+void QPOasesBackEnd::resetProblem()
+{
+    qpOASES::HessianType hessian_type = _problem->getHessianType();
+    int number_of_variables = _H.cols();
+    int number_of_constraints = std::max<int>(_A.rows(), _constraints_capacity);
+    _problem.reset();
+    _problem = std::make_shared<qpOASES::SQProblem>(number_of_variables,
+                                                      number_of_constraints,
+                                                      hessian_type);
+    _problem->setOptions(*_opt.get());
+}
+
+void QPOasesBackEnd::pileConstraints(const double*& A, const double*& lA, const double*& uA)
+{
+    if(_constraints_capacity == 0)
+    {
+        A = _A.data();
+        lA = _lA.data();
+        uA = _uA.data();
+        return;
+    }
+
+    const int number_of_constraints = _A.rows();
+    const int rows = std::max(number_of_constraints, _constraints_capacity);
+
+    _A_padded.resize(rows, _H.cols());
+    _lA_padded.resize(rows);
+    _uA_padded.resize(rows);
+
+    if(number_of_constraints > 0)
+    {
+        _A_padded.topRows(number_of_constraints) = _A;
+        _lA_padded.head(number_of_constraints) = _lA;
+        _uA_padded.head(number_of_constraints) = _uA;
+    }
+
+    const int free_rows = rows - number_of_constraints;
+    if(free_rows > 0)
+    {
+        _A_padded.bottomRows(free_rows).setZero();
+        _lA_padded.tail(free_rows).setConstant(-qpOASES::INFTY);
+        _uA_padded.tail(free_rows).setConstant(qpOASES::INFTY);
+    }
+
+    A = _A_padded.data();
+    lA = _lA_padded.data();
+    uA = _uA_padded.data();
+}
+
 bool QPOasesBackEnd::setEpsRegularisation(const double eps)
 {
     if(eps < 0.0)
@@ -367,6 +437,13 @@ bool QPOasesBackEnd::setEpsRegularisation(const double eps)
 
     _opt->epsRegularisation = _epsRegularisation;
     _problem->setOptions(*_opt);
+    regulariseHessian();
 
     return true;
 }
+
+void QPOasesBackEnd::regulariseHessian()
+{
+    _H_regularised = _H;
+    _H_regularised.diagonal().array() += _epsRegularisation;
+}
@@ -1,6 +1,7 @@
 #include <OpenSoT/solvers/eHQP.h>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 #define GREEN "\033[0;32m"
 #define YELLOW "\033[0;33m"
@@ -9,7 +10,8 @@
 
 using namespace OpenSoT::solvers;
 
-eHQP::eHQP(Stack& stack) : Solver<Eigen::MatrixXd, Eigen::VectorXd>(stack), sigma_min(Eigen::NumTraits<double>::epsilon())
+eHQP::eHQP(Stack& stack) : Solver<Eigen::MatrixXd, Eigen::VectorXd>(stack),
+    _decomposition_method(DecompositionMethod::SVD), sigma_min(Eigen::NumTraits<double>::epsilon())
 {
     //if(stack.size() > 0)
     //{
@@ -30,23 +32,40 @@ eHQP::eHQP(Stack& stack) : Solver<Eigen::MatrixXd, Eigen::VectorXd>(stack), sigm
                     error_ss << "Task "<<i-1<<" has Hessian Type HST_ZERO which is not handled by eHQP, aborting!"<<std::endl;
                     throw std::runtime_error(error_ss.str());}
 
+                const int task_size = _tasks[i-1]->getA().rows();
+                const int k = std::min(task_size, _x_size);
+
                 lvl._P = Eigen::MatrixXd::Identity(_x_size, _x_size);
                 lvl._JP = Eigen::MatrixXd::Identity(
-                    _tasks[i-1]->getA().rows(), _x_size);
+                    task_size, _x_size);
                 lvl._JPpinv = Eigen::MatrixXd::Identity(
-                    _x_size, _tasks[i-1]->getA().rows());
+                    _x_size, task_size);
 
                 lvl._JPsvd = Eigen::JacobiSVD<Eigen::MatrixXd>(
-                            _tasks[i-1]->getA().rows(),_x_size,
+                            task_size,_x_size,
                             Eigen::ComputeThinU | Eigen::ComputeThinV);
 
                 #if EIGEN_MINOR_VERSION <= 0
                 lvl._FPL = Eigen::FullPivLU<Eigen::MatrixXd>(
-                            _tasks[i-1]->getA().rows(), _x_size);
+                            task_size, _x_size);
 
                 #endif
 
-
+                lvl._WChol = Eigen::LLT<Eigen::MatrixXd>(task_size);
+                lvl._Wsqrt.setOnes(task_size);
+                lvl._AP.setZero(task_size, _x_size);
+                lvl._r.setZero(task_size);
+                lvl._Lr.setZero(task_size);
+                lvl._singularValuesInv.setZero(k);
+                lvl._VsingularValuesInv.setZero(_x_size, k);
+
+                lvl._JPqr = Eigen::ColPivHouseholderQR<Eigen::MatrixXd>(_x_size, task_size);
+                lvl._Q.setZero(_x_size, k);
+                lvl._RPt.setZero(k, task_size);
+                lvl._G.setZero(k, k);
+                lvl._GChol = Eigen::LLT<Eigen::MatrixXd>(k);
+                lvl._z.setZero(k);
+                lvl._workspace.setZero(k);
             }
             _stack_levels.push_back(lvl);
 
@@ -63,70 +82,156 @@ eHQP::eHQP(Stack& stack) : Solver<Eigen::MatrixXd, Eigen::VectorXd>(stack), sigm
 
 bool eHQP::solve(Eigen::VectorXd& solution)
 {
+    utils::SolverStatistics::clock::time_point solve_start;
+    if(_statistics) solve_start = utils::SolverStatistics::clock::now();
+
     solution.setZero(_x_size);
     for(unsigned int i = 1; i <= _tasks.size(); ++i)
     {
-        _stack_levels[i]._WChol.compute(_tasks[i-1]->getWeight());
+        //timings are taken only if the statistics are enabled, there is no back-end: the weighting and the
+        //projection of the task are recorded as cost, the decomposition as back-end time
+        utils::LevelStatistics* stats = _statistics ? &_statistics->level(i-1) : nullptr;
+        utils::SolverStatistics::clock::time_point start;
+        if(stats) start = utils::SolverStatistics::clock::now();
+
+        stack_level& level = _stack_levels[i];
+        const stack_level& previous_level = _stack_levels[i-1];
+        const Eigen::MatrixXd& A = _tasks[i-1]->getA();
+        const Eigen::MatrixXd& W = _tasks[i-1]->getWeight();
+
+        // error of the task at the solution of the previous levels
+        level._r.noalias() = A * solution;
+        level._r = _tasks[i-1]->getb() - level._r;
+
+        // L'*A*P and L'*r with W = LL', the projector of the first level is the identity
+        if(W.isDiagonal(0.))
+        {
+            if(i == 1)
+                level._JP = A;
+            else
+                level._JP.noalias() = A * previous_level._P;
+
+            if(!W.isIdentity(0.))
+            {
+                level._Wsqrt = W.diagonal().cwiseSqrt();
+                level._JP.array().colwise() *= level._Wsqrt.array();
+                level._r.array() *= level._Wsqrt.array();
+            }
+        }
+        else
+        {
+            level._WChol.compute(W);
 
-        _stack_levels[i]._JP = _stack_levels[i]._WChol.matrixL().transpose() * _tasks[i-1]->getA()*_stack_levels[i-1]._P;
-        _stack_levels[i]._JPsvd.compute(_stack_levels[i]._JP);
+            if(i == 1)
+                level._AP = A;
+            else
+                level._AP.noalias() = A * previous_level._P;
 
-#if EIGEN_MINOR_VERSION <= 0
-        _stack_levels[i]._FPL.compute(_stack_levels[i]._JP);
-        _stack_levels[i]._JPpinv = this->getDampedPinv(
-                    _stack_levels[i]._JP, _stack_levels[i]._JPsvd,
-                    _stack_levels[i]._FPL);
-#else
-        _stack_levels[i]._JPpinv = this->getDampedPinv(_stack_levels[i]._JP,
-                                                       _stack_levels[i]._JPsvd);
-#endif
+            level._JP.noalias() = level._WChol.matrixU() * level._AP;
+            level._Lr.noalias() = level._WChol.matrixU() * level._r;
+            level._r.swap(level._Lr);
+        }
 
-         solution += _stack_levels[i]._JPpinv * (
-                     _stack_levels[i]._WChol.matrixL().transpose() * _tasks[i-1]->getb()-
-                 _stack_levels[i]._WChol.matrixL().transpose() * _tasks[i-1]->getA()*solution
-                 );
+        if(stats)
+        {
+            stats->cost_time = utils::SolverStatistics::elapsed(start);
+            start = utils::SolverStatistics::clock::now();
+        }
 
+        if(_decomposition_method == DecompositionMethod::COD)
+            solveCOD(level, previous_level, solution);
+        else
+            solveSVD(level, previous_level, solution);
 
+        if(stats)
+        {
+            stats->back_end_time = stats->back_end_solve_time = utils::SolverStatistics::elapsed(start);
+            stats->success = true;
+        }
+    }
 
-        _stack_levels[i]._P = _stack_levels[i-1]._P -
-                _stack_levels[i]._JPsvd.matrixV() * _stack_levels[i]._JPsvd.matrixV().transpose();
+    if(_statistics)
+    {
+        _statistics->current().solve_time = utils::SolverStatistics::elapsed(solve_start);
+        _statistics->current().success = true;
+        _statistics->commit();
     }
     return true;
 }
 
-#if EIGEN_MINOR_VERSION <= 0
-Eigen::MatrixXd eHQP::getDampedPinv(  const Eigen::MatrixXd& J,
-                        const Eigen::JacobiSVD<Eigen::MatrixXd>& svd,
-                        const Eigen::FullPivLU<Eigen::MatrixXd>& fpl) const
+void eHQP::solveSVD(stack_level& level, const stack_level& previous_level, Eigen::VectorXd& solution)
 {
-    int rank = fpl.rank();
-    Eigen::MatrixXd singularValuesInv(J.cols(), J.cols());
-    singularValuesInv.setZero(J.rows(), J.rows());
+    level._JPsvd.compute(level._JP);
+#if EIGEN_MINOR_VERSION <= 0
+    level._FPL.compute(level._JP);
+#endif
+    const int rank = this->getDampedPinv(level);
 
-    double lambda = svd.singularValues().minCoeff();
+    solution.noalias() += level._JPpinv * level._r;
 
+    // P = P_prev - V*V' (rank update in place), only the singular vectors spanning the row space of J*P are considered
+    level._P = previous_level._P;
+    level._P.noalias() -= level._JPsvd.matrixV().leftCols(rank) * level._JPsvd.matrixV().leftCols(rank).transpose();
+}
 
-    if(svd.singularValues().minCoeff() >= sigma_min)
+void eHQP::solveCOD(stack_level& level, const stack_level& previous_level, Eigen::VectorXd& solution)
+{
+    const int k = level._Q.cols();
+
+    // (J*P)'*Pi = Q*R  ->  J*P = Pi*R'*Q'
+    level._JPqr.compute(level._JP.transpose());
+    const int rank = level._JPqr.rank();
+
+    // _RPt = R*Pi', the rows after the rank are set to zero
+    level._RPt.setZero();
+    for(unsigned int j = 0; j < level._RPt.cols(); ++j)
     {
-        for(unsigned int i = 0; i < rank; ++i)
-            singularValuesInv(i,i) = 1./svd.singularValues()[i];
-    } else {
-        //double lambda = std::pow(lambda_max,2) * (1. -  std::pow(svd.singularValues()[rank-1]/sigma_min,2));
-        for(unsigned int i = 0; i < rank; ++i)
-            singularValuesInv(i,i) =
-                    svd.singularValues()[i]/(std::pow(svd.singularValues()[i],2)+lambda*lambda);
+        const int rows = std::min<int>(j + 1, rank);
+        level._RPt.col(level._JPqr.colsPermutation().indices()[j]).head(rows) =
+                level._JPqr.matrixQR().col(j).head(rows);
     }
 
+    // the damping is applied as in getDampedPinv, the smallest singular value is estimated from R
+    double lambda = 0.;
+    if(rank == k)
+    {
+        lambda = level._JPqr.matrixQR().diagonal().cwiseAbs().minCoeff();
+        if(lambda >= sigma_min)
+            lambda = 0.;
+    }
 
-    return svd.matrixV()* singularValuesInv *svd.matrixU().transpose();
+    // G = R*R' + lambda^2*I, the rows after the rank are decoupled from the others
+    level._G.setZero();
+    level._G.selfadjointView<Eigen::Lower>().rankUpdate(level._RPt);
+    level._G.diagonal().array() += lambda*lambda;
+    level._G.diagonal().tail(k - rank).setOnes();
+    level._GChol.compute(level._G);
+
+    // first rank columns of Q, spanning the row space of J*P
+    level._Q.setZero();
+    level._Q.topRows(k).setIdentity();
+    level._JPqr.householderQ().applyThisOnTheLeft(level._Q, level._workspace);
+
+    // solution += Q*G^-1*R*Pi'*r
+    level._z.noalias() = level._RPt * level._r;
+    level._GChol.solveInPlace(level._z);
+    solution.noalias() += level._Q.leftCols(rank) * level._z.head(rank);
+
+    // P = P_prev - Q*Q' (rank update in place)
+    level._P = previous_level._P;
+    level._P.noalias() -= level._Q.leftCols(rank) * level._Q.leftCols(rank).transpose();
 }
-#else
-Eigen::MatrixXd eHQP::getDampedPinv( const Eigen::MatrixXd& J,
-                                                    const Eigen::JacobiSVD<Eigen::MatrixXd>& svd) const
+
+int eHQP::getDampedPinv(stack_level& level) const
 {
+    const Eigen::JacobiSVD<Eigen::MatrixXd>& svd = level._JPsvd;
+
+#if EIGEN_MINOR_VERSION <= 0
+    int rank = level._FPL.rank();
+#else
     int rank = svd.rank();
-    Eigen::MatrixXd singularValuesInv(J.cols(), J.cols());
-    singularValuesInv.setZero(J.rows(), J.rows());
+#endif
+    level._singularValuesInv.setZero();
 
     double lambda = svd.singularValues().minCoeff();
 
@@ -134,17 +239,19 @@ Eigen::MatrixXd eHQP::getDampedPinv( const Eigen::MatrixXd& J,
     if(svd.singularValues().minCoeff() >= sigma_min)
     {
         for(unsigned int i = 0; i < rank; ++i)
-            singularValuesInv(i,i) = 1./svd.singularValues()[i];
+            level._singularValuesInv[i] = 1./svd.singularValues()[i];
     } else {
         //double lambda = std::pow(lambda_max,2) * (1. -  std::pow(svd.singularValues()[rank-1]/sigma_min,2));
         for(unsigned int i = 0; i < rank; ++i)
-            singularValuesInv(i,i) =
+            level._singularValuesInv[i] =
                     svd.singularValues()[i]/(std::pow(svd.singularValues()[i],2)+lambda*lambda);
     }
 
-    return svd.matrixV()* singularValuesInv *svd.matrixU().transpose();
+    level._VsingularValuesInv.noalias() = svd.matrixV() * level._singularValuesInv.asDiagonal();
+    level._JPpinv.noalias() = level._VsingularValuesInv * svd.matrixU().transpose();
+
+    return rank;
 }
-#endif
 
 double eHQP::getSigmaMin() const
 {
@@ -157,7 +264,10 @@ void eHQP::setSigmaMin(const double& sigma_min)
     if(sigma_min > 0)
     {
         for(unsigned int i = 0; i < _stack_levels.size(); ++i)
+        {
             _stack_levels[i]._FPL.setThreshold(sigma_min);
+            _stack_levels[i]._JPqr.setThreshold(sigma_min);
+        }
 
         this->sigma_min = sigma_min;
     }
@@ -170,7 +280,10 @@ void eHQP::setSigmaMin(const double& sigma_min)
         // for(unsigned int i = 0; i < _JPsvd.size(); ++i)
         //    _JPsvd[i].setThreshold(sigma_min);
         for(unsigned int i = 0; i < _stack_levels.size(); ++i)
+        {
             _stack_levels[i]._JPsvd.setThreshold(sigma_min);
+            _stack_levels[i]._JPqr.setThreshold(sigma_min);
+        }
 
 
         this->sigma_min = sigma_min;
@@ -178,6 +291,16 @@ void eHQP::setSigmaMin(const double& sigma_min)
 }
 #endif
 
+void eHQP::setDecompositionMethod(const DecompositionMethod method)
+{
+    _decomposition_method = method;
+}
+
+eHQP::DecompositionMethod eHQP::getDecompositionMethod() const
+{
+    return _decomposition_method;
+}
+
 void eHQP::printProblemInformation(const int problem_number, const std::string& problem_id,
                                       const std::string& constraints_id, const std::string& bounds_id)
 {
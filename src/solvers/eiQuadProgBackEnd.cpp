@@ -19,16 +19,22 @@ extern "C" void destroy_instance( BackEnd * instance )
     delete instance;
 }
 
+extern "C" void get_capabilities(BackEndCapabilities * capabilities)
+{
+    capabilities->real_time_safe = true;
+    capabilities->positive_definite_hessian = true;
+    capabilities->max_recommended_size = 100;
+}
+
 eiQuadProgBackEnd::eiQuadProgBackEnd(const int number_of_variables,
                                    const int number_of_constraints,
                                    const double eps_regularisation):
     BackEnd(number_of_variables, number_of_constraints),
     _eps_regularisation(eps_regularisation*BASE_REGULARISATION),
-    /** initialization of Pilers **/
-    _CIPiler(number_of_variables),
-    _ci0Piler(1)
+    _H_trace(0.),
+    _eps_factorized(-1.)
 {
-    _I.setIdentity(number_of_variables, number_of_variables);
+
 }
 
 eiQuadProgBackEnd::~eiQuadProgBackEnd()
@@ -39,34 +45,82 @@ eiQuadProgBackEnd::~eiQuadProgBackEnd()
 
 void eiQuadProgBackEnd::__generate_data_struct()
 {
-    //Bounds & Constraints
-        _CIPiler.reset();
-        _ci0Piler.reset();
+    //Bounds & Constraints, in the order: lower bounds, upper bounds, lower constraints, upper constraints
+    int m = 0;
+    for(int i = 0; i < _l.size(); ++i)
+        m += (_l[i] > -EIQUADPROG_INFINITY) + (_u[i] < EIQUADPROG_INFINITY);
+    for(int i = 0; i < _lA.size(); ++i)
+        m += (_lA[i] > -EIQUADPROG_INFINITY) + (_uA[i] < EIQUADPROG_INFINITY);
+
+    _CI.resize(_number_of_variables, m);
+    _ci0.resize(m);
+
+    int k = 0;
 
-        //1) Bounds
-        if(_l.size() > 0)
+    //1) Bounds
+    for(int i = 0; i < _l.size(); ++i)
+    {
+        if(_l[i] > -EIQUADPROG_INFINITY)
+        {
+            _CI.col(k).setZero();
+            _CI(i, k) = 1.;
+            _ci0[k++] = -_l[i];
+        }
+    }
+    for(int i = 0; i < _u.size(); ++i)
+    {
+        if(_u[i] < EIQUADPROG_INFINITY)
         {
-            _CIPiler.pile(_I);
-            _ci0Piler.pile(-_l);
-            _CIPiler.pile(-_I);
-            _ci0Piler.pile(_u);
+            _CI.col(k).setZero();
+            _CI(i, k) = -1.;
+            _ci0[k++] = _u[i];
         }
+    }
 
-        //2) Constraints
-        if(_A.rows() > 0)
+    //2) Constraints, _A is row-major hence its rows are copied in the columns of _CI without strided accesses
+    for(int i = 0; i < _lA.size(); ++i)
+    {
+        if(_lA[i] > -EIQUADPROG_INFINITY)
+        {
+            _CI.col(k) = _A.row(i).transpose();
+            _ci0[k++] = -_lA[i];
+        }
+    }
+    for(int i = 0; i < _uA.size(); ++i)
+    {
+        if(_uA[i] < EIQUADPROG_INFINITY)
         {
-            _CIPiler.pile(_A);
-            _ci0Piler.pile(-_lA);
-            _CIPiler.pile(-_A);
-            _ci0Piler.pile(_uA);
+            _CI.col(k) = -_A.row(i).transpose();
+            _ci0[k++] = _uA[i];
         }
+    }
+}
 
-        for(int i = 0; i < _H.rows(); ++i)
-            _H(i,i) += _eps_regularisation;
+bool eiQuadProgBackEnd::__solve()
+{
+    //the Cholesky decomposition of H is computed only if H or the regularisation changed, the regularisation is
+    //added to a copy so that _H is not modified
+    if(_H_factorized.rows() != _H.rows() || _H_factorized != _H || _eps_factorized != _eps_regularisation)
+    {
+        _H_factorized = _H;
+        _eps_factorized = _eps_regularisation;
+        _H_regularised = _H;
+        _H_regularised.diagonal().array() += _eps_regularisation;
+        _H_trace = _H_regularised.trace();
+        _workspace.chol.compute(_H_regularised);
+    }
+
+    _f_value = solve_quadprog2(_workspace.chol, _H_trace, _g, _CE, _ce0, _CI, _ci0, _solution, _workspace);
+    if(_f_value == std::numeric_limits<double>::infinity())
+    {
+        XBot::Logger::error("QPP is infeasible");
+        return false;
+    }
+    return true;
 }
 
 bool eiQuadProgBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::VectorXd &g,
-                         const Eigen::MatrixXd &A,
+                         const Eigen::Ref<const RowMajorMatrixXd> &A,
                          const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                          const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
@@ -78,39 +132,14 @@ bool eiQuadProgBackEnd::initProblem(const Eigen::MatrixXd &H, const Eigen::Vecto
     _H = H; _g = g; _A = A; _lA = lA; _uA = uA; _l = l; _u = u; //this is needed since updateX should be used just to update and not init (maybe can be done in the base class)
     __generate_data_struct();
 
-    const double inf = std::numeric_limits<double>::infinity();
-
-
-    _f_value = solve_quadprog(_H, _g, Eigen::MatrixXd(), Eigen::VectorXd(),
-                              _CIPiler.generate_and_get().transpose(),
-                              _ci0Piler.generate_and_get(),
-                              _solution);
-    if(_f_value == inf)
-    {
-        XBot::Logger::error("QPP is infeasible");
-        return false;
-    }
-    return true;
-
+    return __solve();
 }
 
 bool eiQuadProgBackEnd::solve()
 {
     __generate_data_struct();
 
-    const double inf = std::numeric_limits<double>::infinity();
-
-
-    _f_value = solve_quadprog(_H, _g, Eigen::MatrixXd(), Eigen::VectorXd(),
-                              _CIPiler.generate_and_get().transpose(),
-                              _ci0Piler.generate_and_get(),
-                              _solution);
-    if(_f_value == inf)
-    {
-        XBot::Logger::error("QPP is infeasible");
-        return false;
-    }
-    return true;
+    return __solve();
 }
 
 double eiQuadProgBackEnd::getObjective()
@@ -2,10 +2,124 @@
 #include <OpenSoT/constraints/BilateralConstraint.h>
 #include <xbot2_interface/logger.h>
 #include <OpenSoT/utils/AutoStack.h>
+#include <numeric>
+#include <algorithm>
 
 
 using namespace OpenSoT::solvers;
 
+namespace {
+    /**
+     * @brief The BlockTask class contains the rows and the columns of a task which belong to an
+     * independent sub-problem, copied from the task at each solve
+     */
+    class BlockTask: public OpenSoT::Task<Eigen::MatrixXd, Eigen::VectorXd>
+    {
+    public:
+        typedef std::shared_ptr<BlockTask> Ptr;
+
+        BlockTask(const std::string& task_id, const std::vector<int>& rows, const std::vector<int>& columns,
+                  const OpenSoT::HessianType hessian_type):
+            Task(task_id, columns.size()),
+            _rows(rows),
+            _columns(columns)
+        {
+            _hessianType = hessian_type;
+            _A.setZero(_rows.size(), _columns.size());
+            _b.setZero(_rows.size());
+            _W.setIdentity(_rows.size(), _rows.size());
+        }
+
+        void copy(const TaskPtr& task)
+        {
+            _A = task->getA()(_rows, _columns);
+            _b = task->getb()(_rows);
+            _W = task->getWeight()(_rows, _rows);
+            _c = task->getc()(_columns);
+            _weight_is_diagonal = task->getWeightIsDiagonalFlag();
+            increaseVersion();
+        }
+
+    private:
+        void _update() override {}
+
+        std::vector<int> _rows, _columns;
+    };
+
+    /**
+     * @brief The BlockConstraint class contains the rows and the columns of the constraints of a level which
+     * belong to an independent sub-problem, copied from the constraints at each solve
+     */
+    class BlockConstraint: public OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>
+    {
+    public:
+        typedef std::shared_ptr<BlockConstraint> Ptr;
+
+        BlockConstraint(const std::string& constraint_id, const std::vector<int>& rows,
+                        const std::vector<int>& columns):
+            Constraint(constraint_id, columns.size()),
+            _rows(rows),
+            _columns(columns)
+        {
+
+        }
+
+        void copy(OpenSoT::constraints::Aggregated& constraints)
+        {
+            _Aineq = constraints.getAineq()(_rows, _columns);
+            _bLowerBound = constraints.getbLowerBound()(_rows);
+            _bUpperBound = constraints.getbUpperBound()(_rows);
+            if(constraints.getLowerBound().size() > 0)
+            {
+                _lowerBound = constraints.getLowerBound()(_columns);
+                _upperBound = constraints.getUpperBound()(_columns);
+            }
+            increaseVersion();
+        }
+
+    private:
+        std::vector<int> _rows, _columns;
+    };
+
+    /**
+     * @brief first_column of a row
+     * @return first non-zero column of the row, -1 for zero rows
+     */
+    int first_column(const Eigen::MatrixXd& A, const int row)
+    {
+        for(int j = 0; j < A.cols(); ++j)
+        {
+            if(A(row, j) != 0.)
+                return j;
+        }
+        return -1;
+    }
+}
+
+/**
+ * @brief The SubProblem struct contains the levels of the stack restricted to a block of variables
+ */
+struct iHQP::SubProblem {
+    std::vector<int> columns;
+    /**
+     * @brief levels of the stack in the sub-problem, i.e. levels with rows in the block
+     */
+    std::vector<unsigned int> levels;
+    std::vector<BlockTask::Ptr> tasks;
+    /**
+     * @brief constraints of each level, nullptr if the level has no constraints in the block
+     */
+    std::vector<BlockConstraint::Ptr> constraints;
+    iHQP::Ptr solver;
+    /**
+     * @brief statistics recorded by the solver of the sub-problem, never committed: they are summed in the
+     * record of the whole problem
+     */
+    SolverStatistics::Ptr statistics;
+    Eigen::VectorXd solution;
+    bool success;
+};
+
 const std::string iHQP::_IHQP_CONSTRAINTS_PLUS_ = "+";
 const std::string iHQP::_IHQP_CONSTRAINTS_OPTIMALITY_ = "_OPTIMALITY";
 
@@ -13,6 +127,7 @@ iHQP::iHQP(OpenSoT::AutoStack& stack_of_tasks, const double eps_regularisation,
      const solver_back_ends be_solver):
     Solver(stack_of_tasks.getStack(), stack_of_tasks.getBounds()),
     _epsRegularisation(eps_regularisation),
+    _real_time_mode(false),
     _regularisation_task(stack_of_tasks.getRegularisationTask())
 {
     for(unsigned int i = 0; i < stack_of_tasks.getStack().size(); ++i){
@@ -28,6 +143,7 @@ iHQP::iHQP(OpenSoT::AutoStack& stack_of_tasks, const double eps_regularisation,
      const std::vector<solver_back_ends> be_solver):
     Solver(stack_of_tasks.getStack(), stack_of_tasks.getBounds()),
     _epsRegularisation(eps_regularisation),
+    _real_time_mode(false),
     _be_solver(be_solver),
     _regularisation_task(stack_of_tasks.getRegularisationTask())
 {
@@ -40,7 +156,8 @@ iHQP::iHQP(OpenSoT::AutoStack& stack_of_tasks, const double eps_regularisation,
 
 iHQP::iHQP(Stack &stack_of_tasks, const double eps_regularisation,const solver_back_ends be_solver):
     Solver(stack_of_tasks),
-    _epsRegularisation(eps_regularisation)
+    _epsRegularisation(eps_regularisation),
+    _real_time_mode(false)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i){
         _active_stacks.push_back(true);
@@ -55,6 +172,7 @@ iHQP::iHQP(Stack& stack_of_tasks, const double eps_regularisation,
      const std::vector<solver_back_ends> be_solver):
     Solver(stack_of_tasks),
     _epsRegularisation(eps_regularisation),
+    _real_time_mode(false),
     _be_solver(be_solver)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i)
@@ -68,7 +186,8 @@ iHQP::iHQP(Stack &stack_of_tasks,
                          ConstraintPtr bounds,
                          const double eps_regularisation,const solver_back_ends be_solver):
     Solver(stack_of_tasks, bounds),
-    _epsRegularisation(eps_regularisation)
+    _epsRegularisation(eps_regularisation),
+    _real_time_mode(false)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i){
         _active_stacks.push_back(true);
@@ -85,6 +204,7 @@ iHQP::iHQP(Stack& stack_of_tasks,
             const std::vector<solver_back_ends> be_solver):
     Solver(stack_of_tasks, bounds),
     _epsRegularisation(eps_regularisation),
+    _real_time_mode(false),
     _be_solver(be_solver)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i)
@@ -99,7 +219,8 @@ iHQP::iHQP(Stack &stack_of_tasks,
                          ConstraintPtr globalConstraints,
                          const double eps_regularisation,const solver_back_ends be_solver):
     Solver(stack_of_tasks, bounds, globalConstraints),
-    _epsRegularisation(eps_regularisation)
+    _epsRegularisation(eps_regularisation),
+    _real_time_mode(false)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i){
         _active_stacks.push_back(true);
@@ -117,6 +238,7 @@ iHQP::iHQP(Stack& stack_of_tasks,
             const std::vector<solver_back_ends> be_solver):
     Solver(stack_of_tasks, bounds, globalConstraints),
     _epsRegularisation(eps_regularisation),
+    _real_time_mode(false),
     _be_solver(be_solver)
 {
     for(unsigned int i = 0; i < stack_of_tasks.size(); ++i)
@@ -131,42 +253,37 @@ void iHQP::computeCostFunction(const TaskPtr& task, Eigen::MatrixXd& H, Eigen::V
 //    H = task->getA().transpose() * task->getWeight() * task->getA();
 //    g = -1.0 * task->getA().transpose() * task->getWeight() * task->getb();
 
+    //the cache is shared by all the calls, it is invalidated since the task may be a different one
+    _cost_function.invalidate();
+    computeCostFunction(task, _cost_function);
+    H = _cost_function.getH();
+    g = _cost_function.getg();
+}
 
-    H.resize(task->getXSize(), task->getXSize());
-    if(task->getWeight().isIdentity())
-    {
-        if(task->getA().size() != 0)
-        {
-            H.triangularView<Eigen::Upper>() = task->getATranspose()*task->getA();
-            H = H.selfadjointView<Eigen::Upper>();
-            g.noalias() = -1.0 * task->getATranspose() * task->getb();
-            g += task->getc();
-        }
-        else
-            g = task->getc();
-    }
-    else
-    {
-        if(task->getA().size() != 0)
-        {
-            H.triangularView<Eigen::Upper>() = task->getATranspose()*task->getWA();
-            H = H.selfadjointView<Eigen::Upper>();
-            g.noalias() = -1.0 * task->getATranspose() * task->getWb();
-            g += task->getc();
-        }
-        else
-            g = task->getc();
-    }
-    
-    
+bool iHQP::computeCostFunction(const TaskPtr& task, CostFunctionCache& cost)
+{
+    return cost.compute(task->getA(), task->getb(), task->getWeight(), task->getc(), task->getVersion());
 }
 
 void iHQP::computeOptimalityConstraint(  const TaskPtr& task, BackEnd::Ptr& problem,
-                                                Eigen::MatrixXd& A, Eigen::VectorXd& lA, Eigen::VectorXd& uA)
+                                         RowMajorMatrixPiler& A, VectorPiler& lA, VectorPiler& uA)
+{
+    //opt_b is only enlarged, so that tasks of different sizes do not reallocate it at each solve
+    const int rows = task->getA().rows();
+    if(opt_b.size() < rows)
+        opt_b.resize(rows);
+    opt_b.head(rows).noalias() = task->getA()*problem->getSolution();
+    A.pile(task->getA());
+    lA.pile(opt_b.head(rows));
+    uA.pile(opt_b.head(rows));
+}
+
+void iHQP::computeFakeOptimalityConstraint(const TaskPtr& task,
+                                           RowMajorMatrixPiler& A, VectorPiler& lA, VectorPiler& uA)
 {
-    A = task->getA();
-    lA.noalias() = task->getA()*problem->getSolution();
-    uA = lA;
+    A.pile(Eigen::MatrixXd::Zero(task->getA().rows(), task->getA().cols()));
+    lA.pile(Eigen::VectorXd::Constant(task->getA().rows(), -1.0));
+    uA.pile(Eigen::VectorXd::Constant(task->getA().rows(), 1.0));
 }
 
 bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
@@ -174,17 +291,26 @@ bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
     if(_regularisation_task)
     {
         XBot::Logger::info("User defined regularisation will be added to all levels");
-        computeCostFunction(_regularisation_task, Hr, gr);
+        computeCostFunction(_regularisation_task, _regularisation_cost_function);
     }
 
+    _cost_functions.assign(_tasks.size(), CostFunctionCache());
+
+    if(!_tasks.empty())
+        A.reset(_tasks[0]->getXSize());
+    lA.reset(1);
+    uA.reset(1);
+
     for(unsigned int i = 0; i < _tasks.size(); ++i)
     {
         XBot::Logger::info("#USING BACK-END @LEVEL %i: %s\n", i, getBackEndName(i).c_str());
-        computeCostFunction(_tasks[i], H, g);
+        computeCostFunction(_tasks[i], _cost_functions[i]);
+        H = _cost_functions[i].getH();
+        g = _cost_functions[i].getg();
         if(_regularisation_task)
         {
-            H += Hr;
-            g += gr;
+            H += _regularisation_cost_function.getH();
+            g += _regularisation_cost_function.getg();
         }
 
         OpenSoT::constraints::Aggregated constraints_task_i(_tasks[i]->getConstraints(), _tasks[i]->getXSize());
@@ -197,35 +323,22 @@ bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
             constraints_task_i.generateAll();
         }
 
-        std::string constraints_str = constraints_task_i.getConstraintID();
-
-        A.set(constraints_task_i.getAineq());
-        lA.set(constraints_task_i.getbLowerBound());
-        uA.set(constraints_task_i.getbUpperBound());
-        if(i > 0)
+        std::string constraints_str = "";
+        for(unsigned int j = 0; j < i; ++j)
         {
-            Eigen::MatrixXd _tmp_A;
-            Eigen::VectorXd _tmp_lA, _tmp_uA;
-            for(unsigned int j = 0; j < i; ++j)
-            {
-                computeOptimalityConstraint(_tasks[j], _qp_stack_of_tasks[j], _tmp_A, _tmp_lA, _tmp_uA);
-
-                if( j == i-1)
-                {
-                    tmp_A.push_back(_tmp_A);
-                    tmp_lA.push_back(_tmp_lA);
-                    tmp_uA.push_back(_tmp_uA);
-                }
-
-                if(!constraints_str.compare("") == 0)
-                    constraints_str = constraints_str + _IHQP_CONSTRAINTS_PLUS_;
-                constraints_str = constraints_str + _tasks[j]->getTaskID() + _IHQP_CONSTRAINTS_OPTIMALITY_;
-
-                A.pile(tmp_A[j]);
-                lA.pile(tmp_lA[j]);
-                uA.pile(tmp_uA[j]);
-            }
+            if(!constraints_str.compare("") == 0)
+                constraints_str = constraints_str + _IHQP_CONSTRAINTS_PLUS_;
+            constraints_str = constraints_str + _tasks[j]->getTaskID() + _IHQP_CONSTRAINTS_OPTIMALITY_;
         }
+        if(!constraints_str.compare("") == 0 && !constraints_task_i.getConstraintID().compare("") == 0)
+            constraints_str = constraints_str + _IHQP_CONSTRAINTS_PLUS_;
+        constraints_str = constraints_str + constraints_task_i.getConstraintID();
+
+        //The optimality constraints of the previous levels are already piled in A, lA and uA
+        const int optimality_rows = A.rows();
+        A.pile(constraints_task_i.getAineq());
+        lA.pile(constraints_task_i.getbLowerBound());
+        uA.pile(constraints_task_i.getbUpperBound());
 
         if(_bounds && _bounds->isBound()){   // if it is a constraint, it has already been added in #74
             constraints_task_i.getConstraintsList().push_back(_bounds);
@@ -236,7 +349,15 @@ bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
 //        QPOasesBackEnd problem_i(_tasks[i]->getXSize(), A.rows(), (OpenSoT::HessianType)(_tasks[i]->getHessianAtype()),
 //                                 _epsRegularisation);
 
-        BackEnd::Ptr problem_i = BackEndFactory(be_solver[i],_tasks[i]->getXSize(), A.rows(), (OpenSoT::HessianType)(_tasks[i]->getHessianAtype()),
+        //the back-end of the level is chosen from the size, sparsity and Hessian type of the problem
+        if(be_solver[i] == solver_back_ends::Auto)
+        {
+            _be_solver[i] = selectBackEnd(_tasks[i]->getXSize(), A.rows(), (OpenSoT::HessianType)(_tasks[i]->getHessianAtype()),
+                                          _epsRegularisation, estimateDensity(H, A.generate_and_get()));
+            XBot::Logger::info("iHQP: level %i solved using %s back-end\n", i, whichBackEnd(_be_solver[i]).c_str());
+        }
+
+        BackEnd::Ptr problem_i = BackEndFactory(_be_solver[i],_tasks[i]->getXSize(), A.rows(), (OpenSoT::HessianType)(_tasks[i]->getHessianAtype()),
                                            _epsRegularisation);
 
         if(problem_i->initProblem(H, g, A.generate_and_get(), lA.generate_and_get(), uA.generate_and_get(), l, u)){
@@ -254,6 +375,14 @@ bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
             XBot::Logger::error("ERROR: INITIALIZING STACK %i \n", i);
             return false;}
 
+        //The constraints of this level are replaced by its optimality constraint for the next levels
+        if(i < _tasks.size() - 1)
+        {
+            A.rewind(optimality_rows);
+            lA.rewind(optimality_rows);
+            uA.rewind(optimality_rows);
+            computeOptimalityConstraint(_tasks[i], _qp_stack_of_tasks[i], A, lA, uA);
+        }
 
         constraints_task.push_back(constraints_task_i);
     }
@@ -262,101 +391,568 @@ bool iHQP::prepareSoT(const std::vector<solver_back_ends> be_solver)
 
 bool iHQP::solve(Eigen::VectorXd &solution)
 {
+    if(!_statistics)
+        return _thread_pool ? solveSubProblems(solution) : solveStack(solution);
+
+    const auto start = SolverStatistics::clock::now();
+    bool success = _thread_pool ? solveSubProblems(solution) : solveStack(solution);
+    _statistics->current().solve_time = SolverStatistics::elapsed(start);
+    _statistics->current().success = success;
+    _statistics->commit();
+    return success;
+}
+
+bool iHQP::solveStack(Eigen::VectorXd &solution)
+{
+    bool regularisation_changed = false;
     if(_regularisation_task)
-        computeCostFunction(_regularisation_task, Hr, gr);
+        regularisation_changed = computeCostFunction(_regularisation_task, _regularisation_cost_function);
 
+    A.reset();
+    lA.reset();
+    uA.reset();
 
     for(unsigned int i = 0; i < _tasks.size(); ++i)
     {
+        //Here A, lA and uA contain only the optimality (priority) constraints of the levels 0...i-1,
+        //these rows are kept in place while only the rows of level i are (re)written after them
+        const int optimality_rows = A.rows();
+
         if(_active_stacks[i])
         {
-            computeCostFunction(_tasks[i], H, g);
-            if(_regularisation_task)
+            //timings are taken only if the statistics are enabled
+            LevelStatistics* stats = _statistics ? &_statistics->level(i) : nullptr;
+            SolverStatistics::clock::time_point start;
+
+            if(stats) start = SolverStatistics::clock::now();
+            //H and g are assembled (and loaded in the back-end) only if the task or the regularisation changed
+            const bool cost_changed = computeCostFunction(_tasks[i], _cost_functions[i]) || regularisation_changed;
+            if(cost_changed && _regularisation_task)
             {
-                H += Hr;
-                g += gr;
+                H = _cost_functions[i].getH() + _regularisation_cost_function.getH();
+                g = _cost_functions[i].getg() + _regularisation_cost_function.getg();
             }
-            if(!_qp_stack_of_tasks[i]->updateTask(H, g))
-                return false;
+            if(stats) stats->cost_time = SolverStatistics::elapsed(start);
 
+            if(stats) start = SolverStatistics::clock::now();
             OpenSoT::constraints::Aggregated& constraints_task_i = constraints_task[i];
             constraints_task_i.generateAll();
 
-            A.set(constraints_task_i.getAineq());
-            lA.set(constraints_task_i.getbLowerBound());
-            uA.set(constraints_task_i.getbUpperBound());
-            if(i > 0)
+            A.pile(constraints_task_i.getAineq());
+            lA.pile(constraints_task_i.getbLowerBound());
+            uA.pile(constraints_task_i.getbUpperBound());
+            if(stats) stats->constraints_time = SolverStatistics::elapsed(start);
+
+            if(stats) start = SolverStatistics::clock::now();
+            bool success = updateAndSolveLevel(i, constraints_task_i, cost_changed, stats);
+            if(stats)
+            {
+                stats->back_end_time = SolverStatistics::elapsed(start);
+                stats->iterations = _qp_stack_of_tasks[i]->getNumberOfIterations();
+                stats->success = success;
+            }
+            if(!success)
+                return false;
+
+            solution = _qp_stack_of_tasks[i]->getSolution();
+            
+        }
+
+        //The constraints of level i are overwritten by its optimality (priority) constraint,
+        //if the level is not active we consider fake optimality constraints
+        if(i < _tasks.size() - 1)
+        {
+            A.rewind(optimality_rows);
+            lA.rewind(optimality_rows);
+            uA.rewind(optimality_rows);
+
+            if(_active_stacks[i])
+                computeOptimalityConstraint(_tasks[i], _qp_stack_of_tasks[i], A, lA, uA);
+            else
+                computeFakeOptimalityConstraint(_tasks[i], A, lA, uA);
+        }
+    }
+    return true;
+}
+
+bool iHQP::setRealTimeMode(const bool enable)
+{
+    if(enable)
+    {
+        for(unsigned int i = 0; i < _be_solver.size(); ++i)
+        {
+            if(!isBackEndAvailable(_be_solver[i]) || !getBackEndCapabilities(_be_solver[i]).real_time_safe)
             {
+                XBot::Logger::error("iHQP: real-time mode not available, the %s back-end of level %i allocates memory\n",
+                                    whichBackEnd(_be_solver[i]).c_str(), i);
+                return false;
+            }
+        }
 
-                ///TODO: new implementation, this permits to save some multiplications since
-                /// we do not recompute always all the optimality (priority) constraints but only the one
-                /// at the previous level. The problem arise if a level is not active so all the previous
-                /// not active levels are set to zero up to the last active level which is computed
-                //Here I compute the optimality (priority) constraint only for the previous active level
-                for(unsigned int l = i-1; l >= 0; --l)
-                {
-                    if(_active_stacks[l]){
-                        computeOptimalityConstraint(_tasks[l], _qp_stack_of_tasks[l], tmp_A[l], tmp_lA[l], tmp_uA[l]);
-                        break;}
-                    else
-                    {
-                        //Here we consider fake optimality constraints:
-                        //
-                        //    -1 <= 0x <= 1
-                        tmp_A[l].setZero(_tasks[l]->getA().rows(), _tasks[l]->getA().cols());
-                        tmp_lA[l].setConstant(_tasks[l]->getA().rows(), -1.0);
-                        tmp_uA[l].setConstant(_tasks[l]->getA().rows(), 1.0);
-                    }
-                }
-                ///
+        if(_thread_pool)
+        {
+            XBot::Logger::error("iHQP: real-time mode not available with the parallel solve\n");
+            return false;
+        }
+    }
+
+    _real_time_mode = enable;
+    return true;
+}
+
+void iHQP::setThreadPool(ThreadPool::Ptr thread_pool)
+{
+    if(thread_pool && _regularisation_task)
+    {
+        XBot::Logger::warning("iHQP: parallel solve is not available with a user defined regularisation\n");
+        return;
+    }
+
+    if(thread_pool && _real_time_mode)
+    {
+        XBot::Logger::warning("iHQP: parallel solve is not available in real-time mode\n");
+        return;
+    }
+
+    _thread_pool = thread_pool;
+    partitionColumns();
+}
+
+bool iHQP::setColumnBlocks(const std::vector<int>& blocks)
+{
+    if(!blocks.empty())
+    {
+        if(blocks.size() != _tasks[0]->getXSize())
+        {
+            XBot::Logger::error("iHQP: %i column blocks declared, %i expected\n", (int)blocks.size(), _tasks[0]->getXSize());
+            return false;
+        }
+
+        if(*std::min_element(blocks.begin(), blocks.end()) < 0)
+        {
+            XBot::Logger::error("iHQP: negative column block declared\n");
+            return false;
+        }
+    }
+
+    _declared_column_blocks = blocks;
+    return partitionColumns();
+}
 
+bool iHQP::partitionColumns()
+{
+    _sub_problems.clear();
+    _column_blocks.clear();
+    if(!_thread_pool && _declared_column_blocks.empty())
+        return true;
+
+    for(auto& constraints : constraints_task)
+        constraints.generateAll();
+
+    int number_of_blocks = computeColumnBlocks(_column_blocks);
+    if(!_declared_column_blocks.empty())
+    {
+        //the variables coupled by the stack (same root) have to be declared in the same block
+        for(unsigned int j = 0; j < _column_parents.size(); ++j)
+        {
+            int root = j;
+            while(_column_parents[root] != root)
+                root = _column_parents[root];
+            if(_declared_column_blocks[j] != _declared_column_blocks[root])
+            {
+                XBot::Logger::error("iHQP: the declared column blocks are coupled by the stack\n");
+                _column_blocks.clear();
+                _declared_column_blocks.clear();
+                return false;
+            }
+        }
+
+        _column_blocks = _declared_column_blocks;
+        number_of_blocks = *std::max_element(_column_blocks.begin(), _column_blocks.end()) + 1;
+    }
+
+    //the declared blocks are checked also before the pool is set
+    if(!_thread_pool)
+    {
+        _column_blocks.clear();
+        return true;
+    }
+
+    if(prepareSubProblems(number_of_blocks) && number_of_blocks > 1)
+        XBot::Logger::info("iHQP: stack split in %i independent sub-problems\n", number_of_blocks);
+    return true;
+}
 
-                for(unsigned int j = 0; j < i; ++j)
+int iHQP::computeColumnBlocks(std::vector<int>& blocks)
+{
+    const int n = _tasks[0]->getXSize();
+    _column_parents.resize(n);
+    std::iota(_column_parents.begin(), _column_parents.end(), 0);
+    //-1 marks the variables which do not appear in any task or constraint
+    blocks.assign(n, -1);
+
+    auto find = [this](int j){
+        while(_column_parents[j] != j)
+            j = _column_parents[j] = _column_parents[_column_parents[j]];
+        return j;
+    };
+    auto join = [&](int i, int j){
+        i = find(i);
+        j = find(j);
+        if(i != j)
+            _column_parents[std::max(i, j)] = std::min(i, j);
+    };
+    //the non-zero columns of a row are coupled
+    auto join_rows = [&](const Eigen::MatrixXd& A){
+        for(int r = 0; r < A.rows(); ++r)
+        {
+            int first = -1;
+            for(int j = 0; j < n; ++j)
+            {
+                if(A(r, j) == 0.)
+                    continue;
+                blocks[j] = 0;
+                if(first < 0)
+                    first = j;
+                else
+                    join(first, j);
+            }
+        }
+    };
+
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+    {
+        const Eigen::MatrixXd& A = _tasks[i]->getA();
+        join_rows(A);
+        join_rows(constraints_task[i].getAineq());
+
+        //rows coupled by the weight
+        const Eigen::MatrixXd& W = _tasks[i]->getWeight();
+        if(!_tasks[i]->getWeightIsDiagonalFlag() && !W.isDiagonal(0.))
+        {
+            for(int r = 0; r < W.rows(); ++r)
+            {
+                for(int s = r + 1; s < W.cols(); ++s)
                 {
-                    ///TODO: old implementation keep it to check against the new implementation
-//                    if(_active_stacks[j])
-//                        computeOptimalityConstraint(_tasks[j], _qp_stack_of_tasks[j], tmp_A[j], tmp_lA[j], tmp_uA[j]);
-//                    else
-//                    {
-//                        //Here we consider fake optimality constraints:
-//                        //
-//                        //    -1 <= 0x <= 1
-//                        tmp_A[j].setZero(_tasks[j]->getA().rows(), _tasks[j]->getA().cols());
-//                        tmp_lA[j].setConstant(_tasks[j]->getA().rows(), -1.0);
-//                        tmp_uA[j].setConstant(_tasks[j]->getA().rows(), 1.0);
-//                    }
-                    ///
-                    A.pile(tmp_A[j]);
-                    lA.pile(tmp_lA[j]);
-                    uA.pile(tmp_uA[j]);
+                    if(W(r, s) == 0. && W(s, r) == 0.)
+                        continue;
+                    const int jr = first_column(A, r), js = first_column(A, s);
+                    if(jr >= 0 && js >= 0)
+                        join(jr, js);
                 }
             }
+        }
+
+        const Eigen::VectorXd& c = _tasks[i]->getc();
+        for(int j = 0; j < c.size(); ++j)
+        {
+            if(c[j] != 0.)
+                blocks[j] = 0;
+        }
+    }
+
+    //the roots are the first variable of each block, hence they are labeled before the other variables
+    int number_of_blocks = 0;
+    for(int j = 0; j < n; ++j)
+    {
+        if(blocks[j] < 0)
+            continue;
+        const int root = find(j);
+        blocks[j] = root == j ? number_of_blocks++ : blocks[root];
+    }
+
+    //variables which do not appear anywhere are solved with the first block
+    for(int j = 0; j < n; ++j)
+    {
+        if(blocks[j] < 0)
+            blocks[j] = 0;
+    }
+
+    return std::max(number_of_blocks, 1);
+}
+
+bool iHQP::prepareSubProblems(const int number_of_blocks)
+{
+    _sub_problems.clear();
+    if(number_of_blocks < 2)
+        return true;
+
+    //the block of a row is the block of its first non-zero column
+    auto row_blocks = [this](const Eigen::MatrixXd& A){
+        std::vector<int> blocks(A.rows(), -1);
+        for(int r = 0; r < A.rows(); ++r)
+        {
+            const int j = first_column(A, r);
+            if(j >= 0)
+                blocks[r] = _column_blocks[j];
+        }
+        return blocks;
+    };
+    _task_row_blocks.resize(_tasks.size());
+    _constraint_row_blocks.resize(_tasks.size());
+    _column_blocks_versions.clear();
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+    {
+        _task_row_blocks[i] = row_blocks(_tasks[i]->getA());
+        _constraint_row_blocks[i] = row_blocks(constraints_task[i].getAineq());
+        _column_blocks_versions.push_back(_tasks[i]->getVersion());
+        _column_blocks_versions.push_back(constraints_task[i].getVersion());
+    }
+
+    for(int b = 0; b < number_of_blocks; ++b)
+    {
+        auto sub_problem = std::make_shared<SubProblem>();
+        for(int j = 0; j < (int)_column_blocks.size(); ++j)
+        {
+            if(_column_blocks[j] == b)
+                sub_problem->columns.push_back(j);
+        }
+
+        Stack stack;
+        std::vector<solver_back_ends> be_solver;
+        for(unsigned int i = 0; i < _tasks.size(); ++i)
+        {
+            //zero rows are dropped
+            std::vector<int> rows, constraint_rows;
+            for(int r = 0; r < (int)_task_row_blocks[i].size(); ++r)
+            {
+                if(_task_row_blocks[i][r] == b)
+                    rows.push_back(r);
+            }
+            if(rows.empty())
+                continue;
+
+            for(int r = 0; r < (int)_constraint_row_blocks[i].size(); ++r)
+            {
+                if(_constraint_row_blocks[i][r] == b)
+                    constraint_rows.push_back(r);
+            }
+
+            auto task = std::make_shared<BlockTask>(_tasks[i]->getTaskID() + "_block_" + std::to_string(b),
+                                                    rows, sub_problem->columns, _tasks[i]->getHessianAtype());
+            task->copy(_tasks[i]);
+
+            BlockConstraint::Ptr constraint;
+            if(!constraint_rows.empty() || constraints_task[i].getLowerBound().size() > 0)
+            {
+                constraint = std::make_shared<BlockConstraint>(constraints_task[i].getConstraintID() + "_block_" +
+                                                               std::to_string(b), constraint_rows, sub_problem->columns);
+                constraint->copy(constraints_task[i]);
+                task->getConstraints().push_back(constraint);
+            }
+
+            sub_problem->levels.push_back(i);
+            sub_problem->tasks.push_back(task);
+            sub_problem->constraints.push_back(constraint);
+            stack.push_back(task);
+            be_solver.push_back(_be_solver[i]);
+        }
+
+        //a block coupled only by constraints is not a stack
+        if(stack.empty())
+        {
+            XBot::Logger::warning("iHQP: block %i does not contain any task, the stack is solved as a single problem\n", b);
+            _sub_problems.clear();
+            return false;
+        }
 
-            if(!_qp_stack_of_tasks[i]->updateConstraints(A.generate_and_get(),
-                                    lA.generate_and_get(), uA.generate_and_get()))
+        try
+        {
+            sub_problem->solver = std::make_shared<iHQP>(stack, _epsRegularisation, be_solver);
+        }
+        catch(const std::exception& e)
+        {
+            XBot::Logger::error("iHQP: can not initialize sub-problem %i: %s\n", b, e.what());
+            _sub_problems.clear();
+            return false;
+        }
+
+        //the options and the eps regularisation of the levels are the same of the whole problem
+        for(unsigned int j = 0; j < sub_problem->levels.size(); ++j)
+        {
+            const unsigned int i = sub_problem->levels[j];
+            sub_problem->solver->setOptions(j, _qp_stack_of_tasks[i]->getOptions());
+            if(_be_solver[i] != solver_back_ends::GLPK)
+                sub_problem->solver->setEpsRegularisation(_qp_stack_of_tasks[i]->getEpsRegularisation(), j);
+        }
+        sub_problem->statistics = std::make_shared<SolverStatistics>(1);
+        _sub_problems.push_back(sub_problem);
+    }
+
+    return true;
+}
+
+bool iHQP::columnBlocksValid()
+{
+    //block of the non-zeros of a row, -1 for zero rows and -2 for rows coupling two blocks
+    auto row_block = [this](const Eigen::MatrixXd& A, const int r){
+        int block = -1;
+        for(int j = 0; j < A.cols(); ++j)
+        {
+            if(A(r, j) == 0.)
+                continue;
+            if(block < 0)
+                block = _column_blocks[j];
+            else if(_column_blocks[j] != block)
+                return -2;
+        }
+        return block;
+    };
+    //zero rows are always valid since a row of the sub-problems can become zero
+    auto rows_valid = [&](const Eigen::MatrixXd& A, const std::vector<int>& blocks){
+        if(A.rows() != (int)blocks.size())
+            return false;
+        for(int r = 0; r < A.rows(); ++r)
+        {
+            const int block = row_block(A, r);
+            if(block != -1 && block != blocks[r])
                 return false;
+        }
+        return true;
+    };
 
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+    {
+        const unsigned int task_version = _tasks[i]->getVersion();
+        const unsigned int constraints_version = constraints_task[i].getVersion();
 
-            if(constraints_task_i.hasBounds()) // bounds specified everywhere will work
+        if(task_version != _column_blocks_versions[2*i])
+        {
+            const Eigen::MatrixXd& A = _tasks[i]->getA();
+            if(!rows_valid(A, _task_row_blocks[i]))
+                return false;
+
+            const Eigen::MatrixXd& W = _tasks[i]->getWeight();
+            if(!_tasks[i]->getWeightIsDiagonalFlag() && !W.isDiagonal(0.))
             {
-                if(!_qp_stack_of_tasks[i]->updateBounds(constraints_task_i.getLowerBound(), constraints_task_i.getUpperBound()))
-                    return false;
+                for(int r = 0; r < W.rows(); ++r)
+                {
+                    for(int s = r + 1; s < W.cols(); ++s)
+                    {
+                        if(W(r, s) == 0. && W(s, r) == 0.)
+                            continue;
+                        const int br = row_block(A, r), bs = row_block(A, s);
+                        if(br >= 0 && bs >= 0 && br != bs)
+                            return false;
+                    }
+                }
             }
+            _column_blocks_versions[2*i] = task_version;
+        }
 
-            if(!_qp_stack_of_tasks[i]->solve())
+        if(constraints_version != _column_blocks_versions[2*i + 1])
+        {
+            if(!rows_valid(constraints_task[i].getAineq(), _constraint_row_blocks[i]))
                 return false;
+            _column_blocks_versions[2*i + 1] = constraints_version;
+        }
+    }
+    return true;
+}
 
-            solution = _qp_stack_of_tasks[i]->getSolution();
-            
+bool iHQP::solveSubProblems(Eigen::VectorXd& solution)
+{
+    if(_sub_problems.empty())
+        return solveStack(solution);
+
+    for(auto& constraints : constraints_task)
+        constraints.generateAll();
+
+    if(!columnBlocksValid())
+    {
+        XBot::Logger::warning("iHQP: the sparsity pattern of the stack couples the column blocks, the columns are partitioned again\n");
+        partitionColumns();
+        if(_sub_problems.empty())
+            return solveStack(solution);
+    }
+
+    _thread_pool->run(_sub_problems.size(), [this](const unsigned int k)
+    {
+        SubProblem& sub_problem = *_sub_problems[k];
+        for(unsigned int j = 0; j < sub_problem.levels.size(); ++j)
+        {
+            const unsigned int i = sub_problem.levels[j];
+            sub_problem.tasks[j]->copy(_tasks[i]);
+            if(sub_problem.constraints[j])
+                sub_problem.constraints[j]->copy(constraints_task[i]);
+            sub_problem.solver->setActiveStack(j, _active_stacks[i]);
         }
-        else
+
+        //solveStack() does not commit the statistics of the sub-problem
+        sub_problem.solver->setStatistics(_statistics ? sub_problem.statistics : nullptr);
+        if(_statistics)
+            sub_problem.statistics->current() = TickStatistics();
+        sub_problem.success = sub_problem.solver->solveStack(sub_problem.solution);
+    });
+
+    if(_statistics)
+    {
+        //the timings of the levels are summed over the sub-problems, a level succeeds if all its sub-problems do
+        for(const auto& sub_problem : _sub_problems)
         {
-            //Here we do nothing
+            for(const unsigned int i : sub_problem->levels)
+                _statistics->level(i).success = true;
+        }
+
+        for(const auto& sub_problem : _sub_problems)
+        {
+            for(unsigned int j = 0; j < sub_problem->levels.size(); ++j)
+            {
+                const LevelStatistics& sub_stats = sub_problem->statistics->level(j);
+                LevelStatistics& stats = _statistics->level(sub_problem->levels[j]);
+                stats.cost_time += sub_stats.cost_time;
+                stats.constraints_time += sub_stats.constraints_time;
+                stats.back_end_time += sub_stats.back_end_time;
+                stats.back_end_solve_time += sub_stats.back_end_solve_time;
+                if(sub_stats.iterations >= 0)
+                    stats.iterations = std::max(stats.iterations, 0) + sub_stats.iterations;
+                stats.success = stats.success && sub_stats.success;
+            }
         }
     }
+
+    solution.resize(_column_blocks.size());
+    for(const auto& sub_problem : _sub_problems)
+    {
+        if(!sub_problem->success)
+            return false;
+        solution(sub_problem->columns) = sub_problem->solution;
+    }
     return true;
 }
 
+bool iHQP::updateAndSolveLevel(const unsigned int i, OpenSoT::constraints::Aggregated& constraints_task_i,
+                               const bool cost_changed, LevelStatistics* stats)
+{
+    if(cost_changed)
+    {
+        //without regularisation the cached cost is loaded directly, without passing through H and g
+        bool updated = _regularisation_task ?
+                    _qp_stack_of_tasks[i]->updateTask(H, g) :
+                    _qp_stack_of_tasks[i]->updateTask(_cost_functions[i].getH(), _cost_functions[i].getg());
+        if(!updated)
+            return false;
+    }
+
+    if(!_qp_stack_of_tasks[i]->updateConstraints(A.generate_and_get(),
+                            lA.generate_and_get(), uA.generate_and_get()))
+        return false;
+
+    if(constraints_task_i.hasBounds()) // bounds specified everywhere will work
+    {
+        if(!_qp_stack_of_tasks[i]->updateBounds(constraints_task_i.getLowerBound(), constraints_task_i.getUpperBound()))
+            return false;
+    }
+
+    if(!stats)
+        return _qp_stack_of_tasks[i]->solve();
+
+    const auto start = SolverStatistics::clock::now();
+    bool success = _qp_stack_of_tasks[i]->solve();
+    stats->back_end_solve_time = SolverStatistics::elapsed(start);
+    return success;
+}
+
 bool iHQP::setOptions(const unsigned int i, const boost::any &opt)
 {
     if(i > _qp_stack_of_tasks.size()){
@@ -364,6 +960,14 @@ bool iHQP::setOptions(const unsigned int i, const boost::any &opt)
         return false;}
 
     _qp_stack_of_tasks[i]->setOptions(opt);
+    for(auto& sub_problem : _sub_problems)
+    {
+        for(unsigned int j = 0; j < sub_problem->levels.size(); ++j)
+        {
+            if(sub_problem->levels[j] == i)
+                sub_problem->solver->setOptions(j, opt);
+        }
+    }
     return true;
 }
 
@@ -404,10 +1008,10 @@ void iHQP::_log(XBot::MatLogger2::Ptr logger, const std::string& prefix)
 {
     if(_regularisation_task)
     {
-        if(Hr.rows() > 0)
-            logger->add("Hr", Hr);
-        if(gr.size() > 0)
-            logger->add("gr", gr);
+        if(_regularisation_cost_function.getH().rows() > 0)
+            logger->add("Hr", _regularisation_cost_function.getH());
+        if(_regularisation_cost_function.getg().size() > 0)
+            logger->add("gr", _regularisation_cost_function.getg());
     }
 
     for(unsigned int i = 0; i < _qp_stack_of_tasks.size(); ++i)
@@ -443,6 +1047,17 @@ bool iHQP::setEpsRegularisation(const double eps, const unsigned int i)
         return false;
     }
 
+    for(auto& sub_problem : _sub_problems)
+    {
+        for(unsigned int j = 0; j < sub_problem->levels.size(); ++j)
+        {
+            if(sub_problem->levels[j] == i && !sub_problem->solver->setEpsRegularisation(eps, j))
+                return false;
+        }
+    }
+
+    //the cost is loaded again at the next solve, so that the new eps is applied to H
+    _cost_functions[i].invalidate();
     return _qp_stack_of_tasks[i]->setEpsRegularisation(eps);
 }
 
@@ -455,6 +1070,12 @@ bool iHQP::setEpsRegularisation(const double eps)
             XBot::Logger::error("Problem setting eps regularisation in level %i", i);
             return false;
         }
+        _cost_functions[i].invalidate();
+    }
+    for(auto& sub_problem : _sub_problems)
+    {
+        if(!sub_problem->solver->setEpsRegularisation(eps))
+            return false;
     }
     return true;
 }
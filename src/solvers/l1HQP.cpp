@@ -2,12 +2,33 @@
 #include <OpenSoT/utils/AutoStack.h>
 #include <OpenSoT/solvers/BackEndFactory.h>
 #include <string>
+#include <stdexcept>
 #include <math.h>
 
 #define ENABLE_PRIORITY_CONSTRAINT true
 
 using namespace OpenSoT::solvers;
 
+namespace {
+    /**
+     * @brief variable_offset returns the first column of a variable created by an OptvarHelper,
+     * i.e. x = Mv with M a selection matrix
+     */
+    int variable_offset(const OpenSoT::AffineHelper& x)
+    {
+        const Eigen::MatrixXd& M = x.getM();
+        const int n = x.getOutputSize();
+        Eigen::Index offset = 0;
+        if(n > 0)
+            M.row(0).maxCoeff(&offset);
+
+        if(offset + n > M.cols() || !M.middleCols(offset, n).isIdentity(0.) ||
+           M.cwiseAbs().sum() != n || !x.getq().isZero(0.))
+            throw std::invalid_argument("l1HQP: x must be a variable of an OptvarHelper");
+        return offset;
+    }
+}
+
 l1HQP::l1HQP(OpenSoT::AutoStack& stack_of_tasks, const double eps_regularisation,const solver_back_ends be_solver):
     Solver(stack_of_tasks.getStack(), stack_of_tasks.getBounds()),
     _epsRegularisation(eps_regularisation),
@@ -38,15 +59,18 @@ void l1HQP::getBackEnd(BackEnd::Ptr& back_end)
 
 bool l1HQP::creates_solver(const solver_back_ends solver_back_end)
 {
+    _A = _internal_stack->getBounds()->getAineq();
+    _lA = _internal_stack->getBounds()->getbLowerBound();
+    _uA = _internal_stack->getBounds()->getbUpperBound();
+
     _solver = BackEndFactory(solver_back_end,
                    _internal_stack->getStack()[0]->getXSize(),
-                   _internal_stack->getBounds()->getAineq().rows(),
-                   _hessian_type, _epsRegularisation);
+                   _A.rows(),
+                   _hessian_type, _epsRegularisation, estimateDensity(_H, _A));
 
     bool success = _solver->initProblem(_H,
                    _internal_stack->getStack()[0]->getc().transpose(),
-                   _internal_stack->getBounds()->getAineq(),
-                   _internal_stack->getBounds()->getbLowerBound(), _internal_stack->getBounds()->getbUpperBound(),
+                   _A, _lA, _uA,
                    Eigen::VectorXd(0), Eigen::VectorXd(0));
 
     if(success)
@@ -165,24 +189,83 @@ void l1HQP::creates_problem_variables()
     }
 
     _opt = std::make_shared<OptvarHelper>(vars);
+    _x = _opt->getVariable("x");
+}
+
+bool l1HQP::update_constraints()
+{
+    //the rows are ordered as in creates_internal_problem(), the priority constraints are constant
+    unsigned int row = 0;
+    for(auto& constraint : _constraints)
+    {
+        constraint.second->update();
+        if(constraint.second->isChanged())
+            constraint.second->copyTo(row, _A, _uA);
+        row += constraint.second->getAineq().rows();
+    }
+
+    if(_constraints2)
+    {
+        _constraints2->update();
+        if(row + _constraints2->getAineq().rows() + _priority_constraints.size() != static_cast<unsigned int>(_A.rows()))
+        {
+            XBot::Logger::error("l1HQP: size of the constraints changed\n");
+            return false;
+        }
+        if(_constraints2->isChanged())
+            _constraints2->copyTo(row, _A, _lA, _uA);
+    }
+
+    return true;
 }
 
 bool l1HQP::solve(Eigen::VectorXd& solution)
-{   
-    _internal_stack->update();
+{
+    if(!_statistics)
+        return solveProblem(solution);
+
+    const auto start = utils::SolverStatistics::clock::now();
+    bool success = solveProblem(solution);
+    _statistics->current().solve_time = utils::SolverStatistics::elapsed(start);
+    _statistics->current().success = success;
+    _statistics->commit();
+    return success;
+}
+
+bool l1HQP::solveProblem(Eigen::VectorXd& solution)
+{
+    //the whole hierarchy is a single LP, its timings are recorded in the first level
+    utils::LevelStatistics* stats = _statistics ? &_statistics->level(0) : nullptr;
+    utils::SolverStatistics::clock::time_point start;
+
+    if(stats) start = utils::SolverStatistics::clock::now();
+    if(!update_constraints())
+        return false;
+    if(stats) stats->constraints_time = utils::SolverStatistics::elapsed(start);
 
-    if(!_solver->updateProblem(_H, _internal_stack->getStack()[0]->getc().transpose(),
-        _internal_stack->getBounds()->getAineq(),
-        _internal_stack->getBounds()->getbLowerBound(), _internal_stack->getBounds()->getbUpperBound(),
+    //the cost of the LP is constant
+    if(stats) start = utils::SolverStatistics::clock::now();
+    if(!_solver->updateProblem(_H, _internal_stack->getStack()[0]->getc(),
+        _A, _lA, _uA,
         Eigen::VectorXd(0), Eigen::VectorXd(0)))
         return false;
 
-    if(!_solver->solve())
+    utils::SolverStatistics::clock::time_point solve_start;
+    if(stats) solve_start = utils::SolverStatistics::clock::now();
+    bool success = _solver->solve();
+    if(stats)
+    {
+        stats->back_end_solve_time = utils::SolverStatistics::elapsed(solve_start);
+        stats->back_end_time = utils::SolverStatistics::elapsed(start);
+        stats->iterations = _solver->getNumberOfIterations();
+        stats->success = success;
+    }
+    if(!success)
         return false;
 
     _internal_solution = _solver->getSolution();
 
-    _opt->getVariable("x").getValue(_internal_solution, solution);
+    _x.getValue(_internal_solution, solution);
 
     return true;
 }
@@ -206,89 +289,105 @@ bool l1HQP::getInternalVariable(const std::string& var, Eigen::VectorXd& value)
 task_to_constraint_helper::task_to_constraint_helper(std::string id, OpenSoT::tasks::Aggregated::TaskPtr& task,
            const AffineHelper& x, const AffineHelper& t):
     OpenSoT::Constraint< Eigen::MatrixXd, Eigen::VectorXd >(id, x.getInputSize()),
-    _task(task), _x(x), _t(t), _II(task->getA().rows()), _AA(_task->getA().cols()), _bb(1)
+    _task(task), _x(x), _t(t), _x_col(variable_offset(x)), _version(0), _changed(false)
 {
-    Eigen::MatrixXd I;
-    I.setIdentity(task->getA().rows(),task->getA().rows());
-    _II.pile(-M*I);
-    _II.pile(-M*I);
-    _II.pile(I);
-
-    o.setZero(_task->getb().size());
-    O.setZero(task->getA().rows(),task->getA().cols());
-
-    inf = Eigen::VectorXd::Constant(task->getA().rows(), 1.0e20);
-
-    ones = Eigen::VectorXd::Constant(task->getA().rows(), 1.);
-
-    _bLowerBound.resize(3*task->getA().rows());
-    _bLowerBound << -inf, -inf, o;
-
-    update();
+    const int r = task->getA().rows();
+
+    //the contribution of the extra variable and the bounds of t are constant:
+    //  [ WA -MI]         [ Wb]
+    //  [-WA -MI] [x;t] <= [-Wb]
+    //  [  0   I]         [  1]
+    Eigen::MatrixXd II(3*r, r);
+    II << -M*Eigen::MatrixXd::Identity(r, r), -M*Eigen::MatrixXd::Identity(r, r), Eigen::MatrixXd::Identity(r, r);
+    _Aineq.noalias() = II*_t.getM();
+
+    _bLowerBound.resize(3*r);
+    _bLowerBound << Eigen::VectorXd::Constant(r, -1.0e20), Eigen::VectorXd::Constant(r, -1.0e20), Eigen::VectorXd::Zero(r);
+
+    _bUpperBound.setOnes(3*r);
+
+    _version = _task->getVersion();
+    _changed = true;
+    _Aineq.block(0, _x_col, r, _x.getOutputSize()) = _task->getWA();
+    _Aineq.block(r, _x_col, r, _x.getOutputSize()) = -_task->getWA();
+    _bUpperBound.head(r) = _task->getWb();
+    _bUpperBound.segment(r, r) = -_task->getWb();
 }
 
 void task_to_constraint_helper::update()
 {
-    _AA.pile(_task->getWA());
-    _AA.pile(-_task->getWA());
-    _AA.pile(O);
-
-    _bb.pile(_task->getWb());
-    _bb.pile(-_task->getWb());
-    _bb.pile(ones);
-
-    _constraint = _AA.generate_and_get()*_x + _II.generate_and_get()*_t -_bb.generate_and_get();
-
-    _Aineq = _constraint.getM();
-    _bUpperBound = - _constraint.getq();
+    const unsigned int version = _task->getVersion();
+    _changed = version != _version;
+    if(!_changed)
+        return;
+    _version = version;
+
+    const int r = _task->getA().rows();
+    _Aineq.block(0, _x_col, r, _x.getOutputSize()) = _task->getWA();
+    _Aineq.block(r, _x_col, r, _x.getOutputSize()) = -_task->getWA();
+    _bUpperBound.head(r) = _task->getWb();
+    _bUpperBound.segment(r, r) = -_task->getWb();
+    increaseVersion();
+}
 
-    _AA.reset();
-    _bb.reset();
+void task_to_constraint_helper::copyTo(const unsigned int row, BackEnd::RowMajorMatrixXd& A,
+                                       Eigen::VectorXd& uA) const
+{
+    const int r = 2*_task->getA().rows();
+    A.block(row, _x_col, r, _x.getOutputSize()) = _Aineq.block(0, _x_col, r, _x.getOutputSize());
+    uA.segment(row, r) = _bUpperBound.head(r);
 }
 
 constraint_helper::constraint_helper(std::string id, OpenSoT::constraints::Aggregated::ConstraintPtr constraints,
                                      const AffineHelper& x):
     OpenSoT::Constraint< Eigen::MatrixXd, Eigen::VectorXd >(id, x.getInputSize()),
-    _constraints(constraints), _x(x), _A(x.getInputSize()), _b_lower(1), _b_upper(1)
+    _constraints(constraints), _x(x), _x_col(variable_offset(x)), _version(0), _changed(false)
 {
-    if(_constraints->getLowerBound().size() > 0)
-        I.setIdentity(_constraints->getLowerBound().size(), _constraints->getLowerBound().size());
-
     update();
 }
 
 void constraint_helper::update()
 {
-
-
-    if(_constraints->getAineq().rows() > 0)
-    {
-        _constraint = _constraints->getAineq()*_x;
-        _A.pile(_constraint.getM());
-        _b_lower.pile(_constraints->getbLowerBound());
-        _b_upper.pile(_constraints->getbUpperBound());
-    }
-
-    if(_constraints->getAeq().rows() > 0 ) //TODO: equality constraints
+    const unsigned int version = _constraints->getVersion();
+    const int rA = _constraints->getAineq().rows();
+    const int re = _constraints->getAeq().rows();
+    const int rb = _constraints->getLowerBound().size();
+    const int rows = rA + re + rb;
+
+    _changed = version != _version || _Aineq.rows() != rows;
+    if(!_changed)
+        return;
+    _version = version;
+
+    //the rows of the bounds are constant and written only on resize
+    if(_Aineq.rows() != rows)
     {
-
-    }
-
-    if(_constraints->getLowerBound().size() > 0) //bounds
-    {
-        _constraint = I*_x;
-        _A.pile(_constraint.getM());
-        _b_lower.pile(_constraints->getLowerBound());
-        _b_upper.pile(_constraints->getUpperBound());
+        _Aineq.setZero(rows, _x.getInputSize());
+        _Aineq.block(rA + re, _x_col, rb, _x.getOutputSize()).setIdentity();
+        _bLowerBound.resize(rows);
+        _bUpperBound.resize(rows);
     }
 
-    _Aineq = _A.generate_and_get();
-    _bLowerBound = _b_lower.generate_and_get();
-    _bUpperBound = _b_upper.generate_and_get();
+    _Aineq.block(0, _x_col, rA, _x.getOutputSize()) = _constraints->getAineq();
+    _bLowerBound.head(rA) = _constraints->getbLowerBound();
+    _bUpperBound.head(rA) = _constraints->getbUpperBound();
+
+    //equality constraints: beq <= Aeq x <= beq
+    _Aineq.block(rA, _x_col, re, _x.getOutputSize()) = _constraints->getAeq();
+    _bLowerBound.segment(rA, re) = _constraints->getbeq();
+    _bUpperBound.segment(rA, re) = _constraints->getbeq();
+    _bLowerBound.tail(rb) = _constraints->getLowerBound();
+    _bUpperBound.tail(rb) = _constraints->getUpperBound();
+    increaseVersion();
+}
 
-    _A.reset();
-    _b_lower.reset();
-    _b_upper.reset();
+void constraint_helper::copyTo(const unsigned int row, BackEnd::RowMajorMatrixXd& A,
+                               Eigen::VectorXd& lA, Eigen::VectorXd& uA) const
+{
+    const int rA = _constraints->getAineq().rows() + _constraints->getAeq().rows();
+    A.block(row, _x_col, rA, _x.getOutputSize()) = _Aineq.block(0, _x_col, rA, _x.getOutputSize());
+    lA.segment(row, _Aineq.rows()) = _bLowerBound;
+    uA.segment(row, _Aineq.rows()) = _bUpperBound;
 }
 
 priority_constraint::priority_constraint(const std::string& id,
@@ -7,7 +7,8 @@ OpenSoT::solvers::nHQP::nHQP(OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::
                              OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::ConstraintPtr bounds,
                              const double eps_regularisation,
                              const OpenSoT::solvers::solver_back_ends be_solver):
-    Solver(stack_of_tasks, bounds)
+    Solver(stack_of_tasks, bounds),
+    _cumulated_nullspace_valid(true)
 {
     // nx = number of optimization variables
     const int nx = stack_of_tasks.front()->getXSize();
@@ -36,23 +37,22 @@ OpenSoT::solvers::nHQP::nHQP(OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::
             throw std::runtime_error("[nHQP] No free variables left at layer #" + std::to_string(i) + ": decrease the number of layers!");
         }
 
-        // local constraints not supported (TODO)
-        if(t->getConstraints().size() > 0)
+        // local constraints (and equality constraints) are aggregated together with the global constraints,
+        // the aggregation turns equalities into inequalities with equal lower and upper bounds
+        OpenSoT::constraints::Aggregated::Ptr local_constraints;
+        if(t->getConstraints().size() > 0 || bounds->getAeq().rows() > 0)
         {
-            throw std::runtime_error("[nHQP] Local constraints not supported");
-        }
-
-        // equality constraints not supported (TODO)
-        if(bounds->getAeq().rows() > 0)
-        {
-            throw std::runtime_error("[nHQP] Equality constraints not supported");
+            std::list<ConstraintPtr> constraints_list = t->getConstraints();
+            constraints_list.push_back(bounds);
+            local_constraints = std::make_shared<OpenSoT::constraints::Aggregated>(constraints_list, nx);
         }
+        ConstraintPtr layer_constraints = local_constraints ? local_constraints : bounds;
 
         printf("[nHQP] Free variables at layer #%d = %d \n", i, num_free_vars);
 
-        // compute number of constraints and bounds (TBD: consider equalities)
-        int num_constr = bounds->getAineq().rows();
-        int num_bounds = nx;
+        // compute number of constraints and bounds
+        int num_constr = layer_constraints->getAineq().rows();
+        int num_bounds = layer_constraints->getLowerBound().size();
 
         // for all layers except the first, bounds must be turned into constraints
         if(num_free_vars != nx)
@@ -61,16 +61,23 @@ OpenSoT::solvers::nHQP::nHQP(OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::
             num_bounds = 0;
         }
 
+        // the first layer keeps the structure of the task and of the constraints, the following ones are
+        // projected onto dense nullspace bases
+        double density = 1.;
+        if(i == 0)
+            density = estimateDensity(t->getA().transpose()*t->getWeight()*t->getA(), layer_constraints->getAineq());
+
         // construct backend
         auto backend = BackEndFactory(be_solver,
                                       num_free_vars,
                                       num_constr,
                                       HessianType::HST_SEMIDEF,
-                                      eps_regularisation);
+                                      eps_regularisation,
+                                      density);
 
 
         // construct task data and push it into a vector
-        _data_struct.emplace_back(num_free_vars, t, bounds, backend);
+        _data_struct.emplace_back(num_free_vars, t, bounds, backend, local_constraints);
 
         // if we are processing the last task, skip nullspace dim computation
         if(i == n_tasks - 1)
@@ -144,6 +151,21 @@ void OpenSoT::solvers::nHQP::setPerformSelectiveNullSpaceRegularization(bool per
         data.set_perform_selective_null_space_regularization(perform_selective_null_space_regularization);
 }
 
+void OpenSoT::solvers::nHQP::setNullspaceMethod(NullspaceMethod method)
+{
+    for(auto& data : _data_struct)
+        data.set_nullspace_method(method);
+}
+
+void OpenSoT::solvers::nHQP::setNullspaceWarmStart(bool enable, double tolerance)
+{
+    if(tolerance < 0.0)
+        throw std::invalid_argument("[nHQP::setNullspaceWarmStart] tolerance should be >= 0");
+
+    for(auto& data : _data_struct)
+        data.set_nullspace_warm_start(enable, tolerance);
+}
+
 void OpenSoT::solvers::nHQP::setPerformSelectiveNullSpaceRegularization(int hierarchy_level, bool perform_selective_null_space_regularization)
 {
     if(hierarchy_level >= _data_struct.size())
@@ -153,6 +175,19 @@ void OpenSoT::solvers::nHQP::setPerformSelectiveNullSpaceRegularization(int hier
 }
 
 bool OpenSoT::solvers::nHQP::solve(Eigen::VectorXd& solution)
+{
+    if(!_statistics)
+        return solveStack(solution);
+
+    const auto start = utils::SolverStatistics::clock::now();
+    bool success = solveStack(solution);
+    _statistics->current().solve_time = utils::SolverStatistics::elapsed(start);
+    _statistics->current().success = success;
+    _statistics->commit();
+    return success;
+}
+
+bool OpenSoT::solvers::nHQP::solveStack(Eigen::VectorXd& solution)
 {
     const int n_tasks = _tasks.size();
     const int n_x = _tasks.front()->getXSize();
@@ -160,32 +195,47 @@ bool OpenSoT::solvers::nHQP::solve(Eigen::VectorXd& solution)
     // initialize solution with zeros
     _solution.setZero(n_x);
 
+    // true if the cumulated nullspace of the current layer differs from the one of the previous solve, all of them
+    // are computed again if the previous solve failed before reaching the last layer
+    bool cumulated_nullspace_changed = !_cumulated_nullspace_valid;
+    _cumulated_nullspace_valid = false;
+
     // iterate over the hierarchy
     for(int i = 0; i < n_tasks; i++)
     {
         // get i-th task data
         TaskData& data = _data_struct[i];
 
+        // timings are taken only if the statistics are enabled
+        utils::LevelStatistics* stats = _statistics ? &_statistics->level(i) : nullptr;
+        utils::SolverStatistics::clock::time_point start;
+
         // first layer, no nullspace to be considered (i.e. it would be the nx-by-nx identity)
-        if(i == 0)
-        {
-            data.compute_cost(nullptr, _solution);
-            data.compute_contraints(nullptr, _solution);
-        }
-        else // use nullspace basis computed at the previous step
-        {
-            data.compute_cost(&(_cumulated_nullspace[i]), _solution);
-            data.compute_contraints(&(_cumulated_nullspace[i]), _solution);
-        }
+        const Eigen::MatrixXd* nullspace = i == 0 ? nullptr : &(_cumulated_nullspace[i]);
+
+        if(stats) start = utils::SolverStatistics::clock::now();
+        data.compute_cost(nullspace, _solution);
+        if(stats) stats->cost_time = utils::SolverStatistics::elapsed(start);
+
+        if(stats) start = utils::SolverStatistics::clock::now();
+        data.compute_contraints(nullspace, _solution);
+        if(stats) stats->constraints_time = utils::SolverStatistics::elapsed(start);
 
         // solve QP
-        if(!data.update_and_solve())
+        if(stats) start = utils::SolverStatistics::clock::now();
+        bool success = data.update_and_solve(stats);
+        if(stats) stats->back_end_time = utils::SolverStatistics::elapsed(start);
+
+        if(!success)
         {
             return false;
         }
 
         // update solution according to 'solK = solK-1 + NK-1*xK_opt'
-        _solution.noalias() += _cumulated_nullspace[i] * data.get_solution();
+        if(i == 0) // first cumulated nullspace is the identity
+            _solution += data.get_solution();
+        else
+            _solution.noalias() += _cumulated_nullspace[i] * data.get_solution();
 
         // compute cumulated nullspace
         if(i < (n_tasks - 1))
@@ -194,11 +244,21 @@ bool OpenSoT::solvers::nHQP::solve(Eigen::VectorXd& solution)
             {
                 throw std::runtime_error("Nullspace basis not available");
             }
-            _cumulated_nullspace[i+1].noalias() = _cumulated_nullspace[i] * data.get_nullspace();
+
+            // the cumulated nullspace changes only if one of the previous nullspaces changed
+            cumulated_nullspace_changed = cumulated_nullspace_changed || !data.is_nullspace_reused();
+            if(cumulated_nullspace_changed)
+            {
+                if(i == 0) // first cumulated nullspace is the identity
+                    _cumulated_nullspace[i+1] = data.get_nullspace();
+                else
+                    _cumulated_nullspace[i+1].noalias() = _cumulated_nullspace[i] * data.get_nullspace();
+            }
         }
 
     }
 
+    _cumulated_nullspace_valid = true;
     solution = _solution;
     return true;
 }
@@ -266,8 +326,11 @@ void OpenSoT::solvers::nHQP::TaskData::regularize_A_b(double threshold)
         }
     }
 
+    // right singular vectors of AN (see compute_cost)
+    const Eigen::MatrixXd& V = nullspace_method == NullspaceMethod::SVD ? svd.matrixV() : qr_V;
+
     b0 = svd.matrixU()*b0;
-    AN = svd.matrixU().leftCols(sv.size())*sv.asDiagonal()*svd.matrixV().transpose().topRows(sv.size());
+    AN = svd.matrixU().leftCols(sv.size())*sv.asDiagonal()*V.transpose().topRows(sv.size());
 
     if(logger)
     {
@@ -283,9 +346,10 @@ void OpenSoT::solvers::nHQP::TaskData::compute_contraints(const Eigen::MatrixXd*
                                                           const Eigen::VectorXd& q0)
 {
 
-    if(constraints->getAeq().size() > 0)
+    // the local constraints are updated by the task, only the aggregation has to be regenerated
+    if(local_constraints)
     {
-        throw std::runtime_error("Equality constraits not supported by nHQP solver");
+        local_constraints->generateAll();
     }
 
     Aineq.reset();
@@ -305,13 +369,16 @@ void OpenSoT::solvers::nHQP::TaskData::compute_contraints(const Eigen::MatrixXd*
     else
     {
         Aineq.pile(constraints->getAineq() * (*N));
-        Aineq.pile(*N);
-
         lb.pile(constraints->getbLowerBound() - constraints->getAineq()*q0);
-        lb.pile(constraints->getLowerBound() - q0);
-
         ub.pile(constraints->getbUpperBound() - constraints->getAineq()*q0);
-        ub.pile(constraints->getUpperBound() - q0);
+
+        // bounds are turned into constraints
+        if(constraints->getLowerBound().size() > 0)
+        {
+            Aineq.pile(*N);
+            lb.pile(constraints->getLowerBound() - q0);
+            ub.pile(constraints->getUpperBound() - q0);
+        }
     }
 
 }
@@ -325,11 +392,18 @@ const Eigen::MatrixXd & OpenSoT::solvers::nHQP::TaskData::get_nullspace() const
 OpenSoT::solvers::nHQP::TaskData::TaskData(int num_free_vars,
                                            OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::TaskPtr a_task,
                                            OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::ConstraintPtr a_constraint,
-                                           BackEnd::Ptr a_back_end):
+                                           BackEnd::Ptr a_back_end,
+                                           OpenSoT::constraints::Aggregated::Ptr a_local_constraints):
     task(a_task),
-    constraints(a_constraint),
+    constraints(a_local_constraints ? a_local_constraints : a_constraint),
+    local_constraints(a_local_constraints),
     min_sv_ratio(nHQP::DEFAULT_MIN_SV_RATIO),
     Aineq(num_free_vars), lb(1), ub(1),
+    nullspace_method(NullspaceMethod::SVD),
+    nullspace_warm_start(false),
+    nullspace_warm_start_tolerance(nHQP::DEFAULT_NULLSPACE_WARM_START_TOLERANCE),
+    nullspace_computed(false),
+    nullspace_reused(false),
     ns_dim(num_free_vars - a_task->getTaskSize()),
     back_end(a_back_end),
     back_end_initialized(false),
@@ -371,7 +445,48 @@ void OpenSoT::solvers::nHQP::TaskData::compute_cost(const Eigen::MatrixXd* N,
         b0.noalias() = task->getb() - task->getA() * q0;
     }
 
-    svd.compute(AN, Eigen::ComputeFullU|Eigen::ComputeFullV);
+    // the nullspace is the one of the non regularized AN
+    nullspace_reused = nullspace_warm_start && check_nullspace_warm_start();
+    nullspace_computed = nullspace_reused;
+
+    const bool compute_sv = perform_A_b_regularization || perform_selective_null_space_regularization;
+
+    if(nullspace_method == NullspaceMethod::SVD)
+    {
+        // full V is needed only to extract the nullspace, thin U and V are enough for the regularization
+        if(!nullspace_reused)
+            svd.compute(AN, Eigen::ComputeThinU|Eigen::ComputeFullV);
+        else if(perform_A_b_regularization)
+            svd.compute(AN, Eigen::ComputeThinU|Eigen::ComputeThinV);
+        else if(perform_selective_null_space_regularization)
+            svd.compute(AN);
+    }
+    else
+    {
+        if(!nullspace_reused || compute_sv)
+            qr.compute(AN.transpose());
+
+        if(compute_sv)
+        {
+            // AN = P*R^T*Q^T: the svd of the small P*R^T = U*S*W^T gives U and the singular values of AN,
+            // while V = Q*W
+            const int k = std::min(AN.rows(), AN.cols());
+            qr_R = qr.matrixR().topRows(k).triangularView<Eigen::Upper>();
+            qr_PRt = qr.colsPermutation() * qr_R.transpose();
+
+            if(perform_A_b_regularization)
+            {
+                svd.compute(qr_PRt, Eigen::ComputeThinU|Eigen::ComputeThinV);
+                qr_V.setZero(AN.cols(), k);
+                qr_V.topRows(k) = svd.matrixV();
+                qr_V.applyOnTheLeft(qr.householderQ());
+            }
+            else
+            {
+                svd.compute(qr_PRt);
+            }
+        }
+    }
 
     if(perform_A_b_regularization)
         regularize_A_b(min_sv_ratio);
@@ -389,13 +504,15 @@ void OpenSoT::solvers::nHQP::TaskData::compute_cost(const Eigen::MatrixXd* N,
     }
 }
 
-bool OpenSoT::solvers::nHQP::TaskData::update_and_solve()
+bool OpenSoT::solvers::nHQP::TaskData::update_and_solve(utils::LevelStatistics* stats)
 {
     bool success = false;
+    utils::SolverStatistics::clock::time_point start;
 
     // solver is not initialized
     if(!back_end_initialized)
     {
+        if(stats) start = utils::SolverStatistics::clock::now();
         success = back_end->initProblem(H, g,
                                         Aineq.generate_and_get(),
                                         lb.generate_and_get(),
@@ -403,6 +520,7 @@ bool OpenSoT::solvers::nHQP::TaskData::update_and_solve()
                                         lb_bound,
                                         ub_bound
                                         );
+        if(stats) stats->back_end_solve_time = utils::SolverStatistics::elapsed(start);
 
         if(success)
         {
@@ -422,10 +540,18 @@ bool OpenSoT::solvers::nHQP::TaskData::update_and_solve()
         back_end->updateBounds(lb_bound, ub_bound);
 
 
+        if(stats) start = utils::SolverStatistics::clock::now();
         success = back_end->solve();
+        if(stats) stats->back_end_solve_time = utils::SolverStatistics::elapsed(start);
 
     }
 
+    if(stats)
+    {
+        stats->iterations = back_end->getNumberOfIterations();
+        stats->success = success;
+    }
+
     if(logger)
     {
         logger->add(log_prefix + "solution", back_end->getSolution());
@@ -458,15 +584,38 @@ bool OpenSoT::solvers::nHQP::TaskData::compute_nullspace()
     {
         return false;
     }
-    else
+
+    if(nullspace_computed && AN_nullspace.cols() == ns_dim)
     {
-        AN_nullspace = svd.matrixV().rightCols(ns_dim); // svd was computed during compute_cost
         return true;
     }
 
+    if(nullspace_method == NullspaceMethod::SVD)
+    {
+        AN_nullspace = svd.matrixV().rightCols(ns_dim); // svd was computed during compute_cost
+    }
+    else
+    {
+        // AN^T*P = Q*R, the last ns_dim columns of Q span the nullspace of AN (qr was computed during compute_cost)
+        AN_nullspace.setZero(AN.cols(), ns_dim);
+        AN_nullspace.bottomRows(ns_dim).setIdentity();
+        AN_nullspace.applyOnTheLeft(qr.householderQ());
+    }
+
+    nullspace_computed = true;
     return true;
 }
 
+bool OpenSoT::solvers::nHQP::TaskData::check_nullspace_warm_start() const
+{
+    if(ns_dim <= 0 || AN_nullspace.rows() != AN.cols() || AN_nullspace.cols() != ns_dim)
+    {
+        return false;
+    }
+
+    return (AN * AN_nullspace).lpNorm<Eigen::Infinity>() <= nullspace_warm_start_tolerance;
+}
+
 int OpenSoT::solvers::nHQP::TaskData::compute_nullspace_dimension(double threshold)
 {
     int rank = (svd.singularValues().array() >= threshold).count(); // svd was computed during compute_cost
@@ -488,5 +637,23 @@ void OpenSoT::solvers::nHQP::TaskData::set_perform_selective_null_space_regulari
     perform_selective_null_space_regularization = perform_selective_null_space_regularization_;
 }
 
+void OpenSoT::solvers::nHQP::TaskData::set_nullspace_method(NullspaceMethod method)
+{
+    if(method != nullspace_method)
+    {
+        nullspace_method = method;
+        nullspace_computed = false;
+        AN_nullspace.resize(0, 0);
+    }
+}
 
+void OpenSoT::solvers::nHQP::TaskData::set_nullspace_warm_start(bool enable, double tolerance)
+{
+    nullspace_warm_start = enable;
+    nullspace_warm_start_tolerance = tolerance;
+}
 
+bool OpenSoT::solvers::nHQP::TaskData::is_nullspace_reused() const
+{
+    return nullspace_reused;
+}
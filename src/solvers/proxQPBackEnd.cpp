@@ -1,4 +1,5 @@
 #include <OpenSoT/solvers/proxQPBackEnd.h>
+#include <xbot2_interface/logger.h>
 
 using namespace OpenSoT::solvers;
 using namespace proxsuite;
@@ -19,6 +20,12 @@ extern "C" void destroy_instance( BackEnd * instance )
     delete instance;
 }
 
+extern "C" void get_capabilities(BackEndCapabilities * capabilities)
+{
+    capabilities->hotstart = true;
+    capabilities->max_recommended_size = 500;
+}
+
 proxQPBackEnd::proxQPBackEnd(const int number_of_variables,
                              const int number_of_constraints,
                              const double eps_regularisation):
@@ -28,7 +35,9 @@ proxQPBackEnd::proxQPBackEnd(const int number_of_variables,
     _G(number_of_variables),
     _ll(1),
     _uu(1),
-    _eps_regularisation(eps_regularisation*BASE_REGULARISATION) //TO HAVE COMPATIBILITY WITH THE QPOASES ONE!
+    _eps_regularisation(eps_regularisation*BASE_REGULARISATION), //TO HAVE COMPATIBILITY WITH THE QPOASES ONE!
+    _number_of_equalities(0),
+    _number_of_inequalities(0)
 {
     _I.resize(number_of_variables, number_of_variables);
     _I.setIdentity();
@@ -39,7 +48,7 @@ proxQPBackEnd::~proxQPBackEnd()
 
 }
 
-void proxQPBackEnd::create_data_structure(const Eigen::MatrixXd &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
+void proxQPBackEnd::create_data_structure(const RowMajorMatrixXd &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                                           const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
     for(unsigned int i = 0; i < lA.size(); ++i)
@@ -84,7 +93,7 @@ void proxQPBackEnd::create_data_structure(const Eigen::MatrixXd &A, const Eigen:
 }
 
 bool proxQPBackEnd::initProblem(const Eigen::MatrixXd &H,
-                                 const Eigen::VectorXd &g, const Eigen::MatrixXd &A,
+                                 const Eigen::VectorXd &g, const Eigen::Ref<const RowMajorMatrixXd> &A,
                                  const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                                  const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
@@ -94,7 +103,7 @@ bool proxQPBackEnd::initProblem(const Eigen::MatrixXd &H,
     _l = l;
     _u = u;
 
-    create_data_structure(A, lA, uA, l, u);
+    create_data_structure(_A, lA, uA, l, u);
 
     //3) popolate qp structure
     _g = g;
@@ -105,13 +114,26 @@ bool proxQPBackEnd::initProblem(const Eigen::MatrixXd &H,
 
 
     //4) init
-    _QP = std::make_shared<dense::QP<double>>(H.rows(), _AA.rows(), _G.rows());
+    _number_of_equalities = _AA.rows();
+    _number_of_inequalities = _G.rows();
+    _QP = std::make_shared<dense::QP<double>>(H.rows(), _number_of_equalities, _number_of_inequalities);
     _QP->init(_H, _g, _AA.generate_and_get(), _b.generate_and_get(), _G.generate_and_get(), _uu.generate_and_get(), _ll.generate_and_get());
     _QP->solve();
     _QP->settings.initial_guess =
         InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT;
 
-    return true;
+    _solution = _QP->results.x;
+
+    return checkStatus();
+}
+
+bool proxQPBackEnd::checkStatus()
+{
+    if(_QP->results.info.status == QPSolverOutput::PROXQP_SOLVED)
+        return true;
+
+    XBot::Logger::error("proxQP: problem not solved, status %i\n", int(_QP->results.info.status));
+    return false;
 }
 
 bool proxQPBackEnd::solve()
@@ -129,12 +151,34 @@ bool proxQPBackEnd::solve()
 
     create_data_structure(_A, _lA, _uA, _l, _u);
 
-    _QP->update(_H, _g, _AA.generate_and_get(), _b.generate_and_get(), _G.generate_and_get(), _uu.generate_and_get(), _ll.generate_and_get());
-    _QP->solve();
+    if(_AA.rows() != _number_of_equalities || _G.rows() != _number_of_inequalities)
+    {
+        //the split between equalities and inequalities changed: the problem is initialized again, warm starting
+        //from the previous primal solution
+        Eigen::VectorXd x = _QP->results.x;
+        Settings<double> settings = _QP->settings;
+
+        _number_of_equalities = _AA.rows();
+        _number_of_inequalities = _G.rows();
+        _QP = std::make_shared<dense::QP<double>>(_H.rows(), _number_of_equalities, _number_of_inequalities);
+        _QP->settings = settings;
+        _QP->init(_H, _g, _AA.generate_and_get(), _b.generate_and_get(), _G.generate_and_get(), _uu.generate_and_get(), _ll.generate_and_get());
+
+        _QP->settings.initial_guess = InitialGuessStatus::WARM_START;
+        Eigen::VectorXd y = Eigen::VectorXd::Zero(_number_of_equalities);
+        Eigen::VectorXd z = Eigen::VectorXd::Zero(_number_of_inequalities);
+        _QP->solve(x, y, z);
+        _QP->settings.initial_guess = InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT;
+    }
+    else
+    {
+        _QP->update(_H, _g, _AA.generate_and_get(), _b.generate_and_get(), _G.generate_and_get(), _uu.generate_and_get(), _ll.generate_and_get());
+        _QP->solve();
+    }
 
     _solution = _QP->results.x;
 
-    return true;
+    return checkStatus();
 }
 
 bool proxQPBackEnd::updateTask(const Eigen::MatrixXd& H, const Eigen::VectorXd& g)
@@ -153,7 +197,7 @@ bool proxQPBackEnd::updateTask(const Eigen::MatrixXd& H, const Eigen::VectorXd&
     return true;
 }
 
-bool proxQPBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
+bool proxQPBackEnd::updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A,
                             const Eigen::Ref<const Eigen::VectorXd>& lA,
                             const Eigen::Ref<const Eigen::VectorXd>& uA)
 {
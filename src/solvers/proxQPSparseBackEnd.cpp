@@ -0,0 +1,325 @@
+#include <OpenSoT/solvers/proxQPSparseBackEnd.h>
+#include <xbot2_interface/logger.h>
+
+using namespace OpenSoT::solvers;
+using namespace proxsuite;
+using namespace proxsuite::proxqp;
+
+#define BASE_REGULARISATION 2.22E-13 //previous 1E-12
+
+/* Define factories for dynamic loading */
+extern "C" BackEnd * create_instance(const int number_of_variables,
+                               const int number_of_constraints,
+                               OpenSoT::HessianType hessian_type, const double eps_regularisation)
+{
+    return new proxQPSparseBackEnd(number_of_variables, number_of_constraints, eps_regularisation);
+}
+
+extern "C" void destroy_instance( BackEnd * instance )
+{
+    delete instance;
+}
+
+extern "C" void get_capabilities(BackEndCapabilities * capabilities)
+{
+    capabilities->hotstart = true;
+    capabilities->sparse = true;
+}
+
+proxQPSparseBackEnd::proxQPSparseBackEnd(const int number_of_variables,
+                                         const int number_of_constraints,
+                                         const double eps_regularisation):
+    BackEnd(number_of_variables, number_of_constraints),
+    _patterns_grown(false),
+    _eps_regularisation(eps_regularisation*BASE_REGULARISATION) //TO HAVE COMPATIBILITY WITH THE QPOASES ONE!
+{
+
+}
+
+proxQPSparseBackEnd::~proxQPSparseBackEnd()
+{
+
+}
+
+void proxQPSparseBackEnd::createSparseMatrices()
+{
+    const int number_of_variables = _H.rows();
+    const int number_of_constraints = _A.rows();
+    const int number_of_bounds = _l.size();
+
+    /* the diagonal of H is always set for the regularisation */
+    std::vector<Eigen::Triplet<double>> triplets;
+    for(int j = 0; j < number_of_variables; ++j)
+        for(int i = 0; i < number_of_variables; ++i)
+            if(i == j || _H_pattern(i,j))
+                triplets.emplace_back(i, j, 0.);
+
+    _Hsparse.resize(number_of_variables, number_of_variables);
+    _Hsparse.setFromTriplets(triplets.begin(), triplets.end());
+    _Hsparse.makeCompressed();
+
+    _H_index.clear();
+    _H_diagonal.clear();
+    for(int j = 0; j < _Hsparse.outerSize(); ++j)
+    {
+        for(SparseMatrix::InnerIterator it(_Hsparse, j); it; ++it)
+        {
+            if(it.row() == j)
+                _H_diagonal.push_back(_H_index.size());
+            _H_index.push_back(&_H(it.row(), j) - _H.data());
+        }
+    }
+
+    /* the rows of the bounds come first and are constant */
+    triplets.clear();
+    for(int j = 0; j < number_of_variables; ++j)
+    {
+        if(j < number_of_bounds)
+            triplets.emplace_back(j, j, 1.);
+        for(int i = 0; i < number_of_constraints; ++i)
+            if(_A_pattern(i,j))
+                triplets.emplace_back(number_of_bounds + i, j, 0.);
+    }
+
+    _Csparse.resize(number_of_bounds + number_of_constraints, number_of_variables);
+    _Csparse.setFromTriplets(triplets.begin(), triplets.end());
+    _Csparse.makeCompressed();
+
+    _C_index.clear();
+    for(int j = 0; j < _Csparse.outerSize(); ++j)
+        for(SparseMatrix::InnerIterator it(_Csparse, j); it; ++it)
+            _C_index.push_back(it.row() >= number_of_bounds ? &_A(it.row() - number_of_bounds, j) - _A.data() : -1);
+
+    _Asparse.resize(0, number_of_variables);
+    _b.resize(0);
+
+    _lC.resize(number_of_bounds + number_of_constraints);
+    _uC.resize(number_of_bounds + number_of_constraints);
+}
+
+void proxQPSparseBackEnd::updateSparseValues()
+{
+    double* values = _Hsparse.valuePtr();
+    for(unsigned int k = 0; k < _H_index.size(); ++k)
+        values[k] = _H.data()[_H_index[k]];
+    for(unsigned int k = 0; k < _H_diagonal.size(); ++k)
+        values[_H_diagonal[k]] += _eps_regularisation;
+
+    values = _Csparse.valuePtr();
+    for(unsigned int k = 0; k < _C_index.size(); ++k)
+        if(_C_index[k] >= 0)
+            values[k] = _A.data()[_C_index[k]];
+
+    const int number_of_bounds = _l.size();
+    _lC.head(number_of_bounds) = _l;
+    _uC.head(number_of_bounds) = _u;
+    _lC.tail(_lA.size()) = _lA;
+    _uC.tail(_uA.size()) = _uA;
+}
+
+bool proxQPSparseBackEnd::growPatterns()
+{
+    //the diagonal of H is always in the sparse matrix
+    bool grown = false;
+    for(int j = 0; j < _H.cols(); ++j)
+    {
+        for(int i = 0; i < _H.rows(); ++i)
+        {
+            if(i != j && !_H_pattern(i,j) && _H(i,j) != 0.)
+                grown = _H_pattern(i,j) = true;
+        }
+    }
+    for(int i = 0; i < _A.rows(); ++i)
+    {
+        for(int j = 0; j < _A.cols(); ++j)
+        {
+            if(!_A_pattern(i,j) && _A(i,j) != 0.)
+                grown = _A_pattern(i,j) = true;
+        }
+    }
+    return grown;
+}
+
+void proxQPSparseBackEnd::initQP()
+{
+    Eigen::VectorXd x, y, z;
+    const bool warm_start = _QP && _QP->results.x.size() == _Hsparse.rows() &&
+                            _QP->results.z.size() == _Csparse.rows();
+    if(warm_start)
+    {
+        x = _QP->results.x;
+        y = _QP->results.y;
+        z = _QP->results.z;
+    }
+
+    _QP = std::make_shared<sparse::QP<double, int>>(_Hsparse.rows(), _Asparse.rows(), _Csparse.rows());
+    if(_user_settings)
+        _QP->settings = *_user_settings;
+
+    //same ordering of the bounds of the inequalities used in proxQPBackEnd
+    _QP->init(_Hsparse, _g, _Asparse, _b, _Csparse, _uC, _lC);
+
+    if(warm_start)
+    {
+        _QP->settings.initial_guess = InitialGuessStatus::WARM_START;
+        _QP->solve(x, y, z);
+    }
+    else
+        _QP->solve();
+
+    _QP->settings.initial_guess = InitialGuessStatus::WARM_START_WITH_PREVIOUS_RESULT;
+}
+
+bool proxQPSparseBackEnd::initProblem(const Eigen::MatrixXd &H,
+                                      const Eigen::VectorXd &g, const Eigen::Ref<const RowMajorMatrixXd> &A,
+                                      const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
+                                      const Eigen::VectorXd &l, const Eigen::VectorXd &u)
+{
+    _A = A;
+    _lA = lA;
+    _uA = uA;
+    _l = l;
+    _u = u;
+    _g = g;
+    _H = H;
+
+    //patterns which are not declared (or declared for another size) are detected from the problem, the previous
+    //solution is kept to warm start the new problem
+    if(_H_pattern.rows() != H.rows() || _H_pattern.cols() != H.cols())
+        _H_pattern.setConstant(H.rows(), H.cols(), false);
+    if(_A_pattern.rows() != A.rows() || _A_pattern.cols() != A.cols())
+        _A_pattern.setConstant(A.rows(), A.cols(), false);
+    growPatterns();
+    _patterns_grown = false;
+
+    createSparseMatrices();
+    updateSparseValues();
+    initQP();
+
+    _solution = _QP->results.x;
+
+    return checkStatus();
+}
+
+bool proxQPSparseBackEnd::solve()
+{
+    if(_patterns_grown)
+    {
+        XBot::Logger::warning("proxQP: nonzeros outside of the sparsity patterns, the problem is initialized again\n");
+        return initProblem(_H, _g, _A, _lA, _uA, _l, _u);
+    }
+
+    updateSparseValues();
+    _QP->update(_Hsparse, _g, _Asparse, _b, _Csparse, _uC, _lC);
+    _QP->solve();
+
+    _solution = _QP->results.x;
+
+    return checkStatus();
+}
+
+bool proxQPSparseBackEnd::checkStatus()
+{
+    if(_QP->results.info.status == QPSolverOutput::PROXQP_SOLVED)
+        return true;
+
+    XBot::Logger::error("proxQP: problem not solved, status %i\n", int(_QP->results.info.status));
+    return false;
+}
+
+bool proxQPSparseBackEnd::updateTask(const Eigen::MatrixXd& H, const Eigen::VectorXd& g)
+{
+    if(_H.rows() != H.rows() || _H.cols() != H.cols())
+        return false;
+    if(g.size() != _g.size())
+        return false;
+
+    _g = g;
+    _H = H;
+    if(growPatterns())
+        _patterns_grown = true;
+
+    return true;
+}
+
+bool proxQPSparseBackEnd::updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A,
+                                            const Eigen::Ref<const Eigen::VectorXd>& lA,
+                                            const Eigen::Ref<const Eigen::VectorXd>& uA)
+{
+    if(_A.rows() != A.rows() || _A.cols() != A.cols())
+        return false;
+    if(lA.size() != _lA.size())
+        return false;
+    if(uA.size() != _uA.size())
+        return false;
+
+    _A = A;
+    _lA = lA;
+    _uA = uA;
+    if(growPatterns())
+        _patterns_grown = true;
+
+    return true;
+}
+
+bool proxQPSparseBackEnd::updateBounds(const Eigen::VectorXd& l, const Eigen::VectorXd& u)
+{
+    if(l.size() != _l.size())
+        return false;
+    if(u.size() != _u.size())
+        return false;
+
+    _l = l;
+    _u = u;
+
+    return true;
+}
+
+void proxQPSparseBackEnd::setOptions(const boost::any& options)
+{
+    if(options.type() == typeid(proxQPSparseBackEndOptions))
+    {
+        const proxQPSparseBackEndOptions& opt = boost::any_cast<const proxQPSparseBackEndOptions&>(options);
+        if(opt.settings)
+            setOptions(*opt.settings);
+
+        if(opt.H_pattern.size() > 0 && (opt.H_pattern.rows() != getNumVariables() || opt.H_pattern.cols() != getNumVariables()))
+        {
+            XBot::Logger::error("proxQP: H_pattern should be %i x %i\n", getNumVariables(), getNumVariables());
+            return;
+        }
+        if(opt.A_pattern.size() > 0 && (opt.A_pattern.rows() != getNumConstraints() || opt.A_pattern.cols() != getNumVariables()))
+        {
+            XBot::Logger::error("proxQP: A_pattern should be %i x %i\n", getNumConstraints(), getNumVariables());
+            return;
+        }
+
+        auto same = [](const SparsityPattern& a, const SparsityPattern& b){
+            return a.size() == 0 || (a.rows() == b.rows() && a.cols() == b.cols() && a == b);
+        };
+        if(!same(opt.H_pattern, _H_pattern) || !same(opt.A_pattern, _A_pattern))
+        {
+            _H_pattern = opt.H_pattern;
+            _A_pattern = opt.A_pattern;
+            //the sparse matrices of an initialized problem have to be created again, warm starting from the
+            //previous solution
+            if(_QP)
+                initProblem(_H, _g, _A, _lA, _uA, _l, _u);
+        }
+        return;
+    }
+
+    _user_settings = std::make_shared<Settings<double>>(boost::any_cast<Settings<double>>(options));
+    if(_QP)
+        _QP->settings = *_user_settings;
+}
+
+boost::any proxQPSparseBackEnd::getOptions()
+{
+    return _QP ? _QP->settings : Settings<double>();
+}
+
+double proxQPSparseBackEnd::getObjective()
+{
+    return _QP->results.info.objValue;
+}
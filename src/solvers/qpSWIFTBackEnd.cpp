@@ -1,4 +1,6 @@
 #include <OpenSoT/solvers/qpSWIFTBackEnd.h>
+#include <cmath>
+#include <limits>
 
 using namespace OpenSoT::solvers;
 
@@ -18,6 +20,12 @@ extern "C" void destroy_instance( BackEnd * instance )
     delete instance;
 }
 
+extern "C" void get_capabilities(BackEndCapabilities * capabilities)
+{
+    //the problem is set up through QP_SETUP_dense, the sparsity of H and A is not exploited
+    capabilities->sparse = false;
+}
+
 /**
  * @brief qpSWIFTBackEnd::qpSWIFTBackEnd
  * @param number_of_variables
@@ -29,14 +37,10 @@ qpSWIFTBackEnd::qpSWIFTBackEnd(const int number_of_variables,
                                const int number_of_constraints,
                                const double eps_regularisation):
     BackEnd(number_of_variables, number_of_constraints),
-    _AA(number_of_variables),
-    _b(1),
-    _G(number_of_variables),
-    _h(1),
-    _eps_regularisation(eps_regularisation*BASE_REGULARISATION) //TO HAVE COMPATIBILITY WITH THE QPOASES ONE!
+    _eps_regularisation(eps_regularisation*BASE_REGULARISATION), //TO HAVE COMPATIBILITY WITH THE QPOASES ONE!
+    _matrices_changed(true)
 {
-    _I.resize(number_of_variables, number_of_variables);
-    _I.setIdentity();
+
 }
 
 qpSWIFTBackEnd::~qpSWIFTBackEnd()
@@ -44,64 +48,145 @@ qpSWIFTBackEnd::~qpSWIFTBackEnd()
 
 }
 
-void qpSWIFTBackEnd::createDataStructure(const Eigen::MatrixXd &A, const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
-                                         const Eigen::VectorXd &l, const Eigen::VectorXd &u)
+namespace {
+
+enum RowType: char {FREE = 0, UPPER, LOWER, BOTH, EQUALITY};
+
+RowType row_type(const double l, const double u)
 {
-    _equality_constraint_indices.clear();
-    _equality_bounds_indices.clear();
-    _inequality_constraint_indices.clear();
-    _inequality_bounds_indices.clear();
+    const bool has_lower = l > -QPSWIFT_INFINITY;
+    const bool has_upper = u < QPSWIFT_INFINITY;
+
+    if(has_lower && has_upper && std::fabs(l-u) <= std::numeric_limits<double>::epsilon())
+        return EQUALITY;
+    if(has_lower && has_upper)
+        return BOTH;
+    if(has_upper)
+        return UPPER;
+    if(has_lower)
+        return LOWER;
+    return FREE;
+}
 
-    //1) Creates equality and inequality indices
-    for(unsigned int i = 0; i < lA.size(); ++i)
-    {
-        if(std::fabs(lA[i]-uA[i]) <= std::numeric_limits<double>::epsilon())
-            _equality_constraint_indices.push_back(i);
-        else
-            _inequality_constraint_indices.push_back(i);
-    }
+}
+
+bool qpSWIFTBackEnd::updateRowLayout()
+{
+    const int number_of_constraints = _lA.size();
 
-    for(unsigned int i = 0; i < l.size(); ++i)
+    bool changed = _row_types.size() != (std::size_t)(number_of_constraints + _l.size());
+    _row_types.resize(number_of_constraints + _l.size(), FREE);
+
+    for(int i = 0; i < (int)_row_types.size(); ++i)
     {
-        if(std::fabs(l[i]-u[i]) <= std::numeric_limits<double>::epsilon())
-            _equality_bounds_indices.push_back(i);
-        else
-            _inequality_bounds_indices.push_back(i);
+        const char type = i < number_of_constraints ? row_type(_lA[i], _uA[i]) :
+                                                      row_type(_l[i - number_of_constraints], _u[i - number_of_constraints]);
+        changed = changed || type != _row_types[i];
+        _row_types[i] = type;
     }
 
-    //2) Creates equality and inequality matrices
-    for(const auto& i : _equality_constraint_indices)
+    if(!changed && _qp)
+        return false;
+
+    _equality_rows.clear();
+    _inequality_rows.clear();
+    for(int i = 0; i < (int)_row_types.size(); ++i)
     {
-        _AA.pile(A.row(i));
-        _b.pile(lA.segment(i, 1));
+        switch(_row_types[i])
+        {
+        case EQUALITY:
+            _equality_rows.push_back(i);
+            break;
+        case UPPER:
+            _inequality_rows.emplace_back(i, 1.);
+            break;
+        case LOWER:
+            _inequality_rows.emplace_back(i, -1.);
+            break;
+        case BOTH:
+            _inequality_rows.emplace_back(i, 1.);
+            _inequality_rows.emplace_back(i, -1.);
+            break;
+        default:
+            break;
+        }
     }
-    for(const auto& i : _equality_bounds_indices)
+
+    _AA.setZero(_equality_rows.size(), _number_of_variables);
+    _b.setZero(_equality_rows.size());
+    _G.setZero(_inequality_rows.size(), _number_of_variables);
+    _h.setZero(_inequality_rows.size());
+
+    return true;
+}
+
+void qpSWIFTBackEnd::fillDataStructure()
+{
+    const int number_of_constraints = _lA.size();
+
+    for(unsigned int k = 0; k < _equality_rows.size(); ++k)
     {
-        _AA.pile(_I.row(i));
-        _b.pile(_l.segment(i, 1));
+        const int i = _equality_rows[k];
+        if(i < number_of_constraints)
+        {
+            _AA.row(k) = _A.row(i);
+            _b[k] = _lA[i];
+        }
+        else
+        {
+            _AA.row(k).setZero();
+            _AA(k, i - number_of_constraints) = 1.;
+            _b[k] = _l[i - number_of_constraints];
+        }
     }
 
-    for(const auto& i : _inequality_constraint_indices)
+    for(unsigned int k = 0; k < _inequality_rows.size(); ++k)
     {
-        _G.pile(A.row(i));
-        _h.pile(uA.segment(i, 1));
-
-        _G.pile(-A.row(i));
-        _h.pile(-lA.segment(i, 1));
+        const int i = _inequality_rows[k].first;
+        const double sign = _inequality_rows[k].second;
+        if(i < number_of_constraints)
+        {
+            _G.row(k) = sign*_A.row(i);
+            _h[k] = sign > 0. ? _uA[i] : -_lA[i];
+        }
+        else
+        {
+            _G.row(k).setZero();
+            _G(k, i - number_of_constraints) = sign;
+            _h[k] = sign > 0. ? _u[i - number_of_constraints] : -_l[i - number_of_constraints];
+        }
     }
-    for(const auto& i : _inequality_bounds_indices)
-    {
-        _G.pile(_I.row(i));
-        _h.pile(u.segment(i, 1));
+}
 
-        _G.pile(-_I.row(i));
-        _h.pile(-l.segment(i, 1));
+bool qpSWIFTBackEnd::setup()
+{
+    _H_setup = _H;
+    _AA_setup = _AA;
+    _G_setup = _G;
+    _g_setup = _g;
+    _h_setup = _h;
+    _b_setup = _b;
+
+    _qp.reset(QP_SETUP_dense(_H_setup.cols(), _h_setup.rows(), _b_setup.rows(),
+                             _H_setup.data(),
+                             _AA_setup.data(),
+                             _G_setup.data(),
+                             _g_setup.data(),
+                             _h_setup.data(),
+                             _b_setup.data(),
+                             NULL, COLUMN_MAJOR_ORDERING));
 
-    }
+    if(!_qp)
+        return false;
+    _matrices_changed = false;
+
+    if(_user_options)
+        _qp->options = _user_options.get();
+    return true;
 }
 
 bool qpSWIFTBackEnd::initProblem(const Eigen::MatrixXd &H,
-                                 const Eigen::VectorXd &g, const Eigen::MatrixXd &A,
+                                 const Eigen::VectorXd &g, const Eigen::Ref<const RowMajorMatrixXd> &A,
                                  const Eigen::VectorXd &lA, const Eigen::VectorXd &uA,
                                  const Eigen::VectorXd &l, const Eigen::VectorXd &u)
 {
@@ -116,45 +201,33 @@ bool qpSWIFTBackEnd::initProblem(const Eigen::MatrixXd &H,
     for(unsigned int i = 0; i < H.cols(); ++i)
         _H(i, i) += _eps_regularisation;
 
-    createDataStructure(_A, _lA, _uA, _l, _u);
-
-    _qp.reset(QP_SETUP_dense(_H.cols(), _h.rows(), _b.rows(),
-                             _H.data(),
-                             _AA.generate_and_get().data(),
-                             _G.generate_and_get().data(),
-                             _g.data(),
-                             _h.generate_and_get().data(),
-                             _b.generate_and_get().data(),
-                             NULL, COLUMN_MAJOR_ORDERING));
+    _qp.reset();
+    updateRowLayout();
+    fillDataStructure();
 
-    if(_qp)
+    if(setup())
         return solve();
     return false;
 }
 
 bool qpSWIFTBackEnd::solve()
 {
+    const bool layout_changed = updateRowLayout();
+    fillDataStructure();
 
-    _AA.reset();
-    _b.reset();
-    _h.reset();
-    _G.reset();
-
-    createDataStructure(_A, _lA, _uA, _l, _u);
-
-
-
-    _qp.reset(QP_SETUP_dense(_H.cols(), _h.rows(), _b.rows(),
-                             _H.data(),
-                             _AA.generate_and_get().data(),
-                             _G.generate_and_get().data(),
-                             _g.data(),
-                             _h.generate_and_get().data(),
-                             _b.generate_and_get().data(),
-                             NULL, COLUMN_MAJOR_ORDERING));
-
-    if(_user_options)
-        _qp->options = _user_options.get();
+    //the KKT structure of qpSWIFT is built from H, _AA and _G and can not be updated in place: the problem is set up
+    //again whenever they are passed, only the vectors are updated if just the bounds changed
+    if(layout_changed || _matrices_changed)
+    {
+        if(!setup())
+            return false;
+    }
+    else
+    {
+        Eigen::Map<Eigen::VectorXd>(_qp->c, _g.size()) = _g;
+        Eigen::Map<Eigen::VectorXd>(_qp->h, _h.size()) = _h;
+        Eigen::Map<Eigen::VectorXd>(_qp->b, _b.size()) = _b;
+    }
 
     qp_int exit_code = QP_SOLVE(_qp.get());
     if(exit_code == QP_MAXIT)
@@ -204,10 +277,11 @@ bool qpSWIFTBackEnd::updateTask(const Eigen::MatrixXd& H, const Eigen::VectorXd&
     for(unsigned int i = 0; i < H.cols(); ++i)
         _H(i, i) += _eps_regularisation;
 
+    _matrices_changed = true;
     return true;
 }
 
-bool qpSWIFTBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>& A,
+bool qpSWIFTBackEnd::updateConstraints(const Eigen::Ref<const RowMajorMatrixXd>& A,
                             const Eigen::Ref<const Eigen::VectorXd>& lA,
                             const Eigen::Ref<const Eigen::VectorXd>& uA)
 {
@@ -222,6 +296,7 @@ bool qpSWIFTBackEnd::updateConstraints(const Eigen::Ref<const Eigen::MatrixXd>&
     _lA = lA;
     _uA = uA;
 
+    _matrices_changed = true;
     return true;
 }
 
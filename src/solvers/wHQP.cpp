@@ -0,0 +1,263 @@
+#include <OpenSoT/solvers/wHQP.h>
+#include <OpenSoT/utils/AutoStack.h>
+#include <xbot2_interface/logger.h>
+#include <algorithm>
+#include <cmath>
+
+using namespace OpenSoT::solvers;
+
+wHQP::wHQP(OpenSoT::AutoStack& stack_of_tasks, const std::vector<double>& level_weights,
+           const double eps_regularisation, const solver_back_ends be_solver):
+    Solver(stack_of_tasks.getStack(), stack_of_tasks.getBounds()),
+    _weights_changed(true),
+    _epsRegularisation(eps_regularisation),
+    _be_solver(be_solver),
+    _regularisation_task(stack_of_tasks.getRegularisationTask()),
+    _hessian_type(OpenSoT::HessianType::HST_UNKNOWN)
+{
+    if(_tasks.empty())
+        throw std::runtime_error("Can Not initizalize wHQP with an empty stack!");
+
+    _level_weights = computeLevelWeights(_tasks.size());
+    if(!level_weights.empty() && !setLevelWeights(level_weights))
+        throw std::invalid_argument("wHQP: level_weights should contain a non-negative weight per level");
+
+    if(!prepareQP(be_solver))
+        throw std::runtime_error("Can Not initizalize wHQP!");
+}
+
+std::vector<double> wHQP::computeLevelWeights(const unsigned int levels, const double ratio)
+{
+    std::vector<double> weights(levels);
+    for(unsigned int i = 0; i < levels; ++i)
+        weights[i] = std::pow(ratio, levels - 1 - i);
+    return weights;
+}
+
+bool wHQP::setLevelWeights(const std::vector<double>& level_weights)
+{
+    if(level_weights.size() != _tasks.size())
+    {
+        XBot::Logger::error("wHQP: %i level weights given, stack has %i levels\n",
+                            (int)level_weights.size(), (int)_tasks.size());
+        return false;
+    }
+
+    if(!checkWeights(level_weights))
+    {
+        XBot::Logger::error("wHQP: level weights should be non-negative (and 1 for a single level with identity Hessian)\n");
+        return false;
+    }
+
+    _level_weights = level_weights;
+    _weights_changed = true;
+    return true;
+}
+
+bool wHQP::setLevelWeight(const unsigned int i, const double weight)
+{
+    std::vector<double> level_weights = _level_weights;
+    if(i < level_weights.size())
+        level_weights[i] = weight;
+    if(i >= _level_weights.size() || !checkWeights(level_weights))
+    {
+        XBot::Logger::error("wHQP: can not set weight %f to level %i\n", weight, i);
+        return false;
+    }
+
+    _level_weights[i] = weight;
+    _weights_changed = true;
+    return true;
+}
+
+bool wHQP::checkWeights(const std::vector<double>& level_weights) const
+{
+    if(std::any_of(level_weights.begin(), level_weights.end(), [](const double w){return !(w >= 0.);}))
+        return false;
+
+    //the back-end of a single level with identity Hessian assumes H = I
+    if(_hessian_type == OpenSoT::HessianType::HST_IDENTITY && level_weights[0] != 1.)
+        return false;
+
+    return true;
+}
+
+OpenSoT::HessianType wHQP::computeHessianType() const
+{
+    const OpenSoT::HessianType hessian_type = (OpenSoT::HessianType)(_tasks[0]->getHessianAtype());
+    if(_tasks.size() == 1 && !_regularisation_task && _level_weights[0] == 1.)
+        return hessian_type;
+
+    bool shared = true;
+    for(const auto& task : _tasks)
+        shared = shared && (OpenSoT::HessianType)(task->getHessianAtype()) == hessian_type;
+    if(_regularisation_task)
+        shared = shared && (OpenSoT::HessianType)(_regularisation_task->getHessianAtype()) == hessian_type;
+
+    if(!shared)
+        return OpenSoT::HessianType::HST_SEMIDEF;
+
+    //sum_i w_i I is positive definite, but not the identity
+    if(hessian_type == OpenSoT::HessianType::HST_IDENTITY)
+        return OpenSoT::HessianType::HST_POSDEF;
+    return hessian_type;
+}
+
+void wHQP::computeCost()
+{
+    bool changed = _weights_changed;
+    _weights_changed = false;
+
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+        changed = _cost_functions[i].compute(_tasks[i]->getA(), _tasks[i]->getb(), _tasks[i]->getWeight(),
+                                             _tasks[i]->getc(), _tasks[i]->getVersion()) || changed;
+
+    if(_regularisation_task)
+        changed = _regularisation_cost_function.compute(_regularisation_task->getA(), _regularisation_task->getb(),
+                                                        _regularisation_task->getWeight(), _regularisation_task->getc(),
+                                                        _regularisation_task->getVersion()) || changed;
+
+    if(!changed)
+        return;
+
+    _H.setZero(_tasks[0]->getXSize(), _tasks[0]->getXSize());
+    _g.setZero(_tasks[0]->getXSize());
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+    {
+        if(_level_weights[i] == 0.)
+            continue;
+        _H += _level_weights[i]*_cost_functions[i].getH();
+        _g += _level_weights[i]*_cost_functions[i].getg();
+    }
+
+    if(_regularisation_task)
+    {
+        _H += _regularisation_cost_function.getH();
+        _g += _regularisation_cost_function.getg();
+    }
+}
+
+bool wHQP::prepareQP(const solver_back_ends be_solver)
+{
+    _cost_functions.assign(_tasks.size(), CostFunctionCache());
+    computeCost();
+
+    //constraints of all the levels (without repetitions), global constraints and bounds
+    std::list<ConstraintPtr> constraints;
+    for(const auto& task : _tasks)
+    {
+        for(const auto& constraint : task->getConstraints())
+        {
+            if(std::find(constraints.begin(), constraints.end(), constraint) == constraints.end())
+                constraints.push_back(constraint);
+        }
+    }
+    if(_globalConstraints)
+        constraints.push_back(_globalConstraints);
+    if(_bounds)
+        constraints.push_back(_bounds);
+
+    _constraints = std::make_shared<OpenSoT::constraints::Aggregated>(constraints, _tasks[0]->getXSize());
+    _constraints->generateAll();
+
+    _hessian_type = computeHessianType();
+
+    XBot::Logger::info("#USING BACK-END: %s\n", whichBackEnd(be_solver).c_str());
+    _back_end = BackEndFactory(be_solver, _tasks[0]->getXSize(), _constraints->getAineq().rows(),
+                               _hessian_type, _epsRegularisation, estimateDensity(_H, _constraints->getAineq()));
+
+    if(!_back_end->initProblem(_H, _g, _constraints->getAineq(),
+                               _constraints->getbLowerBound(), _constraints->getbUpperBound(),
+                               _constraints->getLowerBound(), _constraints->getUpperBound()))
+    {
+        XBot::Logger::error("ERROR: INITIALIZING wHQP \n");
+        return false;
+    }
+
+    std::string tasks_string = "";
+    for(unsigned int i = 0; i < _tasks.size(); ++i)
+        tasks_string += (i > 0 ? "+" : "") + _tasks[i]->getTaskID();
+    std::string bounds_string = "";
+    if(_bounds)
+        bounds_string = _bounds->getConstraintID();
+    _back_end->printProblemInformation(0, tasks_string, _constraints->getConstraintID(), bounds_string);
+
+    return true;
+}
+
+bool wHQP::solve(Eigen::VectorXd& solution)
+{
+    utils::SolverStatistics::clock::time_point start;
+    if(_statistics) start = utils::SolverStatistics::clock::now();
+
+    utils::SolverStatistics::clock::time_point level_start = start;
+    computeCost();
+    if(_statistics)
+    {
+        _statistics->level(0).cost_time = utils::SolverStatistics::elapsed(level_start);
+        level_start = utils::SolverStatistics::clock::now();
+    }
+
+    _constraints->generateAll();
+    if(_statistics)
+    {
+        _statistics->level(0).constraints_time = utils::SolverStatistics::elapsed(level_start);
+        level_start = utils::SolverStatistics::clock::now();
+    }
+
+    bool success = _back_end->updateProblem(_H, _g, _constraints->getAineq(),
+                                            _constraints->getbLowerBound(), _constraints->getbUpperBound(),
+                                            _constraints->getLowerBound(), _constraints->getUpperBound());
+    if(success)
+    {
+        utils::SolverStatistics::clock::time_point solve_start;
+        if(_statistics) solve_start = utils::SolverStatistics::clock::now();
+        success = _back_end->solve();
+        if(_statistics) _statistics->level(0).back_end_solve_time = utils::SolverStatistics::elapsed(solve_start);
+    }
+    if(success)
+        solution = _back_end->getSolution();
+
+    if(_statistics)
+    {
+        _statistics->level(0).back_end_time = utils::SolverStatistics::elapsed(level_start);
+        _statistics->level(0).iterations = _back_end->getNumberOfIterations();
+        _statistics->level(0).success = success;
+        _statistics->current().solve_time = utils::SolverStatistics::elapsed(start);
+        _statistics->current().success = success;
+        _statistics->commit();
+    }
+
+    return success;
+}
+
+void wHQP::setOptions(const boost::any& opt)
+{
+    _back_end->setOptions(opt);
+}
+
+boost::any wHQP::getOptions()
+{
+    return _back_end->getOptions();
+}
+
+double wHQP::getObjective()
+{
+    return _back_end->getObjective();
+}
+
+std::string wHQP::getBackEndName()
+{
+    return whichBackEnd(_be_solver);
+}
+
+bool wHQP::setEpsRegularisation(const double eps)
+{
+    return _back_end->setEpsRegularisation(eps);
+}
+
+void wHQP::_log(XBot::MatLogger2::Ptr logger, const std::string& prefix)
+{
+    logger->add(prefix + "level_weights", Eigen::Map<const Eigen::VectorXd>(_level_weights.data(), _level_weights.size()));
+    _back_end->log(logger, 0, prefix);
+}
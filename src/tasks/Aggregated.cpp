@@ -17,6 +17,7 @@
 
 #include <OpenSoT/tasks/Aggregated.h>
 #include <algorithm>
+#include <map>
 #include <exception>
 #include <stdexcept>
 #include <assert.h>
@@ -28,7 +29,7 @@ std::string Aggregated::concatenatedId = "";
 
 Aggregated::Aggregated(const std::list<TaskPtr> tasks,
                        const unsigned int x_size) :
-    Task(concatenateTaskIds(tasks),x_size), _tasks(tasks)
+    Task(concatenateTaskIds(tasks),x_size), _tasks(tasks), _force_generation(false)
 {
     assert(tasks.size()>0);
 
@@ -47,7 +48,7 @@ Aggregated::Aggregated(const std::list<TaskPtr> tasks,
 Aggregated::Aggregated(TaskPtr task1,
                        TaskPtr task2,
                        const unsigned int x_size) :
-Task(task1->getTaskID()+_TASK_PLUS_+task2->getTaskID(),x_size)
+Task(task1->getTaskID()+_TASK_PLUS_+task2->getTaskID(),x_size), _force_generation(false)
 {
     _tasks.push_back(task1);
     _tasks.push_back(task2);
@@ -67,7 +68,7 @@ Task(task1->getTaskID()+_TASK_PLUS_+task2->getTaskID(),x_size)
 
 Aggregated::Aggregated(TaskPtr task,
                        const unsigned int x_size) :
-Task(task->getTaskID(),x_size)
+Task(task->getTaskID(),x_size), _force_generation(false)
 {
     _tasks.push_back(task);
 
@@ -90,14 +91,106 @@ Aggregated::~Aggregated()
 }
 
 void Aggregated::_update() {
+    if(_thread_pool)
+        _thread_pool->run(_parallel_tasks.size(), [this](const unsigned int i){_parallel_tasks[i]->update();});
+    else
+    {
+        for(std::list< TaskPtr >::iterator i = _tasks.begin();
+            i != _tasks.end(); ++i) {
+            TaskPtr t = *i;
+            t->update();
+        }
+    }
+
+    if(this->isChanged() || _force_generation)
+    {
+        this->generateAll();
+        generateWeight();
+    }
+    else
+        generateConstraints();
+
+    /* a not active task gets A set to zero after the update */
+    _force_generation = !this->isActive();
+}
+
+bool Aggregated::isChanged()
+{
+    bool changed = _generated_tasks.size() != _tasks.size();
+    if(changed)
+    {
+        _generated_tasks.resize(_tasks.size());
+        _generated_versions.resize(_tasks.size());
+    }
+
+    unsigned int j = 0;
     for(std::list< TaskPtr >::iterator i = _tasks.begin();
         i != _tasks.end(); ++i) {
-        TaskPtr t = *i;
-        t->update();
+        const unsigned int version = (*i)->getVersion();
+        if(changed || _generated_tasks[j] != *i || _generated_versions[j] != version)
+        {
+            _generated_tasks[j] = *i;
+            _generated_versions[j] = version;
+            changed = true;
+        }
+        j += 1;
     }
-    this->generateAll();
+    return changed;
+}
 
-    generateWeight();
+bool Aggregated::setThreadPool(ThreadPool::Ptr thread_pool)
+{
+    _thread_pool.reset();
+    _parallel_tasks.clear();
+
+    if(thread_pool)
+    {
+        /* a model can be read by a single task (and its constraints) */
+        std::map<const XBot::ModelInterface*, TaskPtr> readers;
+        std::vector<const XBot::ModelInterface*> models;
+        for(const auto& task : _tasks)
+        {
+            models.clear();
+            task->getModels(models);
+            for(const auto& constraint : task->getConstraints())
+                constraint->getModels(models);
+
+            for(const auto model : models)
+            {
+                const auto reader = readers.emplace(model, task).first;
+                if(reader->second != task)
+                {
+                    XBot::Logger::error("Aggregated: tasks %s and %s read from the same model and can not be updated in parallel\n",
+                                        reader->second->getTaskID().c_str(), task->getTaskID().c_str());
+                    return false;
+                }
+            }
+        }
+    }
+
+    _thread_pool = thread_pool;
+    _parallel_tasks.assign(_tasks.begin(), _tasks.end());
+    return true;
+}
+
+void Aggregated::getModels(std::vector<const XBot::ModelInterface*>& models) const
+{
+    for(const auto& task : _tasks)
+    {
+        task->getModels(models);
+        for(const auto& constraint : task->getConstraints())
+            constraint->getModels(models);
+    }
+}
+
+bool Aggregated::setActiveJointsMask(const std::vector<bool>& active_joints_mask)
+{
+    if(Task::setActiveJointsMask(active_joints_mask))
+    {
+        _force_generation = true;
+        return true;
+    }
+    return false;
 }
 
 
@@ -292,4 +385,5 @@ void OpenSoT::tasks::Aggregated::setWeight(const Eigen::MatrixXd &W)
         (*t)->setWeight(W.block(block, block, (*t)->getWeight().rows(),(*t)->getWeight().cols()));
         block += (*t)->getWeight().rows();
     }
+    increaseVersion();
 }
@@ -48,12 +48,12 @@ GenericTask::~GenericTask()
 
 void GenericTask::_update()
 {
-    _task = __A*_var - __b;
+    //A*var - b is computed in place on _A and _b to avoid temporaries
+    _A.noalias() = __A*_var.getM();
+    _b.noalias() = __A*_var.getq();
+    _b = __b - _b;
 
-    _A = _task.getM();
-    _b = -_task.getq();
-
-    _c = _var.getM().transpose()*__c;
+    _c.noalias() = _var.getM().transpose()*__c;
 }
 
 bool GenericTask::setc(const Eigen::VectorXd& c)
@@ -67,6 +67,7 @@ bool GenericTask::setc(const Eigen::VectorXd& c)
     __c = c;
 
     _update();
+    increaseVersion();
 
     return true;
 }
@@ -115,7 +116,10 @@ bool GenericTask::setAb(const Eigen::MatrixXd& A, const Eigen::VectorXd& b)
     }
 
     if(A.rows() != _A.rows())
+    {
         _W.setIdentity(A.rows(), A.rows());
+        increaseVersion();
+    }
 
     __A = A;
     __b = b;
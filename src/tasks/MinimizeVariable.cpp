@@ -26,6 +26,7 @@ bool OpenSoT::tasks::MinimizeVariable::setReference(const Eigen::VectorXd& ref)
 
     _ref = ref;
     _b = _ref - _var.getq();
+    increaseVersion();
     return true;
     
 }
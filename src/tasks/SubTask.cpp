@@ -81,6 +81,7 @@ void OpenSoT::SubTask::setWeight(const Eigen::MatrixXd &W)
                   this->_subTaskMap.asVector()[c]) = this->_W(r,c);
 
     _taskPtr->setWeight(fullW);
+    increaseVersion();
 }
 
 std::list<OpenSoT::SubTask::ConstraintPtr> &OpenSoT::SubTask::getConstraints()
@@ -282,6 +282,7 @@ void Cartesian::update_b() {
 
     _error<<positionError,-_orientationErrorGain*orientationError;
     _b = _desiredTwist + _lambda*_error;
+    increaseVersion();
 }
 
 bool Cartesian::setBaseLink(const std::string& base_link)
@@ -146,6 +146,7 @@ void CoM::update_b()
 {
     _positionError = _desiredPosition - _actualPosition;
     _b = _desiredVelocity + _lambda*_positionError;
+    increaseVersion();
 }
 
 void OpenSoT::tasks::velocity::CoM::setLambda(double lambda)
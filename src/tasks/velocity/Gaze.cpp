@@ -87,6 +87,7 @@ void Gaze::setWeight(const Eigen::MatrixXd &W)
 {
     this->_W = W;
     _subtask->setWeight(W);
+    increaseVersion();
 }
 
 std::list<OpenSoT::SubTask::ConstraintPtr> &Gaze::getConstraints()
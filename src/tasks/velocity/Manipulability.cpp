@@ -69,8 +69,11 @@ void Manipulability::_update() {
         if(this->getActiveJointsMask()[i])
         {
             _deltas[i] = _step;
-            double fun_a = _manipulabilityIndexGradientWorker.compute(_model.sum(_q, _deltas));
-            double fun_b = _manipulabilityIndexGradientWorker.compute(_model.sum(_q, -_deltas));
+            _model.sum(_q, _deltas, _q_step);
+            double fun_a = _manipulabilityIndexGradientWorker.compute(_q_step);
+            _deltas[i] = -_step;
+            _model.sum(_q, _deltas, _q_step);
+            double fun_b = _manipulabilityIndexGradientWorker.compute(_q_step);
 
             _gradient[i] = (fun_a - fun_b)/(2.0*_step);
             _deltas[i] = 0.0;
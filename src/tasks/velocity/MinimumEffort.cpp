@@ -49,7 +49,7 @@ MinimumEffort::~MinimumEffort()
 }
 
 void MinimumEffort::_update() {
-    _q = _model.getJointPosition();
+    _model.getJointPosition(_q);
 
     /************************* COMPUTING TASK *****************************/
 
@@ -62,8 +62,11 @@ void MinimumEffort::_update() {
         if(this->getActiveJointsMask()[i])
         {
             _deltas[i] = _step;
-            double fun_a = _gTauGradientWorker.compute(_model.sum(_q, _deltas));
-            double fun_b = _gTauGradientWorker.compute(_model.sum(_q, -_deltas));
+            _model.sum(_q, _deltas, _q_step);
+            double fun_a = _gTauGradientWorker.compute(_q_step);
+            _deltas[i] = -_step;
+            _model.sum(_q, _deltas, _q_step);
+            double fun_b = _gTauGradientWorker.compute(_q_step);
 
             _gradient[i] = (fun_a - fun_b)/(2.0*_step);
             _deltas[i] = 0.0;
@@ -97,6 +97,7 @@ void OpenSoT::tasks::velocity::Postural::getReference(Eigen::VectorXd &q_desired
 void Postural::update_b() {
     _robot.difference(_q_desired, _q, _dq);
     _b = _v_desired + _lambda*_dq;
+    increaseVersion();
 }
 
 void OpenSoT::tasks::velocity::Postural::setLambda(double lambda)
@@ -140,5 +140,6 @@ void AffineConstraint::update()
     _Aineq = _internal_generic_constraint->getAineq();
     _bLowerBound = _internal_generic_constraint->getbLowerBound();
     _bUpperBound = _internal_generic_constraint->getbUpperBound();
+    increaseVersion();
 }
 
@@ -384,12 +384,30 @@ OpenSoT::AutoStack::AutoStack(OpenSoT::solvers::iHQP::Stack stack,
 
 void OpenSoT::AutoStack::update()
 {
+    SolverStatistics::clock::time_point start;
+    if(_statistics)
+        start = SolverStatistics::clock::now();
+
     _boundsAggregated->update();
-    typedef std::vector<OpenSoT::tasks::Aggregated::TaskPtr>::iterator it_t;
-    for(it_t task = _stack.begin(); task != _stack.end(); ++task)
-        (*task)->update();
+    if(_statistics)
+        _statistics->current().bounds_update_time = SolverStatistics::elapsed(start);
+
+    for(unsigned int i = 0; i < _stack.size(); ++i)
+    {
+        SolverStatistics::clock::time_point task_start;
+        if(_statistics)
+            task_start = SolverStatistics::clock::now();
+
+        _stack[i]->update();
+
+        if(_statistics)
+            _statistics->level(i).update_time = SolverStatistics::elapsed(task_start);
+    }
     if(_regularisation_task)
         _regularisation_task->update();
+
+    if(_statistics)
+        _statistics->current().update_time = SolverStatistics::elapsed(start);
 }
 
 std::list<OpenSoT::constraints::Aggregated::ConstraintPtr>& OpenSoT::AutoStack::getBoundsList()
@@ -404,7 +422,30 @@ void OpenSoT::AutoStack::setBoundsAggregationPolicy(const unsigned int aggregati
     _boundsAggregated.reset(
         new OpenSoT::constraints::Aggregated(
             bounds,
-            bounds.front()->getXSize()));
+            bounds.front()->getXSize(),
+            aggregationPolicy));
+    _boundsAggregated->setThreadPool(_thread_pool);
+}
+
+bool OpenSoT::AutoStack::setThreadPool(ThreadPool::Ptr thread_pool)
+{
+    _thread_pool = thread_pool;
+
+    bool parallel = _boundsAggregated->setThreadPool(_thread_pool);
+
+    for(auto task : _stack)
+    {
+        OpenSoT::tasks::Aggregated::Ptr aggregated = std::dynamic_pointer_cast<OpenSoT::tasks::Aggregated>(task);
+        if(aggregated)
+            parallel = aggregated->setThreadPool(_thread_pool) && parallel;
+    }
+
+    OpenSoT::tasks::Aggregated::Ptr aggregated =
+            std::dynamic_pointer_cast<OpenSoT::tasks::Aggregated>(_regularisation_task);
+    if(aggregated)
+        parallel = aggregated->setThreadPool(_thread_pool) && parallel;
+
+    return parallel;
 }
 
 OpenSoT::constraints::Aggregated::ConstraintPtr OpenSoT::AutoStack::getBounds()
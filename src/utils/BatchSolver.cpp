@@ -0,0 +1,94 @@
+#include <OpenSoT/utils/BatchSolver.h>
+#include <atomic>
+#include <stdexcept>
+
+using namespace OpenSoT::utils;
+
+namespace {
+    /**
+     * @brief InvalidInput is thrown by the setup of a problem whose input is not consistent with the instance
+     */
+    struct InvalidInput {};
+}
+
+BatchSolver::BatchSolver(const unsigned int number_of_instances, const ProblemFactory& factory,
+                         const std::vector<int>& cpus):
+    _thread_pool(number_of_instances > 0 ? number_of_instances - 1 : 0, cpus)
+{
+    if(number_of_instances == 0)
+        throw std::invalid_argument("BatchSolver: number_of_instances must be greater than 0");
+
+    for(unsigned int i = 0; i < number_of_instances; ++i)
+    {
+        Problem::Ptr problem = factory(i);
+        if(!problem || !problem->stack || !problem->solver)
+            throw std::invalid_argument("BatchSolver: factory returned an incomplete problem for instance " +
+                                        std::to_string(i));
+        _problems.push_back(problem);
+    }
+}
+
+BatchSolver::Problem& BatchSolver::getProblem(const unsigned int instance)
+{
+    if(instance >= _problems.size())
+        throw std::out_of_range("BatchSolver: instance " + std::to_string(instance) + " does not exist");
+    return *_problems[instance];
+}
+
+void BatchSolver::solve(const unsigned int number_of_problems, const SetupFunction& setup,
+                        std::vector<Eigen::VectorXd>& solutions, std::vector<Status>& status)
+{
+    solutions.resize(number_of_problems);
+    status.assign(number_of_problems, Status::EXCEPTION);
+
+    // each job owns an instance and takes the problems of the batch from a shared counter
+    std::atomic<unsigned int> next_problem(0);
+    _thread_pool.run(_problems.size(), [&](const unsigned int instance)
+    {
+        Problem& problem = *_problems[instance];
+
+        unsigned int i;
+        while((i = next_problem.fetch_add(1)) < number_of_problems)
+        {
+            try
+            {
+                if(setup)
+                    setup(problem, i);
+                problem.stack->update();
+
+                status[i] = problem.solver->solve(solutions[i]) ? Status::SUCCESS : Status::SOLVE_FAILED;
+            }
+            catch(const InvalidInput&)
+            {
+                status[i] = Status::INVALID_INPUT;
+            }
+            catch(...)
+            {
+                status[i] = Status::EXCEPTION;
+            }
+        }
+    });
+}
+
+void BatchSolver::solve(const std::vector<Eigen::VectorXd>& q,
+                        std::vector<Eigen::VectorXd>& solutions, std::vector<Status>& status,
+                        const SetupFunction& set_references)
+{
+    for(const auto& problem : _problems)
+    {
+        if(!problem->model)
+            throw std::runtime_error("BatchSolver: joint configurations can not be set, instances do not have a model");
+    }
+
+    solve(q.size(), [&](Problem& problem, const unsigned int i)
+    {
+        if(q[i].size() != problem.model->getNq())
+            throw InvalidInput();
+
+        problem.model->setJointPosition(q[i]);
+        problem.model->update();
+
+        if(set_references)
+            set_references(problem, i);
+    }, solutions, status);
+}
@@ -0,0 +1,76 @@
+#include <OpenSoT/utils/SolverStatistics.h>
+
+using namespace OpenSoT::utils;
+
+SolverStatistics::SolverStatistics(const unsigned int capacity):
+    _tick(0),
+    _buffer(capacity + 1),
+    _head(0),
+    _tail(0),
+    _dropped(0)
+{
+    for(unsigned int i = 0; i < OPENSOT_STATISTICS_MAX_LEVELS; ++i)
+        _level_names.push_back("level_" + std::to_string(i) + "_");
+}
+
+LevelStatistics& SolverStatistics::level(const unsigned int i)
+{
+    const unsigned int j = i < OPENSOT_STATISTICS_MAX_LEVELS ? i : OPENSOT_STATISTICS_MAX_LEVELS - 1;
+    if(j + 1 > _current.number_of_levels)
+        _current.number_of_levels = j + 1;
+    return _current.levels[j];
+}
+
+bool SolverStatistics::commit()
+{
+    _current.tick = _tick++;
+
+    const unsigned int head = _head.load(std::memory_order_relaxed);
+    const unsigned int next = (head + 1) % _buffer.size();
+    bool pushed = next != _tail.load(std::memory_order_acquire);
+    if(pushed)
+    {
+        _buffer[head] = _current;
+        _head.store(next, std::memory_order_release);
+    }
+    else
+        ++_dropped;
+
+    _current = TickStatistics();
+    return pushed;
+}
+
+bool SolverStatistics::pop(TickStatistics& stats)
+{
+    const unsigned int tail = _tail.load(std::memory_order_relaxed);
+    if(tail == _head.load(std::memory_order_acquire))
+        return false;
+
+    stats = _buffer[tail];
+    _tail.store((tail + 1) % _buffer.size(), std::memory_order_release);
+    return true;
+}
+
+void SolverStatistics::log(XBot::MatLogger2::Ptr logger, const std::string& prefix)
+{
+    TickStatistics stats;
+    while(pop(stats))
+    {
+        logger->add(prefix + "tick", (double)stats.tick);
+        logger->add(prefix + "update_time", stats.update_time);
+        logger->add(prefix + "bounds_update_time", stats.bounds_update_time);
+        logger->add(prefix + "solve_time", stats.solve_time);
+        logger->add(prefix + "success", (double)stats.success);
+        for(unsigned int i = 0; i < stats.number_of_levels; ++i)
+        {
+            const std::string level_prefix = prefix + _level_names[i];
+            logger->add(level_prefix + "update_time", stats.levels[i].update_time);
+            logger->add(level_prefix + "cost_time", stats.levels[i].cost_time);
+            logger->add(level_prefix + "constraints_time", stats.levels[i].constraints_time);
+            logger->add(level_prefix + "back_end_time", stats.levels[i].back_end_time);
+            logger->add(level_prefix + "back_end_solve_time", stats.levels[i].back_end_solve_time);
+            logger->add(level_prefix + "iterations", (double)stats.levels[i].iterations);
+            logger->add(level_prefix + "success", (double)stats.levels[i].success);
+        }
+    }
+}
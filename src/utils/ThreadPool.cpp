@@ -0,0 +1,146 @@
+#include <OpenSoT/utils/ThreadPool.h>
+#include <xbot2_interface/logger.h>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+using namespace OpenSoT::utils;
+
+ThreadPool::ThreadPool(const unsigned int number_of_threads, const std::vector<int>& cpus):
+    _running(false),
+    _stop(false),
+    _generation(0),
+    _busy_workers(0),
+    _function(nullptr),
+    _context(nullptr),
+    _number_of_jobs(0),
+    _next_job(0),
+    _pending_jobs(0)
+{
+    for(unsigned int i = 0; i < number_of_threads; ++i)
+    {
+        _workers.emplace_back(&ThreadPool::workerLoop, this);
+
+        if(!cpus.empty())
+        {
+#ifdef __linux__
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(cpus[i % cpus.size()], &cpuset);
+            if(pthread_setaffinity_np(_workers.back().native_handle(), sizeof(cpu_set_t), &cpuset) != 0)
+                XBot::Logger::warning("ThreadPool: can not pin worker %i to cpu %i \n", i, cpus[i % cpus.size()]);
+#else
+            XBot::Logger::warning("ThreadPool: pinning workers to cpus is not supported on this platform \n");
+#endif
+        }
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stop = true;
+    }
+    _start_condition.notify_all();
+
+    for(auto& worker : _workers)
+        worker.join();
+}
+
+void ThreadPool::executeJobs(JobFunction function, void* context, const unsigned int number_of_jobs)
+{
+    unsigned int i;
+    while((i = _next_job.fetch_add(1)) < number_of_jobs)
+    {
+        try
+        {
+            function(context, i);
+        }
+        catch(...)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if(!_exception)
+                _exception = std::current_exception();
+        }
+
+        if(_pending_jobs.fetch_sub(1) == 1)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done_condition.notify_all();
+        }
+    }
+}
+
+void ThreadPool::workerLoop()
+{
+    unsigned long generation = 0;
+    while(true)
+    {
+        JobFunction function;
+        void* context;
+        unsigned int number_of_jobs;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _start_condition.wait(lock, [&]{return _stop || _generation != generation;});
+            if(_stop)
+                return;
+            generation = _generation;
+            function = _function;
+            context = _context;
+            number_of_jobs = _number_of_jobs;
+            ++_busy_workers;
+        }
+
+        executeJobs(function, context, number_of_jobs);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_busy_workers;
+        }
+        _done_condition.notify_all();
+    }
+}
+
+void ThreadPool::runJobs(const unsigned int number_of_jobs, JobFunction function, void* context)
+{
+    if(number_of_jobs == 0)
+        return;
+
+    // serial execution when there are no workers, a single job or the pool is already in use
+    if(_workers.empty() || number_of_jobs == 1 || _running.exchange(true))
+    {
+        for(unsigned int i = 0; i < number_of_jobs; ++i)
+            function(context, i);
+        return;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        // workers woken up late by the previous run have to leave before the jobs are replaced
+        _done_condition.wait(lock, [&]{return _busy_workers == 0;});
+        _function = function;
+        _context = context;
+        _number_of_jobs = number_of_jobs;
+        _next_job = 0;
+        _pending_jobs = number_of_jobs;
+        _exception = nullptr;
+        ++_generation;
+    }
+    _start_condition.notify_all();
+
+    executeJobs(function, context, number_of_jobs);
+
+    std::exception_ptr exception;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done_condition.wait(lock, [&]{return _pending_jobs == 0 && _busy_workers == 0;});
+        exception = _exception;
+        _exception = nullptr;
+    }
+    _running = false;
+
+    if(exception)
+        std::rethrow_exception(exception);
+}
@@ -0,0 +1,165 @@
+#ifndef MALLOC_HOOK_H
+#define MALLOC_HOOK_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+/**
+ * @brief The MallocHook class counts the heap allocations and deallocations done by any thread while the hook is
+ * enabled, it is used to check that the real-time paths do not touch the heap.
+ * On glibc malloc, calloc, realloc, the aligned allocations and free are replaced by the executable
+ * (and hence operator new/delete and Eigen dynamic matrices are counted as well), on other platforms only
+ * operator new/delete are replaced and the hook is reported as not available.
+ * This header has to be included by a single translation unit of the executable: it is used by the real-time
+ * tests and by the allocation counter of the benchmarks (benchmarks/AllocationCounter.cpp).
+ */
+class MallocHook {
+public:
+    /**
+     * @brief isAvailable
+     * @return true if all the allocation functions are replaced on this platform
+     */
+    static bool isAvailable()
+    {
+#ifdef __GLIBC__
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief start resets the counters and enables the hook
+     */
+    static void start()
+    {
+        allocations() = 0;
+        deallocations() = 0;
+        enabled() = true;
+    }
+
+    /**
+     * @brief stop disables the hook
+     */
+    static void stop()
+    {
+        enabled() = false;
+    }
+
+    /**
+     * @brief getAllocations
+     * @return number of allocations between the last start() and stop()
+     */
+    static unsigned long getAllocations(){ return allocations(); }
+
+    /**
+     * @brief getDeallocations
+     * @return number of deallocations between the last start() and stop()
+     */
+    static unsigned long getDeallocations(){ return deallocations(); }
+
+    static void countAllocation()
+    {
+        if(enabled().load(std::memory_order_relaxed))
+            allocations().fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void countDeallocation()
+    {
+        if(enabled().load(std::memory_order_relaxed))
+            deallocations().fetch_add(1, std::memory_order_relaxed);
+    }
+
+private:
+    static std::atomic<bool>& enabled(){ static std::atomic<bool> e(false); return e; }
+    static std::atomic<unsigned long>& allocations(){ static std::atomic<unsigned long> a(0); return a; }
+    static std::atomic<unsigned long>& deallocations(){ static std::atomic<unsigned long> d(0); return d; }
+};
+
+#ifdef __GLIBC__
+/**
+ * The allocation functions defined in the executable take precedence over the ones of libc for all the loaded
+ * libraries (back-ends plugins included), the actual allocation is forwarded to the glibc implementation.
+ */
+extern "C" {
+    void* __libc_malloc(size_t size);
+    void* __libc_calloc(size_t n, size_t size);
+    void* __libc_realloc(void* ptr, size_t size);
+    void* __libc_memalign(size_t alignment, size_t size);
+    void __libc_free(void* ptr);
+
+    void* malloc(size_t size)
+    {
+        MallocHook::countAllocation();
+        return __libc_malloc(size);
+    }
+
+    void* calloc(size_t n, size_t size)
+    {
+        MallocHook::countAllocation();
+        return __libc_calloc(n, size);
+    }
+
+    void* realloc(void* ptr, size_t size)
+    {
+        MallocHook::countAllocation();
+        return __libc_realloc(ptr, size);
+    }
+
+    void* memalign(size_t alignment, size_t size)
+    {
+        MallocHook::countAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    void* aligned_alloc(size_t alignment, size_t size)
+    {
+        MallocHook::countAllocation();
+        return __libc_memalign(alignment, size);
+    }
+
+    int posix_memalign(void** ptr, size_t alignment, size_t size)
+    {
+        MallocHook::countAllocation();
+        *ptr = __libc_memalign(alignment, size);
+        return *ptr ? 0 : ENOMEM;
+    }
+
+    void free(void* ptr)
+    {
+        if(ptr)
+            MallocHook::countDeallocation();
+        __libc_free(ptr);
+    }
+}
+#else
+void* operator new(size_t size)
+{
+    MallocHook::countAllocation();
+    if(void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if(ptr)
+        MallocHook::countDeallocation();
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    operator delete(ptr);
+}
+#endif
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef RANDOM_STACK_H
+#define RANDOM_STACK_H
+
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Helpers to create the random stacks used by the solver tests, the random values are generated through
+ * std::rand() so the caller has to seed it (std::srand) to get repeatable problems.
+ */
+namespace random_stack {
+
+/**
+ * @brief tasks creates a GenericTask "task<i>" of rows[i] x n for each level, A and b are random except for
+ * the last level which is a minimum norm task (A = I) if minimum_norm is true
+ * @param rows of the tasks, the last one has to be n if minimum_norm is true
+ * @param n number of variables
+ * @param minimum_norm if true the last task is a minimum norm task
+ * @param random_b if false b is zero for all the tasks
+ * @return the tasks, from the highest to the lowest priority
+ */
+inline std::vector<OpenSoT::tasks::GenericTask::Ptr> tasks(const std::vector<int>& rows, const int n,
+                                                           const bool minimum_norm = true,
+                                                           const bool random_b = true)
+{
+    std::vector<OpenSoT::tasks::GenericTask::Ptr> tasks;
+    for(unsigned int i = 0; i < rows.size(); ++i)
+    {
+        Eigen::MatrixXd A = Eigen::MatrixXd::Random(rows[i], n);
+        if(minimum_norm && i == rows.size()-1)
+            A.setIdentity(n, n);
+        Eigen::VectorXd b = Eigen::VectorXd::Zero(rows[i]);
+        if(random_b)
+            b.setRandom();
+        tasks.push_back(std::make_shared<OpenSoT::tasks::GenericTask>("task" + std::to_string(i), A, b));
+    }
+    return tasks;
+}
+
+/**
+ * @brief bounds creates the box -u <= x <= u on the n variables
+ */
+inline OpenSoT::constraints::GenericConstraint::Ptr bounds(const int n, const double u)
+{
+    Eigen::VectorXd ub = Eigen::VectorXd::Constant(n, u);
+    return std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", ub, -ub, n);
+}
+
+/**
+ * @brief constraint creates the random constraint -c <= Cx <= c with C of rows x n
+ */
+inline OpenSoT::constraints::GenericConstraint::Ptr constraint(const std::string& name, const int rows, const int n,
+                                                               const double c)
+{
+    Eigen::MatrixXd C = Eigen::MatrixXd::Random(rows, n);
+    return std::make_shared<OpenSoT::constraints::GenericConstraint>(name,
+                OpenSoT::AffineHelper(C, Eigen::VectorXd::Zero(rows)),
+                Eigen::VectorXd::Constant(rows, c), Eigen::VectorXd::Constant(rows, -c),
+                OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT);
+}
+
+}
+
+#endif
@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/BackEndFactory.h>
+
+namespace{
+
+class testBackEndFactory: public ::testing::Test
+{
+protected:
+
+    testBackEndFactory():
+        H(n, n), g(n), A(m, n), lA(m), uA(m), l(n), u(n)
+    {
+        std::srand(42);
+
+        Eigen::MatrixXd J = Eigen::MatrixXd::Random(n, n);
+        H = J.transpose()*J + Eigen::MatrixXd::Identity(n, n);
+        g.setRandom();
+
+        A.setRandom();
+        lA.setConstant(-0.1);
+        uA.setConstant(0.1);
+
+        l.setConstant(-1.);
+        u.setConstant(1.);
+    }
+
+    virtual ~testBackEndFactory() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+    static constexpr int n = 6;
+    static constexpr int m = 3;
+
+    Eigen::MatrixXd H;
+    Eigen::VectorXd g;
+    OpenSoT::solvers::BackEnd::RowMajorMatrixXd A;
+    Eigen::VectorXd lA, uA, l, u;
+};
+
+TEST_F(testBackEndFactory, testCapabilities)
+{
+    using namespace OpenSoT::solvers;
+
+    EXPECT_FALSE(isBackEndAvailable(solver_back_ends::Auto));
+    EXPECT_THROW(getBackEndCapabilities(solver_back_ends::Auto), std::runtime_error);
+
+    if(isBackEndAvailable(solver_back_ends::eiQuadProg))
+    {
+        BackEndCapabilities capabilities = getBackEndCapabilities(solver_back_ends::eiQuadProg);
+        EXPECT_TRUE(capabilities.qp);
+        EXPECT_FALSE(capabilities.lp);
+        EXPECT_TRUE(capabilities.positive_definite_hessian);
+    }
+
+    if(isBackEndAvailable(solver_back_ends::GLPK))
+    {
+        BackEndCapabilities capabilities = getBackEndCapabilities(solver_back_ends::GLPK);
+        EXPECT_TRUE(capabilities.lp);
+        EXPECT_TRUE(capabilities.milp);
+    }
+}
+
+/**
+ * @brief firstAvailable
+ * @return the first available back-end of the list, solver_back_ends::Auto if none is available
+ */
+OpenSoT::solvers::solver_back_ends firstAvailable(const std::vector<OpenSoT::solvers::solver_back_ends>& back_ends)
+{
+    for(const auto& be : back_ends)
+    {
+        if(OpenSoT::solvers::isBackEndAvailable(be))
+            return be;
+    }
+    return OpenSoT::solvers::solver_back_ends::Auto;
+}
+
+TEST_F(testBackEndFactory, testSelectBackEnd)
+{
+    using namespace OpenSoT::solvers;
+
+    // LPs are solved by back-ends supporting LPs
+    solver_back_ends be = selectBackEnd(n, m, OpenSoT::HessianType::HST_ZERO, 0.);
+    EXPECT_EQ(be, firstAvailable({solver_back_ends::GLPK, solver_back_ends::OSQP, solver_back_ends::qpOASES}));
+    EXPECT_TRUE(getBackEndCapabilities(be).lp);
+
+    // small semi-definite QPs are not solved by back-ends needing a positive definite H, also with an eps
+    const solver_back_ends semi_definite = firstAvailable({solver_back_ends::qpOASES, solver_back_ends::proxQP,
+                                                           solver_back_ends::OSQP, solver_back_ends::proxQPSparse,
+                                                           solver_back_ends::qpSWIFT});
+    be = selectBackEnd(n, m, OpenSoT::HessianType::HST_SEMIDEF, 0.);
+    EXPECT_EQ(be, semi_definite);
+    EXPECT_FALSE(getBackEndCapabilities(be).positive_definite_hessian);
+    EXPECT_EQ(selectBackEnd(n, m, OpenSoT::HessianType::HST_SEMIDEF, 1e6), semi_definite);
+
+    // small positive definite QPs
+    be = selectBackEnd(n, m, OpenSoT::HessianType::HST_POSDEF, 0.);
+    EXPECT_EQ(be, firstAvailable({solver_back_ends::eiQuadProg, solver_back_ends::qpOASES, solver_back_ends::proxQP,
+                                  solver_back_ends::OSQP, solver_back_ends::proxQPSparse, solver_back_ends::qpSWIFT}));
+
+    // large sparse QPs are not solved by back-ends with a small recommended size, if any other is available
+    be = selectBackEnd(1000, 1000, OpenSoT::HessianType::HST_SEMIDEF, 1., 0.01);
+    EXPECT_EQ(be, firstAvailable({solver_back_ends::OSQP, solver_back_ends::proxQPSparse, solver_back_ends::qpSWIFT,
+                                  solver_back_ends::qpOASES, solver_back_ends::proxQP}));
+
+    // large dense QPs
+    be = selectBackEnd(1000, 1000, OpenSoT::HessianType::HST_POSDEF, 0., 1.);
+    EXPECT_EQ(be, firstAvailable({solver_back_ends::OSQP, solver_back_ends::proxQPSparse, solver_back_ends::qpSWIFT,
+                                  solver_back_ends::eiQuadProg, solver_back_ends::qpOASES, solver_back_ends::proxQP}));
+
+    Eigen::MatrixXd Hs = Eigen::MatrixXd::Identity(n, n);
+    OpenSoT::solvers::BackEnd::RowMajorMatrixXd As(m, n);
+    As.setZero();
+    As.col(0).setOnes();
+    EXPECT_DOUBLE_EQ(estimateDensity(Hs, As), double(n + m)/double(n*n + m*n));
+}
+
+TEST_F(testBackEndFactory, testAutoBackEnd)
+{
+    using namespace OpenSoT::solvers;
+
+    BackEnd::Ptr reference = BackEndFactory(selectBackEnd(n, m, OpenSoT::HessianType::HST_POSDEF, 0.),
+                                            n, m, OpenSoT::HessianType::HST_POSDEF, 0.);
+    BackEnd::Ptr automatic = BackEndFactory(solver_back_ends::Auto, n, m, OpenSoT::HessianType::HST_POSDEF, 0.);
+
+    ASSERT_TRUE(reference->initProblem(H, g, A, lA, uA, l, u));
+    ASSERT_TRUE(automatic->initProblem(H, g, A, lA, uA, l, u));
+
+    EXPECT_TRUE(reference->getSolution().isApprox(automatic->getSolution(), 1e-6));
+    EXPECT_TRUE(((A*automatic->getSolution()).array() <= uA.array() + 1e-6).all());
+    EXPECT_TRUE(((A*automatic->getSolution()).array() >= lA.array() - 1e-6).all());
+
+    EXPECT_EQ(whichBackEnd(solver_back_ends::Auto), "Auto");
+}
+
+TEST_F(testBackEndFactory, testAutoBackEndThresholds)
+{
+    using namespace OpenSoT::solvers;
+
+    AutoBackEndThresholds thresholds = getAutoBackEndThresholds();
+    EXPECT_EQ(thresholds.small_size, AutoBackEndThresholds::DEFAULT_SMALL_SIZE);
+    EXPECT_DOUBLE_EQ(thresholds.sparse_density, AutoBackEndThresholds::DEFAULT_SPARSE_DENSITY);
+
+    const solver_back_ends dense = firstAvailable({solver_back_ends::eiQuadProg, solver_back_ends::qpOASES,
+                                                   solver_back_ends::proxQP, solver_back_ends::OSQP,
+                                                   solver_back_ends::proxQPSparse, solver_back_ends::qpSWIFT});
+    const solver_back_ends sparse = firstAvailable({solver_back_ends::OSQP, solver_back_ends::proxQPSparse,
+                                                    solver_back_ends::qpOASES, solver_back_ends::proxQP,
+                                                    solver_back_ends::eiQuadProg, solver_back_ends::qpSWIFT});
+
+    // small problems are dense, whatever their density
+    EXPECT_EQ(selectBackEnd(n, m, OpenSoT::HessianType::HST_POSDEF, 0., 0.01), dense);
+
+    thresholds.small_size = 0;
+    ASSERT_TRUE(setAutoBackEndThresholds(thresholds));
+    EXPECT_EQ(selectBackEnd(n, m, OpenSoT::HessianType::HST_POSDEF, 0., 0.01), sparse);
+    EXPECT_EQ(selectBackEnd(n, m, OpenSoT::HessianType::HST_POSDEF, 0., 1.), dense);
+
+    // the density is forwarded by the factory
+    BackEnd::Ptr automatic = BackEndFactory(solver_back_ends::Auto, n, m, OpenSoT::HessianType::HST_POSDEF, 0., 0.01);
+    BackEnd::Ptr reference = BackEndFactory(sparse, n, m, OpenSoT::HessianType::HST_POSDEF, 0.);
+    ASSERT_TRUE(reference->initProblem(H, g, A, lA, uA, l, u));
+    ASSERT_TRUE(automatic->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_EQ(automatic->getSolution(), reference->getSolution());
+
+    thresholds.sparse_density = 1.5;
+    EXPECT_FALSE(setAutoBackEndThresholds(thresholds));
+    EXPECT_EQ(getAutoBackEndThresholds().small_size, 0);
+
+    ASSERT_TRUE(setAutoBackEndThresholds(AutoBackEndThresholds()));
+    EXPECT_EQ(selectBackEnd(n, m, OpenSoT::HessianType::HST_POSDEF, 0., 0.01), dense);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
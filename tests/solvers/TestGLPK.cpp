@@ -590,6 +590,45 @@ TEST_F(testGLPKProblem, testMILPProblem)
 
 }
 
+TEST_F(testGLPKProblem, testIncrementalUpdate)
+{
+    // min c'x s.t. lA <= Ax <= uA, l <= x <= u with a sparse A
+    Eigen::VectorXd c(4);
+    c<<-1., -2., 1., -1.;
+
+    OpenSoT::solvers::BackEnd::RowMajorMatrixXd A(3,4);
+    A<<1., 1., 0., 0.,
+       0., 1., 1., 0.,
+       0., 0., 1., 1.;
+    Eigen::VectorXd lA(3), uA(3);
+    lA<<-1e30, -1e30, -1e30;
+    uA<<2., 3., 4.;
+
+    Eigen::VectorXd l = Eigen::VectorXd::Zero(4);
+    Eigen::VectorXd u = Eigen::VectorXd::Constant(4, 10.);
+
+    OpenSoT::solvers::BackEnd::Ptr solver = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::GLPK, 4, 3, OpenSoT::HessianType::HST_ZERO, 0.0);
+    ASSERT_TRUE(solver->initProblem(Eigen::MatrixXd(0,0), c, A, lA, uA, l, u));
+
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        // the second row changes at each tick, the others are not loaded again
+        A(1,0) = 0.1*k;
+        uA[2] = 4. + k;
+
+        ASSERT_TRUE(solver->updateConstraints(A, lA, uA));
+        ASSERT_TRUE(solver->solve());
+
+        OpenSoT::solvers::BackEnd::Ptr reference = OpenSoT::solvers::BackEndFactory(
+                    OpenSoT::solvers::solver_back_ends::GLPK, 4, 3, OpenSoT::HessianType::HST_ZERO, 0.0);
+        ASSERT_TRUE(reference->initProblem(Eigen::MatrixXd(0,0), c, A, lA, uA, l, u));
+
+        EXPECT_NEAR(c.dot(solver->getSolution()), c.dot(reference->getSolution()), 1e-9) << "at tick " << k;
+        EXPECT_TRUE(((A*solver->getSolution()).array() <= uA.array() + 1e-9).all()) << "at tick " << k;
+    }
+}
+
 }
 
 int main(int argc, char **argv) {
@@ -132,6 +132,144 @@ TEST_F(testOSQPProblem, testSimpleProblem)
 }
 
 
+TEST_F(testOSQPProblem, testSparsityPattern)
+{
+    const int n = 6;
+    const int m = 3;
+
+    Eigen::MatrixXd H(n,n);
+    H.setZero();
+    for(unsigned int i = 0; i < n; ++i)
+    {
+        H(i,i) = 2.0;
+        if(i > 0)
+            H(i,i-1) = H(i-1,i) = -0.5;
+    }
+    Eigen::VectorXd g = Eigen::VectorXd::Random(n);
+
+    Eigen::MatrixXd A(m,n);
+    A.setZero();
+    A(0,0) = 1.0; A(0,1) = 1.0;
+    A(1,2) = 1.0; A(1,4) = -1.0;
+    A(2,5) = 1.0;
+    Eigen::VectorXd lA = -0.2*Eigen::VectorXd::Ones(m);
+    Eigen::VectorXd uA = 0.2*Eigen::VectorXd::Ones(m);
+    Eigen::VectorXd l = -Eigen::VectorXd::Ones(n);
+    Eigen::VectorXd u = Eigen::VectorXd::Ones(n);
+
+    OpenSoT::solvers::BackEnd::Ptr dense = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::OSQP, n, m, OpenSoT::HST_POSDEF, 0.);
+    OpenSoT::solvers::BackEnd::Ptr sparse = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::OSQP, n, m, OpenSoT::HST_POSDEF, 0.);
+
+    //structural pattern: tridiagonal H plus the coupling of the first and last variables, the nonzero of the
+    //third constraint on the first variable is declared as well even if it appears only later
+    OpenSoT::solvers::OSQPBackEnd::OSQPBackEndOptions opt;
+    opt.H_pattern = H.array() != 0.;
+    opt.H_pattern(0,5) = opt.H_pattern(5,0) = true;
+    opt.A_pattern = A.array() != 0.;
+    opt.A_pattern(2,0) = true;
+    sparse->setOptions(opt);
+
+    EXPECT_TRUE(dense->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_TRUE(sparse->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_NEAR((dense->getSolution() - sparse->getSolution()).norm(), 0.0, 1e-4);
+
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        //only the values of the structural nonzeros change
+        H.diagonal().setConstant(2.0 + 0.1*std::sin(0.1*k));
+        g = Eigen::VectorXd::Random(n);
+        A(1,4) = -1.0 + 0.5*std::cos(0.1*k);
+
+        //a new nonzero of the pattern appears in H and A
+        if(k == 10)
+        {
+            H(0,5) = H(5,0) = 0.3;
+            A(2,0) = 0.5;
+        }
+
+        EXPECT_TRUE(dense->updateTask(H, g));
+        EXPECT_TRUE(dense->updateConstraints(A, lA, uA));
+        EXPECT_TRUE(sparse->updateTask(H, g));
+        EXPECT_TRUE(sparse->updateConstraints(A, lA, uA));
+
+        EXPECT_TRUE(dense->solve());
+        EXPECT_TRUE(sparse->solve());
+        EXPECT_NEAR((dense->getSolution() - sparse->getSolution()).norm(), 0.0, 1e-4) << "at tick " << k;
+    }
+
+    //back to the dense structures
+    sparse->setOptions(OpenSoT::solvers::OSQPBackEnd::OSQPBackEndOptions());
+    EXPECT_TRUE(sparse->solve());
+    EXPECT_NEAR((dense->getSolution() - sparse->getSolution()).norm(), 0.0, 1e-4);
+}
+
+TEST_F(testOSQPProblem, testSparsityPatternFillIn)
+{
+    const int n = 6;
+    const int m = 3;
+
+    Eigen::MatrixXd H = 2.0*Eigen::MatrixXd::Identity(n,n);
+    Eigen::VectorXd g = Eigen::VectorXd::Random(n);
+
+    Eigen::MatrixXd A(m,n);
+    A.setZero();
+    A(0,0) = 1.0; A(0,1) = 1.0;
+    A(1,2) = 1.0; A(1,4) = -1.0;
+    A(2,5) = 1.0;
+    Eigen::VectorXd lA = -0.2*Eigen::VectorXd::Ones(m);
+    Eigen::VectorXd uA = 0.2*Eigen::VectorXd::Ones(m);
+    Eigen::VectorXd l = -Eigen::VectorXd::Ones(n);
+    Eigen::VectorXd u = Eigen::VectorXd::Ones(n);
+
+    OpenSoT::solvers::BackEnd::Ptr dense = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::OSQP, n, m, OpenSoT::HST_POSDEF, 0.);
+    OpenSoT::solvers::BackEnd::Ptr declared = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::OSQP, n, m, OpenSoT::HST_POSDEF, 0.);
+    OpenSoT::solvers::BackEnd::Ptr detected = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::OSQP, n, m, OpenSoT::HST_POSDEF, 0.);
+
+    //the declared patterns miss the entries which appear later
+    OpenSoT::solvers::OSQPBackEnd::OSQPBackEndOptions opt;
+    opt.H_pattern = H.array() != 0.;
+    opt.A_pattern = A.array() != 0.;
+    declared->setOptions(opt);
+
+    //the patterns do not depend on the size of the problem
+    OpenSoT::solvers::OSQPBackEnd::OSQPBackEndOptions detect;
+    detect.detect_patterns = true;
+    detected->setOptions(detect);
+
+    EXPECT_TRUE(dense->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_TRUE(declared->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_TRUE(detected->initProblem(H, g, A, lA, uA, l, u));
+
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        g = Eigen::VectorXd::Random(n);
+
+        //fill-in outside of the patterns, in H and A
+        if(k == 5)
+            H(1,3) = H(3,1) = 0.5;
+        if(k == 10)
+            A(2,0) = 0.5;
+        if(k == 15)
+            A(0,3) = -0.5;
+
+        for(auto& be : {dense, declared, detected})
+        {
+            EXPECT_TRUE(be->updateTask(H, g));
+            EXPECT_TRUE(be->updateConstraints(A, lA, uA));
+            EXPECT_TRUE(be->solve());
+        }
+        EXPECT_NEAR((dense->getSolution() - declared->getSolution()).norm(), 0.0, 1e-4) << "at tick " << k;
+        EXPECT_NEAR((dense->getSolution() - detected->getSolution()).norm(), 0.0, 1e-4) << "at tick " << k;
+        EXPECT_TRUE(((A*detected->getSolution()).array() <= uA.array() + 1e-3).all()) << "at tick " << k;
+    }
+}
+
+
 TEST_F(testOSQPProblem, testTask)
 {
     Eigen::VectorXd q_ref = _model_ptr->getNeutralQ();
@@ -271,6 +271,102 @@ TEST_F(testQPOasesProblem, test_update_constraint)
 //    EXPECT_NEAR(solution[2], 2.5714,1E-4);
 }
 
+TEST_F(testQPOasesProblem, test_constraints_capacity)
+{
+    Eigen::MatrixXd H(3,3);
+    H.setIdentity();
+    Eigen::VectorXd g(3);
+    g<<-10,
+       -10,
+       -10;
+    Eigen::VectorXd l = -10.*Eigen::VectorXd::Ones(3);
+    Eigen::VectorXd u = 10.*Eigen::VectorXd::Ones(3);
+
+    Eigen::MatrixXd constraints(4,3);
+    constraints<<1,0,1,
+                 0,1,0,
+                 1,1,1,
+                 1,-1,0;
+    Eigen::VectorXd bounds(4);
+    bounds<<5,
+            2,
+            9,
+            1;
+
+    OpenSoT::solvers::BackEnd::Ptr qp = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, 3, 1, OpenSoT::HST_POSDEF, 0.);
+    OpenSoT::solvers::QPOasesBackEnd::QPOasesBackEndOptions opt;
+    opt.constraints_capacity = 3;
+    qp->setOptions(opt);
+
+    Eigen::MatrixXd A = constraints.topRows(1);
+    Eigen::VectorXd lA = -bounds.head(1);
+    Eigen::VectorXd uA = bounds.head(1);
+    EXPECT_TRUE(qp->initProblem(H,g,A,lA,uA,l,u));
+
+    //the number of constraints changes within and outside the capacity
+    std::vector<int> rows = {1, 3, 2, 0, 2, 4, 1};
+    for(int r : rows)
+    {
+        A = constraints.topRows(r);
+        lA = -bounds.head(r);
+        uA = bounds.head(r);
+
+        EXPECT_TRUE(qp->updateTask(H, g));
+        EXPECT_TRUE(qp->updateConstraints(A, lA, uA));
+        EXPECT_TRUE(qp->solve());
+
+        OpenSoT::solvers::BackEnd::Ptr reference = OpenSoT::solvers::BackEndFactory(
+                    OpenSoT::solvers::solver_back_ends::qpOASES, 3, r, OpenSoT::HST_POSDEF, 0.);
+        EXPECT_TRUE(reference->initProblem(H,g,A,lA,uA,l,u));
+
+        std::cout<<"constraints: "<<r<<" solution is: ["<<qp->getSolution().transpose()<<"]"<<std::endl;
+        EXPECT_NEAR((qp->getSolution() - reference->getSolution()).norm(), 0., 1e-6);
+        EXPECT_EQ(qp->getA().rows(), r);
+        EXPECT_TRUE(qp->getA() == A);
+
+        //the dual solution contains the multipliers of the bounds and of the actual constraints only
+        Eigen::VectorXd dual = std::static_pointer_cast<OpenSoT::solvers::QPOasesBackEnd>(qp)->getDualSolution();
+        Eigen::VectorXd dual_reference = std::static_pointer_cast<OpenSoT::solvers::QPOasesBackEnd>(reference)->getDualSolution();
+        EXPECT_EQ(dual.size(), 3 + r);
+        EXPECT_NEAR((dual - dual_reference).norm(), 0., 1e-6);
+    }
+}
+
+TEST_F(testQPOasesProblem, test_constraints_capacity_regularisation)
+{
+    Eigen::MatrixXd H(3,3);
+    H.setIdentity();
+    Eigen::VectorXd g(3);
+    g<<-10,
+       -10,
+       -10;
+    Eigen::VectorXd l = -10.*Eigen::VectorXd::Ones(3);
+    Eigen::VectorXd u = 10.*Eigen::VectorXd::Ones(3);
+
+    Eigen::MatrixXd A(1,3);
+    A<<1,0,1;
+    Eigen::VectorXd lA = -5.*Eigen::VectorXd::Ones(1);
+    Eigen::VectorXd uA = 5.*Eigen::VectorXd::Ones(1);
+
+    OpenSoT::solvers::BackEnd::Ptr qp = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, 3, 1, OpenSoT::HST_POSDEF, 1e9);
+    OpenSoT::solvers::BackEnd::Ptr reference = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, 3, 1, OpenSoT::HST_POSDEF, 1e9);
+    EXPECT_TRUE(qp->initProblem(H,g,A,lA,uA,l,u));
+    EXPECT_TRUE(reference->initProblem(H,g,A,lA,uA,l,u));
+
+    //changing the capacity initializes the problem again, the eps regularisation is added only once
+    OpenSoT::solvers::QPOasesBackEnd::QPOasesBackEndOptions opt;
+    opt.constraints_capacity = 3;
+    qp->setOptions(opt);
+    EXPECT_TRUE(qp->getH() == H);
+
+    EXPECT_TRUE(qp->solve());
+    EXPECT_TRUE(reference->solve());
+    EXPECT_NEAR((qp->getSolution() - reference->getSolution()).norm(), 0., 1e-9);
+}
+
 TEST_F(testQPOasesProblem, test_update_task)
 {
     //OpenSoT::solvers::QPOasesBackEnd qp(3,0);
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/solvers/eHQP.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <OpenSoT/tasks/velocity/Cartesian.h>
+#include <OpenSoT/tasks/velocity/Postural.h>
+#include <OpenSoT/constraints/velocity/JointLimits.h>
+#include <OpenSoT/constraints/velocity/VelocityLimits.h>
+#include <OpenSoT/utils/AutoStack.h>
+#include "../common.h"
+#include "../MallocHook.h"
+#include "../RandomStack.h"
+
+namespace{
+
+Eigen::VectorXd getGoodInitialPosition(XBot::ModelInterface::Ptr _model_ptr) {
+    Eigen::VectorXd _q = _model_ptr->getNeutralQ();
+    _q[_model_ptr->getDofIndex("RHipSag") + 1] = -25.0*M_PI/180.0;
+    _q[_model_ptr->getDofIndex("RKneeSag") + 1] = 50.0*M_PI/180.0;
+    _q[_model_ptr->getDofIndex("RAnkSag") + 1] = -25.0*M_PI/180.0;
+
+    _q[_model_ptr->getDofIndex("LHipSag") + 1] = -25.0*M_PI/180.0;
+    _q[_model_ptr->getDofIndex("LKneeSag") + 1] = 50.0*M_PI/180.0;
+    _q[_model_ptr->getDofIndex("LAnkSag") + 1] = -25.0*M_PI/180.0;
+
+    _q[_model_ptr->getDofIndex("LShSag") + 1] =  20.0*M_PI/180.0;
+    _q[_model_ptr->getDofIndex("LShLat") + 1] = 10.0*M_PI/180.0;
+    _q[_model_ptr->getDofIndex("LElbj") + 1] = -80.0*M_PI/180.0;
+
+    _q[_model_ptr->getDofIndex("RShSag") + 1] =  20.0*M_PI/180.0;
+    _q[_model_ptr->getDofIndex("RShLat") + 1] = -10.0*M_PI/180.0;
+    _q[_model_ptr->getDofIndex("RElbj") + 1] = -80.0*M_PI/180.0;
+
+    return _q;
+}
+
+/**
+ * The real-time tests check that, once a solver has been initialized and has solved the problem once,
+ * the following calls to solve() (with problems of the same size) do not allocate nor free memory.
+ */
+class testRealTime: public TestBase
+{
+protected:
+
+    testRealTime():TestBase("coman_floating_base")
+    {
+
+    }
+
+    virtual ~testRealTime() {
+
+    }
+
+    virtual void SetUp() {
+        if(!MallocHook::isAvailable())
+            GTEST_SKIP() << "malloc hook not available on this platform";
+    }
+
+    virtual void TearDown() {
+
+    }
+
+};
+
+TEST_F(testRealTime, checkMallocHook)
+{
+    MallocHook::start();
+    Eigen::VectorXd v = Eigen::VectorXd::Random(100);
+    MallocHook::stop();
+
+    EXPECT_EQ(v.size(), 100);
+    EXPECT_EQ(MallocHook::getAllocations(), 1);
+    EXPECT_EQ(MallocHook::getDeallocations(), 0);
+}
+
+TEST_F(testRealTime, checkGenericStack)
+{
+    const int n = 14;
+    std::srand(42);
+
+    const int rows[3] = {3, 5, n};
+    auto tasks = random_stack::tasks({rows[0], rows[1], rows[2]}, n);
+
+    auto bounds = random_stack::bounds(n, 0.6);
+    auto constraint = random_stack::constraint("constraint", 2, n, 0.3);
+
+    OpenSoT::AutoStack::Ptr stack = (tasks[0] / tasks[1] / tasks[2]) << constraint << bounds;
+    stack->update();
+
+    OpenSoT::solvers::iHQP solver(*stack, 1e-9, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    ASSERT_TRUE(solver.setRealTimeMode(true));
+
+    Eigen::VectorXd x;
+    ASSERT_TRUE(solver.solve(x));
+
+    std::vector<Eigen::VectorXd> b;
+    for(unsigned int i = 0; i < 2; ++i)
+        b.push_back(Eigen::VectorXd(rows[i]));
+
+    for(unsigned int k = 0; k < 100; ++k)
+    {
+        for(unsigned int i = 0; i < 2; ++i)
+            b[i].setConstant(std::cos(0.1*k + i));
+
+        MallocHook::start();
+        for(unsigned int i = 0; i < 2; ++i)
+            tasks[i]->setb(b[i]);
+        stack->update();
+        bool success = solver.solve(x);
+        MallocHook::stop();
+
+        ASSERT_TRUE(success);
+        EXPECT_EQ(MallocHook::getAllocations(), 0) << "at tick " << k;
+        EXPECT_EQ(MallocHook::getDeallocations(), 0) << "at tick " << k;
+    }
+}
+
+TEST_F(testRealTime, checkRealTimeMode)
+{
+    const int n = 6;
+    std::srand(42);
+
+    auto tasks = random_stack::tasks({3, n}, n);
+    OpenSoT::AutoStack::Ptr stack = (tasks[0] / tasks[1]) << random_stack::bounds(n, 0.6);
+    stack->update();
+
+    // the guarantee holds only with eiQuadProg
+    OpenSoT::solvers::iHQP solver_qpoases(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::qpOASES);
+    EXPECT_FALSE(solver_qpoases.setRealTimeMode(true));
+    EXPECT_FALSE(solver_qpoases.isRealTimeMode());
+
+    OpenSoT::solvers::iHQP solver(*stack, 1e-9, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    EXPECT_FALSE(solver.isRealTimeMode());
+    EXPECT_TRUE(solver.setRealTimeMode(true));
+    EXPECT_TRUE(solver.isRealTimeMode());
+
+    // the parallel solve is refused in real-time mode, and viceversa
+    solver.setThreadPool(std::make_shared<OpenSoT::utils::ThreadPool>(2));
+    EXPECT_FALSE(solver.getThreadPool());
+
+    EXPECT_TRUE(solver.setRealTimeMode(false));
+    solver.setThreadPool(std::make_shared<OpenSoT::utils::ThreadPool>(2));
+    EXPECT_TRUE(solver.getThreadPool());
+    EXPECT_FALSE(solver.setRealTimeMode(true));
+}
+
+TEST_F(testRealTime, checkeHQP)
+{
+    const int n = 14;
+    std::srand(42);
+
+    const int rows[3] = {3, 5, n};
+    auto tasks = random_stack::tasks({rows[0], rows[1], rows[2]}, n);
+
+    // diagonal and full weights
+    tasks[0]->setWeight(Eigen::Vector3d(1., 2., 3.).asDiagonal().toDenseMatrix());
+    Eigen::MatrixXd M = Eigen::MatrixXd::Random(rows[1], rows[1]);
+    tasks[1]->setWeight(M*M.transpose() + Eigen::MatrixXd::Identity(rows[1], rows[1]));
+
+    OpenSoT::AutoStack::Ptr stack = tasks[0] / tasks[1] / tasks[2];
+    stack->update();
+
+    for(auto method : {OpenSoT::solvers::eHQP::DecompositionMethod::SVD, OpenSoT::solvers::eHQP::DecompositionMethod::COD})
+    {
+        OpenSoT::solvers::eHQP solver(stack->getStack());
+        solver.setDecompositionMethod(method);
+
+        Eigen::VectorXd x;
+        ASSERT_TRUE(solver.solve(x));
+
+        std::vector<Eigen::VectorXd> b;
+        for(unsigned int i = 0; i < 2; ++i)
+            b.push_back(Eigen::VectorXd(rows[i]));
+
+        for(unsigned int k = 0; k < 100; ++k)
+        {
+            for(unsigned int i = 0; i < 2; ++i)
+                b[i].setConstant(std::cos(0.1*k + i));
+
+            MallocHook::start();
+            for(unsigned int i = 0; i < 2; ++i)
+                tasks[i]->setb(b[i]);
+            stack->update();
+            bool success = solver.solve(x);
+            MallocHook::stop();
+
+            ASSERT_TRUE(success);
+            EXPECT_EQ(MallocHook::getAllocations(), 0) << "at tick " << k;
+            EXPECT_EQ(MallocHook::getDeallocations(), 0) << "at tick " << k;
+        }
+    }
+}
+
+TEST_F(testRealTime, checkIKStack)
+{
+    Eigen::VectorXd q = getGoodInitialPosition(_model_ptr);
+    _model_ptr->setJointPosition(q);
+    _model_ptr->update();
+
+    auto cartesian = std::make_shared<OpenSoT::tasks::velocity::Cartesian>("cartesian::left_wrist", *_model_ptr,
+                                                                           "l_wrist", "Waist");
+    Eigen::Affine3d T_ref;
+    cartesian->getReference(T_ref);
+    T_ref.translation()[0] += 0.05;
+    cartesian->setReference(T_ref);
+
+    auto postural = std::make_shared<OpenSoT::tasks::velocity::Postural>(*_model_ptr);
+
+    Eigen::VectorXd q_min, q_max, dq_max;
+    _model_ptr->getJointLimits(q_min, q_max);
+    _model_ptr->getVelocityLimits(dq_max);
+    auto joint_limits = std::make_shared<OpenSoT::constraints::velocity::JointLimits>(*_model_ptr, q_max, q_min);
+    auto velocity_limits = std::make_shared<OpenSoT::constraints::velocity::VelocityLimits>(*_model_ptr, dq_max, 0.01);
+
+    OpenSoT::AutoStack::Ptr stack = (cartesian / postural) << joint_limits << velocity_limits;
+    stack->update();
+
+    OpenSoT::solvers::iHQP solver(*stack, 1e-6, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    ASSERT_TRUE(solver.setRealTimeMode(true));
+
+    Eigen::VectorXd dq;
+    ASSERT_TRUE(solver.solve(dq));
+
+    for(unsigned int k = 0; k < 100; ++k)
+    {
+        q = _model_ptr->sum(q, dq);
+        _model_ptr->setJointPosition(q);
+        _model_ptr->update();
+        stack->update();
+
+        MallocHook::start();
+        bool success = solver.solve(dq);
+        MallocHook::stop();
+
+        ASSERT_TRUE(success);
+        EXPECT_EQ(MallocHook::getAllocations(), 0) << "at tick " << k;
+        EXPECT_EQ(MallocHook::getDeallocations(), 0) << "at tick " << k;
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -189,6 +189,186 @@ TEST_F(testSOTH, constrainedVariableLinearSystemOpenSoT)
 }
 
 
+TEST_F(testSOTH, weightedTasks)
+{
+    std::srand(42);
+    const int n = 6;
+
+    // the first level is overdetermined and rank deficient, so that both weights matter
+    Eigen::MatrixXd A0 = Eigen::MatrixXd::Random(8, 4)*Eigen::MatrixXd::Random(4, n);
+    Eigen::MatrixXd A1 = Eigen::MatrixXd::Random(4, n);
+
+    auto task0 = std::make_shared<OpenSoT::tasks::GenericTask>("0", A0, Eigen::VectorXd::Random(8));
+    auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("1", A1, Eigen::VectorXd::Random(4));
+
+    Eigen::MatrixXd M = Eigen::MatrixXd::Random(8, 8);
+    Eigen::MatrixXd W0 = M*M.transpose() + Eigen::MatrixXd::Identity(8, 8);
+    Eigen::MatrixXd W1 = Eigen::Vector4d(1., 4., 9., 16.).asDiagonal().toDenseMatrix();
+    task0->setWeight(W0);
+    task1->setWeight(W1);
+    task1->setWeightIsDiagonalFlag(true);
+
+    OpenSoT::AutoStack::Ptr stack = task0/task1;
+    stack->update();
+    OpenSoT::solvers::HCOD hcod(*stack, 0.);
+
+    // reference: tasks premultiplied by the square root of the weights
+    auto task0_ref = std::make_shared<OpenSoT::tasks::GenericTask>("0_ref", A0, Eigen::VectorXd::Zero(8));
+    auto task1_ref = std::make_shared<OpenSoT::tasks::GenericTask>("1_ref", A1, Eigen::VectorXd::Zero(4));
+    OpenSoT::AutoStack::Ptr stack_ref = task0_ref/task1_ref;
+    stack_ref->update();
+    OpenSoT::solvers::HCOD hcod_ref(*stack_ref, 0.);
+    hcod_ref.setDisableWeightsComputation(true);
+
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        // the weight of the first task changes once
+        if(k == 10)
+        {
+            M = Eigen::MatrixXd::Random(8, 8);
+            W0 = M*M.transpose() + Eigen::MatrixXd::Identity(8, 8);
+            task0->setWeight(W0);
+        }
+
+        task0->setb(Eigen::VectorXd::Constant(8, std::cos(0.1*k)));
+        task1->setb(Eigen::VectorXd::Constant(4, std::sin(0.1*k)));
+        stack->update();
+
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> sqrt0(W0);
+        Eigen::MatrixXd W0sqrt = sqrt0.operatorSqrt();
+        Eigen::MatrixXd W1sqrt = W1.cwiseSqrt();
+        task0_ref->setA(W0sqrt*A0);
+        task0_ref->setb(W0sqrt*task0->getb());
+        task1_ref->setA(W1sqrt*A1);
+        task1_ref->setb(W1sqrt*task1->getb());
+        stack_ref->update();
+
+        Eigen::VectorXd x, x_ref;
+        ASSERT_TRUE(hcod.solve(x));
+        ASSERT_TRUE(hcod_ref.solve(x_ref));
+
+        EXPECT_NEAR((x - x_ref).norm(), 0., 1e-6) << "at tick " << k;
+    }
+}
+
+
+TEST_F(testSOTH, nativeBounds)
+{
+    std::srand(42);
+    const int n = 12;
+
+    Eigen::MatrixXd A0 = Eigen::MatrixXd::Random(4, n);
+    Eigen::MatrixXd A1 = Eigen::MatrixXd::Identity(n, n);
+    auto task0 = std::make_shared<OpenSoT::tasks::GenericTask>("0", A0, Eigen::VectorXd::Zero(4));
+    auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("1", A1, Eigen::VectorXd::Zero(n));
+
+    // variable bounds (handled natively) and the same bounds written as a general constraint
+    Eigen::VectorXd u = Eigen::VectorXd::Constant(n, 0.3);
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", u, -u, n);
+    auto bounds_as_constraint = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds_as_constraint",
+                OpenSoT::AffineHelper(Eigen::MatrixXd::Identity(n, n), Eigen::VectorXd::Zero(n)), u, -u,
+                OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT);
+
+    // a general constraint with a fixed (twin) row
+    Eigen::MatrixXd C = Eigen::MatrixXd::Random(2, n);
+    Eigen::Vector2d c_upper(0.05, 0.1), c_lower(-0.05, 0.1);
+    auto constraint = std::make_shared<OpenSoT::constraints::GenericConstraint>("constraint",
+                OpenSoT::AffineHelper(C, Eigen::VectorXd::Zero(2)), c_upper, c_lower,
+                OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT);
+
+    OpenSoT::AutoStack::Ptr stack = (task0/task1) << bounds << constraint;
+    stack->update();
+    OpenSoT::solvers::HCOD hcod(*stack, 0.);
+
+    OpenSoT::AutoStack::Ptr stack_ref = (task0/task1) << bounds_as_constraint << constraint;
+    stack_ref->update();
+    OpenSoT::solvers::HCOD hcod_ref(*stack_ref, 0.);
+
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        task0->setb(Eigen::VectorXd::Constant(4, 2.*std::cos(0.1*k)));
+        task1->setb(Eigen::VectorXd::Constant(n, std::sin(0.1*k)));
+        stack->update();
+        stack_ref->update();
+
+        Eigen::VectorXd x, x_ref;
+        ASSERT_TRUE(hcod.solve(x));
+        ASSERT_TRUE(hcod_ref.solve(x_ref));
+
+        EXPECT_NEAR((x - x_ref).norm(), 0., 1e-6) << "at tick " << k;
+        EXPECT_TRUE((x.array().abs() <= 0.3 + 1e-6).all()) << "at tick " << k;
+        EXPECT_NEAR(C.row(1)*x, 0.1, 1e-6) << "at tick " << k;
+        EXPECT_TRUE((C.row(0)*x).cwiseAbs()(0) <= 0.05 + 1e-6) << "at tick " << k;
+    }
+}
+
+
+TEST_F(testSOTH, warmStart)
+{
+    std::srand(42);
+    const int n = 20;
+
+    Eigen::MatrixXd A0 = Eigen::MatrixXd::Random(6, n);
+    auto task0 = std::make_shared<OpenSoT::tasks::GenericTask>("0", A0, Eigen::VectorXd::Zero(6));
+    auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("1", Eigen::MatrixXd::Identity(n, n), Eigen::VectorXd::Zero(n));
+    Eigen::VectorXd u = Eigen::VectorXd::Constant(n, 0.2);
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", u, -u, n);
+
+    OpenSoT::AutoStack::Ptr stack = (task0/task1) << bounds;
+    stack->update();
+
+    OpenSoT::solvers::HCOD hcod(*stack, 0.);
+    OpenSoT::solvers::HCOD hcod_cold(*stack, 0.);
+    EXPECT_TRUE(hcod.getWarmStart());
+    hcod_cold.setWarmStart(false);
+
+    unsigned int iterations = 0, iterations_cold = 0;
+    Eigen::VectorXd x, x_cold;
+    for(unsigned int k = 0; k < 50; ++k)
+    {
+        task0->setb(Eigen::VectorXd::Constant(6, 3.*std::cos(0.02*k)));
+        task1->setb(Eigen::VectorXd::Constant(n, std::sin(0.02*k)));
+        stack->update();
+
+        ASSERT_TRUE(hcod.solve(x));
+        ASSERT_TRUE(hcod_cold.solve(x_cold));
+        EXPECT_NEAR((x - x_cold).norm(), 0., 1e-6) << "at tick " << k;
+
+        iterations += hcod.getNumberOfIterations();
+        iterations_cold += hcod_cold.getNumberOfIterations();
+    }
+    EXPECT_LT(iterations, iterations_cold);
+
+    // the stack is not updated: the last solution is reused
+    Eigen::VectorXd x_reused;
+    ASSERT_TRUE(hcod.solve(x_reused));
+    EXPECT_EQ(hcod.getNumberOfIterations(), 0);
+    EXPECT_TRUE(x_reused == x);
+
+    // the active set of the constraints stage is transferred to a new solver
+    OpenSoT::solvers::HCOD::ActiveSet active_set;
+    hcod.getActiveSet(active_set);
+    ASSERT_EQ(active_set.size(), 3);
+    EXPECT_GT(active_set[0].size(), 0);
+    for(const auto& cst : active_set[0])
+    {
+        if(cst.type == OpenSoT::solvers::HCOD::ActiveConstraint::Type::UPPER)
+            EXPECT_NEAR(x[cst.row], 0.2, 1e-6);
+        else
+            EXPECT_NEAR(x[cst.row], -0.2, 1e-6);
+    }
+
+    OpenSoT::solvers::HCOD hcod_seeded(*stack, 0.);
+    EXPECT_FALSE(hcod_seeded.setActiveSet(OpenSoT::solvers::HCOD::ActiveSet(2)));
+    ASSERT_TRUE(hcod_seeded.setActiveSet(active_set));
+    Eigen::VectorXd x_seeded;
+    ASSERT_TRUE(hcod_seeded.solve(x_seeded));
+    ASSERT_TRUE(hcod_cold.solve(x_cold));
+    EXPECT_NEAR((x_seeded - x).norm(), 0., 1e-6);
+    EXPECT_LT(hcod_seeded.getNumberOfIterations(), hcod_cold.getNumberOfIterations());
+}
+
+
 }
 
 int main(int argc, char **argv) {
@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/eHQP.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/utils/AutoStack.h>
+#include "../RandomStack.h"
+
+namespace{
+
+class testeHQP: public ::testing::TestWithParam<bool>
+{
+protected:
+
+    testeHQP()
+    {
+        std::srand(42);
+
+        tasks = random_stack::tasks({6, 12, 6, n}, n);
+
+        // diagonal weight for the first task, full weight for the second one
+        Eigen::VectorXd w = Eigen::VectorXd::Random(6).cwiseAbs() + Eigen::VectorXd::Constant(6, 0.5);
+        tasks[0]->setWeight(w.asDiagonal().toDenseMatrix());
+        Eigen::MatrixXd M = Eigen::MatrixXd::Random(12, 12);
+        tasks[1]->setWeight(M*M.transpose() + Eigen::MatrixXd::Identity(12, 12));
+    }
+
+    virtual ~testeHQP() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+    static constexpr int n = 30;
+    std::vector<OpenSoT::tasks::GenericTask::Ptr> tasks;
+};
+
+TEST_P(testeHQP, testDecompositionMethods)
+{
+    const bool rank_deficient = GetParam();
+
+    // the third task shares three rows with the first one
+    if(rank_deficient)
+    {
+        Eigen::MatrixXd A = tasks[2]->getA();
+        A.topRows(3) = tasks[0]->getA().topRows(3);
+        tasks[2]->setA(A);
+    }
+
+    OpenSoT::AutoStack::Ptr stack = tasks[0] / tasks[1] / tasks[2] / tasks[3];
+    stack->update();
+
+    OpenSoT::solvers::eHQP solver_svd(stack->getStack());
+    OpenSoT::solvers::eHQP solver_cod(stack->getStack());
+    EXPECT_TRUE(solver_svd.getDecompositionMethod() == OpenSoT::solvers::eHQP::DecompositionMethod::SVD);
+    solver_cod.setDecompositionMethod(OpenSoT::solvers::eHQP::DecompositionMethod::COD);
+
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        for(unsigned int i = 0; i < 3; ++i)
+            tasks[i]->setb(Eigen::VectorXd::Constant(tasks[i]->getb().size(), std::cos(0.05*k + i)));
+        stack->update();
+
+        Eigen::VectorXd x_svd, x_cod;
+        ASSERT_TRUE(solver_svd.solve(x_svd));
+        ASSERT_TRUE(solver_cod.solve(x_cod));
+
+        EXPECT_NEAR((x_svd - x_cod).norm(), 0., 1e-9) << "at tick " << k;
+
+        // the first two tasks are always feasible
+        for(unsigned int i = 0; i < 2; ++i)
+        {
+            EXPECT_NEAR((tasks[i]->getA()*x_svd - tasks[i]->getb()).norm(), 0., 1e-9) << "at tick " << k;
+            EXPECT_NEAR((tasks[i]->getA()*x_cod - tasks[i]->getb()).norm(), 0., 1e-9) << "at tick " << k;
+        }
+
+        // the third task is feasible only if not in conflict with the first one
+        if(!rank_deficient)
+        {
+            EXPECT_NEAR((tasks[2]->getA()*x_svd - tasks[2]->getb()).norm(), 0., 1e-9) << "at tick " << k;
+            EXPECT_NEAR((tasks[2]->getA()*x_cod - tasks[2]->getb()).norm(), 0., 1e-9) << "at tick " << k;
+        }
+    }
+}
+
+TEST_P(testeHQP, testStrictPriority)
+{
+    const bool rank_deficient = GetParam();
+
+    if(rank_deficient)
+    {
+        Eigen::MatrixXd A = tasks[2]->getA();
+        A.topRows(3) = tasks[0]->getA().topRows(3);
+        tasks[2]->setA(A);
+    }
+
+    OpenSoT::AutoStack::Ptr stack = tasks[0] / tasks[1] / tasks[2] / tasks[3];
+    stack->update();
+
+    for(auto method : {OpenSoT::solvers::eHQP::DecompositionMethod::SVD, OpenSoT::solvers::eHQP::DecompositionMethod::COD})
+    {
+        OpenSoT::solvers::eHQP solver(stack->getStack());
+        solver.setDecompositionMethod(method);
+
+        Eigen::VectorXd x;
+        ASSERT_TRUE(solver.solve(x));
+
+        // each level is optimal in the nullspace of the higher priority levels: the gradient of its cost,
+        // projected in that nullspace, is zero
+        Eigen::MatrixXd A_higher(0, n);
+        for(unsigned int i = 0; i < tasks.size(); ++i)
+        {
+            Eigen::MatrixXd N = Eigen::MatrixXd::Identity(n, n);
+            if(A_higher.rows() > 0)
+            {
+                Eigen::JacobiSVD<Eigen::MatrixXd> svd(A_higher, Eigen::ComputeFullV);
+                N = svd.matrixV().rightCols(n - svd.setThreshold(1e-9).rank());
+            }
+
+            const Eigen::MatrixXd& A = tasks[i]->getA();
+            Eigen::VectorXd gradient = A.transpose()*tasks[i]->getWeight()*(A*x - tasks[i]->getb());
+            EXPECT_NEAR((N.transpose()*gradient).norm(), 0., 1e-6) << "at level " << i;
+
+            A_higher.conservativeResize(A_higher.rows() + A.rows(), n);
+            A_higher.bottomRows(A.rows()) = A;
+        }
+    }
+}
+
+INSTANTIATE_TEST_CASE_P(RankDeficient, testeHQP, ::testing::Values(false, true));
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -133,6 +133,53 @@ TEST_F(testeiQuadProgProblem, testSimpleProblem)
 }
 
 
+TEST_F(testeiQuadProgProblem, testInfiniteBoundsAndFactorization)
+{
+    const int n = 6;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    Eigen::MatrixXd H = Eigen::MatrixXd::Identity(n, n);
+    Eigen::VectorXd g = Eigen::VectorXd::Constant(n, -2.);
+
+    // one two-sided, one upper, one lower and one free constraint
+    OpenSoT::solvers::BackEnd::RowMajorMatrixXd A = Eigen::MatrixXd::Random(4, n);
+    Eigen::VectorXd lA(4), uA(4);
+    lA << -1., -inf, -0.5, -inf;
+    uA <<  1.,  0.5,  inf,  inf;
+
+    // only some variables are bounded
+    Eigen::VectorXd l = Eigen::VectorXd::Constant(n, -inf);
+    Eigen::VectorXd u = Eigen::VectorXd::Constant(n, inf);
+    l.head(3).setConstant(-1.);
+    u.head(2).setConstant(1.);
+
+    // the same problem with large, but finite, bounds
+    auto finite = [](const Eigen::VectorXd& v){ return v.cwiseMax(-1e10).cwiseMin(1e10); };
+
+    OpenSoT::solvers::BackEnd::Ptr eiquadprog = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::eiQuadProg, n, A.rows(), OpenSoT::HessianType::HST_POSDEF, 0.);
+    ASSERT_TRUE(eiquadprog->initProblem(H, g, A, lA, uA, l, u));
+
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        // g and the bounds change at each tick, H at tick 10
+        g = Eigen::VectorXd::Constant(n, -2.*std::cos(0.1*k));
+        uA[0] = 1. + 0.1*std::sin(0.1*k);
+        if(k == 10)
+            H *= 2.;
+
+        ASSERT_TRUE(eiquadprog->updateProblem(H, g, A, lA, uA, l, u));
+        ASSERT_TRUE(eiquadprog->solve());
+
+        OpenSoT::solvers::BackEnd::Ptr reference = OpenSoT::solvers::BackEndFactory(
+                    OpenSoT::solvers::solver_back_ends::eiQuadProg, n, A.rows(), OpenSoT::HessianType::HST_POSDEF, 0.);
+        ASSERT_TRUE(reference->initProblem(H, g, A, finite(lA), finite(uA), finite(l), finite(u)));
+
+        EXPECT_NEAR((eiquadprog->getSolution() - reference->getSolution()).norm(), 0., 1e-9) << "at tick " << k;
+    }
+}
+
+
 TEST_F(testeiQuadProgProblem, testTask)
 {
     Eigen::VectorXd q_ref = _model_ptr->getNeutralQ();
@@ -3,6 +3,7 @@
 #include <OpenSoT/solvers/iHQP.h>
 #include <OpenSoT/tasks/GenericTask.h>
 #include <OpenSoT/utils/AutoStack.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
 
 
 namespace name {
@@ -142,6 +143,268 @@ TEST_F(testClass, testUserRegularisation)
 //    EXPECT_TRUE(ddq == sol);
 }
 
+
+TEST_F(testClass, testUnchangedCost)
+{
+    std::srand(7);
+    const int n = 7;
+
+    auto task0 = std::make_shared<OpenSoT::tasks::GenericTask>("task0", Eigen::MatrixXd::Random(3, n), Eigen::VectorXd::Random(3));
+    auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", Eigen::MatrixXd::Identity(n, n), Eigen::VectorXd::Random(n));
+    Eigen::VectorXd u = Eigen::VectorXd::Constant(n, 0.5);
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", u, -u, n);
+
+    OpenSoT::AutoStack::Ptr stack = (task0/task1) << bounds;
+    stack->update();
+
+    _solver = std::make_shared<testiHQP>(*stack, 1e6);
+
+    // the stack is not updated: the cost already loaded in the back-ends is used
+    Eigen::VectorXd x0, x1;
+    EXPECT_TRUE(_solver->solve(x0));
+    EXPECT_TRUE(_solver->solve(x1));
+    EXPECT_NEAR((x0 - x1).norm(), 0., 1e-6);
+
+    // a change of the task is loaded in the back-ends
+    task1->setb(Eigen::VectorXd::Random(n));
+    stack->update();
+    EXPECT_TRUE(_solver->solve(x1));
+
+    testiHQP solver(*stack, 1e6);
+    Eigen::VectorXd x;
+    EXPECT_TRUE(solver.solve(x));
+    EXPECT_NEAR((x - x1).norm(), 0., 1e-6);
+    EXPECT_GT((x0 - x1).norm(), 1e-3);
+
+    // a new eps regularisation is applied also if the tasks did not change
+    EXPECT_TRUE(_solver->setEpsRegularisation(1e9));
+    EXPECT_TRUE(solver.setEpsRegularisation(1e9));
+    EXPECT_TRUE(_solver->solve(x1));
+    EXPECT_TRUE(solver.solve(x));
+    EXPECT_NEAR((x - x1).norm(), 0., 1e-6);
+}
+
+TEST_F(testClass, testUnchangedCostRegularisation)
+{
+    std::srand(11);
+    const int n = 7;
+
+    auto task0 = std::make_shared<OpenSoT::tasks::GenericTask>("task0", Eigen::MatrixXd::Random(3, n), Eigen::VectorXd::Random(3));
+    auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", Eigen::MatrixXd::Identity(n, n), Eigen::VectorXd::Random(n));
+    Eigen::VectorXd u = Eigen::VectorXd::Constant(n, 0.5);
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", u, -u, n);
+
+    OpenSoT::AutoStack::Ptr stack = (task0/task1) << bounds;
+    stack->update();
+
+    // the back-ends do not accumulate the eps regularisation when the cost is not loaded again
+    for(auto be : {OpenSoT::solvers::solver_back_ends::qpOASES, OpenSoT::solvers::solver_back_ends::eiQuadProg})
+    {
+        OpenSoT::solvers::iHQP solver(*stack, 1e9, be);
+
+        Eigen::VectorXd x0, x;
+        ASSERT_TRUE(solver.solve(x0));
+        for(unsigned int k = 0; k < 2000; ++k)
+            ASSERT_TRUE(solver.solve(x));
+        EXPECT_NEAR((x - x0).norm(), 0., 1e-9);
+    }
+}
+
+TEST_F(testClass, testParallelSubProblems)
+{
+    std::srand(42);
+
+    // an "arm" and a "base" sharing no variables
+    OpenSoT::OptvarHelper::VariableVector vars;
+    vars.emplace_back("arm", 7);
+    vars.emplace_back("base", 3);
+    OpenSoT::OptvarHelper opt(vars);
+    OpenSoT::AffineHelper arm = opt.getVariable("arm");
+    OpenSoT::AffineHelper base = opt.getVariable("base");
+
+    auto arm_cartesian = std::make_shared<OpenSoT::tasks::GenericTask>("arm_cartesian",
+                Eigen::MatrixXd::Random(3, 7), Eigen::VectorXd::Random(3), arm);
+    auto base_velocity = std::make_shared<OpenSoT::tasks::GenericTask>("base_velocity",
+                Eigen::MatrixXd::Random(2, 3), Eigen::VectorXd::Random(2), base);
+    auto arm_postural = std::make_shared<OpenSoT::tasks::GenericTask>("arm_postural",
+                Eigen::MatrixXd::Identity(7, 7), Eigen::VectorXd::Zero(7), arm);
+    auto base_postural = std::make_shared<OpenSoT::tasks::GenericTask>("base_postural",
+                Eigen::MatrixXd::Identity(3, 3), Eigen::VectorXd::Zero(3), base);
+
+    Eigen::MatrixXd C = Eigen::MatrixXd::Random(2, 7);
+    auto arm_constraint = std::make_shared<OpenSoT::constraints::GenericConstraint>("arm_constraint",
+                C*arm, Eigen::VectorXd::Constant(2, 0.2), Eigen::VectorXd::Constant(2, -0.2),
+                OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT);
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds",
+                Eigen::VectorXd::Constant(10, 0.5), Eigen::VectorXd::Constant(10, -0.5), 10);
+
+    OpenSoT::AutoStack::Ptr stack = ((arm_cartesian + base_velocity) / (arm_postural + base_postural))
+            << arm_constraint << bounds;
+    stack->update();
+
+    OpenSoT::solvers::iHQP serial(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    OpenSoT::solvers::iHQP parallel(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    parallel.setThreadPool(std::make_shared<OpenSoT::utils::ThreadPool>(1));
+    auto statistics = std::make_shared<OpenSoT::utils::SolverStatistics>(100);
+    parallel.setStatistics(statistics);
+
+    // the same blocks, declared
+    OpenSoT::solvers::iHQP declared(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    EXPECT_FALSE(declared.setColumnBlocks(std::vector<int>(7, 0)));
+    std::vector<int> blocks(10, 0);
+    std::fill(blocks.begin() + 7, blocks.end(), 1);
+    EXPECT_TRUE(declared.setColumnBlocks(blocks));
+    declared.setThreadPool(std::make_shared<OpenSoT::utils::ThreadPool>(1));
+
+    for(unsigned int k = 0; k < 50; ++k)
+    {
+        arm_cartesian->setb(Eigen::VectorXd::Constant(3, 0.3*std::cos(0.1*k)));
+        base_velocity->setb(Eigen::VectorXd::Constant(2, 0.3*std::sin(0.1*k)));
+
+        // the matrices change, but the arm and the base stay independent
+        if(k == 25)
+        {
+            arm_postural->setA(2.*Eigen::MatrixXd::Identity(7, 7));
+            base_velocity->setA(Eigen::MatrixXd::Random(2, 3));
+        }
+        stack->update();
+
+        Eigen::VectorXd x_serial, x_parallel, x_declared;
+        ASSERT_TRUE(serial.solve(x_serial));
+        ASSERT_TRUE(parallel.solve(x_parallel));
+        ASSERT_TRUE(declared.solve(x_declared));
+
+        EXPECT_EQ(parallel.getNumberOfSubProblems(), 2) << "at tick " << k;
+        EXPECT_EQ(declared.getNumberOfSubProblems(), 2) << "at tick " << k;
+        EXPECT_NEAR((x_serial - x_parallel).norm(), 0., 1e-6) << "at tick " << k;
+        EXPECT_NEAR((x_serial - x_declared).norm(), 0., 1e-6) << "at tick " << k;
+
+        // a single record per solve, with the levels of the sub-problems
+        OpenSoT::utils::TickStatistics tick;
+        ASSERT_TRUE(statistics->pop(tick));
+        EXPECT_FALSE(statistics->pop(tick));
+        EXPECT_TRUE(tick.success);
+        EXPECT_EQ(tick.number_of_levels, 2);
+        for(unsigned int i = 0; i < tick.number_of_levels; ++i)
+        {
+            EXPECT_TRUE(tick.levels[i].success) << "at tick " << k;
+            EXPECT_GT(tick.levels[i].back_end_time, 0.) << "at tick " << k;
+        }
+    }
+
+    // a constraint coupling the arm and the base merges the sub-problems
+    stack = ((arm_cartesian + base_velocity) / (arm_postural + base_postural))
+            << arm_constraint << bounds;
+    auto coupling = std::make_shared<OpenSoT::constraints::GenericConstraint>("coupling",
+                OpenSoT::AffineHelper(Eigen::MatrixXd::Ones(1, 10), Eigen::VectorXd::Zero(1)),
+                Eigen::VectorXd::Constant(1, 0.1), Eigen::VectorXd::Constant(1, -0.1),
+                OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT);
+    stack = stack << coupling;
+    stack->update();
+
+    OpenSoT::solvers::iHQP coupled(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    EXPECT_FALSE(coupled.setColumnBlocks(blocks));
+    coupled.setThreadPool(std::make_shared<OpenSoT::utils::ThreadPool>(1));
+    OpenSoT::solvers::iHQP coupled_serial(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+
+    Eigen::VectorXd x_serial, x_parallel;
+    ASSERT_TRUE(coupled.solve(x_parallel));
+    ASSERT_TRUE(coupled_serial.solve(x_serial));
+    EXPECT_EQ(coupled.getNumberOfSubProblems(), 1);
+    EXPECT_NEAR((x_serial - x_parallel).norm(), 0., 1e-12);
+}
+
+TEST_F(testClass, testParallelFillIn)
+{
+    std::srand(42);
+
+    // the arm task does not depend on the base at the beginning
+    Eigen::MatrixXd J = Eigen::MatrixXd::Zero(3, 10);
+    J.leftCols(7).setRandom();
+    auto cartesian = std::make_shared<OpenSoT::tasks::GenericTask>("cartesian", J, Eigen::VectorXd::Random(3));
+    Eigen::MatrixXd B = Eigen::MatrixXd::Zero(2, 10);
+    B.rightCols(3).setRandom();
+    auto base_velocity = std::make_shared<OpenSoT::tasks::GenericTask>("base_velocity", B, Eigen::VectorXd::Random(2));
+    // a zero row is dropped from the sub-problems
+    auto gaze = std::make_shared<OpenSoT::tasks::GenericTask>("gaze", Eigen::MatrixXd::Zero(1, 10), Eigen::VectorXd::Zero(1));
+    auto postural = std::make_shared<OpenSoT::tasks::GenericTask>("postural",
+                Eigen::MatrixXd::Identity(10, 10), Eigen::VectorXd::Zero(10));
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds",
+                Eigen::VectorXd::Constant(10, 0.5), Eigen::VectorXd::Constant(10, -0.5), 10);
+
+    OpenSoT::AutoStack::Ptr stack = ((cartesian + base_velocity + gaze) / postural) << bounds;
+    stack->update();
+
+    OpenSoT::solvers::iHQP serial(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    OpenSoT::solvers::iHQP parallel(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    parallel.setThreadPool(std::make_shared<OpenSoT::utils::ThreadPool>(1));
+    OpenSoT::solvers::iHQP declared(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    std::vector<int> blocks(10, 0);
+    std::fill(blocks.begin() + 7, blocks.end(), 1);
+    EXPECT_TRUE(declared.setColumnBlocks(blocks));
+    declared.setThreadPool(std::make_shared<OpenSoT::utils::ThreadPool>(1));
+
+    for(unsigned int k = 0; k < 30; ++k)
+    {
+        cartesian->setb(Eigen::VectorXd::Constant(3, 0.3*std::cos(0.1*k)));
+
+        // the dropped row becomes non-zero inside the arm block
+        if(k == 10)
+        {
+            Eigen::MatrixXd G = Eigen::MatrixXd::Zero(1, 10);
+            G(0, 3) = 1.;
+            gaze->setA(G);
+            gaze->setb(Eigen::VectorXd::Constant(1, 0.1));
+        }
+
+        // fill-in of the arm task couples the arm and the base
+        if(k == 20)
+        {
+            J.rightCols(3).setRandom();
+            cartesian->setA(J);
+        }
+        stack->update();
+
+        Eigen::VectorXd x_serial, x_parallel, x_declared;
+        ASSERT_TRUE(serial.solve(x_serial));
+        ASSERT_TRUE(parallel.solve(x_parallel));
+        ASSERT_TRUE(declared.solve(x_declared));
+
+        const unsigned int sub_problems = k < 20 ? 2 : 1;
+        EXPECT_EQ(parallel.getNumberOfSubProblems(), sub_problems) << "at tick " << k;
+        EXPECT_EQ(declared.getNumberOfSubProblems(), sub_problems) << "at tick " << k;
+        EXPECT_NEAR((x_serial - x_parallel).norm(), 0., 1e-6) << "at tick " << k;
+        EXPECT_NEAR((x_serial - x_declared).norm(), 0., 1e-6) << "at tick " << k;
+    }
+}
+
+TEST_F(testClass, testAutoBackEnd)
+{
+    std::srand(42);
+
+    auto cartesian = std::make_shared<OpenSoT::tasks::GenericTask>("cartesian",
+                Eigen::MatrixXd::Random(3, 7), Eigen::VectorXd::Random(3));
+    auto postural = std::make_shared<OpenSoT::tasks::GenericTask>("postural",
+                Eigen::MatrixXd::Identity(7, 7), Eigen::VectorXd::Zero(7));
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds",
+                Eigen::VectorXd::Constant(7, 0.5), Eigen::VectorXd::Constant(7, -0.5), 7);
+
+    OpenSoT::AutoStack::Ptr stack = (cartesian / postural) << bounds;
+    stack->update();
+
+    OpenSoT::solvers::iHQP automatic(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::Auto);
+    OpenSoT::solvers::iHQP reference(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+
+    // the back-end of each level is resolved at construction
+    for(unsigned int i = 0; i < 2; ++i)
+        EXPECT_NE(automatic.getBackEndName(i), "Auto");
+
+    Eigen::VectorXd x_automatic, x_reference;
+    ASSERT_TRUE(automatic.solve(x_automatic));
+    ASSERT_TRUE(reference.solve(x_reference));
+    EXPECT_NEAR((x_automatic - x_reference).norm(), 0., 1e-6);
+}
+
 }
 
 int main(int argc, char **argv) {
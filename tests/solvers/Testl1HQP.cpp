@@ -7,8 +7,10 @@
 #include <OpenSoT/tasks/GenericTask.h>
 #include <OpenSoT/utils/AutoStack.h>
 #include <OpenSoT/constraints/velocity/JointLimits.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
 
 #include "../common.h"
+#include "../RandomStack.h"
 
 
 namespace {
@@ -175,6 +177,104 @@ TEST_F(testl1HQP, testContructor)
     std::cout<<"solution: "<<solution.transpose()<<std::endl;
 
 }
+
+TEST_F(testl1HQP, testIncrementalUpdate)
+{
+    const int n = 8;
+    std::srand(42);
+
+    const int rows[3] = {2, 3, n};
+    auto tasks = random_stack::tasks({rows[0], rows[1], rows[2]}, n, false);
+    auto bounds = random_stack::bounds(n, 0.6);
+    auto constraint = random_stack::constraint("constraint", 2, n, 0.3);
+
+    OpenSoT::AutoStack::Ptr stack = (tasks[0] / tasks[1] / tasks[2]) << constraint << bounds;
+    stack->update();
+
+    OpenSoT::solvers::l1HQP solver(*stack);
+
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        // the first task changes at every tick, the second one and the constraint every few ticks
+        tasks[0]->setb(Eigen::VectorXd::Constant(rows[0], std::cos(0.1*k)));
+        if(k % 3 == 0)
+            tasks[1]->setA(Eigen::MatrixXd::Random(rows[1], n));
+        if(k % 4 == 0)
+            constraint->setBounds(Eigen::VectorXd::Constant(2, 0.3 + 0.01*k), Eigen::VectorXd::Constant(2, -0.3));
+        stack->update();
+
+        Eigen::VectorXd x;
+        ASSERT_TRUE(solver.solve(x));
+
+        // the LP of a new solver is assembled from scratch
+        OpenSoT::solvers::l1HQP solver_ref(*stack);
+        Eigen::VectorXd x_ref;
+        ASSERT_TRUE(solver_ref.solve(x_ref));
+
+        EXPECT_NEAR((x - x_ref).norm(), 0., 1e-6) << "at tick " << k;
+
+        for(auto& helper : solver.getConstraints())
+        {
+            EXPECT_TRUE(helper.second->getAineq() == solver_ref.getConstraints().at(helper.first)->getAineq()) << "at tick " << k;
+            EXPECT_TRUE(helper.second->getbUpperBound() == solver_ref.getConstraints().at(helper.first)->getbUpperBound()) << "at tick " << k;
+        }
+        EXPECT_TRUE(solver.getHardConstraints()->getAineq() == solver_ref.getHardConstraints()->getAineq()) << "at tick " << k;
+        EXPECT_TRUE(solver.getHardConstraints()->getbUpperBound() == solver_ref.getHardConstraints()->getbUpperBound()) << "at tick " << k;
+    }
+}
+
+class EqualityConstraint: public OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>
+{
+public:
+    EqualityConstraint(const Eigen::MatrixXd& Aeq, const Eigen::VectorXd& beq):
+        OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>("equality", Aeq.cols())
+    {
+        _Aeq = Aeq;
+        _beq = beq;
+    }
+
+    void setbeq(const Eigen::VectorXd& beq)
+    {
+        _beq = beq;
+        increaseVersion();
+    }
+};
+
+TEST_F(testl1HQP, testEqualityConstraints)
+{
+    const int n = 8;
+    std::srand(7);
+
+    auto task0 = std::make_shared<OpenSoT::tasks::GenericTask>("task0", Eigen::MatrixXd::Random(3, n), Eigen::VectorXd::Random(3));
+    auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", Eigen::MatrixXd::Identity(n, n), Eigen::VectorXd::Zero(n));
+
+    Eigen::VectorXd u = Eigen::VectorXd::Constant(n, 1.);
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", u, -u, n);
+
+    // the equality constraint Ce x = de
+    Eigen::MatrixXd Ce = Eigen::MatrixXd::Random(2, n);
+    auto equality = std::make_shared<EqualityConstraint>(Ce, 0.1*Eigen::VectorXd::Random(2));
+
+    // the equality constraints are kept as such in the bounds of the stack
+    OpenSoT::AutoStack::Ptr stack = (task0 / task1) << equality << bounds;
+    stack->setBoundsAggregationPolicy(OpenSoT::constraints::Aggregated::UNILATERAL_TO_BILATERAL);
+    stack->update();
+    ASSERT_EQ(stack->getBounds()->getAeq().rows(), 2);
+
+    OpenSoT::solvers::l1HQP solver(*stack);
+
+    for(unsigned int k = 0; k < 5; ++k)
+    {
+        equality->setbeq(0.1*Eigen::VectorXd::Constant(2, std::sin(0.3*k)));
+        stack->update();
+
+        Eigen::VectorXd x;
+        ASSERT_TRUE(solver.solve(x));
+
+        EXPECT_NEAR((Ce*x - equality->getbeq()).norm(), 0., 1e-6) << "at tick " << k;
+        EXPECT_LE(x.cwiseAbs().maxCoeff(), 1. + 1e-6) << "at tick " << k;
+    }
+}
 }
 
 
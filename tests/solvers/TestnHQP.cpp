@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/nHQP.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <OpenSoT/utils/AutoStack.h>
+#include "../RandomStack.h"
+
+namespace{
+
+class EqualityConstraint: public OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>
+{
+public:
+    EqualityConstraint(const Eigen::MatrixXd& Aeq, const Eigen::VectorXd& beq):
+        OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>("equality", Aeq.cols())
+    {
+        _Aeq = Aeq;
+        _beq = beq;
+    }
+};
+
+class testnHQP: public ::testing::Test
+{
+protected:
+
+    testnHQP()
+    {
+        std::srand(42);
+
+        tasks = random_stack::tasks({3, 4, 5, n}, n);
+        for(auto task : tasks)
+            A0.push_back(task->getA());
+
+        bounds = random_stack::bounds(n, 0.6);
+    }
+
+    virtual ~testnHQP() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+    OpenSoT::AutoStack::Ptr createStack()
+    {
+        OpenSoT::AutoStack::Ptr stack = (tasks[0] / tasks[1] / tasks[2] / tasks[3]) << bounds;
+        stack->update();
+        return stack;
+    }
+
+    /**
+     * @brief setTick changes the Jacobians of the first three tasks (if move_A is true) and all the references
+     */
+    void setTick(const unsigned int k, const bool move_A)
+    {
+        for(unsigned int i = 0; i < 4; ++i)
+        {
+            Eigen::MatrixXd A = A0[i];
+            if(i < 3 && move_A)
+                A += 0.05*std::sin(0.1*k)*Eigen::MatrixXd::Ones(A.rows(), A.cols());
+            tasks[i]->setA(A);
+            tasks[i]->setb(Eigen::VectorXd::Constant(A.rows(), std::cos(0.05*k + i)));
+        }
+    }
+
+    static constexpr int n = 14;
+    std::vector<Eigen::MatrixXd> A0;
+    std::vector<OpenSoT::tasks::GenericTask::Ptr> tasks;
+    OpenSoT::constraints::GenericConstraint::Ptr bounds;
+};
+
+TEST_F(testnHQP, testNullspaceMethods)
+{
+    for(bool move_A : {true, false})
+    {
+        OpenSoT::AutoStack::Ptr stack = createStack();
+
+        std::vector<OpenSoT::solvers::nHQP::Ptr> solvers;
+        for(unsigned int i = 0; i < 4; ++i)
+            solvers.push_back(std::make_shared<OpenSoT::solvers::nHQP>(stack->getStack(), stack->getBounds(), 0.));
+
+        // 0: SVD, 1: ColPivQR, 2: SVD + warm start, 3: ColPivQR + warm start
+        solvers[1]->setNullspaceMethod(OpenSoT::solvers::nHQP::NullspaceMethod::ColPivQR);
+        solvers[2]->setNullspaceWarmStart(true);
+        solvers[3]->setNullspaceMethod(OpenSoT::solvers::nHQP::NullspaceMethod::ColPivQR);
+        solvers[3]->setNullspaceWarmStart(true);
+
+        for(unsigned int k = 0; k < 50; ++k)
+        {
+            setTick(k, move_A);
+            stack->update();
+
+            Eigen::VectorXd x_svd;
+            ASSERT_TRUE(solvers[0]->solve(x_svd));
+
+            for(unsigned int i = 1; i < 4; ++i)
+            {
+                Eigen::VectorXd x;
+                ASSERT_TRUE(solvers[i]->solve(x));
+                EXPECT_NEAR((x - x_svd).norm(), 0., 1e-6) << "solver " << i << " at tick " << k;
+            }
+        }
+    }
+}
+
+TEST_F(testnHQP, testNullspaceWarmStartTolerance)
+{
+    OpenSoT::AutoStack::Ptr stack = createStack();
+
+    OpenSoT::solvers::nHQP solver(stack->getStack(), stack->getBounds(), 0.);
+    EXPECT_THROW(solver.setNullspaceWarmStart(true, -1.), std::invalid_argument);
+
+    // with a large tolerance the (wrong) nullspace of the first tick is kept even if the Jacobians change
+    OpenSoT::solvers::nHQP solver_ref(stack->getStack(), stack->getBounds(), 0.);
+    solver.setNullspaceWarmStart(true, 1e3);
+
+    Eigen::VectorXd x, x_ref;
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        setTick(k, true);
+        stack->update();
+
+        ASSERT_TRUE(solver.solve(x));
+        ASSERT_TRUE(solver_ref.solve(x_ref));
+    }
+    EXPECT_GT((x - x_ref).norm(), 1e-6);
+
+    // disabling the warm start recomputes the nullspace
+    solver.setNullspaceWarmStart(false);
+    ASSERT_TRUE(solver.solve(x));
+    EXPECT_NEAR((x - x_ref).norm(), 0., 1e-6);
+}
+
+
+TEST_F(testnHQP, testLocalConstraints)
+{
+    // the local constraint is added to the last layer, so that it holds for the final solution
+    Eigen::MatrixXd C = Eigen::MatrixXd::Random(2, n);
+    Eigen::VectorXd c = Eigen::VectorXd::Constant(2, 0.01);
+    auto local_constraint = std::make_shared<OpenSoT::constraints::GenericConstraint>("local_constraint",
+                OpenSoT::AffineHelper(C, Eigen::VectorXd::Zero(2)), c, -c,
+                OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT);
+    tasks[3]->getConstraints().push_back(local_constraint);
+
+    OpenSoT::AutoStack::Ptr stack = (tasks[0] / tasks[3]) << bounds;
+    stack->update();
+    OpenSoT::solvers::nHQP solver(stack->getStack(), stack->getBounds(), 0.);
+
+    Eigen::VectorXd x;
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        setTick(k, true);
+        stack->update();
+
+        ASSERT_TRUE(solver.solve(x));
+        EXPECT_TRUE(((C*x).array() <= c.array() + 1e-6).all()) << "at tick " << k;
+        EXPECT_TRUE(((C*x).array() >= -c.array() - 1e-6).all()) << "at tick " << k;
+        EXPECT_TRUE((x.array().abs() <= 0.6 + 1e-6).all()) << "at tick " << k;
+    }
+
+    // the local constraint is active
+    tasks[3]->getConstraints().clear();
+    OpenSoT::AutoStack::Ptr stack_unconstrained = (tasks[0] / tasks[3]) << bounds;
+    stack_unconstrained->update();
+    OpenSoT::solvers::nHQP solver_unconstrained(stack_unconstrained->getStack(), stack_unconstrained->getBounds(), 0.);
+    ASSERT_TRUE(solver_unconstrained.solve(x));
+    EXPECT_TRUE(((C*x).cwiseAbs().array() > c.array()).any());
+}
+
+TEST_F(testnHQP, testEqualityConstraints)
+{
+    Eigen::MatrixXd Aeq = Eigen::MatrixXd::Random(2, n);
+    Eigen::VectorXd beq = Eigen::VectorXd::Constant(2, 0.1);
+    auto equality = std::make_shared<EqualityConstraint>(Aeq, beq);
+
+    // equalities are not turned into inequalities by this aggregation
+    auto constraints = std::make_shared<OpenSoT::constraints::Aggregated>(
+                std::list<OpenSoT::constraints::Aggregated::ConstraintPtr>{equality, bounds}, n,
+                OpenSoT::constraints::Aggregated::UNILATERAL_TO_BILATERAL);
+    ASSERT_EQ(constraints->getAeq().rows(), 2);
+
+    OpenSoT::AutoStack::Ptr stack = createStack();
+    OpenSoT::solvers::nHQP solver(stack->getStack(), constraints, 0.);
+
+    Eigen::VectorXd x;
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        setTick(k, true);
+        stack->update();
+
+        ASSERT_TRUE(solver.solve(x));
+        EXPECT_NEAR((Aeq*x - beq).norm(), 0., 1e-6) << "at tick " << k;
+        EXPECT_TRUE((x.array().abs() <= 0.6 + 1e-6).all()) << "at tick " << k;
+    }
+}
+
+TEST_F(testnHQP, testFailedLayerWarmStart)
+{
+    // with the QR nullspace of the first task [a b 0 0] the nullspaces of the second task are always reused, while
+    // the cumulated nullspace of the last task depends on a and b
+    const int n = 4;
+    Eigen::MatrixXd A0(1, n), A1(1, n);
+    A0 << 1., 0.5, 0., 0.;
+    A1 << 0., 0., 1., 0.;
+    auto task0 = std::make_shared<OpenSoT::tasks::GenericTask>("task0", A0, Eigen::VectorXd::Constant(1, 0.1));
+    auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", A1, Eigen::VectorXd::Constant(1, 0.2));
+    auto task2 = std::make_shared<OpenSoT::tasks::GenericTask>("task2", Eigen::MatrixXd::Random(2, n), Eigen::VectorXd::Random(2));
+
+    // a local constraint of the second task, infeasible (two opposite rows) at the second tick
+    Eigen::MatrixXd C(2, n);
+    C << A1, A1;
+    Eigen::VectorXd c = Eigen::VectorXd::Constant(2, 10.);
+    Eigen::VectorXd c_upper(2), c_lower(2);
+    c_upper << 2., -1.;
+    c_lower << 1., -2.;
+    auto local_constraint = std::make_shared<OpenSoT::constraints::GenericConstraint>("local_constraint",
+                OpenSoT::AffineHelper(C, Eigen::VectorXd::Zero(2)), c, -c,
+                OpenSoT::constraints::GenericConstraint::Type::CONSTRAINT);
+    task1->getConstraints().push_back(local_constraint);
+
+    Eigen::VectorXd u = Eigen::VectorXd::Constant(n, 10.);
+    auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", u, -u, n);
+    OpenSoT::AutoStack::Ptr stack = (task0 / task1 / task2) << bounds;
+    stack->update();
+
+    OpenSoT::solvers::nHQP solver(stack->getStack(), stack->getBounds(), 0.);
+    solver.setNullspaceMethod(OpenSoT::solvers::nHQP::NullspaceMethod::ColPivQR);
+    solver.setNullspaceWarmStart(true);
+    OpenSoT::solvers::nHQP solver_ref(stack->getStack(), stack->getBounds(), 0.);
+    solver_ref.setNullspaceMethod(OpenSoT::solvers::nHQP::NullspaceMethod::ColPivQR);
+
+    Eigen::VectorXd x, x_ref;
+    ASSERT_TRUE(solver.solve(x));
+    ASSERT_TRUE(solver_ref.solve(x_ref));
+    EXPECT_NEAR((x - x_ref).norm(), 0., 1e-6);
+
+    // the first task changes and the second fails: the last cumulated nullspace is not updated
+    A0 << 0.3, 1., 0., 0.;
+    task0->setA(A0);
+    local_constraint->setBounds(c_upper, c_lower);
+    stack->update();
+    EXPECT_FALSE(solver.solve(x));
+    EXPECT_FALSE(solver_ref.solve(x_ref));
+
+    // nothing changes at the next tick, the cumulated nullspaces are computed again
+    local_constraint->setBounds(c, -c);
+    stack->update();
+    ASSERT_TRUE(solver.solve(x));
+    ASSERT_TRUE(solver_ref.solve(x_ref));
+    EXPECT_NEAR((x - x_ref).norm(), 0., 1e-6);
+    EXPECT_NEAR((A0*x)(0), 0.1, 1e-6);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
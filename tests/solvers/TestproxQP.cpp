@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/BackEndFactory.h>
+#include <OpenSoT/solvers/proxQPSparseBackEnd.h>
+#include <cmath>
+
+namespace{
+
+class testproxQP: public ::testing::Test
+{
+protected:
+
+    testproxQP():
+        H(n, n), g(n), A(m, n), lA(m), uA(m), l(n), u(n)
+    {
+        std::srand(42);
+
+        // sparse Hessian and constraints: tridiagonal (diagonally dominant) Hessian, each constraint involves
+        // only two variables
+        H.setZero();
+        for(int i = 0; i < n; ++i)
+        {
+            H(i, i) = 2. + 0.1*i;
+            if(i + 1 < n)
+                H(i, i+1) = H(i+1, i) = -0.5;
+        }
+        g.setRandom();
+
+        A.setZero();
+        for(int i = 0; i < m; ++i)
+        {
+            A(i, i) = 1.;
+            A(i, i+1) = -1.;
+        }
+        lA.setConstant(-0.1);
+        uA.setConstant(0.1);
+
+        l.setConstant(-1.);
+        u.setConstant(1.);
+    }
+
+    virtual ~testproxQP() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+    static constexpr int n = 12;
+    static constexpr int m = 6;
+
+    Eigen::MatrixXd H;
+    Eigen::VectorXd g;
+    OpenSoT::solvers::BackEnd::RowMajorMatrixXd A;
+    Eigen::VectorXd lA, uA, l, u;
+};
+
+TEST_F(testproxQP, testSparseAndWarmStart)
+{
+    std::vector<OpenSoT::solvers::BackEnd::Ptr> back_ends;
+    for(auto be : {OpenSoT::solvers::solver_back_ends::eiQuadProg, OpenSoT::solvers::solver_back_ends::proxQP,
+                   OpenSoT::solvers::solver_back_ends::proxQPSparse})
+    {
+        back_ends.push_back(OpenSoT::solvers::BackEndFactory(be, n, m, OpenSoT::HessianType::HST_POSDEF, 0.));
+        ASSERT_TRUE(back_ends.back()->initProblem(H, g, A, lA, uA, l, u));
+    }
+
+    // structural nonzeros, including the entry of A which is set only later
+    OpenSoT::solvers::proxQPSparseBackEnd::proxQPSparseBackEndOptions opt;
+    opt.H_pattern = H.array() != 0.;
+    opt.A_pattern = A.array() != 0.;
+    opt.A_pattern(0, n-1) = true;
+    back_ends[2]->setOptions(opt);
+
+    for(unsigned int k = 0; k < 30; ++k)
+    {
+        g = Eigen::VectorXd::Constant(n, std::cos(0.1*k));
+
+        // a declared nonzero of the constraints is set
+        if(k == 10)
+            A(0, n-1) = 0.5;
+
+        // a constraint becomes an equality (the number of rows of the dense problem changes)
+        if(k == 20)
+            lA[1] = uA[1];
+
+        for(auto& be : back_ends)
+        {
+            ASSERT_TRUE(be->updateProblem(H, g, A, lA, uA, l, u));
+            ASSERT_TRUE(be->solve());
+        }
+
+        EXPECT_NEAR((back_ends[0]->getSolution() - back_ends[1]->getSolution()).norm(), 0., 1e-3) << "at tick " << k;
+        EXPECT_NEAR((back_ends[0]->getSolution() - back_ends[2]->getSolution()).norm(), 0., 1e-3) << "at tick " << k;
+    }
+
+    // infeasible constraint (|x| <= 1): the status of proxqp is reported
+    lA[0] = uA[0] = 3.;
+    for(unsigned int i = 1; i < back_ends.size(); ++i)
+    {
+        ASSERT_TRUE(back_ends[i]->updateProblem(H, g, A, lA, uA, l, u));
+        EXPECT_FALSE(back_ends[i]->solve());
+    }
+}
+
+
+TEST_F(testproxQP, testDetectedPatternAndReinit)
+{
+    OpenSoT::solvers::BackEnd::Ptr reference = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::eiQuadProg, n, m, OpenSoT::HessianType::HST_POSDEF, 0.);
+    // the sparsity patterns are detected from the first problem
+    OpenSoT::solvers::BackEnd::Ptr sparse = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::proxQPSparse, n, m, OpenSoT::HessianType::HST_POSDEF, 0.);
+    ASSERT_TRUE(reference->initProblem(H, g, A, lA, uA, l, u));
+    ASSERT_TRUE(sparse->initProblem(H, g, A, lA, uA, l, u));
+
+    for(unsigned int k = 0; k < 30; ++k)
+    {
+        g = Eigen::VectorXd::Constant(n, std::sin(0.1*k));
+
+        // fill-in outside of the detected patterns
+        if(k == 10)
+            A(2, n-2) = 0.4;
+        if(k == 20)
+            H(0, 5) = H(5, 0) = 0.2;
+
+        ASSERT_TRUE(reference->updateProblem(H, g, A, lA, uA, l, u));
+        ASSERT_TRUE(reference->solve());
+        ASSERT_TRUE(sparse->updateProblem(H, g, A, lA, uA, l, u));
+        ASSERT_TRUE(sparse->solve());
+        EXPECT_NEAR((reference->getSolution() - sparse->getSolution()).norm(), 0., 1e-3) << "at tick " << k;
+    }
+
+    // initializing the problem again warm starts from the previous solution
+    OpenSoT::solvers::BackEnd::Ptr cold = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::proxQPSparse, n, m, OpenSoT::HessianType::HST_POSDEF, 0.);
+    ASSERT_TRUE(cold->initProblem(H, g, A, lA, uA, l, u));
+    ASSERT_TRUE(sparse->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_LT(sparse->getNumberOfIterations(), cold->getNumberOfIterations());
+    EXPECT_NEAR((cold->getSolution() - sparse->getSolution()).norm(), 0., 1e-3);
+}
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
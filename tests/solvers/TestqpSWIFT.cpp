@@ -186,6 +186,67 @@ TEST_F(testqpSWIFTProblem, testSimpleProblem)
 }
 
 
+TEST_F(testqpSWIFTProblem, testInfiniteBoundsAndUpdates)
+{
+    const int n = 6;
+    const double inf = std::numeric_limits<double>::infinity();
+
+    Eigen::MatrixXd H = Eigen::MatrixXd::Identity(n, n);
+    Eigen::VectorXd g = Eigen::VectorXd::Constant(n, -2.);
+
+    // one two-sided, one upper, one lower, one free and one equality constraint
+    OpenSoT::solvers::BackEnd::RowMajorMatrixXd A = Eigen::MatrixXd::Random(5, n);
+    Eigen::VectorXd lA(5), uA(5);
+    lA << -1., -inf, -0.5, -inf, 0.3;
+    uA <<  1.,  0.5,  inf,  inf, 0.3;
+
+    // only some variables are bounded
+    Eigen::VectorXd l = Eigen::VectorXd::Constant(n, -inf);
+    Eigen::VectorXd u = Eigen::VectorXd::Constant(n, inf);
+    l.head(3).setConstant(-1.);
+    u.head(2).setConstant(1.);
+
+    OpenSoT::solvers::BackEnd::Ptr qpoases = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpOASES, n, A.rows(), OpenSoT::HessianType::HST_POSDEF, 0.);
+    OpenSoT::solvers::BackEnd::Ptr qpswift = OpenSoT::solvers::BackEndFactory(
+                OpenSoT::solvers::solver_back_ends::qpSWIFT, n, A.rows(), OpenSoT::HessianType::HST_POSDEF, 0.);
+
+    ASSERT_TRUE(qpoases->initProblem(H, g, A, lA, uA, l, u));
+    ASSERT_TRUE(qpswift->initProblem(H, g, A, lA, uA, l, u));
+    EXPECT_NEAR((qpoases->getSolution() - qpswift->getSolution()).norm(), 0., 1e-6);
+
+    for(unsigned int k = 0; k < 20; ++k)
+    {
+        // vectors change at each tick, the constraint matrix every 5 ticks and the layout at tick 10
+        g = Eigen::VectorXd::Constant(n, -2.*std::cos(0.1*k));
+        if(k % 5 == 0)
+            A = Eigen::MatrixXd::Random(5, n);
+        if(k == 10)
+            uA[3] = 2.;
+
+        ASSERT_TRUE(qpoases->updateProblem(H, g, A, lA, uA, l, u));
+        ASSERT_TRUE(qpswift->updateProblem(H, g, A, lA, uA, l, u));
+        ASSERT_TRUE(qpoases->solve());
+        ASSERT_TRUE(qpswift->solve());
+
+        EXPECT_NEAR((qpoases->getSolution() - qpswift->getSolution()).norm(), 0., 1e-6) << "at tick " << k;
+    }
+
+    // only the bounds change: the problem is not set up again
+    for(unsigned int k = 0; k < 5; ++k)
+    {
+        l.head(3).setConstant(-0.1*(k+1));
+        u.head(2).setConstant(0.1*(k+1));
+
+        ASSERT_TRUE(qpoases->updateBounds(l, u));
+        ASSERT_TRUE(qpswift->updateBounds(l, u));
+        ASSERT_TRUE(qpoases->solve());
+        ASSERT_TRUE(qpswift->solve());
+
+        EXPECT_NEAR((qpoases->getSolution() - qpswift->getSolution()).norm(), 0., 1e-6) << "at bounds update " << k;
+    }
+}
+
 TEST_F(testqpSWIFTProblem, testTask)
 {
     Eigen::VectorXd q_ref = _model_ptr->getNeutralQ();
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <OpenSoT/solvers/wHQP.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <OpenSoT/utils/AutoStack.h>
+#include "../RandomStack.h"
+#include <stdexcept>
+
+namespace{
+
+class testwHQP: public ::testing::Test
+{
+protected:
+
+    testwHQP()
+    {
+        std::srand(42);
+
+        // the first two levels are compatible, the last one is a minimum norm task
+        tasks = random_stack::tasks({3, 2, n}, n, true, false);
+        bounds = random_stack::bounds(n, 0.6);
+
+        stack = (tasks[0] / tasks[1] / tasks[2]) << bounds;
+        stack->update();
+    }
+
+    virtual ~testwHQP() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+    void setReferences(const unsigned int k)
+    {
+        for(unsigned int i = 0; i < 2; ++i)
+            tasks[i]->setb(Eigen::VectorXd::Constant(tasks[i]->getb().size(), 0.2*std::cos(0.1*k + i)));
+        stack->update();
+    }
+
+    static constexpr int n = 10;
+    std::vector<OpenSoT::tasks::GenericTask::Ptr> tasks;
+    OpenSoT::constraints::GenericConstraint::Ptr bounds;
+    OpenSoT::AutoStack::Ptr stack;
+};
+
+TEST_F(testwHQP, testLevelWeights)
+{
+    std::vector<double> weights = OpenSoT::solvers::wHQP::computeLevelWeights(3, 10.);
+    EXPECT_EQ(weights, std::vector<double>({100., 10., 1.}));
+
+    OpenSoT::solvers::wHQP solver(*stack, std::vector<double>(), 1e-9, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    EXPECT_EQ(solver.getNumberOfTasks(), 3);
+    EXPECT_EQ(solver.getLevelWeights(), OpenSoT::solvers::wHQP::computeLevelWeights(3));
+
+    EXPECT_FALSE(solver.setLevelWeights({1., 1.}));
+    EXPECT_FALSE(solver.setLevelWeights({1., -1., 1.}));
+    EXPECT_FALSE(solver.setLevelWeight(3, 1.));
+    EXPECT_FALSE(solver.setLevelWeight(0, -1.));
+    EXPECT_EQ(solver.getLevelWeights(), OpenSoT::solvers::wHQP::computeLevelWeights(3));
+
+    EXPECT_THROW(OpenSoT::solvers::wHQP(*stack, {1., 1.}, 1e-9, OpenSoT::solvers::solver_back_ends::eiQuadProg),
+                 std::invalid_argument);
+}
+
+TEST_F(testwHQP, testHessianType)
+{
+    using OpenSoT::HessianType;
+
+    // the weighted sum of identity Hessians is positive definite, but not the identity
+    for(auto& task : tasks)
+        task->setHessianType(HessianType::HST_IDENTITY);
+    OpenSoT::solvers::wHQP solver(*stack, std::vector<double>(), 1e-9, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    EXPECT_EQ(solver.getHessianType(), HessianType::HST_POSDEF);
+
+    // a single level with weight 1 keeps its Hessian type, and the weight can not be changed
+    OpenSoT::AutoStack::Ptr single_level = std::make_shared<OpenSoT::AutoStack>(tasks[2]);
+    single_level << bounds;
+    single_level->update();
+    OpenSoT::solvers::wHQP single_solver(*single_level, {1.}, 1e-9, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    EXPECT_EQ(single_solver.getHessianType(), HessianType::HST_IDENTITY);
+    EXPECT_FALSE(single_solver.setLevelWeight(0, 2.));
+    EXPECT_TRUE(single_solver.setLevelWeight(0, 1.));
+
+    OpenSoT::solvers::wHQP scaled_solver(*single_level, {2.}, 1e-9, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    EXPECT_EQ(scaled_solver.getHessianType(), HessianType::HST_POSDEF);
+
+    // mixed Hessian types
+    tasks[0]->setHessianType(HessianType::HST_SEMIDEF);
+    OpenSoT::solvers::wHQP mixed_solver(*stack, std::vector<double>(), 1e-9, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    EXPECT_EQ(mixed_solver.getHessianType(), HessianType::HST_SEMIDEF);
+}
+
+TEST_F(testwHQP, testSoftHierarchy)
+{
+    OpenSoT::solvers::iHQP ihqp(*stack, DEFAULT_EPS_REGULARISATION, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    OpenSoT::solvers::wHQP whqp(*stack, OpenSoT::solvers::wHQP::computeLevelWeights(3, 1e4), 1e-9,
+                                OpenSoT::solvers::solver_back_ends::eiQuadProg);
+
+    for(unsigned int k = 0; k < 50; ++k)
+    {
+        setReferences(k);
+
+        Eigen::VectorXd x_i, x_w;
+        ASSERT_TRUE(ihqp.solve(x_i));
+        ASSERT_TRUE(whqp.solve(x_w));
+
+        // the first two levels are compatible, hence are (almost) solved by the weighted problem as well
+        for(unsigned int i = 0; i < 2; ++i)
+            EXPECT_NEAR((tasks[i]->getA()*x_w - tasks[i]->getb()).norm(), 0., 1e-3) << "at tick " << k;
+        EXPECT_NEAR((x_i - x_w).norm(), 0., 1e-3) << "at tick " << k;
+
+        // bounds are hard constraints
+        EXPECT_LE(x_w.cwiseAbs().maxCoeff(), 0.6 + 1e-9) << "at tick " << k;
+
+        // the problem is updated in place, a new solver gives the same solution
+        OpenSoT::solvers::wHQP whqp_ref(*stack, whqp.getLevelWeights(), 1e-9,
+                                        OpenSoT::solvers::solver_back_ends::eiQuadProg);
+        Eigen::VectorXd x_ref;
+        ASSERT_TRUE(whqp_ref.solve(x_ref));
+        EXPECT_NEAR((x_ref - x_w).norm(), 0., 1e-9) << "at tick " << k;
+    }
+}
+
+TEST_F(testwHQP, testDisabledLevel)
+{
+    setReferences(0);
+
+    OpenSoT::solvers::wHQP whqp(*stack, std::vector<double>(), 1e-9, OpenSoT::solvers::solver_back_ends::eiQuadProg);
+    Eigen::VectorXd x;
+    ASSERT_TRUE(whqp.solve(x));
+    EXPECT_NEAR((tasks[0]->getA()*x - tasks[0]->getb()).norm(), 0., 1e-3);
+
+    // without the first level the solution satisfies only the second level
+    ASSERT_TRUE(whqp.setLevelWeight(0, 0.));
+    ASSERT_TRUE(whqp.solve(x));
+    EXPECT_GT((tasks[0]->getA()*x - tasks[0]->getb()).norm(), 1e-2);
+    EXPECT_NEAR((tasks[1]->getA()*x - tasks[1]->getb()).norm(), 0., 1e-3);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -8,6 +8,8 @@
 #include <qpOASES/Options.hpp>
 #include <OpenSoT/tasks/MinimizeVariable.h>
 #include <OpenSoT/tasks/GenericLPTask.h>
+#include <OpenSoT/tasks/Aggregated.h>
+#include <OpenSoT/constraints/Aggregated.h>
 
 namespace {
 
@@ -267,6 +269,102 @@ TEST_F(testGenericTask, testGenericTaskVSMinimizeVariables)
     std::cout<<"generic_min_var->getb():\n"<<generic_min_var->getb()<<std::endl;
 }
 
+TEST_F(testGenericTask, testVersion)
+{
+    Eigen::MatrixXd A1(3, 6), A2(2, 6);
+    A1.setRandom(); A2.setRandom();
+    Eigen::VectorXd b1(3), b2(2);
+    b1.setRandom(); b2.setRandom();
+
+    OpenSoT::tasks::GenericTask::Ptr task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", A1, b1);
+    OpenSoT::tasks::GenericTask::Ptr task2 = std::make_shared<OpenSoT::tasks::GenericTask>("task2", A2, b2);
+    OpenSoT::tasks::Aggregated::Ptr aggr = std::make_shared<OpenSoT::tasks::Aggregated>(task1, task2, 6);
+    aggr->update();
+
+    unsigned int version1 = task1->getVersion();
+    unsigned int aggr_version = aggr->getVersion();
+
+    EXPECT_EQ(version1, task1->getVersion());
+    EXPECT_EQ(aggr_version, aggr->getVersion());
+
+    aggr->update();
+    EXPECT_NE(version1, task1->getVersion());
+    EXPECT_NE(aggr_version, aggr->getVersion());
+
+    version1 = task1->getVersion();
+    A1 *= 2.;
+    EXPECT_TRUE(task1->setA(A1));
+    aggr->update();
+    EXPECT_NE(version1, task1->getVersion());
+    EXPECT_TRUE(aggr->getA().topRows(3) == A1);
+    EXPECT_TRUE(aggr->getA().bottomRows(2) == A2);
+
+    aggr->setActive(false);
+    aggr->update();
+    EXPECT_TRUE(aggr->getA().isZero());
+    aggr->setActive(true);
+    aggr->update();
+    EXPECT_TRUE(aggr->getA().topRows(3) == A1);
+    EXPECT_TRUE(aggr->getA().bottomRows(2) == A2);
+
+    Eigen::VectorXd u(6); u.setOnes();
+    OpenSoT::constraints::GenericConstraint::Ptr bounds =
+            std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", u, -u, 6);
+    OpenSoT::constraints::GenericConstraint::Ptr bounds2 =
+            std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds2", 2.*u, -2.*u, 6);
+    OpenSoT::constraints::Aggregated constraints(bounds, bounds2, 6);
+    unsigned int constraints_version = constraints.getVersion();
+
+    constraints.update();
+    EXPECT_EQ(constraints_version, constraints.getVersion());
+
+    EXPECT_TRUE(bounds2->setBounds(0.5*u, -0.5*u));
+    constraints.update();
+    EXPECT_NE(constraints_version, constraints.getVersion());
+    EXPECT_TRUE(constraints.getUpperBound() == 0.5*u);
+    EXPECT_TRUE(constraints.getLowerBound() == -0.5*u);
+}
+
+/**
+ * @brief The UnversionedBounds class writes its bounds in update() without calling increaseVersion(), as derived
+ * classes written before the versions were introduced
+ */
+class UnversionedBounds: public OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>
+{
+public:
+    UnversionedBounds(const unsigned int x_size):
+        OpenSoT::Constraint<Eigen::MatrixXd, Eigen::VectorXd>("unversioned_bounds", x_size),
+        value(1.)
+    {
+        update();
+    }
+
+    void update()
+    {
+        _upperBound.setConstant(_x_size, value);
+        _lowerBound.setConstant(_x_size, -value);
+    }
+
+    double value;
+};
+
+TEST_F(testGenericTask, testUnversionedConstraint)
+{
+    auto unversioned = std::make_shared<UnversionedBounds>(6);
+    OpenSoT::constraints::Aggregated constraints(
+                std::list<OpenSoT::constraints::Aggregated::ConstraintPtr>{unversioned}, 6);
+    EXPECT_NE(unversioned->getVersion(), unversioned->getVersion());
+
+    // the aggregate is generated again at each update
+    for(double value : {0.5, 0.2, 0.7})
+    {
+        unversioned->value = value;
+        constraints.update();
+        EXPECT_TRUE(constraints.getUpperBound() == Eigen::VectorXd::Constant(6, value));
+        EXPECT_TRUE(constraints.getLowerBound() == Eigen::VectorXd::Constant(6, -value));
+    }
+}
+
 TEST_F(testGenericLPTaskFoo, testSingleLPProblem)
 {
     Eigen::MatrixXd A(2,4);
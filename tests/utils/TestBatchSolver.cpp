@@ -0,0 +1,148 @@
+#include <OpenSoT/utils/BatchSolver.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+namespace{
+
+class testBatchSolver: public ::testing::Test
+{
+protected:
+
+    testBatchSolver()
+    {
+        std::srand(42);
+        A0 = Eigen::MatrixXd::Random(3, n);
+        A1 = Eigen::MatrixXd::Identity(n, n);
+    }
+
+    virtual ~testBatchSolver() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+    /**
+     * @brief createProblem creates a two levels stack with bounds solved by an iHQP
+     */
+    OpenSoT::utils::BatchSolver::Problem::Ptr createProblem()
+    {
+        auto problem = std::make_shared<OpenSoT::utils::BatchSolver::Problem>();
+
+        auto task0 = std::make_shared<OpenSoT::tasks::GenericTask>("task0", A0, Eigen::VectorXd::Zero(A0.rows()));
+        auto task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", A1, Eigen::VectorXd::Zero(A1.rows()));
+        Eigen::VectorXd u = Eigen::VectorXd::Constant(n, 0.6);
+        auto bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>("bounds", u, -u, n);
+
+        problem->stack = (task0 / task1) << bounds;
+        problem->stack->update();
+        problem->solver = std::make_shared<OpenSoT::solvers::iHQP>(*problem->stack, 0.,
+                                                                   OpenSoT::solvers::solver_back_ends::eiQuadProg);
+        return problem;
+    }
+
+    /**
+     * @brief setReferences sets the references of the i-th problem of the batch
+     */
+    static void setReferences(OpenSoT::utils::BatchSolver::Problem& problem, const unsigned int i)
+    {
+        for(unsigned int l = 0; l < 2; ++l)
+        {
+            auto task = std::dynamic_pointer_cast<OpenSoT::tasks::GenericTask>(problem.stack->getStack()[l]);
+            task->setb(Eigen::VectorXd::Constant(task->getb().size(), std::cos(0.1*i + l)));
+        }
+    }
+
+    static constexpr int n = 10;
+    Eigen::MatrixXd A0, A1;
+};
+
+TEST_F(testBatchSolver, checkBatch)
+{
+    const unsigned int N = 200;
+
+    OpenSoT::utils::BatchSolver batch(4, [this](const unsigned int){return createProblem();});
+    EXPECT_EQ(batch.getNumberOfInstances(), 4);
+
+    std::vector<Eigen::VectorXd> solutions;
+    std::vector<OpenSoT::utils::BatchSolver::Status> status;
+    batch.solve(N, &testBatchSolver::setReferences, solutions, status);
+    ASSERT_EQ(solutions.size(), N);
+    ASSERT_EQ(status.size(), N);
+
+    // the same problems solved one at a time
+    auto problem = createProblem();
+    for(unsigned int i = 0; i < N; ++i)
+    {
+        setReferences(*problem, i);
+        problem->stack->update();
+
+        Eigen::VectorXd x;
+        ASSERT_TRUE(problem->solver->solve(x));
+
+        ASSERT_TRUE(status[i] == OpenSoT::utils::BatchSolver::Status::SUCCESS) << "problem " << i;
+        EXPECT_NEAR((solutions[i] - x).norm(), 0., 1e-6) << "problem " << i;
+    }
+
+    // the batch solver can be reused
+    std::vector<Eigen::VectorXd> solutions2;
+    batch.solve(N, &testBatchSolver::setReferences, solutions2, status);
+    for(unsigned int i = 0; i < N; ++i)
+        EXPECT_NEAR((solutions[i] - solutions2[i]).norm(), 0., 1e-6) << "problem " << i;
+}
+
+TEST_F(testBatchSolver, checkStatus)
+{
+    OpenSoT::utils::BatchSolver batch(3, [this](const unsigned int){return createProblem();});
+
+    std::vector<Eigen::VectorXd> solutions;
+    std::vector<OpenSoT::utils::BatchSolver::Status> status;
+    batch.solve(30, [](OpenSoT::utils::BatchSolver::Problem& problem, const unsigned int i)
+    {
+        setReferences(problem, i);
+        if(i % 10 == 3)
+            throw std::runtime_error("setup failed");
+    }, solutions, status);
+
+    for(unsigned int i = 0; i < 30; ++i)
+    {
+        if(i % 10 == 3)
+            EXPECT_TRUE(status[i] == OpenSoT::utils::BatchSolver::Status::EXCEPTION) << "problem " << i;
+        else
+            EXPECT_TRUE(status[i] == OpenSoT::utils::BatchSolver::Status::SUCCESS) << "problem " << i;
+    }
+
+    // the instances do not have a model
+    std::vector<Eigen::VectorXd> q(5, Eigen::VectorXd::Zero(n));
+    EXPECT_THROW(batch.solve(q, solutions, status), std::runtime_error);
+}
+
+TEST_F(testBatchSolver, checkFactory)
+{
+    EXPECT_THROW(OpenSoT::utils::BatchSolver(0, [this](const unsigned int){return createProblem();}),
+                 std::invalid_argument);
+    EXPECT_THROW(OpenSoT::utils::BatchSolver(2, [](const unsigned int){
+        return std::make_shared<OpenSoT::utils::BatchSolver::Problem>();}), std::invalid_argument);
+
+    std::vector<unsigned int> instances;
+    OpenSoT::utils::BatchSolver batch(3, [this, &instances](const unsigned int i){
+        instances.push_back(i);
+        return createProblem();});
+    EXPECT_EQ(instances, std::vector<unsigned int>({0, 1, 2}));
+    EXPECT_NO_THROW(batch.getProblem(2));
+    EXPECT_THROW(batch.getProblem(3), std::out_of_range);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
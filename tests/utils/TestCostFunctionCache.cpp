@@ -0,0 +1,110 @@
+#include <OpenSoT/utils/CostFunctionCache.h>
+#include <gtest/gtest.h>
+
+namespace{
+
+class testCostFunctionCache: public ::testing::Test
+{
+protected:
+
+    testCostFunctionCache()
+    {
+
+    }
+
+    virtual ~testCostFunctionCache() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+};
+
+void checkCost(OpenSoT::utils::CostFunctionCache& cost,
+               const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+               const Eigen::MatrixXd& W, const Eigen::VectorXd& c)
+{
+    Eigen::MatrixXd H = A.transpose()*W*A;
+    Eigen::VectorXd g = -A.transpose()*W*b + c;
+
+    EXPECT_TRUE(cost.getH().isApprox(H, 1e-12));
+    EXPECT_TRUE(cost.getg().isApprox(g, 1e-12));
+    EXPECT_TRUE(cost.getH().isApprox(cost.getH().transpose()));
+}
+
+TEST_F(testCostFunctionCache, checkWeights)
+{
+    int m = 12, n = 20;
+    Eigen::MatrixXd A; A.setRandom(m, n);
+    Eigen::VectorXd b; b.setRandom(m);
+    Eigen::VectorXd c; c.setRandom(n);
+
+    OpenSoT::utils::CostFunctionCache cost;
+
+    Eigen::MatrixXd W; W.setIdentity(m, m);
+    EXPECT_TRUE(cost.compute(A, b, W, c, 1));
+    EXPECT_TRUE(cost.getWeightType() == OpenSoT::utils::CostFunctionCache::WeightType::IDENTITY);
+    checkCost(cost, A, b, W, c);
+
+    Eigen::VectorXd w; w.setRandom(m);
+    W = w.cwiseAbs().asDiagonal();
+    EXPECT_TRUE(cost.compute(A, b, W, c, 2));
+    EXPECT_TRUE(cost.getWeightType() == OpenSoT::utils::CostFunctionCache::WeightType::DIAGONAL);
+    checkCost(cost, A, b, W, c);
+
+    W.setRandom(m, m);
+    W = W*W.transpose();
+    EXPECT_TRUE(cost.compute(A, b, W, c, 3));
+    EXPECT_TRUE(cost.getWeightType() == OpenSoT::utils::CostFunctionCache::WeightType::DENSE);
+    checkCost(cost, A, b, W, c);
+}
+
+TEST_F(testCostFunctionCache, checkCaching)
+{
+    int m = 6, n = 10;
+    Eigen::MatrixXd A; A.setRandom(m, n);
+    Eigen::VectorXd b; b.setRandom(m);
+    Eigen::VectorXd c; c.setZero(n);
+    Eigen::MatrixXd W; W.setIdentity(m, m);
+
+    OpenSoT::utils::CostFunctionCache cost;
+
+    EXPECT_TRUE(cost.compute(A, b, W, c, 0));
+    EXPECT_FALSE(cost.compute(A, b, W, c, 0));
+    checkCost(cost, A, b, W, c);
+
+    b.setRandom();
+    EXPECT_TRUE(cost.compute(A, b, W, c, 1));
+    checkCost(cost, A, b, W, c);
+
+    A.setRandom(m+2, n);
+    b.setRandom(m+2);
+    W.setIdentity(m+2, m+2);
+    EXPECT_TRUE(cost.compute(A, b, W, c, 2));
+    checkCost(cost, A, b, W, c);
+
+    cost.invalidate();
+    EXPECT_TRUE(cost.compute(A, b, W, c, 2));
+    EXPECT_FALSE(cost.compute(A, b, W, c, 2));
+
+    A.resize(0, n);
+    b.resize(0);
+    W.resize(0, 0);
+    c.setRandom(n);
+    EXPECT_TRUE(cost.compute(A, b, W, c, 3));
+    EXPECT_TRUE(cost.getH().isZero());
+    EXPECT_TRUE(cost.getg() == c);
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -73,6 +73,56 @@ TEST_F(testPiler, checkPiler)
 
 }
 
+TEST_F(testPiler, checkRewind)
+{
+    int ncols = 20;
+    OpenSoT::utils::MatrixPiler piler(ncols);
+
+    Eigen::MatrixXd A, B, C;
+    A.setRandom(5, ncols);
+    B.setRandom(3, ncols);
+    C.setRandom(7, ncols);
+
+    piler.pile(A);
+    int rows = piler.rows();
+    piler.pile(B);
+
+    piler.rewind(rows);
+    EXPECT_EQ(piler.rows(), A.rows());
+    EXPECT_TRUE( ( (A - piler.generate_and_get()).array() == 0).all() );
+
+    piler.pile(C);
+    Eigen::MatrixXd AC = A;
+    pile(AC, C);
+    EXPECT_TRUE( ( (AC - piler.generate_and_get()).array() == 0).all() );
+
+    EXPECT_THROW(piler.rewind(piler.rows()+1), std::runtime_error);
+}
+
+TEST_F(testPiler, checkRowMajorPiler)
+{
+    int ncols = 20;
+    OpenSoT::utils::RowMajorMatrixPiler piler(ncols);
+
+    Eigen::MatrixXd A, B;
+    A.setRandom(5, ncols);
+    B.setRandom(3, ncols);
+
+    piler.pile(A);
+    piler.pile(B);
+
+    Eigen::MatrixXd AB = A;
+    pile(AB, B);
+    EXPECT_EQ(piler.rows(), AB.rows());
+    EXPECT_TRUE(AB == piler.generate_and_get());
+
+    // the piled rows are contiguous in memory
+    auto block = piler.generate_and_get();
+    for(int i = 0; i < AB.rows(); i++)
+        for(int j = 0; j < ncols; j++)
+            EXPECT_EQ(block.data()[i*ncols + j], AB(i,j));
+}
+
 }
 
 int main(int argc, char **argv) {
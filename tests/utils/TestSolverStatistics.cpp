@@ -0,0 +1,233 @@
+#include <OpenSoT/utils/SolverStatistics.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <OpenSoT/utils/Affine.h>
+#include <OpenSoT/utils/AutoStack.h>
+#include <OpenSoT/solvers/iHQP.h>
+#include <OpenSoT/solvers/nHQP.h>
+#include <OpenSoT/solvers/eHQP.h>
+#include <OpenSoT/solvers/l1HQP.h>
+#include <OpenSoT/solvers/wHQP.h>
+#ifdef OPENSOT_HAS_SOTH_FRONT_END
+#include <OpenSoT/solvers/HCOD.h>
+#endif
+#include <gtest/gtest.h>
+#include <thread>
+
+namespace{
+
+class testSolverStatistics: public ::testing::Test
+{
+protected:
+
+    testSolverStatistics()
+    {
+
+    }
+
+    virtual ~testSolverStatistics() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+};
+
+TEST_F(testSolverStatistics, checkRingBuffer)
+{
+    OpenSoT::utils::SolverStatistics statistics(3);
+
+    OpenSoT::utils::TickStatistics stats;
+    EXPECT_FALSE(statistics.pop(stats));
+
+    for(unsigned int i = 0; i < 5; ++i)
+    {
+        statistics.current().solve_time = i;
+        statistics.level(1).iterations = i;
+        EXPECT_EQ(statistics.commit(), i < 3);
+    }
+    EXPECT_EQ(statistics.getDroppedTicks(), 2);
+
+    for(unsigned int i = 0; i < 3; ++i)
+    {
+        EXPECT_TRUE(statistics.pop(stats));
+        EXPECT_EQ(stats.tick, i);
+        EXPECT_EQ(stats.solve_time, i);
+        EXPECT_EQ(stats.number_of_levels, 2);
+        EXPECT_EQ(stats.levels[0].iterations, -1);
+        EXPECT_EQ(stats.levels[1].iterations, i);
+    }
+    EXPECT_FALSE(statistics.pop(stats));
+
+    // the current record is reset after each commit
+    EXPECT_EQ(statistics.current().number_of_levels, 0);
+    EXPECT_EQ(statistics.current().solve_time, 0.);
+
+    // levels exceeding the maximum are recorded in the last one
+    statistics.level(OPENSOT_STATISTICS_MAX_LEVELS + 3).iterations = 7;
+    EXPECT_EQ(statistics.current().number_of_levels, OPENSOT_STATISTICS_MAX_LEVELS);
+    EXPECT_EQ(statistics.current().levels[OPENSOT_STATISTICS_MAX_LEVELS-1].iterations, 7);
+}
+
+TEST_F(testSolverStatistics, checkConcurrentProducerConsumer)
+{
+    OpenSoT::utils::SolverStatistics statistics(16);
+    const unsigned int number_of_ticks = 100000;
+
+    std::thread producer([&statistics, number_of_ticks](){
+        for(unsigned int i = 0; i < number_of_ticks; ++i)
+        {
+            statistics.current().update_time = i;
+            statistics.commit();
+        }
+    });
+
+    unsigned long popped = 0;
+    long last_tick = -1;
+    OpenSoT::utils::TickStatistics stats;
+    while(popped + statistics.getDroppedTicks() < number_of_ticks)
+    {
+        if(statistics.pop(stats))
+        {
+            // records are received in order and are not corrupted
+            EXPECT_GT((long)stats.tick, last_tick);
+            EXPECT_EQ(stats.update_time, stats.tick);
+            last_tick = stats.tick;
+            ++popped;
+        }
+    }
+    producer.join();
+
+    EXPECT_EQ(popped + statistics.getDroppedTicks(), number_of_ticks);
+}
+
+TEST_F(testSolverStatistics, checkiHQPStatistics)
+{
+    Eigen::MatrixXd A(1,2);
+    A<<1.,1.;
+    Eigen::VectorXd b(1);
+    b<<1.;
+    OpenSoT::tasks::GenericTask::Ptr task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1",A,b);
+    A<<1.,-1.;
+    OpenSoT::tasks::GenericTask::Ptr task2 = std::make_shared<OpenSoT::tasks::GenericTask>("task2",A,b);
+
+    OpenSoT::AffineHelper var(2,2);
+    Eigen::VectorXd u(2);
+    u<<5.,5.;
+    OpenSoT::constraints::GenericConstraint::Ptr bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>(
+                "bounds",var,u,-u,OpenSoT::constraints::GenericConstraint::Type::BOUND);
+
+    OpenSoT::AutoStack::Ptr autostack = (task1 / task2)<<bounds;
+
+    OpenSoT::solvers::iHQP::Ptr sot = std::make_shared<OpenSoT::solvers::iHQP>(
+                autostack->getStack(), autostack->getBounds(), 1.);
+
+    OpenSoT::utils::SolverStatistics::Ptr statistics = std::make_shared<OpenSoT::utils::SolverStatistics>();
+    autostack->setStatistics(statistics);
+    sot->setStatistics(statistics);
+
+    Eigen::VectorXd x(2);
+    for(unsigned int i = 0; i < 10; ++i)
+    {
+        autostack->update();
+        EXPECT_TRUE(sot->solve(x));
+    }
+
+    OpenSoT::utils::TickStatistics stats;
+    for(unsigned int i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(statistics->pop(stats));
+        EXPECT_EQ(stats.tick, i);
+        EXPECT_TRUE(stats.success);
+        EXPECT_GT(stats.update_time, 0.);
+        EXPECT_GT(stats.bounds_update_time, 0.);
+        EXPECT_LE(stats.bounds_update_time, stats.update_time);
+        EXPECT_GT(stats.solve_time, 0.);
+        EXPECT_EQ(stats.number_of_levels, 2);
+        for(unsigned int j = 0; j < stats.number_of_levels; ++j)
+        {
+            EXPECT_TRUE(stats.levels[j].success);
+            EXPECT_GE(stats.levels[j].iterations, 0);
+            EXPECT_GT(stats.levels[j].update_time, 0.);
+            EXPECT_LE(stats.levels[j].update_time, stats.update_time);
+            EXPECT_GT(stats.levels[j].back_end_time, 0.);
+            EXPECT_GT(stats.levels[j].back_end_solve_time, 0.);
+            EXPECT_LE(stats.levels[j].back_end_solve_time, stats.levels[j].back_end_time);
+            EXPECT_LE(stats.levels[j].cost_time + stats.levels[j].constraints_time + stats.levels[j].back_end_time,
+                      stats.solve_time);
+        }
+    }
+    EXPECT_FALSE(statistics->pop(stats));
+}
+
+TEST_F(testSolverStatistics, checkFrontEndsStatistics)
+{
+    const int n = 6;
+    std::srand(42);
+
+    Eigen::MatrixXd A = Eigen::MatrixXd::Random(3, n);
+    OpenSoT::tasks::GenericTask::Ptr task1 = std::make_shared<OpenSoT::tasks::GenericTask>("task1", A,
+                                                                                           Eigen::VectorXd::Random(3));
+    OpenSoT::tasks::GenericTask::Ptr task2 = std::make_shared<OpenSoT::tasks::GenericTask>("task2",
+                                                                                           Eigen::MatrixXd::Identity(n, n),
+                                                                                           Eigen::VectorXd::Zero(n));
+    Eigen::VectorXd u = Eigen::VectorXd::Constant(n, 5.);
+    OpenSoT::constraints::GenericConstraint::Ptr bounds = std::make_shared<OpenSoT::constraints::GenericConstraint>(
+                "bounds", u, -u, n);
+
+    OpenSoT::AutoStack::Ptr autostack = (task1 / task2)<<bounds;
+    autostack->update();
+
+    std::vector<std::pair<std::string, OpenSoT::Solver<Eigen::MatrixXd, Eigen::VectorXd>::SolverPtr>> solvers;
+    solvers.emplace_back("nHQP", std::make_shared<OpenSoT::solvers::nHQP>(autostack->getStack(), autostack->getBounds(), 1e-6));
+    solvers.emplace_back("eHQP", std::make_shared<OpenSoT::solvers::eHQP>(autostack->getStack()));
+    solvers.emplace_back("l1HQP", std::make_shared<OpenSoT::solvers::l1HQP>(*autostack));
+    solvers.emplace_back("wHQP", std::make_shared<OpenSoT::solvers::wHQP>(*autostack, std::vector<double>{1e3, 1.}));
+#ifdef OPENSOT_HAS_SOTH_FRONT_END
+    solvers.emplace_back("HCOD", std::make_shared<OpenSoT::solvers::HCOD>(*autostack, 1e-9));
+#endif
+
+    for(auto& solver : solvers)
+    {
+        OpenSoT::utils::SolverStatistics::Ptr statistics = std::make_shared<OpenSoT::utils::SolverStatistics>();
+        solver.second->setStatistics(statistics);
+
+        Eigen::VectorXd x;
+        for(unsigned int i = 0; i < 3; ++i)
+        {
+            autostack->update();
+            EXPECT_TRUE(solver.second->solve(x)) << solver.first;
+        }
+
+        OpenSoT::utils::TickStatistics stats;
+        for(unsigned int i = 0; i < 3; ++i)
+        {
+            ASSERT_TRUE(statistics->pop(stats)) << solver.first;
+            EXPECT_EQ(stats.tick, i) << solver.first;
+            EXPECT_TRUE(stats.success) << solver.first;
+            EXPECT_GT(stats.solve_time, 0.) << solver.first;
+            EXPECT_GE(stats.number_of_levels, 1) << solver.first;
+            for(unsigned int j = 0; j < stats.number_of_levels; ++j)
+            {
+                EXPECT_TRUE(stats.levels[j].success) << solver.first;
+                EXPECT_LE(stats.levels[j].back_end_solve_time, stats.levels[j].back_end_time) << solver.first;
+                EXPECT_LE(stats.levels[j].cost_time + stats.levels[j].constraints_time + stats.levels[j].back_end_time,
+                          stats.solve_time) << solver.first;
+            }
+        }
+        EXPECT_FALSE(statistics->pop(stats)) << solver.first;
+    }
+}
+
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
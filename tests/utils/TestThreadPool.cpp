@@ -0,0 +1,198 @@
+#include <OpenSoT/utils/ThreadPool.h>
+#include <OpenSoT/tasks/Aggregated.h>
+#include <OpenSoT/tasks/GenericTask.h>
+#include <OpenSoT/constraints/Aggregated.h>
+#include <OpenSoT/constraints/GenericConstraint.h>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <cstdint>
+
+namespace{
+
+/* the models are only compared, never read */
+const XBot::ModelInterface* fakeModel(const std::uintptr_t i)
+{
+    return reinterpret_cast<const XBot::ModelInterface*>(i);
+}
+
+class ModelTask: public OpenSoT::tasks::GenericTask
+{
+public:
+    ModelTask(const std::string& task_id, const Eigen::MatrixXd& A, const Eigen::VectorXd& b,
+              const XBot::ModelInterface* model):
+        GenericTask(task_id, A, b),
+        _fake_model(model)
+    {
+
+    }
+
+    void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(_fake_model); }
+
+private:
+    const XBot::ModelInterface* _fake_model;
+};
+
+class ModelConstraint: public OpenSoT::constraints::GenericConstraint
+{
+public:
+    ModelConstraint(const std::string& constraint_id, const Eigen::VectorXd& upper_bound,
+                    const Eigen::VectorXd& lower_bound, const XBot::ModelInterface* model):
+        GenericConstraint(constraint_id, upper_bound, lower_bound, upper_bound.size()),
+        _fake_model(model)
+    {
+
+    }
+
+    void getModels(std::vector<const XBot::ModelInterface*>& models) const override { models.push_back(_fake_model); }
+
+private:
+    const XBot::ModelInterface* _fake_model;
+};
+
+class testThreadPool: public ::testing::Test
+{
+protected:
+
+    testThreadPool()
+    {
+
+    }
+
+    virtual ~testThreadPool() {
+
+    }
+
+    virtual void SetUp() {
+
+    }
+
+    virtual void TearDown() {
+
+    }
+
+};
+
+TEST_F(testThreadPool, checkRun)
+{
+    OpenSoT::utils::ThreadPool pool(3);
+    EXPECT_EQ(pool.getNumberOfThreads(), 3);
+
+    std::vector<int> counter(100, 0);
+    for(unsigned int k = 0; k < 50; ++k)
+    {
+        pool.run(counter.size(), [&counter](const unsigned int i){counter[i] += 1;});
+        for(unsigned int i = 0; i < counter.size(); ++i)
+            EXPECT_EQ(counter[i], k+1);
+    }
+
+    // nested calls are executed serially by the calling thread
+    std::vector<int> nested(4*10, 0);
+    pool.run(4, [&pool, &nested](const unsigned int i){
+        pool.run(10, [i, &nested](const unsigned int j){nested[10*i + j] += 1;});
+    });
+    for(unsigned int i = 0; i < nested.size(); ++i)
+        EXPECT_EQ(nested[i], 1);
+
+    EXPECT_THROW(pool.run(10, [](const unsigned int i){
+        if(i == 7) throw std::runtime_error("job failed");}), std::runtime_error);
+
+    // the pool is still usable after an exception
+    pool.run(counter.size(), [&counter](const unsigned int i){counter[i] = 0;});
+    for(unsigned int i = 0; i < counter.size(); ++i)
+        EXPECT_EQ(counter[i], 0);
+}
+
+TEST_F(testThreadPool, checkParallelAggregated)
+{
+    const int n = 10;
+    std::list<OpenSoT::tasks::Aggregated::TaskPtr> tasks, tasks_parallel;
+    for(unsigned int i = 0; i < 6; ++i)
+    {
+        Eigen::MatrixXd A(i+1, n); A.setRandom();
+        Eigen::VectorXd b(i+1); b.setRandom();
+        tasks.push_back(std::make_shared<OpenSoT::tasks::GenericTask>("task_" + std::to_string(i), A, b));
+        tasks_parallel.push_back(std::make_shared<OpenSoT::tasks::GenericTask>("task_" + std::to_string(i), A, b));
+    }
+
+    OpenSoT::tasks::Aggregated aggregated(tasks, n);
+    OpenSoT::tasks::Aggregated aggregated_parallel(tasks_parallel, n);
+    EXPECT_TRUE(aggregated_parallel.setThreadPool(std::make_shared<OpenSoT::utils::ThreadPool>(2)));
+
+    for(unsigned int k = 0; k < 10; ++k)
+    {
+        auto it = tasks.begin();
+        auto it_parallel = tasks_parallel.begin();
+        for(; it != tasks.end(); ++it, ++it_parallel)
+        {
+            Eigen::VectorXd b((*it)->getTaskSize()); b.setRandom();
+            std::static_pointer_cast<OpenSoT::tasks::GenericTask>(*it)->setb(b);
+            std::static_pointer_cast<OpenSoT::tasks::GenericTask>(*it_parallel)->setb(b);
+        }
+
+        aggregated.update();
+        aggregated_parallel.update();
+
+        EXPECT_TRUE(aggregated.getA() == aggregated_parallel.getA());
+        EXPECT_TRUE(aggregated.getb() == aggregated_parallel.getb());
+    }
+}
+
+}
+
+TEST_F(testThreadPool, checkSharedModel)
+{
+    const int n = 10;
+    auto pool = std::make_shared<OpenSoT::utils::ThreadPool>(2);
+    Eigen::MatrixXd A(3, n); A.setRandom();
+    Eigen::VectorXd b(3); b.setRandom();
+
+    // tasks reading from different models are updated in parallel
+    auto task_0 = std::make_shared<ModelTask>("task_0", A, b, fakeModel(8));
+    auto task_1 = std::make_shared<ModelTask>("task_1", A, b, fakeModel(16));
+    OpenSoT::tasks::Aggregated distinct(task_0, task_1, n);
+    EXPECT_TRUE(distinct.setThreadPool(pool));
+
+    std::vector<const XBot::ModelInterface*> models;
+    distinct.getModels(models);
+    EXPECT_EQ(models.size(), 2);
+
+    // tasks reading from the same model keep the serial update
+    auto task_2 = std::make_shared<ModelTask>("task_2", A, b, fakeModel(8));
+    OpenSoT::tasks::Aggregated shared(task_0, task_2, n);
+    EXPECT_FALSE(shared.setThreadPool(pool));
+    shared.update();
+    EXPECT_TRUE(shared.getA().topRows(3) == A);
+    EXPECT_TRUE(shared.getA().bottomRows(3) == A);
+
+    // the model can be shared through the constraints of a task
+    auto task_3 = std::make_shared<ModelTask>("task_3", A, b, fakeModel(24));
+    task_3->getConstraints().push_back(
+        std::make_shared<ModelConstraint>("constraint_0", Eigen::VectorXd::Ones(n), -Eigen::VectorXd::Ones(n), fakeModel(16)));
+    OpenSoT::tasks::Aggregated shared_by_constraint(task_1, task_3, n);
+    EXPECT_FALSE(shared_by_constraint.setThreadPool(pool));
+
+    // a nested Aggregated reports the models of its tasks
+    OpenSoT::tasks::Aggregated::Ptr nested = std::make_shared<OpenSoT::tasks::Aggregated>(task_0, task_1, n);
+    OpenSoT::tasks::Aggregated shared_by_nested(nested, task_2, n);
+    EXPECT_FALSE(shared_by_nested.setThreadPool(pool));
+
+    // the same holds for the constraints
+    auto constraint_1 = std::make_shared<ModelConstraint>("constraint_1", Eigen::VectorXd::Ones(n), -Eigen::VectorXd::Ones(n), fakeModel(8));
+    auto constraint_2 = std::make_shared<ModelConstraint>("constraint_2", Eigen::VectorXd::Ones(n), -Eigen::VectorXd::Ones(n), fakeModel(16));
+    auto constraint_3 = std::make_shared<ModelConstraint>("constraint_3", Eigen::VectorXd::Ones(n), -Eigen::VectorXd::Ones(n), fakeModel(8));
+    OpenSoT::constraints::Aggregated distinct_constraints(constraint_1, constraint_2, n);
+    EXPECT_TRUE(distinct_constraints.setThreadPool(pool));
+    OpenSoT::constraints::Aggregated shared_constraints(constraint_1, constraint_3, n);
+    EXPECT_FALSE(shared_constraints.setThreadPool(pool));
+    shared_constraints.update();
+    EXPECT_TRUE(shared_constraints.getUpperBound() == Eigen::VectorXd::Ones(n));
+
+    // getting back to the serial update is always allowed
+    EXPECT_TRUE(shared.setThreadPool(nullptr));
+    EXPECT_TRUE(shared_constraints.setThreadPool(nullptr));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}